@@ -5,7 +5,10 @@
 #include <iostream>
 #include <cstring>
 #include <array>
+#include <algorithm>
+#include <span>
 #include <fstream>
+#include <string_view>
 #include <asio.hpp>
 #include <QApplication>
 #include "ProxyProtocol.hpp"
@@ -17,17 +20,21 @@
 #include "protocol/ShiftModule.h"
 #include "protocol/PaddingModule.h"
 #include "protocol/EncryptionModule.h"
+#include "common/GuardTrafficClass.h"
 #ifdef _WIN32
     #include <winsock2.h>
 #else
     #include <arpa/inet.h>
 #endif
 
+// --cipher <cbc|ctr|gcm> : 페이로드 ARIA 운용 모드 (가드 recv의 --cipher와 같아야 함)
+static ARIAAlgorithm::Mode g_cipher_mode = ARIAAlgorithm::Mode::Cbc;
+
 ProtocolEngine GetProtocolEngine()
 {
     ProtocolEngine engine;
     engine.addModule(std::make_unique<ShiftModule>(8));
-    engine.addModule(std::make_unique<EncryptionModule>(std::vector<uint8_t>(32, 0x01))); // 예시로 32바이트 키 사용
+    engine.addModule(std::make_unique<EncryptionModule>(std::vector<uint8_t>(32, 0x01), g_cipher_mode)); // 예시로 32바이트 키 사용
     engine.addModule(std::make_unique<PaddingModule>(std::vector<uint8_t>{0,0,0,0}));
 
     return engine;
@@ -59,7 +66,15 @@ void DispatchFilteredPayloadTcp(ReceivedPayload&& payload)
 
         constexpr size_t kOriginalDestInfoSize = 1 + 1 + 16 + 2; // IP 버전(1) + IP 길이(1) + IP 주소(16) + 포트(2)
         std::vector<uint8_t> buffer;
-        buffer.reserve(kOriginalDestInfoSize);
+        buffer.reserve(1 + kOriginalDestInfoSize);
+
+        // --- [0] 가드 대기열 우선순위용 트래픽 클래스 태그 (가드가 떼어내고 전송) ---
+        GuardTrafficClass traffic_class = GuardTrafficClass::INTERACTIVE;
+        if (payload.is_file)
+        {
+            traffic_class = payload.data.size() > GUARD_DOCUMENT_MAX_SIZE ? GuardTrafficClass::BULK : GuardTrafficClass::DOCUMENT;
+        }
+        buffer.push_back(make_traffic_class_tag(traffic_class));
         
         // --- [1] 헤더에 원래 출발지/목적지 정보 삽입 ---
         buffer.push_back(static_cast<uint8_t>(payload.src_ip_ver));
@@ -72,41 +87,46 @@ void DispatchFilteredPayloadTcp(ReceivedPayload&& payload)
         buffer.push_back(static_cast<uint8_t>((payload.dest_port >> 8) & 0xFF));
         buffer.push_back(static_cast<uint8_t>(payload.dest_port & 0xFF));
         
-        std::vector<uint8_t> new_payload_vec;
-        size_t new_payload_size = 5 + (payload.is_file ? (4 + payload.file_name.size() + 8) : 8) + payload.data.size();
-        new_payload_vec.reserve(new_payload_size);
+        // --- [2] 실제 데이터 형식 머리 구성 (본문은 아래에서 조각으로 바로 암호화) ---
+        std::vector<uint8_t> format_header;
+        format_header.reserve(5 + (payload.is_file ? (4 + payload.file_name.size() + 8) : 8));
 
-        // --- [2] 실제 데이터 형식 구성 ---
         if (payload.is_file) 
         {
-            new_payload_vec.insert(new_payload_vec.end(), {'F', 'I', 'L', 'E', '\0'});
+            format_header.insert(format_header.end(), {'F', 'I', 'L', 'E', '\0'});
 
             uint32_t nameLen = static_cast<uint32_t>(payload.file_name.size());
             for (int i = 0; i < 4; ++i)
-                new_payload_vec.push_back((nameLen >> (i * 8)) & 0xFF);
+                format_header.push_back((nameLen >> (i * 8)) & 0xFF);
 
-            new_payload_vec.insert(new_payload_vec.end(), payload.file_name.begin(), payload.file_name.end());
+            format_header.insert(format_header.end(), payload.file_name.begin(), payload.file_name.end());
 
             uint64_t fileSize = payload.data.size();
             for (int i = 0; i < 8; ++i)
-                new_payload_vec.push_back((fileSize >> (i * 8)) & 0xFF);
-
-            new_payload_vec.insert(new_payload_vec.end(), payload.data.begin(), payload.data.end());
+                format_header.push_back((fileSize >> (i * 8)) & 0xFF);
         }
         else 
         {
-            new_payload_vec.insert(new_payload_vec.end(), {'T', 'E', 'X', 'T', '\0'});
+            format_header.insert(format_header.end(), {'T', 'E', 'X', 'T', '\0'});
 
             uint64_t textLen = payload.data.size();
-            for (int i = 0; i < 8; ++i) new_payload_vec.push_back((textLen >> (i * 8)) & 0xFF);
-
-            new_payload_vec.insert(new_payload_vec.end(), payload.data.begin(), payload.data.end());
+            for (int i = 0; i < 8; ++i) format_header.push_back((textLen >> (i * 8)) & 0xFF);
         }
 
-        new_payload_vec = protocol_engine.encrypt(std::span<const uint8_t>(new_payload_vec.begin(), new_payload_vec.end()));
-        buffer.insert(buffer.end(), new_payload_vec.begin(), new_payload_vec.end());
-
-        // --- TCP로 데이터 전송 ---
+        // --- [3] 암호화하면서 TCP로 전송 ---
+        // 형식 머리 + 본문을 조각마다 암호화해 바로 보내므로 파일 크기만큼의 평문/암호문 사본을 더 만들지 않음.
+        // 가드는 연결이 닫힐 때까지 읽으므로 한 번에 보낸 것과 같음
+        constexpr size_t kStreamChunkSize = 1024 * 1024;
+        ProtocolEngine::Stream stream = protocol_engine.beginEncrypt();
+        stream.update(format_header, buffer);
+        for (size_t off = 0; off < payload.data.size(); off += kStreamChunkSize)
+        {
+            const size_t len = std::min(kStreamChunkSize, payload.data.size() - off);
+            stream.update(std::span<const uint8_t>(payload.data.data() + off, len), buffer);
+            asio::write(socket, asio::buffer(buffer));
+            buffer.clear();
+        }
+        stream.finish(buffer);
         asio::write(socket, asio::buffer(buffer));
         socket.close();
 
@@ -195,6 +215,34 @@ void DispatchFilteredPayloadUdp(ReceivedPayload&& payload)
 int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
+
+    // Qt가 자기 옵션을 뗀 뒤 남은 인자
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg = argv[i];
+        if (arg != "--cipher")
+        {
+            continue;
+        }
+        const std::string_view cipher = i + 1 < argc ? argv[++i] : "";
+        if (cipher == "cbc")
+        {
+            g_cipher_mode = ARIAAlgorithm::Mode::Cbc;
+        }
+        else if (cipher == "ctr")
+        {
+            g_cipher_mode = ARIAAlgorithm::Mode::Ctr;
+        }
+        else if (cipher == "gcm")
+        {
+            g_cipher_mode = ARIAAlgorithm::Mode::Gcm;
+        }
+        else
+        {
+            std::cerr << "--cipher requires cbc, ctr or gcm\n";
+            return 1;
+        }
+    }
     CdsGuardMainWindow w;
     w.show();
 
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+
+/**
+ * @brief 단계(스레드) 사이를 잇는 크기 제한 대기열
+ * @details 가득 차면 push가, 비어 있으면 pop이 블로킹되어 느린 단계가 앞 단계를 자연스럽게 늦춤.
+ *          중단 요청 시 push는 false, pop은 std::nullopt를 돌려줌
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity) {}
+
+    bool push(T &&item, std::stop_token token)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (!not_full_.wait(lock, token, [this] { return items_.size() < capacity_; }))
+            {
+                return false;
+            }
+            items_.push_back(std::move(item));
+            if (items_.size() > high_watermark_)
+            {
+                high_watermark_ = items_.size();
+            }
+        }
+        not_empty_.notify_one();
+        return true;
+    }
+
+    std::optional<T> pop(std::stop_token token)
+    {
+        std::optional<T> item;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (!not_empty_.wait(lock, token, [this] { return !items_.empty(); }))
+            {
+                return std::nullopt;
+            }
+            item.emplace(std::move(items_.front()));
+            items_.pop_front();
+        }
+        not_full_.notify_one();
+        return item;
+    }
+
+    // timeout 동안 비어 있으면 std::nullopt (중단 요청과 구분하려면 token을 확인)
+    template <typename Rep, typename Period>
+    std::optional<T> pop_for(std::chrono::duration<Rep, Period> timeout, std::stop_token token)
+    {
+        std::optional<T> item;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (!not_empty_.wait_for(lock, token, timeout, [this] { return !items_.empty(); }))
+            {
+                return std::nullopt;
+            }
+            item.emplace(std::move(items_.front()));
+            items_.pop_front();
+        }
+        not_full_.notify_one();
+        return item;
+    }
+
+    size_t depth() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return items_.size();
+    }
+
+    size_t high_watermark() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return high_watermark_;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    const size_t capacity_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable_any not_full_;
+    std::condition_variable_any not_empty_;
+    std::deque<T> items_;
+    size_t high_watermark_ = 0;
+};
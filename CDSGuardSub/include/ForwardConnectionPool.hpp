@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <asio.hpp>
+#include "GuardUring.hpp"
+
+// 목적지가 SYN을 버리면(RST도 없음) 커널 연결 시도가 2분 가까이 걸리므로 전달 스레드가 기다리는 상한
+constexpr std::chrono::milliseconds FORWARD_CONNECT_TIMEOUT{2000};
+// 연결은 받고 읽지 않는 목적지가 전달 스레드를 붙잡지 않도록, 쓰기가 이 시간 동안 한 바이트도 나아가지 않으면 실패 처리
+constexpr std::chrono::milliseconds FORWARD_WRITE_TIMEOUT{10000};
+
+struct ForwardPoolConfig
+{
+    std::chrono::milliseconds connect_timeout = FORWARD_CONNECT_TIMEOUT; // 연결 시도 상한 (넘으면 timed_out으로 실패하고 백오프)
+    std::chrono::milliseconds write_timeout = FORWARD_WRITE_TIMEOUT;     // 쓰기가 진척 없이 기다리는 상한 (넘으면 연결을 닫고 백오프)
+    size_t max_idle_per_destination = 4;                          // 목적지마다 보관할 유휴 연결 수
+    std::chrono::seconds idle_timeout{60};                        // 이보다 오래 쉰 연결은 재사용하지 않고 닫음
+    std::chrono::milliseconds reconnect_backoff_initial{100};     // 연결 실패 후 다음 시도까지 대기 (실패마다 두 배)
+    std::chrono::milliseconds reconnect_backoff_max{30000};
+    bool use_io_uring = false;                                    // 길이 헤더(고정 버퍼)와 페이로드를 연결된 io_uring 요청 하나로 보냄
+};
+
+/**
+ * @brief RecvMode에서 목적지로 복원 데이터를 전달하는 지속 연결 풀
+ *
+ * - 목적지(ip, port)별로 유휴 연결을 보관하여 전달마다 연결/종료를 반복하지 않음
+ * - 연결을 닫아 메시지 경계를 알릴 수 없으므로 각 메시지 앞에 8바이트 빅엔디언 길이를 붙임 (RecvMode는 --forward-framing length일 때만 풀을 씀)
+ * - 재사용 전에 상대가 연결을 닫았는지(또는 예상치 않은 데이터를 보냈는지) 확인하고, 그런 연결은 버림
+ * - 재사용한 연결에 쓰기가 실패하면 새 연결로 한 번 더 시도 (쓰기 시간 초과는 목적지가 멈춘 것이므로 재시도하지 않음)
+ * - 연결 시도는 connect_timeout, 쓰기는 진척 없이 write_timeout까지만 기다리고, 실패한 목적지는 백오프 기간 동안
+ *   바로 실패 처리하여 전달 루프가 느린 목적지에 묶이지 않게 함
+ * - use_io_uring이면 쓰기를 io_uring으로 제출함. 커널이 지원하지 않으면 asio::write를 그대로 씀
+ */
+class ForwardConnectionPool {
+public:
+    constexpr static size_t FRAME_HEADER_SIZE = 8;
+
+    ForwardConnectionPool(asio::io_context& ctx, ForwardPoolConfig config);
+
+    /**
+     * @brief payload를 길이 프레임으로 감싸 endpoint로 보냄
+     * @return 실패 시 오류 코드 (백오프 중이면 connection_refused)
+     */
+    asio::error_code send(const asio::ip::tcp::endpoint& endpoint, std::span<const uint8_t> payload);
+
+    size_t idle_connections() const;
+
+    /**
+     * @brief 비차단 connect 후 poll로 timeout까지만 기다림 (socket이 닫혀 있으면 endpoint 프로토콜로 엶)
+     * @return 시간이 지나면 timed_out. 실패하면 socket을 닫음
+     */
+    static asio::error_code connect_with_timeout(asio::ip::tcp::socket& socket, const asio::ip::tcp::endpoint& endpoint,
+                                                 std::chrono::milliseconds timeout);
+
+    /**
+     * @brief buffers를 차례로 모두 보냄. 비차단 sendmsg 후 보낼 수 없으면 poll로 timeout까지만 기다림 (진척이 있으면 다시 셈)
+     * @return 시간이 지나면 timed_out. 일부만 나갔을 수 있으므로 실패한 연결은 닫아야 함
+     */
+    static asio::error_code write_with_timeout(asio::ip::tcp::socket& socket, std::span<const asio::const_buffer> buffers,
+                                               std::chrono::milliseconds timeout);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct IdleConnection
+    {
+        asio::ip::tcp::socket socket;
+        Clock::time_point idle_since;
+    };
+
+    struct Destination
+    {
+        std::deque<IdleConnection> idle;
+        std::chrono::milliseconds backoff{0};
+        Clock::time_point next_attempt{};
+    };
+
+    std::optional<asio::ip::tcp::socket> take_idle(const asio::ip::tcp::endpoint& endpoint);
+    asio::error_code connect(const asio::ip::tcp::endpoint& endpoint, asio::ip::tcp::socket& socket);
+    void back_off(const asio::ip::tcp::endpoint& endpoint, const asio::error_code& ec, const char* what);
+    void release(const asio::ip::tcp::endpoint& endpoint, asio::ip::tcp::socket&& socket);
+    static bool is_healthy(asio::ip::tcp::socket& socket);
+    asio::error_code write_frame(asio::ip::tcp::socket& socket, std::span<const uint8_t> payload);
+
+    asio::io_context& ctx_;
+    const ForwardPoolConfig config_;
+
+    mutable std::mutex mutex_;
+    std::map<asio::ip::tcp::endpoint, Destination> destinations_;
+
+    std::mutex uring_mutex_;              // 링은 한 번에 한 스레드만 사용
+    std::unique_ptr<GuardUring> uring_;   // use_io_uring이고 지원될 때만
+};
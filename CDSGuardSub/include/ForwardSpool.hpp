@@ -0,0 +1,119 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <optional>
+#include <span>
+#include <asio.hpp>
+
+enum class ForwardSpoolSync {
+    ALWAYS,   // 기록/전달 완료 표시마다 msync (가장 안전, 가장 느림)
+    INTERVAL, // sync_interval마다 변경된 세그먼트를 msync (기본)
+    NONE,     // 커널에 맡김. 프로세스가 죽어도 남지만 전원 장애 시 최근 기록 유실 가능
+};
+
+struct ForwardSpoolConfig
+{
+    std::filesystem::path dir;
+    uint64_t max_bytes = 1024ULL * 1024 * 1024;                 // 세그먼트 파일 크기 합계 상한
+    uint64_t segment_size = 64ULL * 1024 * 1024;                // 기본 세그먼트 크기 (더 큰 레코드는 전용 세그먼트)
+    ForwardSpoolSync sync = ForwardSpoolSync::INTERVAL;
+    std::chrono::milliseconds sync_interval{1000};
+    std::chrono::milliseconds replay_backoff_initial{1000};     // 재전달 실패 시 대기 (실패마다 두 배)
+    std::chrono::milliseconds replay_backoff_max{60000};
+};
+
+/**
+ * @brief RecvMode에서 목적지에 전달하지 못한 페이로드를 보관했다가 순서대로 다시 보내는 디스크 스풀
+ *
+ * - dir 아래 세그먼트 파일(segment_<id>.spool)을 fallocate로 확보하고 mmap하여 레코드를 이어 붙임
+ * - 레코드는 헤더(목적지, 길이, CRC32) + 페이로드. 전달하면 헤더의 delivered 바이트만 제자리에서 표시하고,
+ *   세그먼트의 레코드가 모두 전달되면 파일을 지움
+ * - 시작 시 세그먼트를 순서대로 읽어 CRC가 맞고 아직 전달되지 않은 레코드를 복구. 중간에 잘린 레코드에서 그 세그먼트 읽기를 멈춤
+ * - 목적지마다 순서를 지키므로 스풀에 남은 것이 있는 목적지의 새 페이로드는 바로 보내지 않고 뒤에 붙임
+ * - 전달 완료 표시가 디스크에 닿기 전에 죽으면 재시작 후 한 번 더 전달될 수 있음 (최소 한 번 전달)
+ *
+ * 전달 스레드 하나에서만 사용해야 함
+ */
+class ForwardSpool {
+public:
+    using SendFn = std::function<asio::error_code(const asio::ip::tcp::endpoint&, std::span<const uint8_t>)>;
+
+    explicit ForwardSpool(ForwardSpoolConfig config);
+    ~ForwardSpool();
+
+    ForwardSpool(const ForwardSpool&) = delete;
+    ForwardSpool& operator=(const ForwardSpool&) = delete;
+
+    bool has_pending(const asio::ip::tcp::endpoint& endpoint) const;
+
+    /**
+     * @return 크기 상한을 넘거나 파일을 만들지 못하면 false (호출자가 버림 처리)
+     */
+    bool append(const asio::ip::tcp::endpoint& endpoint, std::span<const uint8_t> payload);
+
+    /**
+     * @brief 백오프가 지난 목적지마다 보관된 레코드를 순서대로 send로 보내고, 처음 실패한 곳에서 그 목적지는 멈춤
+     * @return 전달한 레코드 수
+     */
+    size_t replay(const SendFn& send);
+
+    // INTERVAL 정책에서 주기가 지났으면 변경된 세그먼트를 디스크에 씀
+    void flush_if_due();
+
+    // 다음 재전달 또는 동기화까지 남은 시간. 보관된 것이 없으면 std::nullopt
+    std::optional<std::chrono::milliseconds> next_wakeup() const;
+
+    size_t pending_records() const { return pending_records_; }
+    uint64_t bytes_in_use() const { return bytes_in_use_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Segment
+    {
+        std::filesystem::path path;
+        uint8_t* base = nullptr;
+        uint64_t capacity = 0;  // 매핑 크기
+        uint64_t file_size = 0; // 디스크에서 차지하는 크기 (봉인 시 used로 줄임)
+        uint64_t used = 0;      // 기록된 레코드 끝
+        size_t pending = 0;     // 아직 전달되지 않은 레코드 수
+        int fd = -1;            // 추가 중인 세그먼트만 열어 둠
+        bool dirty = false;
+    };
+
+    struct RecordRef
+    {
+        uint64_t segment_id;
+        uint64_t offset;
+    };
+
+    struct Destination
+    {
+        std::deque<RecordRef> records;
+        std::chrono::milliseconds backoff{0};
+        Clock::time_point next_attempt{};
+    };
+
+    void recover();
+    bool open_segment(uint64_t capacity);
+    void seal_active();
+    void mark_delivered(const RecordRef& ref);
+    void release_segment(uint64_t id);
+    void sync_range(Segment& segment, uint64_t offset, uint64_t length);
+
+    const ForwardSpoolConfig config_;
+
+    std::map<uint64_t, Segment> segments_;
+    std::optional<uint64_t> active_id_; // 레코드를 이어 붙이는 세그먼트
+    uint64_t next_segment_id_ = 0;
+    uint64_t bytes_in_use_ = 0;
+    size_t pending_records_ = 0;
+
+    std::map<asio::ip::tcp::endpoint, Destination> destinations_;
+    Clock::time_point last_sync_ = Clock::now();
+};
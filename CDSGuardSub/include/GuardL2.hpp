@@ -13,6 +13,14 @@
 #include <condition_variable>
 #include <thread>
 #include <source_location>
+#include <deque>
+#include <filesystem>
+#include <atomic>
+#include <memory>
+#include "GuardL2Reassembly.hpp"
+#include "GuardL2FramePipeline.hpp"
+#include "GuardL2LowLatency.hpp"
+#include "GuardL2Capture.hpp"
 
 #if __cplusplus >= 202302L
     #include <print>
@@ -61,6 +69,30 @@ inline void GuardL2DebugErrorLog(const std::source_location& loc, Args&&... args
 
 constexpr uint16_t ETHERTYPE_GUARDL2 = 0x88B5;
 
+/**
+ * @brief 프레임 검증에 쓰는 CRC32(IEEE). previous에 이전 결과를 넘기면 나누어 계산 가능
+ */
+uint32_t guard_l2_crc32(std::span<const uint8_t> data, uint32_t previous = 0);
+
+/**
+ * @brief Ethernet 헤더 뒤의 GuardL2 프레임(전체 헤더 또는 축약 DATA)의 CRC를 다시 계산
+ * @details 재생 하네스가 세션 ID나 세션 태그를 바꾼 뒤 사용
+ * @return 길이가 맞지 않는 프레임이면 false
+ */
+bool guard_l2_refresh_frame_crc(std::span<uint8_t> frame);
+
+// 1: 최초 형식 (START/START ACK 페이로드 없음), 2: 버전/기능 협상과 축약 DATA 프레임
+constexpr uint8_t GUARD_L2_PROTOCOL_VERSION = 2;
+
+/**
+ * @brief START/START ACK로 교환하는 기능 비트
+ * @details 송신자는 자신이 지원하는 기능을, 수신자는 그중 자신도 지원하는 기능만 돌려보냄. 돌려받은 기능만 사용
+ */
+enum GuardL2Capability : uint32_t {
+    GUARD_L2_CAP_RESUME       = 0x01,
+    GUARD_L2_CAP_COMPACT_DATA = 0x02, // DATA 대신 GuardL2CompactDataHeader 형식의 DATA_COMPACT 사용
+};
+
 // L2 페이로드 앞에 붙을 커스텀 프로토콜 헤더
 // __attribute__((packed))는 컴파일러가 패딩을 추가하지 않도록 하여
 // 네트워크상에서 정확한 구조를 유지
@@ -73,6 +105,7 @@ struct GuardL2Header {
         DATA  = 0x02,
         ACK   = 0x03,
         END   = 0x04,
+        DATA_COMPACT = 0x05, // 협상된 경우에만 사용. GuardL2Header 대신 GuardL2CompactDataHeader로 시작
     };
 
     FrameType type;
@@ -84,71 +117,218 @@ struct GuardL2Header {
     uint32_t crc32;
 } __attribute__((packed));
 
+/**
+ * @brief START 프레임에 실리는 페이로드
+ * @details 이전 버전 수신자는 START의 페이로드를 읽지 않으므로 무시됨.
+ *          뒤쪽 필드는 버전 2부터 추가되었으므로 수신자는 payload_length로 각 필드의 존재 여부를 판단
+ */
+struct GuardL2StartPayload {
+    enum Flags : uint8_t {
+        FLAG_RESUME    = 0x01, // session_id가 이전에 중단된 세션을 가리킴. 수신자는 남아있는 부분부터 이어받음
+        FLAG_RESUMABLE = 0x02, // data_crc32가 유효하며 수신자는 중단 시 받은 부분을 보관할 수 있음 (버전 2부터)
+    };
+
+    uint8_t flags;
+    uint32_t data_crc32;      // 전체 데이터의 CRC32. 재개 시 같은 데이터인지 확인하는 데 사용
+    uint8_t protocol_version; // 송신자의 GUARD_L2_PROTOCOL_VERSION
+    uint32_t capabilities;    // 송신자가 지원하는 GuardL2Capability 비트
+} __attribute__((packed));
+
+/**
+ * @brief START에 대한 ACK에 실리는 페이로드
+ * @details 이전 버전 수신자는 페이로드 없이(또는 앞쪽 필드만) 보내므로 송신자는 payload_length로 각 필드의 존재 여부를 판단
+ */
+struct GuardL2StartAckPayload {
+    uint32_t receiver_instance_id; // 수신자 객체가 생성될 때 정해지는 값. 바뀌었다면 수신 측 상태(중복 제거 캐시 등)가 초기화된 것
+    uint32_t resume_base;          // 수신자가 아직 갖고 있지 않은 첫 DATA 시퀀스 번호. 새 세션이면 1
+    uint8_t protocol_version;      // 수신자의 GUARD_L2_PROTOCOL_VERSION
+    uint32_t capabilities;         // 송신자가 제안한 기능 중 수신자도 지원하는 것
+    uint16_t session_tag;          // DATA_COMPACT 프레임에서 session_id 대신 쓰는 값
+} __attribute__((packed));
+
+/**
+ * @brief 축약 DATA 프레임 헤더 (GUARD_L2_CAP_COMPACT_DATA 협상 시)
+ * @details 헤더 뒤에 LEB128 varint 시퀀스 번호, varint 페이로드 길이, 페이로드가 이어짐.
+ *          total_size와 receive_window가 없고 세션을 16비트 태그로 구분하여 전체 헤더(28바이트)보다 14~18바이트 작음.
+ *          CRC는 crc32 필드를 0으로 두고 type부터 페이로드 끝까지 계산
+ */
+struct GuardL2CompactDataHeader {
+    GuardL2Header::FrameType type;
+    uint16_t session_tag;
+    uint32_t crc32;
+} __attribute__((packed));
+
+/**
+ * @brief 중단된 전송을 이어 보내기 위한 정보. send_reliable_data()가 실패한 뒤 resume_token()으로 얻음
+ */
+struct GuardL2ResumeToken {
+    uint32_t session_id = 0;
+    uint64_t total_size = 0;
+    uint32_t data_crc32 = 0;
+
+    bool valid() const { return session_id != 0; }
+};
+
+/**
+ * @brief 본딩 모드에서 사용하는 물리 링크(NIC) 하나의 설정
+ * @details 수신 측은 peer_mac을 사용하지 않으며, 수신한 프레임의 송신 MAC으로 ACK를 돌려보냄
+ */
+struct GuardL2LinkConfig {
+    std::string interface_name;
+    std::array<uint8_t, 6> local_mac{};
+    std::array<uint8_t, 6> peer_mac{};
+    int sock_fd = -1; // 0 이상이면 raw 소켓을 만들지 않고 이 소켓을 사용하며 소유권을 가져감 (재생 하네스의 socketpair 등)
+};
+
 
 class GuardL2Sender {
 public:
     GuardL2Sender(const std::string& interface_name, const std::array<uint8_t, 6>& src_mac, const std::array<uint8_t, 6>& dst_mac);
+
+    /**
+     * @brief 여러 링크에 세션의 DATA 프레임을 분산(striping)하는 본딩 모드 송신자
+     * @param links 사용할 링크 목록 (첫 번째 링크가 START/END 제어 프레임의 기본 링크)
+     * @param enable_failover true면 연속 타임아웃이 발생한 링크를 세션에서 제외하고 미확인 프레임을 다른 링크로 재전송
+     */
+    explicit GuardL2Sender(const std::vector<GuardL2LinkConfig>& links, bool enable_failover = false);
     ~GuardL2Sender();
 
     // 데이터를 안정적으로 전송하는 메인 함수
     bool send_reliable_data(std::span<const uint8_t> data);
 
+    /**
+     * @brief 이전에 실패한 전송을 수신자가 가진 부분 이후부터 이어서 전송
+     * @param resume_from 실패한 전송 직후 resume_token()으로 얻은 값. 데이터의 크기/CRC가 다르면 처음부터 전송
+     */
+    bool send_reliable_data(std::span<const uint8_t> data, const GuardL2ResumeToken& resume_from);
+
+    /**
+     * @brief 재개 가능 모드. 켜면 START에 데이터 CRC를 실어 수신자가 실패한 세션을 디스크에 보관하도록 함
+     */
+    void enable_resume(bool enable) { resume_enabled_ = enable; }
+
+    // 마지막 send_reliable_data() 호출의 세션 정보 (재개 가능 모드에서만 유효)
+    GuardL2ResumeToken resume_token() const { return last_resume_token_; }
+
+    /**
+     * @brief 마지막 START 핸드셰이크에서 수신자가 알려준 instance id
+     * @return 수신자가 알려주지 않았으면 0
+     */
+    uint32_t peer_instance_id() const { return peer_instance_id_; }
+
+    /**
+     * @brief DATA 프레임을 미리 만들어 두는 작업 스레드 수. 0이면 전송 루프에서 직접 생성
+     * @details 기본값은 코어가 2개 이상이면 1, 아니면 0. 다음 send_reliable_data()부터 적용됨
+     */
+    void set_frame_workers(size_t workers) { frame_workers_ = workers; }
+
+    // 수신자가 지원하면 축약 DATA 프레임 사용 (기본값 true)
+    void set_compact_data(bool enable) { compact_data_enabled_ = enable; }
+
+    /**
+     * @brief 지연 시간 우선 모드. 전송 스레드와 ACK 리스너를 지정한 코어에 고정하고 소켓에 busy poll을 설정
+     * @details 다음 send_reliable_data()부터 적용됨
+     */
+    void set_latency_profile(const GuardL2LatencyProfile& profile);
+
+    // 송수신하는 모든 GuardL2 프레임을 capture에 기록. 링크마다 인터페이스 하나씩 등록됨
+    void set_capture(std::shared_ptr<GuardL2Capture> capture);
+
 private:
     struct SentPacketInfo 
     {
         std::vector<uint8_t> frame_data;
         std::chrono::steady_clock::time_point time_sent;
         bool acked = false;
+        size_t link_index = 0; // 이 프레임을 마지막으로 전송한 링크
+    };
+
+    /**
+     * @brief 링크별 소켓과 혼잡 제어/RTT 상태
+     * @details cwnd, ssthresh, ack_count는 cwnd_mutex_로, srtt, rttvar, rto는 rtt_mutex_로 보호됨
+     */
+    struct LinkState
+    {
+        GuardL2LinkConfig config;
+        int sock_fd = -1;
+
+        double cwnd = 1.0;                  // 혼잡 윈도우 크기 (Congestion Window)
+        uint32_t ssthresh = 64;             // 느린 시작 임계값 (Slow Start Threshold)
+        uint32_t ack_count = 0;             // 혼잡 회피 단계에서 cwnd 증가를 위한 카운터
+
+        std::chrono::microseconds srtt{};
+        std::chrono::microseconds rttvar{};
+        std::chrono::microseconds rto{std::chrono::milliseconds(200)}; // 초기 200 ms
+
+        uint32_t consecutive_timeouts = 0;  // ACK 수신 없이 연속으로 발생한 타임아웃 횟수
+        bool alive = true;                  // failover로 제외되면 false
+        uint32_t capture_interface = 0;     // capture_에 등록된 인터페이스 번호
     };
 
     int create_raw_socket(const std::string& interface_name);
     std::vector<uint8_t> build_frame(GuardL2Header::FrameType type, uint32_t seq_num, std::span<const uint8_t> payload);
+    static std::vector<uint8_t> build_compact_data_frame(uint16_t session_tag, uint32_t seq_num, std::span<const uint8_t> payload);
     
-    void send_raw_frame(const std::vector<uint8_t>& frame_data);
+    // 프레임의 Ethernet 헤더를 해당 링크의 MAC으로 기록한 뒤 그 링크의 소켓으로 전송
+    void send_raw_frame(size_t link_index, std::vector<uint8_t>& frame_data);
 
     // --- 동적 윈도우를 위한 함수 ---
-    void on_ack_received(uint32_t ack_seq, uint16_t advertised_window);
-    void on_packet_loss();
+    void on_ack_received(size_t link_index, uint32_t ack_seq, uint16_t advertised_window);
+    void on_packet_loss(size_t link_index);
     
     // 특정 시퀀스 번호의 ACK를 기다리는 함수
     bool wait_for_ack(uint32_t expected_seq_num, uint32_t timeout_sec = 2);
-    void ack_listener_thread(std::stop_token token);
-    void update_rtt(std::chrono::steady_clock::duration sample_rtt);
-    std::chrono::milliseconds get_rto();
+    void ack_listener_thread(std::stop_token token, size_t link_index);
+    void update_rtt(size_t link_index, std::chrono::steady_clock::duration sample_rtt);
+    std::chrono::milliseconds get_rto(size_t link_index);
 
+    // --- 본딩을 위한 함수 ---
+    size_t pick_data_link(const std::vector<uint32_t>& in_flight);
+    size_t next_alive_link(size_t after) const;
+    bool mark_link_failed(size_t link_index);
+    bool send_control_frame(uint32_t seq);
 
-    int sock_fd_ = -1;
-    std::string interface_name_;
-    std::array<uint8_t, 6> src_mac_;
-    std::array<uint8_t, 6> dst_mac_;
+
+    std::vector<LinkState> links_;
+    bool enable_failover_ = false;
     uint32_t session_id_;
     uint64_t total_data_size_ = 0;
+    uint32_t peer_instance_id_ = 0; // buffer_mutex_로 보호
+    uint32_t peer_resume_base_ = 1; // buffer_mutex_로 보호
+    uint8_t peer_protocol_version_ = 1; // buffer_mutex_로 보호
+    uint32_t peer_capabilities_ = 0;    // buffer_mutex_로 보호 (수신자가 수락한 기능)
+    uint16_t peer_session_tag_ = 0;     // buffer_mutex_로 보호
+    bool compact_data_enabled_ = true;
+
+    bool resume_enabled_ = false;
+    GuardL2ResumeToken last_resume_token_;
+    size_t frame_workers_ = std::thread::hardware_concurrency() > 1 ? 1 : 0;
+    GuardL2LatencyProfile latency_profile_;
+    std::shared_ptr<GuardL2Capture> capture_;
 
     std::map<uint32_t, SentPacketInfo> send_buffer_; // Selective Repeat 상태 변수
 
-    std::mutex buffer_mutex_; // send_buffer_ 보호용 뮤텍스
-    std::jthread listener_thread_; // 소멸 시 자동 join되는 스레드
+    std::mutex buffer_mutex_; // send_buffer_, LinkState::alive 보호용 뮤텍스
+    std::vector<std::jthread> listener_threads_; // 링크별 ACK 리스너, 소멸 시 자동 join
     std::condition_variable ack_cv_;
 
-    // --- 동적 윈도우 멤버 변수 ---
-    double cwnd_ = 1.0;                  // 혼잡 윈도우 크기 (Congestion Window)
-    uint32_t ssthresh_ = 64;             // 느린 시작 임계값 (Slow Start Threshold)
-    uint32_t ack_count_ = 0;             // 혼잡 회피 단계에서 cwnd 증가를 위한 카운터
-    std::mutex cwnd_mutex_;              // cwnd_, ssthresh_ 보호용 뮤텍스
+    std::mutex cwnd_mutex_;              // 링크별 cwnd, ssthresh, ack_count 보호용 뮤텍스
 
-    uint32_t rwnd_ = 64;
+    uint32_t rwnd_ = 64;                 // 수신자는 모든 링크를 하나의 재조립 버퍼로 합치므로 세션 단위로 하나만 유지
     std::mutex rwnd_mutex_;
 
-    // RTT 추정치
-    std::chrono::microseconds srtt_{};
-    std::chrono::microseconds rttvar_{};
-    std::chrono::microseconds rto_{std::chrono::milliseconds(200)}; // 초기 200 ms
-    std::mutex rtt_mutex_;
+    std::mutex rtt_mutex_;               // 링크별 RTT 추정치 보호용 뮤텍스
 };
 
 class GuardL2Receiver {
 public:
     GuardL2Receiver(const std::string& interface_name, const std::array<uint8_t, 6>& my_mac);
+
+    /**
+     * @brief 여러 링크에서 같은 세션의 프레임을 받아 하나의 재조립 버퍼로 합치는 본딩 모드 수신자
+     * @param links 수신할 링크 목록 (peer_mac은 사용하지 않음)
+     */
+    explicit GuardL2Receiver(const std::vector<GuardL2LinkConfig>& links);
     ~GuardL2Receiver();
 
     /**
@@ -157,14 +337,85 @@ public:
      */
     std::vector<uint8_t> receive_reliable_data();
 
+    /**
+     * @brief receive_reliable_data()와 같지만 재조립 저장소를 그대로 넘겨줌. 큰 전송이 디스크 스풀에 있을 때 메모리로 복사하지 않음
+     * @return 수신 성공 여부. 성공 시 store.data()가 전체 데이터
+     */
+    bool receive_reliable_data(GuardL2ReassemblyStore& store);
+
+    /**
+     * @brief 재개 가능 모드. 타임아웃으로 끝난 재개 가능 세션의 받은 부분을 spool_dir에 보관하고,
+     *        같은 세션의 재개 START가 오면 이어서 받음
+     */
+    void enable_resume(const std::filesystem::path& spool_dir);
+
+    /**
+     * @brief 지연 시간 우선 모드. receive_reliable_data()를 호출한 스레드를 data_cpu에 고정하고 소켓에 busy poll을 설정
+     */
+    void set_latency_profile(const GuardL2LatencyProfile& profile);
+
+    // 송수신하는 모든 GuardL2 프레임을 capture에 기록. 링크마다 인터페이스 하나씩 등록됨
+    void set_capture(std::shared_ptr<GuardL2Capture> capture);
+
 private:
+    struct LinkState
+    {
+        GuardL2LinkConfig config;
+        int sock_fd = -1;
+        uint32_t capture_interface = 0;
+    };
+
     int create_raw_socket(const std::string& interface_name);
-    void send_ack(const std::array<uint8_t, 6>& dst_mac, uint32_t session_id, uint32_t seq_num);
+    // ACK는 해당 프레임이 도착한 링크로 돌려보냄
+    void send_ack(size_t link_index, const std::array<uint8_t, 6>& dst_mac, uint32_t session_id, uint32_t seq_num, std::span<const uint8_t> payload = {});
+
+    /**
+     * @brief 광고할 수신 윈도우를 조정 (TCP의 dynamic right-sizing과 같은 방식)
+     * @details RTT마다 순서대로 빠져나간 프레임 수의 두 배로 윈도우를 키우고(대역폭-지연 곱 추종),
+     *          메모리 예산의 여유와 동시 세션 수로 정한 상한을 넘으면 줄임
+     * @param delivered 이번 프레임으로 순서대로 이어진 프레임 수
+     */
+    void update_receive_window(uint32_t seq_num, uint32_t receive_window_base, uint32_t delivered);
+    void reset_receive_window();
+    uint32_t receive_window_limit() const;
+
+    // 재개 보관 파일 (<spool_dir>/session_<id>.part, .meta)
+    struct CompletedSession
+    {
+        uint32_t session_id;
+        uint64_t total_size;
+        uint32_t data_crc32;
+    };
+
+    void save_resume_state(uint32_t session_id, uint64_t total_size, uint32_t data_crc32, std::span<const uint8_t> prefix);
+    // 보관된 앞부분을 store에 복원하고 그 길이를 반환. 없거나 손상되었으면 0
+    uint64_t load_resume_state(uint32_t session_id, uint64_t total_size, uint32_t data_crc32, GuardL2ReassemblyStore& store);
+    void remove_resume_state(uint32_t session_id);
+
+    std::vector<LinkState> links_;
+    uint32_t instance_id_; // START ACK로 송신자에게 알려주는 수신자 식별 값
+    uint16_t next_session_tag_; // 연속된 세션이 같은 태그를 쓰지 않도록 세션마다 증가
+
+    std::filesystem::path resume_dir_; // 비어있으면 재개 모드 꺼짐
+    GuardL2LatencyProfile latency_profile_;
+    std::shared_ptr<GuardL2Capture> capture_;
+    std::deque<CompletedSession> completed_sessions_; // END ACK 유실로 송신자가 재개를 요청할 때 중복 전달을 막기 위한 최근 완료 세션
+
+    // 프레임은 도착 즉시 저장소의 제자리에 기록하고, 받은 프레임만 표시 (시퀀스 번호 -> 수신 여부)
+    std::vector<bool> received_frames_;
+    size_t out_of_order_frames_ = 0; // 윈도우 기준점 이후에 먼저 도착한 프레임 수
 
-    int sock_fd_ = -1;
-    std::string interface_name_;
-    std::array<uint8_t, 6> my_mac_;
+    // 수신 윈도우 (프레임 단위). 헤더의 receive_window가 16비트이므로 최대 65535
+    constexpr static uint32_t INITIAL_RECEIVE_WINDOW = 64;  // 송신자의 초기 rwnd와 같음
+    constexpr static uint32_t MIN_RECEIVE_WINDOW = 16;
+    constexpr static uint32_t MAX_RECEIVE_WINDOW = 65535;
+    uint32_t receive_window_ = INITIAL_RECEIVE_WINDOW;
+    uint32_t advertised_edge_ = 0;     // 지금까지 광고한 윈도우 끝(시퀀스 번호) 중 최댓값
+    uint32_t rtt_probe_edge_ = 0;      // 0이 아니면 이 번호 이상의 프레임 도착을 기다리며 RTT 측정 중
+    std::chrono::steady_clock::time_point rtt_probe_time_;
+    std::chrono::steady_clock::duration receiver_rtt_{}; // 수신 측에서 추정한 RTT (상한값)
+    std::chrono::steady_clock::time_point window_epoch_start_;
+    uint32_t window_epoch_delivered_ = 0;
 
-    std::map<uint32_t, std::vector<uint8_t>> out_of_order_buffer_; // 순서가 맞지 않게 도착한 패킷의 '페이로드'를 임시 저장하는 버퍼 (시퀀스 번호 -> 데이터)
-    constexpr static size_t RECEIVER_WINDOW_CAPACITY = 512; // 프레임 단위 버퍼 용량
+    static std::atomic<size_t> active_sessions_; // 프로세스 내 모든 수신자의 진행 중 세션 수
 };
\ No newline at end of file
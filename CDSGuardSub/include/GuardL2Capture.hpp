@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 캡처한 프레임의 방향 (pcapng EPB의 epb_flags 하위 2비트와 같은 값)
+ */
+enum class GuardL2CaptureDirection : uint32_t {
+    INBOUND  = 1,
+    OUTBOUND = 2,
+};
+
+/**
+ * @brief GuardL2 프레임을 pcapng로 기록 (Wireshark 등에서 바로 열림)
+ * @details 링크마다 인터페이스 블록(IDB, 이더넷, 나노초 타임스탬프)을 하나씩 두고 프레임마다 EPB를 씀.
+ *          송신 스레드와 ACK 리스너가 함께 기록하므로 내부에서 직렬화함.
+ *          프로세스가 강제 종료되어도 대부분 남도록 기록 중 1초마다 파일로 내보냄
+ */
+class GuardL2Capture {
+public:
+    // 파일을 열지 못하면 std::runtime_error
+    explicit GuardL2Capture(const std::filesystem::path& path);
+    ~GuardL2Capture();
+
+    GuardL2Capture(const GuardL2Capture&) = delete;
+    GuardL2Capture& operator=(const GuardL2Capture&) = delete;
+
+    // 인터페이스 블록을 쓰고 그 번호를 돌려줌. 프레임을 기록할 때 이 번호를 씀
+    uint32_t add_interface(const std::string& interface_name);
+
+    void record(uint32_t interface_id, GuardL2CaptureDirection direction, std::span<const uint8_t> frame);
+
+    void flush();
+
+    uint64_t frames_recorded() const;
+
+private:
+    void write_block(uint32_t block_type, std::span<const uint8_t> body);
+
+    constexpr static std::chrono::seconds FLUSH_INTERVAL{1};
+
+    std::ofstream file_;
+    mutable std::mutex mutex_;
+    uint32_t next_interface_id_ = 0;
+    uint64_t frames_recorded_ = 0;
+    std::chrono::steady_clock::time_point last_flush_ = std::chrono::steady_clock::now();
+};
+
+/**
+ * @brief pcapng에서 읽은 프레임 하나
+ */
+struct GuardL2CapturedFrame
+{
+    uint64_t timestamp_ns;       // 캡처 시각 (에포크 기준 나노초)
+    uint32_t interface_id;
+    uint32_t direction;          // GuardL2CaptureDirection 값, 기록되지 않았으면 0
+    std::vector<uint8_t> data;   // 이더넷 헤더부터
+};
+
+/**
+ * @brief pcapng의 EPB/SPB 프레임을 파일 순서대로 읽음
+ * @details 다른 도구(tcpdump, dumpcap)로 만든 파일도 읽을 수 있도록 if_tsresol과 바이트 순서를 해석함.
+ *          형식 오류는 std::runtime_error
+ */
+std::vector<GuardL2CapturedFrame> read_guard_l2_capture(const std::filesystem::path& path, std::vector<std::string>* interface_names = nullptr);
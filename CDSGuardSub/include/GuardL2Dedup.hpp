@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * GuardL2 위에 얹는 내용 기반 청크 중복 제거 계층
+ *
+ * - 송신 측은 Gear 롤링 해시로 청크 경계를 정하고(content-defined chunking) SHA-256으로 청크를 식별
+ * - 수신 측 캐시가 이미 가진 청크는 해시(REF)만, 처음 보는 청크는 데이터(NEW)를 전송
+ * - 양쪽 모두 바이트 용량 기준 FIFO로 청크를 내보냄. 송신 인덱스 용량을 수신 캐시 용량보다 작게 두어
+ *   END ACK 유실 등으로 수신 측에만 추가된 청크가 있어도 송신 측이 REF로 가리키는 청크는 캐시에 남아있게 함
+ * - 송신 인덱스에서 밀려난 청크는 다시 NEW로 오고 인덱스 맨 뒤에 들어가므로, 수신 캐시도 이미 가진 청크가
+ *   NEW로 오면 맨 뒤로 옮겨 양쪽의 내보내는 순서를 맞춤
+ *
+ * 스트림 형식: "GDD1" | 레코드...
+ *   NEW : 0x01 | u32 length (big endian) | data
+ *   REF : 0x02 | sha256 (32 bytes)
+ *
+ * 게이트웨이 암호문은 메시지마다 IV가 새로 뽑혀 같은 내용도 바이트가 매번 달라지므로 청크가 겹치지 않음.
+ * 그래서 송신 측은 페이로드를 복호화한 평문에 중복 제거를 적용하고, 그 스트림을 다시 암호화하여
+ * 봉인 형식으로 보냄. 링크에는 평문이 실리지 않음
+ *
+ * 봉인 형식: "GDE1" | ProtocolEngine으로 암호화한 "GDD1" 스트림
+ *
+ * 일반 페이로드는 IP 버전(4 또는 6)으로 시작하므로 매직으로 구분 가능
+ */
+
+using GuardL2ChunkHash = std::array<uint8_t, 32>;
+
+struct GuardL2ChunkHashHasher
+{
+    size_t operator()(const GuardL2ChunkHash &hash) const
+    {
+        size_t value;
+        std::memcpy(&value, hash.data(), sizeof(value)); // SHA-256 출력은 이미 고르게 분포되어 있음
+        return value;
+    }
+};
+
+/**
+ * @brief 송신 측: 청크 분할, 상대가 가진 청크 인덱스 관리, 중복 제거 스트림 생성
+ */
+class GuardL2DedupEncoder {
+public:
+    constexpr static size_t DEFAULT_INDEX_CAPACITY = 32 * 1024 * 1024; // 수신 캐시 기본 용량의 절반
+
+    explicit GuardL2DedupEncoder(size_t index_capacity_bytes = DEFAULT_INDEX_CAPACITY);
+
+    /**
+     * @brief 데이터를 중복 제거 스트림으로 변환. 새로 보내는 청크는 commit() 전까지 인덱스에 반영되지 않음
+     */
+    std::vector<uint8_t> encode(std::span<const uint8_t> data);
+
+    /**
+     * @brief 마지막 encode() 결과의 전송이 성공했을 때 새 청크를 인덱스에 반영
+     * @param peer_instance_id GuardL2Sender::peer_instance_id() 값 (0이면 알 수 없음으로 취급)
+     * @return false면 수신자가 재시작되어 마지막 스트림의 REF가 유효하지 않았던 것. 인덱스가 초기화되었으므로 다시 encode()하여 재전송해야 함
+     */
+    bool commit(uint32_t peer_instance_id);
+
+    // 전송 실패 시 마지막 encode()의 새 청크를 버림
+    void discard();
+
+    // 암호화한 스트림 앞에 봉인 매직을 붙임
+    static std::vector<uint8_t> seal(std::span<const uint8_t> encrypted_stream);
+
+    size_t last_new_bytes() const { return last_new_bytes_; }
+    size_t last_ref_bytes() const { return last_ref_bytes_; }
+
+private:
+    void insert_into_index(const GuardL2ChunkHash &hash, size_t size);
+
+    size_t index_capacity_bytes_;
+    size_t index_bytes_ = 0;
+    std::unordered_set<GuardL2ChunkHash, GuardL2ChunkHashHasher> index_;
+    std::deque<std::pair<GuardL2ChunkHash, size_t>> index_order_; // FIFO 제거 순서
+
+    std::vector<std::pair<GuardL2ChunkHash, size_t>> pending_; // 마지막 encode()에서 NEW로 보낸 청크
+    uint32_t peer_instance_id_ = 0;
+    size_t last_new_bytes_ = 0;
+    size_t last_ref_bytes_ = 0;
+};
+
+/**
+ * @brief 수신 측: 청크 캐시를 유지하며 중복 제거 스트림을 원래 데이터로 복원
+ */
+class GuardL2DedupDecoder {
+public:
+    constexpr static size_t DEFAULT_CACHE_CAPACITY = 64 * 1024 * 1024;
+
+    explicit GuardL2DedupDecoder(size_t cache_capacity_bytes = DEFAULT_CACHE_CAPACITY);
+
+    static bool is_dedup_stream(std::span<const uint8_t> data);
+    static bool is_sealed_stream(std::span<const uint8_t> data);
+    // 봉인 매직 뒤의 암호문. 복호화하면 "GDD1" 스트림
+    static std::span<const uint8_t> sealed_payload(std::span<const uint8_t> data);
+
+    /**
+     * @return 형식 오류 또는 캐시에 없는 청크를 참조하면 std::nullopt
+     */
+    std::optional<std::vector<uint8_t>> decode(std::span<const uint8_t> stream);
+
+private:
+    void insert_into_cache(const GuardL2ChunkHash &hash, std::span<const uint8_t> chunk);
+
+    size_t cache_capacity_bytes_;
+    size_t cache_bytes_ = 0;
+    struct CachedChunk
+    {
+        std::vector<uint8_t> data;
+        std::list<GuardL2ChunkHash>::iterator order; // cache_order_ 안의 위치
+    };
+
+    std::unordered_map<GuardL2ChunkHash, CachedChunk, GuardL2ChunkHashHasher> cache_;
+    std::list<GuardL2ChunkHash> cache_order_; // FIFO 제거 순서 (다시 NEW로 온 청크는 맨 뒤로 옮김)
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 단일 생산자/단일 소비자 lock-free 링 버퍼
+ * @details 용량은 2의 거듭제곱으로 올림. 생산자는 try_push만, 소비자는 try_pop만 호출해야 함
+ */
+template <typename T>
+class GuardL2SpscRing {
+public:
+    explicit GuardL2SpscRing(size_t capacity)
+    {
+        size_t rounded = 1;
+        while (rounded < capacity)
+        {
+            rounded <<= 1;
+        }
+        slots_.resize(rounded);
+        mask_ = rounded - 1;
+    }
+
+    bool try_push(T &&item)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == slots_.size())
+        {
+            return false; // 가득 참
+        }
+        slots_[tail & mask_] = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::optional<T> try_pop()
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+        {
+            return std::nullopt; // 비어 있음
+        }
+        T item = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return item;
+    }
+
+private:
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+
+    // 생산자와 소비자가 같은 캐시 라인을 두고 다투지 않도록 분리
+    alignas(64) std::atomic<size_t> head_{0}; // 소비자가 다음에 꺼낼 위치
+    alignas(64) std::atomic<size_t> tail_{0}; // 생산자가 다음에 넣을 위치
+};
+
+/**
+ * @brief 전송 스레드보다 앞서 DATA 프레임을 만들어 두는 생산 단계
+ *
+ * 작업 스레드 N개가 시퀀스 번호를 나누어(seq % N) 프레임 생성(할당, 헤더, 페이로드 복사, CRC)을 하고
+ * 각자의 SPSC 링에 넣음. 전송 스레드는 take()로 시퀀스 순서대로 꺼내 커널에 넘기기만 함
+ */
+class GuardL2FramePreparer {
+public:
+    using BuildFrameFn = std::function<std::vector<uint8_t>(uint32_t seq)>;
+
+    constexpr static size_t PIPELINE_DEPTH = 512; // 모든 작업 스레드가 미리 만들어 둘 수 있는 프레임 수 합계
+
+    /**
+     * @param first_seq, last_seq 생성할 시퀀스 범위 (양끝 포함)
+     * @param build_frame 작업 스레드에서 호출되므로 호출 중에 바뀌는 상태를 읽으면 안 됨
+     */
+    GuardL2FramePreparer(uint32_t first_seq, uint32_t last_seq, size_t workers, BuildFrameFn build_frame);
+
+    /**
+     * @brief 다음 프레임을 꺼냄. 처음 호출은 first_seq, 이후 1씩 증가하는 seq로만 호출해야 함
+     */
+    std::vector<uint8_t> take(uint32_t seq);
+
+private:
+    struct Worker
+    {
+        explicit Worker(size_t capacity) : ring(capacity) {}
+
+        GuardL2SpscRing<std::vector<uint8_t>> ring;
+        std::jthread thread; // ring보다 먼저 소멸(join)되어야 하므로 뒤에 선언
+    };
+
+    void worker_loop(std::stop_token token, size_t worker_index);
+
+    uint32_t first_seq_;
+    uint32_t last_seq_;
+    BuildFrameFn build_frame_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+};
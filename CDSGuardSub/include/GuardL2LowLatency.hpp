@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <sys/select.h>
+#include <vector>
+
+/**
+ * @brief 지연 시간 우선 프로파일
+ *
+ * - CPU 고정: 데이터 경로 스레드가 코어를 옮겨 다니며 캐시를 잃지 않도록 지정한 코어에 고정 (-1이면 고정하지 않음)
+ * - SO_BUSY_POLL: 소켓에 데이터가 없을 때 커널이 잠들기 전에 busy_poll_usec 동안 장치 큐를 직접 확인
+ * - spin: select()로 잠들지 않고 타임아웃 0으로 계속 확인하여 깨어나는 지연을 없앰 (코어 하나를 계속 사용)
+ */
+struct GuardL2LatencyProfile
+{
+    int data_cpu = -1;       // 송신 측은 send_reliable_data, 수신 측은 receive_reliable_data를 호출하는 스레드
+    int ack_cpu = -1;        // 송신 측 링크별 ACK 리스너 (모두 같은 코어)
+    int busy_poll_usec = 0;  // 0이면 사용하지 않음
+    bool spin = false;
+
+    bool enabled() const { return data_cpu >= 0 || ack_cpu >= 0 || busy_poll_usec > 0 || spin; }
+};
+
+/**
+ * @brief NIC와 같은 NUMA 노드의 코어 목록 (/sys/class/net/<if>/device/local_cpulist)
+ * @details 가상 인터페이스처럼 정보가 없으면 현재 프로세스가 쓸 수 있는 모든 코어
+ */
+std::vector<int> guard_l2_nic_local_cpus(const std::string& interface_name);
+
+/**
+ * @brief NIC 근처 코어로 데이터/ACK 스레드를 나누어 고정하고 busy poll과 spin을 켠 프로파일
+ * @details 코어가 하나뿐이면 spin은 다른 스레드의 실행을 막으므로 끔
+ */
+GuardL2LatencyProfile guard_l2_auto_latency_profile(const std::string& interface_name);
+
+// 호출한 스레드를 cpu에 고정. cpu < 0이면 아무것도 하지 않음
+bool guard_l2_pin_current_thread(int cpu);
+
+// SO_BUSY_POLL 설정 (CAP_NET_ADMIN이 없거나 커널이 지원하지 않으면 false)
+bool guard_l2_enable_busy_poll(int sock_fd, int busy_poll_usec);
+
+/**
+ * @brief select()로 읽기 가능한 소켓을 기다림. 반환값과 read_fds는 select()와 같음
+ * @details spin이면 타임아웃 0으로 계속 확인하다가 timeout이 지나면 0을 반환
+ */
+int guard_l2_select_read(int max_fd, fd_set& read_fds, timeval timeout, bool spin);
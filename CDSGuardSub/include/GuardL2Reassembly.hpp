@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+/**
+ * 수신 세션의 재조립 저장소
+ *
+ * - START의 total_size는 신뢰할 수 없으므로 크기만큼 바로 메모리를 잡지 않음
+ * - memory_threshold 이하이고 전체 메모리 예산(모든 세션 합계)에 여유가 있으면 메모리에 재조립
+ * - 그 밖에는 spool_dir에 익명 파일을 만들어 fallocate로 공간을 미리 확보한 뒤 mmap하여 프레임을 오프셋에 기록
+ * - max_transfer_size를 넘거나 스풀 예산(모든 세션 합계)에 여유가 없으면 바로 거부하므로,
+ *   거짓 total_size 하나가 스풀 파일 시스템(tmpfs면 메모리)을 채우지 못하고 세션 시작 단계에서 걸러짐
+ */
+struct GuardL2ReassemblyLimits
+{
+    size_t memory_threshold = 64 * 1024 * 1024;  // 이보다 큰 전송은 디스크 스풀 사용
+    size_t memory_budget = 256 * 1024 * 1024;    // 모든 세션의 메모리 재조립 총량
+    uint64_t max_transfer_size = 4ull << 30;     // 전송 하나의 상한 (START total_size가 이보다 크면 거부)
+    uint64_t spool_budget = 8ull << 30;          // 모든 세션의 디스크 스풀 재조립 총량
+    std::filesystem::path spool_dir = std::filesystem::temp_directory_path();
+};
+
+class GuardL2ReassemblyStore {
+public:
+    GuardL2ReassemblyStore() = default;
+    ~GuardL2ReassemblyStore();
+
+    GuardL2ReassemblyStore(const GuardL2ReassemblyStore&) = delete;
+    GuardL2ReassemblyStore& operator=(const GuardL2ReassemblyStore&) = delete;
+    GuardL2ReassemblyStore(GuardL2ReassemblyStore&& other) noexcept;
+    GuardL2ReassemblyStore& operator=(GuardL2ReassemblyStore&& other) noexcept;
+
+    // 프로세스 전역 설정. 이후 open()부터 적용됨
+    static void set_limits(const GuardL2ReassemblyLimits& limits);
+    static GuardL2ReassemblyLimits limits();
+    static size_t memory_in_use() { return memory_in_use_.load(std::memory_order_relaxed); }
+    static size_t memory_budget() { return memory_budget_.load(std::memory_order_relaxed); } // 수신 경로에서 잠금 없이 읽기 위한 사본
+    static uint64_t spool_in_use() { return spool_in_use_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 기존 내용을 버리고 total_size 바이트 저장소를 준비
+     * @return max_transfer_size를 넘거나, 메모리 예산도 스풀 예산/디스크 공간도 확보하지 못하면 false
+     */
+    bool open(uint64_t total_size);
+    void reset();
+
+    // 범위를 벗어난 쓰기는 호출자가 막아야 함
+    void write(uint64_t offset, std::span<const uint8_t> data);
+
+    std::span<const uint8_t> data() const { return {base_, static_cast<size_t>(size_)}; }
+    uint64_t size() const { return size_; }
+    bool disk_backed() const { return mapped_; }
+
+    std::vector<uint8_t> to_vector() const { return {base_, base_ + size_}; }
+
+private:
+    static std::atomic<size_t> memory_in_use_;
+    static std::atomic<size_t> memory_budget_;
+    static std::atomic<uint64_t> spool_in_use_;
+
+    std::vector<uint8_t> memory_;
+    uint8_t* base_ = nullptr;
+    uint64_t size_ = 0;
+    size_t reserved_bytes_ = 0; // memory_in_use_에 더해 둔 양
+    uint64_t spool_reserved_bytes_ = 0; // spool_in_use_에 더해 둔 양
+    bool mapped_ = false;
+};
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include "ForwardSpool.hpp"
+#include "GuardL2LowLatency.hpp"
+#include "encryption/ARIAAlgorithm.h"
+
+/**
+ * @brief 위치 인자 뒤에 붙는 선택 옵션 (--name [value])
+ */
+struct GuardOptions
+{
+    bool link_failover = false; // --failover : 본딩 모드에서 연속 타임아웃이 난 링크를 세션에서 제외
+    bool dedup = false;         // --dedup    : 송신 시 페이로드를 평문으로 풀어 수신 측이 이미 가진 청크를 참조로 대체하고 다시 암호화 (수신 측은 자동 인식)
+    bool resume = false;        // --resume   : 끊긴 전송을 처음부터가 아니라 수신 측이 가진 지점부터 이어서 전송/수신
+    bool qos = false;           // --qos      : (send) 큰 전송을 조각으로 나누어 보내 높은 우선순위 전송이 사이에 끼어들게 함 (수신 측은 자동 인식)
+    std::string spool_dir = "/var/tmp/cdsguard"; // --spool-dir <dir> : (recv) 재개용 부분 수신 데이터를 보관할 디렉터리
+    uint64_t max_transfer_mb = 4096;      // --max-transfer-mb <n> : (recv) 전송 하나의 크기 상한 MiB (START가 알린 크기가 넘으면 거부)
+    uint64_t reassembly_spool_mb = 8192;  // --reassembly-spool-mb <n> : (recv) 큰 전송을 재조립하는 디스크 스풀의 모든 세션 합계 상한 MiB
+    size_t forward_pool_size = 0; // --forward-pool <n> : (recv) 목적지별 지속 연결 최대 n개 유지 (--forward-framing length 필요, 0이면 메시지마다 연결/종료)
+    bool forward_length_framing = false; // --forward-framing <close|length> : (recv) 목적지로 보내는 메시지 경계. length면 메시지마다 8바이트 빅엔디언 길이를 붙임
+    uint64_t forward_spool_mb = 1024; // --forward-spool-mb <n> : (recv) 전달 실패 페이로드를 보관할 디스크 스풀 상한 (0이면 보관하지 않고 버림)
+    ForwardSpoolSync spool_sync = ForwardSpoolSync::INTERVAL; // --spool-fsync <always|interval|none> : (recv) 전달 스풀 동기화 정책
+    size_t decrypt_workers = 0;   // --decrypt-workers <n> : (recv) 복호화 작업 스레드 수 (0이면 코어 수 - 1)
+    bool low_latency = false;     // --low-latency : L2 스레드를 NIC 근처 코어에 고정하고 busy poll/spin으로 대기
+    int pin_data_cpu = -1;        // --pin-cpus <data>[,<ack>] : L2 데이터/ACK 스레드를 고정할 코어 (--low-latency의 자동 선택보다 우선)
+    int pin_ack_cpu = -1;
+    std::string capture_path;     // --capture <file> : 송수신하는 모든 GuardL2 프레임을 pcapng로 기록
+    size_t replay_speed = 1;      // --replay-speed <n> : (replay) 캡처 시각 간격을 n배 빠르게 재생 (0이면 기다리지 않음)
+    bool io_uring = false;        // --io-uring : TCP 수신(send)과 지속 연결 전달(recv)에 io_uring 사용 (지원하지 않는 커널이면 asio)
+    ARIAAlgorithm::Mode cipher_mode = ARIAAlgorithm::Mode::Cbc; // --cipher <cbc|ctr|gcm> : (recv, send --dedup) 페이로드 ARIA 운용 모드 (CDSGateway의 --cipher와 같아야 함)
+    ARIAAlgorithm::Provider crypto_provider = ARIAAlgorithm::defaultProvider(); // --crypto-provider <builtin|openssl> : (recv, send --dedup) ARIA 구현 (기본: 빌드 설정)
+};
+
+/**
+ * @brief 옵션으로 L2 송수신자의 지연 시간 프로파일을 만듦
+ * @param interface_name 첫 번째 링크 인터페이스 (NIC 근처 코어를 찾는 데 사용)
+ */
+inline GuardL2LatencyProfile latency_profile_from_options(const GuardOptions &options, const std::string &interface_name)
+{
+    GuardL2LatencyProfile profile;
+    if (options.low_latency)
+    {
+        profile = guard_l2_auto_latency_profile(interface_name);
+    }
+    if (options.pin_data_cpu >= 0)
+    {
+        profile.data_cpu = options.pin_data_cpu;
+        profile.ack_cpu = options.pin_ack_cpu >= 0 ? options.pin_ack_cpu : options.pin_data_cpu;
+    }
+    return profile;
+}
+
+/**
+ * @brief argv[i]가 가리키는 옵션 다음의 음이 아닌 정수 값을 읽고 i를 값 위치로 옮김
+ */
+inline size_t parse_count_option(int argc, char *argv[], int &i)
+{
+    std::string name = argv[i];
+    if (i + 1 >= argc)
+    {
+        throw std::invalid_argument(name + " requires a number");
+    }
+
+    std::string_view value = argv[++i];
+    size_t count = 0;
+    auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), count);
+    if (ec != std::errc{} || end != value.data() + value.size())
+    {
+        throw std::invalid_argument("Invalid " + name + " value: " + std::string(value));
+    }
+    return count;
+}
+
+inline GuardOptions parse_guard_options(int argc, char *argv[], int first_index)
+{
+    GuardOptions options;
+
+    for (int i = first_index; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+
+        if (arg == "--failover")
+        {
+            options.link_failover = true;
+        }
+        else if (arg == "--dedup")
+        {
+            options.dedup = true;
+        }
+        else if (arg == "--resume")
+        {
+            options.resume = true;
+        }
+        else if (arg == "--qos")
+        {
+            options.qos = true;
+        }
+        else if (arg == "--spool-dir")
+        {
+            if (i + 1 >= argc)
+            {
+                throw std::invalid_argument("--spool-dir requires a directory");
+            }
+            options.spool_dir = argv[++i];
+        }
+        else if (arg == "--max-transfer-mb")
+        {
+            options.max_transfer_mb = parse_count_option(argc, argv, i);
+        }
+        else if (arg == "--reassembly-spool-mb")
+        {
+            options.reassembly_spool_mb = parse_count_option(argc, argv, i);
+        }
+        else if (arg == "--forward-pool")
+        {
+            options.forward_pool_size = parse_count_option(argc, argv, i);
+        }
+        else if (arg == "--forward-framing")
+        {
+            std::string_view framing = i + 1 < argc ? argv[++i] : "";
+            if (framing == "close")
+            {
+                options.forward_length_framing = false;
+            }
+            else if (framing == "length")
+            {
+                options.forward_length_framing = true;
+            }
+            else
+            {
+                throw std::invalid_argument("--forward-framing requires close or length");
+            }
+        }
+        else if (arg == "--forward-spool-mb")
+        {
+            options.forward_spool_mb = parse_count_option(argc, argv, i);
+        }
+        else if (arg == "--spool-fsync")
+        {
+            std::string_view policy = i + 1 < argc ? argv[++i] : "";
+            if (policy == "always")
+            {
+                options.spool_sync = ForwardSpoolSync::ALWAYS;
+            }
+            else if (policy == "interval")
+            {
+                options.spool_sync = ForwardSpoolSync::INTERVAL;
+            }
+            else if (policy == "none")
+            {
+                options.spool_sync = ForwardSpoolSync::NONE;
+            }
+            else
+            {
+                throw std::invalid_argument("--spool-fsync requires always, interval or none");
+            }
+        }
+        else if (arg == "--cipher")
+        {
+            std::string_view cipher = i + 1 < argc ? argv[++i] : "";
+            if (cipher == "cbc")
+            {
+                options.cipher_mode = ARIAAlgorithm::Mode::Cbc;
+            }
+            else if (cipher == "ctr")
+            {
+                options.cipher_mode = ARIAAlgorithm::Mode::Ctr;
+            }
+            else if (cipher == "gcm")
+            {
+                options.cipher_mode = ARIAAlgorithm::Mode::Gcm;
+            }
+            else
+            {
+                throw std::invalid_argument("--cipher requires cbc, ctr or gcm");
+            }
+        }
+        else if (arg == "--crypto-provider")
+        {
+            std::string_view provider = i + 1 < argc ? argv[++i] : "";
+            if (provider == "builtin")
+            {
+                options.crypto_provider = ARIAAlgorithm::Provider::Builtin;
+            }
+            else if (provider == "openssl")
+            {
+                options.crypto_provider = ARIAAlgorithm::Provider::OpenSsl;
+            }
+            else
+            {
+                throw std::invalid_argument("--crypto-provider requires builtin or openssl");
+            }
+            if (!ARIAAlgorithm::providerAvailable(options.crypto_provider))
+            {
+                throw std::invalid_argument("--crypto-provider openssl is not available in this build");
+            }
+        }
+        else if (arg == "--decrypt-workers")
+        {
+            options.decrypt_workers = parse_count_option(argc, argv, i);
+        }
+        else if (arg == "--low-latency")
+        {
+            options.low_latency = true;
+        }
+        else if (arg == "--pin-cpus")
+        {
+            std::string_view cpus = i + 1 < argc ? argv[++i] : "";
+            size_t comma = cpus.find(',');
+            std::string_view data_cpu = cpus.substr(0, comma);
+            std::string_view ack_cpu = comma == std::string_view::npos ? data_cpu : cpus.substr(comma + 1);
+
+            auto parse_cpu = [&cpus](std::string_view value)
+            {
+                int cpu = -1;
+                auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), cpu);
+                if (ec != std::errc{} || end != value.data() + value.size() || cpu < 0)
+                {
+                    throw std::invalid_argument("Invalid --pin-cpus value: " + std::string(cpus));
+                }
+                return cpu;
+            };
+            options.pin_data_cpu = parse_cpu(data_cpu);
+            options.pin_ack_cpu = parse_cpu(ack_cpu);
+        }
+        else if (arg == "--capture")
+        {
+            if (i + 1 >= argc)
+            {
+                throw std::invalid_argument("--capture requires a file");
+            }
+            options.capture_path = argv[++i];
+        }
+        else if (arg == "--replay-speed")
+        {
+            options.replay_speed = parse_count_option(argc, argv, i);
+        }
+        else if (arg == "--io-uring")
+        {
+            options.io_uring = true;
+        }
+        else
+        {
+            throw std::invalid_argument("Unknown option: " + std::string(arg));
+        }
+    }
+
+    // 지속 연결은 연결 종료로 메시지 경계를 알릴 수 없으므로 목적지가 길이 프레임을 읽는다고 명시해야 함
+    if (options.forward_pool_size > 0 && !options.forward_length_framing)
+    {
+        throw std::invalid_argument("--forward-pool requires --forward-framing length (destinations must read 8-byte length frames)");
+    }
+
+    return options;
+}
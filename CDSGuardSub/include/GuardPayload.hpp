@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <asio.hpp>
+#include "protocol/ProtocolEngine.h"
+#include "encryption/ARIAAlgorithm.h"
+
+/**
+ * 게이트웨이 페이로드 형식: 주소 헤더(src ip ver/ip/port, dest ip ver/ip/port) | ProtocolEngine 암호문
+ * 수신 측 복호화와 송신 측 --dedup(평문 중복 제거)이 같은 엔진 구성을 써야 하므로 여기서 공유
+ */
+
+// CDSGateway의 GetProtocolEngine과 같은 모듈 구성이어야 함
+ProtocolEngine GetProtocolEngine(ARIAAlgorithm::Mode cipher_mode);
+
+/**
+ * @brief 페이로드 앞의 주소 헤더를 해석
+ * @return 목적지와 헤더 크기. 헤더가 잘렸거나 IP 버전이 잘못되면 std::nullopt
+ */
+std::optional<std::pair<asio::ip::tcp::endpoint, size_t>> parse_forward_header(std::span<const uint8_t> recv_data);
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <span>
+#include <vector>
+#include "GuardL2Reassembly.hpp"
+#include "common/GuardTrafficClass.h"
+
+inline const char *traffic_class_name(GuardTrafficClass traffic_class)
+{
+    switch (traffic_class)
+    {
+    case GuardTrafficClass::INTERACTIVE: return "interactive";
+    case GuardTrafficClass::DOCUMENT:    return "document";
+    case GuardTrafficClass::BULK:        return "bulk";
+    }
+    return "unknown";
+}
+
+inline GuardTrafficClass classify_by_size(size_t size)
+{
+    if (size <= GUARD_INTERACTIVE_MAX_SIZE)
+    {
+        return GuardTrafficClass::INTERACTIVE;
+    }
+    return size <= GUARD_DOCUMENT_MAX_SIZE ? GuardTrafficClass::DOCUMENT : GuardTrafficClass::BULK;
+}
+
+/**
+ * @brief --qos 송신 시 큰 전송을 여러 L2 세션으로 나눌 때 각 세션 페이로드 앞에 붙는 헤더
+ * @details 조각 하나가 끝날 때마다 송신 측이 대기열을 다시 보므로 작은 전송이 큰 전송 사이에 끼어들 수 있음.
+ *          한 전송의 조각은 순서대로 보내지만 서로 다른 전송의 조각은 섞여 도착함
+ */
+struct GuardQosSegmentHeader
+{
+    std::array<char, 4> magic;
+    uint8_t traffic_class;
+    uint64_t transfer_id;
+    uint64_t total_size;   // 원래 전송의 전체 크기
+    uint64_t offset;       // 이 조각 데이터의 시작 위치 (데이터 길이는 세션 크기 - 헤더)
+} __attribute__((packed));
+
+constexpr std::array<char, 4> GUARD_QOS_SEGMENT_MAGIC = {'G', 'Q', 'S', '1'};
+
+std::vector<uint8_t> build_qos_segment(GuardTrafficClass traffic_class, uint64_t transfer_id, uint64_t total_size,
+                                       uint64_t offset, std::span<const uint8_t> data);
+
+/**
+ * @brief 수신 측에서 조각들을 원래 전송으로 합침
+ */
+class GuardQosSegmentAssembler {
+public:
+    constexpr static size_t MAX_PENDING_TRANSFERS = 64;
+    constexpr static std::chrono::minutes TRANSFER_TIMEOUT{10}; // 송신 측이 중간에 포기한 전송을 정리
+
+    static bool is_segment(std::span<const uint8_t> data);
+
+    /**
+     * @brief 조각을 더하고 전송이 완성되면 그 저장소를 돌려줌
+     * @details 형식 오류, 순서가 어긋난 조각, 공간 부족은 그 전송 전체를 버림
+     */
+    std::optional<GuardL2ReassemblyStore> add(std::span<const uint8_t> segment);
+
+    size_t pending_transfers() const { return pending_.size(); }
+
+private:
+    struct PendingTransfer
+    {
+        GuardL2ReassemblyStore store;
+        uint64_t received = 0;
+        std::chrono::steady_clock::time_point last_update;
+    };
+
+    void expire_stale();
+
+    std::map<uint64_t, PendingTransfer> pending_;
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <linux/io_uring.h>
+// linux/io_uring.h가 끌어오는 linux/fs.h의 BLOCK_SIZE 매크로가 ARIAAlgorithm::BLOCK_SIZE를 깨뜨리므로 지움
+#undef BLOCK_SIZE
+#include <asio.hpp>
+
+/**
+ * @brief io_uring 링 하나 (liburing 없이 시스템 콜을 직접 사용)
+ *
+ * - 제출 큐(SQ)와 완료 큐(CQ)를 mmap으로 공유하여 여러 요청을 시스템 콜 한 번으로 제출/수확
+ * - 제공 버퍼(provided buffers): 멀티샷 recv가 커널이 고른 버퍼에 바로 받도록 미리 넘겨 둠
+ * - 고정 버퍼(registered buffer): 쓰기마다 페이지를 고정하지 않도록 미리 등록한 영역
+ *
+ * 한 스레드에서만 사용해야 함
+ */
+class GuardUring {
+public:
+    constexpr static size_t FIXED_REGION_SIZE = 4096; // 고정 버퍼 0번의 크기
+
+    /**
+     * @param entries 제출 큐 크기 (2의 거듭제곱으로 올림)
+     * @details 링 생성 또는 고정 버퍼 등록에 실패하면 std::system_error
+     */
+    explicit GuardUring(unsigned entries);
+    ~GuardUring();
+
+    GuardUring(const GuardUring&) = delete;
+    GuardUring& operator=(const GuardUring&) = delete;
+
+    /**
+     * @brief 이 커널에서 멀티샷 accept/recv, 제공 버퍼, 고정 버퍼 쓰기를 쓸 수 있는지 (6.0 이상)
+     * @details 처음 한 번만 시험 링을 만들어 확인하고 결과를 기억함
+     */
+    static bool supported();
+
+    // 빈 SQE. 제출 큐가 가득 차면 먼저 제출하고 가져옴
+    io_uring_sqe* get_sqe();
+
+    /**
+     * @brief 쌓인 SQE를 제출하고 완료가 wait_nr개 이상 쌓일 때까지 기다림
+     * @return 제출한 수 또는 -errno (EINTR은 0)
+     */
+    int submit(unsigned wait_nr = 0);
+
+    // 쌓인 완료를 차례로 fn(const io_uring_cqe&)에 넘기고 처리한 수를 돌려줌
+    template <typename Fn>
+    unsigned for_each_cqe(Fn&& fn)
+    {
+        unsigned head = *cq_head_;
+        const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        unsigned processed = 0;
+        for (; head != tail; ++head, ++processed)
+        {
+            fn(cqes_[head & cq_mask_]);
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        return processed;
+    }
+
+    /**
+     * @brief 멀티샷 recv용 제공 버퍼를 커널에 넘김 (group 번호로 SQE에서 지정). 다음 submit()에 함께 제출됨
+     * @details 매핑된 버퍼 링(IORING_REGISTER_PBUF_RING)은 일부 커널에서 등록은 되지만 항상 ENOBUFS를 돌려주므로
+     *          IORING_OP_PROVIDE_BUFFERS를 씀. 성공 완료는 CQE를 만들지 않음(IOSQE_CQE_SKIP_SUCCESS)
+     */
+    void provide_buffers(uint16_t group, unsigned count, size_t buffer_size);
+    std::span<const uint8_t> provided_buffer(uint16_t buffer_id, size_t length) const;
+    // 다 읽은 버퍼를 커널에 돌려줌 (SQE 하나, 다음 submit()에 함께 제출)
+    void recycle_buffer(uint16_t buffer_id);
+
+    // provide_buffers()/recycle_buffer()가 실패했을 때만 오는 CQE의 user_data
+    constexpr static uint64_t PROVIDE_BUFFERS_USER_DATA = ~0ULL - 3;
+
+    // --- SQE 준비 ---
+    void prep_multishot_accept(int listen_fd, uint64_t user_data);
+    void prep_multishot_recv(int fd, uint16_t group, uint64_t user_data);
+    void prep_read(int fd, void* buffer, size_t length, uint64_t user_data);
+    void prep_cancel(uint64_t target_user_data, uint64_t user_data);
+
+    /**
+     * @brief header를 고정 버퍼에서, payload를 그 뒤에 이어서 보내는 연결된(IOSQE_IO_LINK) 두 요청을 제출하고 끝날 때까지 기다림
+     * @details 블로킹 소켓을 가정함. 두 요청 각각에 timeout짜리 IORING_OP_LINK_TIMEOUT을 걸어 목적지가 읽지 않아도 돌아옴.
+     *          payload가 일부만 나갔으면(신호, 시간 초과 중 진척) 오류 없이 보낸 양만 payload_sent에 남기고 나머지는 호출자가 보냄
+     * @return 헤더가 다 나가지 못했거나 payload가 하나도 나가지 못한 채 시간이 지나면 오류 (시간 초과는 timed_out)
+     */
+    asio::error_code send_frame(int fd, std::span<const uint8_t> header, std::span<const uint8_t> payload,
+                                std::chrono::milliseconds timeout, size_t& payload_sent);
+
+private:
+    void release();
+
+    int ring_fd_ = -1;
+
+    void* sq_ring_ = nullptr;
+    size_t sq_ring_size_ = 0;
+    void* cq_ring_ = nullptr;
+    size_t cq_ring_size_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned sqe_tail_ = 0;       // 아직 커널에 알리지 않은 SQE까지 포함한 꼬리
+
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    uint16_t buffer_group_ = 0;
+    uint8_t* buffers_ = nullptr;
+    size_t buffers_size_ = 0;
+    size_t buffer_size_ = 0;
+
+    uint8_t* fixed_region_ = nullptr;
+    __kernel_timespec send_deadline_{}; // send_frame()의 IORING_OP_LINK_TIMEOUT이 가리키는 시간
+};
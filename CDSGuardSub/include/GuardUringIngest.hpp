@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <vector>
+#include "GuardUring.hpp"
+#include "SendTransferQueue.hpp"
+
+/**
+ * @brief SendMode의 TCP 수신을 io_uring 하나로 처리하는 루프 (--io-uring)
+ *
+ * - 리스닝 소켓에 멀티샷 accept 하나, 연결마다 멀티샷 recv 하나를 걸어 두고 완료만 수확함.
+ *   커널이 제공 버퍼 중 하나를 골라 받으므로 읽기마다 시스템 콜을 하지 않음
+ * - 대기열 예산이 차면 그 연결의 recv를 취소하고, 예산이 풀리면(io_context 스레드의 콜백) eventfd로 루프를 깨워 다시 검
+ * - EOF가 오면 모은 데이터를 on_complete로 넘기고 연결을 닫음
+ */
+class GuardUringIngest {
+public:
+    // 받은 데이터 전체와 로그용 연결 정보. 빈 데이터도 넘김
+    using Completion = std::function<void(std::vector<uint8_t>&&, const std::string&)>;
+
+    GuardUringIngest(int listen_fd, SendTransferQueue& queue, Completion on_complete);
+    ~GuardUringIngest();
+
+    GuardUringIngest(const GuardUringIngest&) = delete;
+    GuardUringIngest& operator=(const GuardUringIngest&) = delete;
+
+    // 중단 요청까지 블로킹. 링을 만들지 못하면 std::system_error
+    void run(std::stop_token token);
+
+private:
+    struct Connection
+    {
+        int fd;
+        std::string source;
+        std::vector<uint8_t> buffer;
+        bool armed = false;   // 멀티샷 recv가 걸려 있음
+        bool paused = false;  // 예산을 기다리는 중
+    };
+
+    void on_accept(GuardUring& ring, const io_uring_cqe& cqe);
+    void on_recv(GuardUring& ring, uint64_t id, const io_uring_cqe& cqe);
+    void arm_recv(GuardUring& ring, uint64_t id, Connection& connection);
+    void resume_connections(GuardUring& ring);
+    void close_connection(uint64_t id);
+
+    constexpr static unsigned RING_ENTRIES = 256;
+    constexpr static uint16_t BUFFER_GROUP = 0;
+    constexpr static unsigned BUFFER_COUNT = 64;
+    constexpr static size_t BUFFER_SIZE = 64 * 1024;
+
+    const int listen_fd_;
+    SendTransferQueue& queue_;
+    const Completion on_complete_;
+    const int wake_fd_;
+
+    std::map<uint64_t, Connection> connections_;   // 루프 스레드만 접근
+    uint64_t next_connection_id_ = 1;
+    uint64_t wake_value_ = 0;
+
+    std::mutex resumed_mutex_;
+    std::vector<uint64_t> resumed_;   // 예산이 풀려 다시 읽을 연결
+};
@@ -1,5 +1,9 @@
 #pragma once
 
 #include <string>
+#include "GuardOptions.hpp"
 
-void run_recv_mode(const std::string &interface_name);
\ No newline at end of file
+/**
+ * @param interface_name 수신 인터페이스. 쉼표로 여러 개를 주면 본딩 모드 (예: enp0s8,enp0s9)
+ */
+void run_recv_mode(const std::string &interface_name, const GuardOptions &options);
\ No newline at end of file
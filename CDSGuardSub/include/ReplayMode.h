@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string>
+#include "GuardOptions.hpp"
+
+/**
+ * @brief --capture로 기록한 pcapng를 NIC 없이 GuardL2Receiver 또는 GuardL2Sender에 다시 넣음
+ * @param capture_path 재생할 pcapng 파일
+ * @param target "recv"면 캡처의 START/DATA/END를 수신자에 넣고, "send"면 캡처의 ACK를 송신자에 돌려줌
+ */
+void run_replay_mode(const std::string &capture_path, const std::string &target, const GuardOptions &options);
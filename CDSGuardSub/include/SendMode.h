@@ -1,5 +1,10 @@
 #pragma once
 
 #include <string>
+#include "GuardOptions.hpp"
 
-void run_send_mode(const std::string &interface_name, const std::string &dst_mac_str);
\ No newline at end of file
+/**
+ * @param interface_name 송신 인터페이스. 쉼표로 여러 개를 주면 본딩 모드 (예: enp0s8,enp0s9)
+ * @param dst_mac_str 인터페이스와 같은 순서의 목적지 MAC 목록
+ */
+void run_send_mode(const std::string &interface_name, const std::string &dst_mac_str, const GuardOptions &options);
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <condition_variable>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <vector>
+#include <asio.hpp>
+#include "GuardQos.hpp"
+
+/**
+ * @brief TCP로 받아 L2 전송을 기다리는 페이로드 하나
+ */
+struct SendTransfer
+{
+    std::vector<uint8_t> payload;
+    std::string source; // 로그용 연결 정보
+    GuardTrafficClass traffic_class = GuardTrafficClass::DOCUMENT;
+    size_t data_offset = 0;  // 게이트웨이 클래스 태그를 건너뛴 실제 데이터 시작
+    size_t sent_offset = 0;  // data() 중 이미 보낸 바이트 (--qos 조각 전송)
+    uint64_t transfer_id = 0;
+    bool opened = false;     // --dedup: 게이트웨이 암호문을 풀어 payload가 "주소 헤더 | 평문"이 된 상태
+
+    std::span<const uint8_t> data() const { return std::span<const uint8_t>(payload).subspan(data_offset); }
+};
+
+/**
+ * @brief SendMode의 수신 연결들(io_context 스레드)과 L2 전송 스레드 사이의 대기열
+ *
+ * - 수신 중인 바이트와 전송 대기/진행 중인 바이트의 합을 byte_budget으로 제한
+ * - 예산을 넘으면 연결은 읽기를 멈추고(커널 수신 버퍼가 차서 TCP 흐름 제어로 상대가 느려짐),
+ *   전송 스레드가 예산을 돌려주면 io_context 스레드에서 다시 읽기 시작
+ * - 전송할 것이 하나도 없는데 수신 중인 연결들만으로 예산이 찬 경우에는 풀어줄 쪽이 없으므로 멈추지 않음
+ * - 트래픽 클래스마다 따로 줄을 세움. INTERACTIVE는 항상 먼저(엄격 우선순위), DOCUMENT와 BULK는
+ *   꺼낼 때마다 3:1 가중 라운드 로빈으로 나눔. 조각 단위로 보내는 전송은 requeue()로 자기 클래스 맨 앞에 돌아감
+ */
+class SendTransferQueue {
+public:
+    SendTransferQueue(asio::io_context& ctx, size_t byte_budget);
+
+    // --- io_context 스레드에서 호출 ---
+    bool should_pause() const;
+    // 예산이 풀리면 resume을 io_context 스레드에서 호출
+    void wait_for_budget(std::function<void()> resume);
+    void add_ingress(size_t bytes);
+    void drop_ingress(size_t bytes); // 연결 오류로 버려진 수신 데이터
+    void push(SendTransfer&& transfer);
+
+    // --- 전송 스레드에서 호출 ---
+    // 대기열이 빌 때까지 블로킹. 중단 요청 시 std::nullopt
+    std::optional<SendTransfer> pop(std::stop_token token);
+    // 일부만 보낸 전송을 같은 클래스의 맨 앞으로 되돌림 (더 높은 클래스가 있으면 그쪽이 먼저 나감)
+    void requeue(SendTransfer&& transfer);
+    // pop()한 전송이 끝나 메모리를 돌려줌
+    void complete(size_t bytes);
+
+    size_t queued_transfers() const;
+    size_t budget_in_use() const;
+
+private:
+    void wake_waiters_locked();
+    size_t select_class_locked();
+
+    // DOCUMENT:BULK 가중치 (꺼내는 횟수 기준, INTERACTIVE는 몫과 무관하게 먼저 나감)
+    constexpr static std::array<size_t, GUARD_TRAFFIC_CLASS_COUNT> CLASS_WEIGHTS = {1, 3, 1};
+
+    asio::io_context& ctx_;
+    const size_t byte_budget_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable_any queue_cv_;
+    std::array<std::deque<SendTransfer>, GUARD_TRAFFIC_CLASS_COUNT> queues_;
+    std::array<size_t, GUARD_TRAFFIC_CLASS_COUNT> credits_ = CLASS_WEIGHTS; // 이번 라운드에 남은 몫
+    size_t ingress_bytes_ = 0;  // 연결에서 읽는 중인 바이트
+    size_t pending_bytes_ = 0;  // 대기열에 있거나 전송 중인 바이트
+    std::vector<std::function<void()>> waiters_;
+};
@@ -10,6 +10,7 @@
 #include <unistd.h>
 #include <sstream>
 #include <system_error>
+#include <vector>
 
 inline std::array<uint8_t, 6> get_mac_address(std::string_view _interface_name)
 {
@@ -59,4 +60,22 @@ inline std::array<uint8_t, 6> mac_str_to_bytes(const std::string &mac_str) {
     }
 
     return mac_bytes;
+}
+
+// "enp0s8,enp0s9" 처럼 쉼표로 구분된 목록을 분리 (본딩 모드의 인터페이스/MAC 목록)
+inline std::vector<std::string> split_comma_list(const std::string &list_str)
+{
+    std::vector<std::string> items;
+    std::istringstream iss(list_str);
+    std::string item;
+
+    while (std::getline(iss, item, ','))
+    {
+        if (!item.empty())
+        {
+            items.push_back(item);
+        }
+    }
+
+    return items;
 }
\ No newline at end of file
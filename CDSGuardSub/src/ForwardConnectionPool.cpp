@@ -0,0 +1,326 @@
+#include "ForwardConnectionPool.hpp"
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <cerrno>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <vector>
+
+constexpr static unsigned URING_ENTRIES = 8;
+
+ForwardConnectionPool::ForwardConnectionPool(asio::io_context &ctx, ForwardPoolConfig config)
+    : ctx_(ctx), config_(config)
+{
+    if (config_.use_io_uring)
+    {
+        if (GuardUring::supported())
+        {
+            uring_ = std::make_unique<GuardUring>(URING_ENTRIES);
+            std::cout << "[FORWARD-POOL] Egress backend: io_uring (linked header + payload send).\n";
+        }
+        else
+        {
+            std::cerr << "[FORWARD-POOL] io_uring is not available on this kernel. Falling back to asio.\n";
+        }
+    }
+}
+
+asio::error_code ForwardConnectionPool::send(const asio::ip::tcp::endpoint &endpoint, std::span<const uint8_t> payload)
+{
+    // 유휴 연결이 있으면 먼저 사용. 상대가 그 사이 닫았을 수 있으므로 실패 시 새 연결로 재시도
+    if (std::optional<asio::ip::tcp::socket> reused = take_idle(endpoint))
+    {
+        asio::error_code ec = write_frame(*reused, payload);
+        if (!ec)
+        {
+            release(endpoint, std::move(*reused));
+            return ec;
+        }
+        if (ec == asio::error::timed_out)
+        {
+            // 연결은 살아있는데 읽지 않는 목적지. 새 연결도 같은 시간만큼 기다리게 되므로 바로 백오프
+            back_off(endpoint, ec, "Write to");
+            return ec;
+        }
+        std::cerr << "[FORWARD-POOL] Pooled connection to " << endpoint << " failed (" << ec.message() << "). Reconnecting.\n";
+    }
+
+    asio::ip::tcp::socket socket(ctx_);
+    asio::error_code ec = connect(endpoint, socket);
+    if (ec)
+    {
+        return ec;
+    }
+
+    ec = write_frame(socket, payload);
+    if (!ec)
+    {
+        release(endpoint, std::move(socket));
+    }
+    else if (ec == asio::error::timed_out)
+    {
+        back_off(endpoint, ec, "Write to");
+    }
+    return ec;
+}
+
+size_t ForwardConnectionPool::idle_connections() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto &[endpoint, destination] : destinations_)
+    {
+        count += destination.idle.size();
+    }
+    return count;
+}
+
+std::optional<asio::ip::tcp::socket> ForwardConnectionPool::take_idle(const asio::ip::tcp::endpoint &endpoint)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = destinations_.find(endpoint);
+    if (it == destinations_.end())
+    {
+        return std::nullopt;
+    }
+
+    // 가장 최근에 쓴 연결부터 확인 (오래된 연결일수록 상대가 닫았을 가능성이 큼)
+    auto &idle = it->second.idle;
+    const Clock::time_point now = Clock::now();
+    while (!idle.empty())
+    {
+        IdleConnection connection = std::move(idle.back());
+        idle.pop_back();
+
+        if (now - connection.idle_since < config_.idle_timeout && is_healthy(connection.socket))
+        {
+            return std::move(connection.socket);
+        }
+        asio::error_code ignored;
+        connection.socket.close(ignored);
+    }
+    return std::nullopt;
+}
+
+asio::error_code ForwardConnectionPool::connect(const asio::ip::tcp::endpoint &endpoint, asio::ip::tcp::socket &socket)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Destination &destination = destinations_[endpoint];
+        if (Clock::now() < destination.next_attempt)
+        {
+            return asio::error::connection_refused;
+        }
+    }
+
+    asio::error_code ec = connect_with_timeout(socket, endpoint, config_.connect_timeout);
+    if (!ec)
+    {
+        // 작은 메시지가 Nagle에 묶여 지연되지 않도록
+        socket.set_option(asio::ip::tcp::no_delay(true), ec);
+        socket.set_option(asio::socket_base::keep_alive(true), ec);
+        ec.clear();
+    }
+
+    if (ec)
+    {
+        back_off(endpoint, ec, "Cannot connect to");
+    }
+    return ec;
+}
+
+void ForwardConnectionPool::back_off(const asio::ip::tcp::endpoint &endpoint, const asio::error_code &ec, const char *what)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Destination &destination = destinations_[endpoint];
+    destination.backoff = destination.backoff.count() == 0
+        ? config_.reconnect_backoff_initial
+        : std::min(destination.backoff * 2, config_.reconnect_backoff_max);
+    destination.next_attempt = Clock::now() + destination.backoff;
+    std::cerr << "[FORWARD-POOL] " << what << " " << endpoint << ": " << ec.message()
+              << ". Retrying after " << destination.backoff.count() << "ms.\n";
+}
+
+asio::error_code ForwardConnectionPool::connect_with_timeout(asio::ip::tcp::socket &socket, const asio::ip::tcp::endpoint &endpoint,
+                                                             std::chrono::milliseconds timeout)
+{
+    asio::error_code ec;
+    if (!socket.is_open())
+    {
+        socket.open(endpoint.protocol(), ec);
+        if (ec)
+        {
+            return ec;
+        }
+    }
+
+    // asio의 동기 connect는 비차단 소켓에서도 끝까지 기다리므로 connect/poll을 직접 부름
+    socket.native_non_blocking(true, ec);
+    if (!ec && ::connect(socket.native_handle(), endpoint.data(), static_cast<socklen_t>(endpoint.size())) != 0)
+    {
+        if (errno != EINPROGRESS)
+        {
+            ec = asio::error_code(errno, asio::error::get_system_category());
+        }
+        else
+        {
+            pollfd pfd{socket.native_handle(), POLLOUT, 0};
+            int ready;
+            do
+            {
+                ready = ::poll(&pfd, 1, static_cast<int>(timeout.count()));
+            } while (ready < 0 && errno == EINTR);
+
+            int error = 0;
+            socklen_t len = sizeof(error);
+            if (ready == 0)
+            {
+                error = ETIMEDOUT;
+            }
+            else if (ready < 0)
+            {
+                error = errno;
+            }
+            else if (::getsockopt(socket.native_handle(), SOL_SOCKET, SO_ERROR, &error, &len) != 0)
+            {
+                error = errno;
+            }
+            if (error != 0)
+            {
+                ec = asio::error_code(error, asio::error::get_system_category());
+            }
+        }
+    }
+    if (!ec)
+    {
+        socket.native_non_blocking(false, ec);
+    }
+
+    if (ec)
+    {
+        asio::error_code ignored;
+        socket.close(ignored);
+    }
+    return ec;
+}
+
+asio::error_code ForwardConnectionPool::write_with_timeout(asio::ip::tcp::socket &socket, std::span<const asio::const_buffer> buffers,
+                                                           std::chrono::milliseconds timeout)
+{
+    std::vector<iovec> iov;
+    iov.reserve(buffers.size());
+    for (const asio::const_buffer &buffer : buffers)
+    {
+        if (buffer.size() > 0)
+        {
+            iov.push_back({const_cast<void *>(buffer.data()), buffer.size()});
+        }
+    }
+
+    // asio::write는 블로킹 소켓에서 보낼 수 없으면 제한 없이 기다리므로 sendmsg/poll을 직접 부름
+    size_t first = 0;
+    while (first < iov.size())
+    {
+        msghdr msg{};
+        msg.msg_iov = iov.data() + first;
+        msg.msg_iovlen = iov.size() - first;
+        ssize_t n = ::sendmsg(socket.native_handle(), &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                return asio::error_code(errno, asio::error::get_system_category());
+            }
+
+            pollfd pfd{socket.native_handle(), POLLOUT, 0};
+            int ready;
+            do
+            {
+                ready = ::poll(&pfd, 1, static_cast<int>(timeout.count()));
+            } while (ready < 0 && errno == EINTR);
+            if (ready == 0)
+            {
+                return asio::error::timed_out;
+            }
+            if (ready < 0)
+            {
+                return asio::error_code(errno, asio::error::get_system_category());
+            }
+            continue; // POLLERR/POLLHUP이면 다음 sendmsg가 오류를 돌려줌
+        }
+
+        // 나간 만큼 iovec을 앞으로 당김
+        size_t sent = static_cast<size_t>(n);
+        while (first < iov.size() && sent >= iov[first].iov_len)
+        {
+            sent -= iov[first].iov_len;
+            ++first;
+        }
+        if (first < iov.size())
+        {
+            iov[first].iov_base = static_cast<uint8_t *>(iov[first].iov_base) + sent;
+            iov[first].iov_len -= sent;
+        }
+    }
+    return {};
+}
+
+void ForwardConnectionPool::release(const asio::ip::tcp::endpoint &endpoint, asio::ip::tcp::socket &&socket)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Destination &destination = destinations_[endpoint];
+    // 연결만 받고 읽지 않는 목적지도 있으므로 백오프는 연결이 아니라 쓰기가 성공했을 때 초기화
+    destination.backoff = std::chrono::milliseconds{0};
+    auto &idle = destination.idle;
+    if (idle.size() >= config_.max_idle_per_destination)
+    {
+        asio::error_code ignored;
+        socket.close(ignored);
+        return;
+    }
+    idle.push_back({std::move(socket), Clock::now()});
+}
+
+bool ForwardConnectionPool::is_healthy(asio::ip::tcp::socket &socket)
+{
+    // 목적지는 응답을 보내지 않으므로 읽을 것이 있으면 FIN(0) 또는 예상치 못한 데이터
+    std::array<uint8_t, 1> probe;
+    ssize_t n = ::recv(socket.native_handle(), probe.data(), probe.size(), MSG_PEEK | MSG_DONTWAIT);
+    return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+asio::error_code ForwardConnectionPool::write_frame(asio::ip::tcp::socket &socket, std::span<const uint8_t> payload)
+{
+    std::array<uint8_t, FRAME_HEADER_SIZE> header;
+    uint64_t length = payload.size();
+    for (size_t i = 0; i < FRAME_HEADER_SIZE; ++i)
+    {
+        header[FRAME_HEADER_SIZE - 1 - i] = static_cast<uint8_t>(length >> (8 * i));
+    }
+
+    if (uring_)
+    {
+        size_t payload_sent = 0;
+        asio::error_code ec;
+        {
+            std::lock_guard<std::mutex> lock(uring_mutex_);
+            ec = uring_->send_frame(socket.native_handle(), header, payload, config_.write_timeout, payload_sent);
+        }
+        if (ec || payload_sent == payload.size())
+        {
+            return ec;
+        }
+        // 일부만 나갔으면 나머지는 같은 시간 제한으로 직접 보냄
+        const std::array<asio::const_buffer, 1> rest{asio::buffer(payload.data() + payload_sent, payload.size() - payload_sent)};
+        return write_with_timeout(socket, rest, config_.write_timeout);
+    }
+
+    const std::array<asio::const_buffer, 2> buffers{asio::buffer(header), asio::buffer(payload.data(), payload.size())};
+    return write_with_timeout(socket, buffers, config_.write_timeout);
+}
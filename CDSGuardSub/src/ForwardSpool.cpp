@@ -0,0 +1,471 @@
+#include "ForwardSpool.hpp"
+#include "GuardL2.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// 스풀 레코드 헤더. 바로 뒤에 length 바이트의 페이로드가 오고, 다음 레코드는 8바이트 경계에서 시작
+struct ForwardSpoolRecordHeader
+{
+    std::array<char, 4> magic;
+    uint32_t crc32;            // ip_ver부터 페이로드 끝까지 (delivered 제외)
+    uint8_t delivered;         // 전달 후 제자리에서 1로 바꿈
+    uint8_t ip_ver;            // 4 / 6
+    std::array<uint8_t, 16> ip;
+    uint16_t port;
+    uint64_t length;
+} __attribute__((packed));
+
+constexpr static std::array<char, 4> SPOOL_RECORD_MAGIC = {'G', 'F', 'S', '1'};
+constexpr static size_t SPOOL_RECORD_CRC_OFFSET = offsetof(ForwardSpoolRecordHeader, ip_ver);
+
+static uint64_t spool_record_size(uint64_t payload_length)
+{
+    return (sizeof(ForwardSpoolRecordHeader) + payload_length + 7) & ~uint64_t{7};
+}
+
+static uint32_t spool_record_crc(const ForwardSpoolRecordHeader *header)
+{
+    const auto *bytes = reinterpret_cast<const uint8_t *>(header);
+    uint32_t crc = guard_l2_crc32({bytes + SPOOL_RECORD_CRC_OFFSET, sizeof(ForwardSpoolRecordHeader) - SPOOL_RECORD_CRC_OFFSET});
+    return guard_l2_crc32({bytes + sizeof(ForwardSpoolRecordHeader), static_cast<size_t>(header->length)}, crc);
+}
+
+static std::filesystem::path spool_segment_path(const std::filesystem::path &dir, uint64_t id)
+{
+    std::ostringstream name;
+    name << "segment_" << std::setw(20) << std::setfill('0') << id << ".spool";
+    return dir / name.str();
+}
+
+ForwardSpool::ForwardSpool(ForwardSpoolConfig config)
+    : config_(std::move(config))
+{
+    std::filesystem::create_directories(config_.dir);
+    recover();
+}
+
+ForwardSpool::~ForwardSpool()
+{
+    seal_active();
+    for (auto &[id, segment] : segments_)
+    {
+        if (segment.dirty && config_.sync != ForwardSpoolSync::NONE)
+        {
+            msync(segment.base, segment.used, MS_SYNC);
+        }
+        munmap(segment.base, segment.capacity);
+    }
+}
+
+void ForwardSpool::recover()
+{
+    std::vector<std::pair<uint64_t, std::filesystem::path>> found;
+    for (const auto &entry : std::filesystem::directory_iterator(config_.dir))
+    {
+        const std::string name = entry.path().filename().string();
+        if (entry.is_regular_file() && name.starts_with("segment_") && name.ends_with(".spool"))
+        {
+            try
+            {
+                found.emplace_back(std::stoull(name.substr(8, name.size() - 8 - 6)), entry.path());
+            }
+            catch (const std::exception &)
+            {
+                // 이름 형식이 다른 파일은 건드리지 않음
+            }
+        }
+    }
+    std::sort(found.begin(), found.end());
+
+    for (const auto &[id, path] : found)
+    {
+        next_segment_id_ = id + 1;
+
+        int fd = open(path.c_str(), O_RDWR);
+        struct stat st{};
+        if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+            std::filesystem::remove(path);
+            continue;
+        }
+
+        const uint64_t file_size = static_cast<uint64_t>(st.st_size);
+        void *mapping = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            std::cerr << "[FORWARD-SPOOL] Cannot map " << path << ": " << std::strerror(errno) << ". Left untouched.\n";
+            close(fd);
+            continue;
+        }
+
+        Segment segment;
+        segment.path = path;
+        segment.base = static_cast<uint8_t *>(mapping);
+        segment.capacity = file_size;
+        segment.file_size = file_size;
+
+        // 유효한 레코드가 끝나는 곳(미리 확보한 0 영역 또는 기록 중 잘린 레코드)까지 읽음
+        uint64_t offset = 0;
+        std::vector<std::pair<asio::ip::tcp::endpoint, uint64_t>> records;
+        while (offset + sizeof(ForwardSpoolRecordHeader) <= file_size)
+        {
+            auto *header = reinterpret_cast<ForwardSpoolRecordHeader *>(segment.base + offset);
+            if (header->magic != SPOOL_RECORD_MAGIC ||
+                header->length > file_size - offset - sizeof(ForwardSpoolRecordHeader) ||
+                (header->ip_ver != 4 && header->ip_ver != 6) ||
+                header->crc32 != spool_record_crc(header))
+            {
+                break;
+            }
+
+            if (!header->delivered)
+            {
+                asio::ip::address address;
+                if (header->ip_ver == 4)
+                {
+                    address = asio::ip::address_v4({header->ip[0], header->ip[1], header->ip[2], header->ip[3]});
+                }
+                else
+                {
+                    address = asio::ip::address_v6(header->ip);
+                }
+                records.emplace_back(asio::ip::tcp::endpoint(address, header->port), offset);
+            }
+            offset += spool_record_size(header->length);
+        }
+        segment.used = std::min(offset, file_size);
+
+        if (records.empty())
+        {
+            munmap(segment.base, segment.capacity);
+            close(fd);
+            std::filesystem::remove(path);
+            continue;
+        }
+
+        // 크래시로 남은 미사용 예약 공간은 돌려줌. 복구한 세그먼트에는 더 이어 붙이지 않음
+        if (segment.used < file_size && ftruncate(fd, static_cast<off_t>(segment.used)) == 0)
+        {
+            segment.file_size = segment.used;
+        }
+        close(fd);
+
+        segment.pending = records.size();
+        for (const auto &[endpoint, record_offset] : records)
+        {
+            destinations_[endpoint].records.push_back({id, record_offset});
+        }
+        pending_records_ += records.size();
+        bytes_in_use_ += segment.file_size;
+        segments_.emplace(id, std::move(segment));
+    }
+
+    if (pending_records_ > 0)
+    {
+        std::cout << "[FORWARD-SPOOL] Recovered " << pending_records_ << " undelivered payload(s) for "
+                  << destinations_.size() << " destination(s) from " << config_.dir << ".\n";
+    }
+}
+
+bool ForwardSpool::has_pending(const asio::ip::tcp::endpoint &endpoint) const
+{
+    auto it = destinations_.find(endpoint);
+    return it != destinations_.end() && !it->second.records.empty();
+}
+
+bool ForwardSpool::append(const asio::ip::tcp::endpoint &endpoint, std::span<const uint8_t> payload)
+{
+    const uint64_t need = spool_record_size(payload.size());
+
+    if (!active_id_ || segments_.at(*active_id_).used + need > segments_.at(*active_id_).capacity)
+    {
+        seal_active();
+
+        const uint64_t remaining = config_.max_bytes > bytes_in_use_ ? config_.max_bytes - bytes_in_use_ : 0;
+        if (need > remaining)
+        {
+            std::cerr << "[FORWARD-SPOOL] Spool limit reached (" << bytes_in_use_ << " of " << config_.max_bytes << " bytes in use).\n";
+            return false;
+        }
+        if (!open_segment(std::max(need, std::min(config_.segment_size, remaining))))
+        {
+            return false;
+        }
+    }
+
+    Segment &segment = segments_.at(*active_id_);
+    const uint64_t offset = segment.used;
+    auto *header = reinterpret_cast<ForwardSpoolRecordHeader *>(segment.base + offset);
+
+    if (!payload.empty())
+    {
+        std::memcpy(segment.base + offset + sizeof(ForwardSpoolRecordHeader), payload.data(), payload.size());
+    }
+    header->delivered = 0;
+    header->ip_ver = endpoint.address().is_v4() ? 4 : 6;
+    header->ip = {};
+    if (header->ip_ver == 4)
+    {
+        auto bytes = endpoint.address().to_v4().to_bytes();
+        std::copy(bytes.begin(), bytes.end(), header->ip.begin());
+    }
+    else
+    {
+        auto bytes = endpoint.address().to_v6().to_bytes();
+        std::copy(bytes.begin(), bytes.end(), header->ip.begin());
+    }
+    header->port = endpoint.port();
+    header->length = payload.size();
+    header->crc32 = spool_record_crc(header);
+    header->magic = SPOOL_RECORD_MAGIC;
+
+    segment.used += need;
+    segment.pending++;
+    segment.dirty = true;
+    pending_records_++;
+    Destination &destination = destinations_[endpoint];
+    if (destination.records.empty())
+    {
+        // 방금 전달에 실패한 목적지이므로 바로 재시도하지 않음
+        destination.backoff = config_.replay_backoff_initial;
+        destination.next_attempt = Clock::now() + destination.backoff;
+    }
+    destination.records.push_back({*active_id_, offset});
+
+    if (config_.sync == ForwardSpoolSync::ALWAYS)
+    {
+        sync_range(segment, offset, need);
+    }
+    return true;
+}
+
+size_t ForwardSpool::replay(const SendFn &send)
+{
+    size_t delivered = 0;
+    const Clock::time_point now = Clock::now();
+
+    for (auto it = destinations_.begin(); it != destinations_.end();)
+    {
+        const asio::ip::tcp::endpoint &endpoint = it->first;
+        Destination &destination = it->second;
+        if (now < destination.next_attempt)
+        {
+            ++it;
+            continue;
+        }
+
+        while (!destination.records.empty())
+        {
+            const RecordRef ref = destination.records.front();
+            const Segment &segment = segments_.at(ref.segment_id);
+            const auto *header = reinterpret_cast<const ForwardSpoolRecordHeader *>(segment.base + ref.offset);
+
+            asio::error_code ec = send(endpoint, {segment.base + ref.offset + sizeof(ForwardSpoolRecordHeader), static_cast<size_t>(header->length)});
+            if (ec)
+            {
+                destination.backoff = destination.backoff.count() == 0
+                    ? config_.replay_backoff_initial
+                    : std::min(destination.backoff * 2, config_.replay_backoff_max);
+                destination.next_attempt = Clock::now() + destination.backoff;
+                std::cerr << "[FORWARD-SPOOL] Replay to " << endpoint << " failed: " << ec.message() << ". "
+                          << destination.records.size() << " payload(s) waiting, retrying after " << destination.backoff.count() << "ms.\n";
+                break;
+            }
+
+            destination.records.pop_front();
+            destination.backoff = std::chrono::milliseconds{0};
+            mark_delivered(ref);
+            delivered++;
+        }
+
+        if (destination.records.empty())
+        {
+            std::cout << "[FORWARD-SPOOL] Destination " << endpoint << " recovered. Spooled payloads delivered.\n";
+            it = destinations_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return delivered;
+}
+
+void ForwardSpool::flush_if_due()
+{
+    if (config_.sync != ForwardSpoolSync::INTERVAL || Clock::now() - last_sync_ < config_.sync_interval)
+    {
+        return;
+    }
+
+    for (auto &[id, segment] : segments_)
+    {
+        if (segment.dirty)
+        {
+            msync(segment.base, segment.used, MS_SYNC);
+            segment.dirty = false;
+        }
+    }
+    last_sync_ = Clock::now();
+}
+
+std::optional<std::chrono::milliseconds> ForwardSpool::next_wakeup() const
+{
+    std::optional<Clock::time_point> wakeup;
+    for (const auto &[endpoint, destination] : destinations_)
+    {
+        if (!wakeup || destination.next_attempt < *wakeup)
+        {
+            wakeup = destination.next_attempt;
+        }
+    }
+
+    if (config_.sync == ForwardSpoolSync::INTERVAL)
+    {
+        for (const auto &[id, segment] : segments_)
+        {
+            if (segment.dirty)
+            {
+                wakeup = std::min(wakeup.value_or(Clock::time_point::max()), last_sync_ + config_.sync_interval);
+                break;
+            }
+        }
+    }
+
+    if (!wakeup)
+    {
+        return std::nullopt;
+    }
+    auto remaining = std::chrono::ceil<std::chrono::milliseconds>(*wakeup - Clock::now());
+    return std::max(remaining, std::chrono::milliseconds{0});
+}
+
+bool ForwardSpool::open_segment(uint64_t capacity)
+{
+    const uint64_t id = next_segment_id_++;
+    const std::filesystem::path path = spool_segment_path(config_.dir, id);
+
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0)
+    {
+        std::cerr << "[FORWARD-SPOOL] Cannot create " << path << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    int err = posix_fallocate(fd, 0, static_cast<off_t>(capacity));
+    void *mapping = err == 0 ? mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    if (mapping == MAP_FAILED)
+    {
+        std::cerr << "[FORWARD-SPOOL] Cannot reserve " << capacity << " bytes in " << path << ": "
+                  << std::strerror(err != 0 ? err : errno) << "\n";
+        close(fd);
+        std::filesystem::remove(path);
+        return false;
+    }
+
+    if (config_.sync == ForwardSpoolSync::ALWAYS)
+    {
+        // 새 파일의 디렉터리 항목까지 남겨야 크래시 후 복구 대상이 됨
+        int dir_fd = open(config_.dir.c_str(), O_RDONLY | O_DIRECTORY);
+        if (dir_fd >= 0)
+        {
+            fsync(dir_fd);
+            close(dir_fd);
+        }
+    }
+
+    Segment segment;
+    segment.path = path;
+    segment.base = static_cast<uint8_t *>(mapping);
+    segment.capacity = capacity;
+    segment.file_size = capacity;
+    segment.fd = fd;
+    segments_.emplace(id, std::move(segment));
+    bytes_in_use_ += capacity;
+    active_id_ = id;
+    return true;
+}
+
+void ForwardSpool::seal_active()
+{
+    if (!active_id_)
+    {
+        return;
+    }
+
+    const uint64_t id = *active_id_;
+    active_id_.reset();
+
+    Segment &segment = segments_.at(id);
+    if (segment.pending == 0)
+    {
+        release_segment(id);
+        return;
+    }
+
+    // 남은 예약 공간을 돌려줌. 매핑은 used 이후를 건드리지 않으므로 그대로 둠
+    if (ftruncate(segment.fd, static_cast<off_t>(segment.used)) == 0)
+    {
+        bytes_in_use_ -= segment.file_size - segment.used;
+        segment.file_size = segment.used;
+    }
+    close(segment.fd);
+    segment.fd = -1;
+}
+
+void ForwardSpool::mark_delivered(const RecordRef &ref)
+{
+    Segment &segment = segments_.at(ref.segment_id);
+    auto *header = reinterpret_cast<ForwardSpoolRecordHeader *>(segment.base + ref.offset);
+    header->delivered = 1;
+    segment.dirty = true;
+    if (config_.sync == ForwardSpoolSync::ALWAYS)
+    {
+        sync_range(segment, ref.offset, sizeof(ForwardSpoolRecordHeader));
+    }
+
+    pending_records_--;
+    if (--segment.pending == 0)
+    {
+        if (active_id_ == ref.segment_id)
+        {
+            active_id_.reset();
+        }
+        release_segment(ref.segment_id);
+    }
+}
+
+void ForwardSpool::release_segment(uint64_t id)
+{
+    Segment &segment = segments_.at(id);
+    munmap(segment.base, segment.capacity);
+    if (segment.fd >= 0)
+    {
+        close(segment.fd);
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(segment.path, ec);
+    bytes_in_use_ -= segment.file_size;
+    segments_.erase(id);
+}
+
+void ForwardSpool::sync_range(Segment &segment, uint64_t offset, uint64_t length)
+{
+    static const uint64_t page_size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    const uint64_t begin = offset & ~(page_size - 1);
+    msync(segment.base + begin, offset + length - begin, MS_SYNC);
+}
@@ -10,6 +10,10 @@
 #include <chrono>
 #include <stdexcept>
 #include <utility>
+#include <algorithm>
+#include <random>
+#include <fstream>
+#include <cstddef>
 
 static uint64_t htonll(uint64_t x)
 {
@@ -36,6 +40,31 @@ static uint64_t ntohll(uint64_t x)
 }
 
 constexpr static std::chrono::milliseconds PACKET_TIMEOUT(100); // 패킷 타임아웃 (0.5초)
+constexpr static uint32_t LINK_FAILOVER_THRESHOLD = 3; // 이 횟수만큼 연속 타임아웃이 나면 링크를 장애로 판단
+constexpr static std::chrono::seconds DATA_STALL_TIMEOUT(30); // 송신 윈도우가 이 시간 동안 전진하지 않으면 전송 실패 (수신자 세션 타임아웃과 동일)
+constexpr static std::chrono::hours RESUME_STATE_MAX_AGE(24); // 이보다 오래된 재개 보관 파일은 정리
+constexpr static size_t COMPLETED_SESSION_HISTORY = 16;
+constexpr static int RAW_SOCKET_RCVBUF = 8 * 1024 * 1024; // 수신 윈도우가 커졌을 때 버스트를 커널에서 흘리지 않도록
+
+std::atomic<size_t> GuardL2Receiver::active_sessions_{0};
+
+// receive_reliable_data() 호출 동안 진행 중인 세션을 전역 카운트에 반영
+struct GuardL2ActiveSessionCount
+{
+    std::atomic<size_t> &counter;
+    bool counted = false;
+
+    void set(bool active)
+    {
+        if (active != counted)
+        {
+            active ? counter.fetch_add(1, std::memory_order_relaxed) : counter.fetch_sub(1, std::memory_order_relaxed);
+            counted = active;
+        }
+    }
+
+    ~GuardL2ActiveSessionCount() { set(false); }
+};
 
 // 간단한 CRC32 구현
 constexpr uint32_t crc32_single(uint32_t i)
@@ -63,58 +92,218 @@ constexpr uint32_t compute_crc32(std::span<const uint8_t> data)
     return ~crc;
 }
 
+uint32_t guard_l2_crc32(std::span<const uint8_t> data, uint32_t previous)
+{
+    uint32_t crc = ~previous;
+    for (uint8_t b : data)
+        crc = (crc >> 8) ^ kCrcTable[(crc ^ b) & 0xFF];
+    return ~crc;
+}
+
+// 이 구현이 지원하는 기능
+constexpr static uint32_t LOCAL_CAPABILITIES = GUARD_L2_CAP_RESUME | GUARD_L2_CAP_COMPACT_DATA;
+
+// LEB128 부호 없는 varint (7비트씩, 상위 비트는 계속 여부)
+static size_t put_varint(uint8_t *out, uint32_t value)
+{
+    size_t n = 0;
+    while (value >= 0x80)
+    {
+        out[n++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(value);
+    return n;
+}
+
+static std::optional<uint32_t> get_varint(std::span<const uint8_t> in, size_t &pos)
+{
+    uint64_t value = 0;
+    for (int shift = 0; shift < 35 && pos < in.size(); shift += 7)
+    {
+        uint8_t b = in[pos++];
+        value |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80))
+        {
+            if (value > UINT32_MAX)
+                return std::nullopt;
+            return static_cast<uint32_t>(value);
+        }
+    }
+    return std::nullopt;
+}
+
+struct GuardL2CompactDataFrame
+{
+    uint16_t session_tag;
+    uint32_t seq_num;
+    std::span<const uint8_t> payload;
+};
+
+/**
+ * @brief Ethernet 헤더 뒤의 DATA_COMPACT 프레임을 해석하고 CRC를 검증
+ * @param frame Ethernet 패딩이 붙어 있을 수 있음
+ */
+static std::optional<GuardL2CompactDataFrame> parse_compact_data_frame(std::span<uint8_t> frame)
+{
+    if (frame.size() < sizeof(GuardL2CompactDataHeader))
+        return std::nullopt;
+
+    GuardL2CompactDataHeader *ch = (GuardL2CompactDataHeader *)frame.data();
+    size_t pos = sizeof(GuardL2CompactDataHeader);
+    auto seq_num = get_varint(frame, pos);
+    auto payload_len = get_varint(frame, pos);
+    if (!seq_num || !payload_len || frame.size() - pos < *payload_len)
+    {
+        GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "Malformed compact DATA frame. Dropped.\n");
+        return std::nullopt;
+    }
+
+    uint32_t received_crc = ntohl(ch->crc32);
+    ch->crc32 = 0;
+    uint32_t calculated_crc = compute_crc32(frame.first(pos + *payload_len));
+    ch->crc32 = htonl(received_crc);
+
+    if (received_crc != calculated_crc)
+    {
+        GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "CRC mismatch on compact DATA frame. Packet dropped.\n");
+        return std::nullopt;
+    }
+
+    return GuardL2CompactDataFrame{ntohs(ch->session_tag), *seq_num, frame.subspan(pos, *payload_len)};
+}
+
+bool guard_l2_refresh_frame_crc(std::span<uint8_t> frame)
+{
+    if (frame.size() < sizeof(GuardL2CompactDataHeader))
+        return false;
+
+    if (frame[0] == static_cast<uint8_t>(GuardL2Header::FrameType::DATA_COMPACT))
+    {
+        size_t pos = sizeof(GuardL2CompactDataHeader);
+        auto seq_num = get_varint(frame, pos);
+        auto payload_len = get_varint(frame, pos);
+        if (!seq_num || !payload_len || frame.size() - pos < *payload_len)
+            return false;
+
+        GuardL2CompactDataHeader *ch = (GuardL2CompactDataHeader *)frame.data();
+        ch->crc32 = 0;
+        ch->crc32 = htonl(compute_crc32(frame.first(pos + *payload_len)));
+        return true;
+    }
+
+    if (frame.size() < sizeof(GuardL2Header))
+        return false;
+
+    GuardL2Header *gh = (GuardL2Header *)frame.data();
+    const size_t covered = sizeof(GuardL2Header) + ntohs(gh->payload_length);
+    if (frame.size() < covered)
+        return false;
+
+    gh->crc32 = 0;
+    gh->crc32 = htonl(compute_crc32(frame.first(covered)));
+    return true;
+}
+
 GuardL2Sender::GuardL2Sender(const std::string &interface_name, const std::array<uint8_t, 6> &src_mac, const std::array<uint8_t, 6> &dst_mac)
-: interface_name_(interface_name), src_mac_(src_mac), dst_mac_(dst_mac)
+: GuardL2Sender(std::vector<GuardL2LinkConfig>{{interface_name, src_mac, dst_mac}})
 {
+}
+
+GuardL2Sender::GuardL2Sender(const std::vector<GuardL2LinkConfig> &links, bool enable_failover)
+: enable_failover_(enable_failover)
+{
+    if (links.empty())
+    {
+        throw std::invalid_argument("Sender: At least one link is required.");
+    }
+
     session_id_ = std::chrono::system_clock::now().time_since_epoch().count();
-    sock_fd_ = create_raw_socket(interface_name);
+    links_.reserve(links.size());
 
-    if (sock_fd_ < 0)
+    for (const auto &link_config : links)
     {
-        throw std::runtime_error("Sender: Failed to create raw socket.");
+        LinkState link;
+        link.config = link_config;
+        link.sock_fd = link_config.sock_fd >= 0 ? link_config.sock_fd : create_raw_socket(link_config.interface_name);
+
+        if (link.sock_fd < 0)
+        {
+            for (auto &opened : links_)
+            {
+                close(opened.sock_fd);
+            }
+            throw std::runtime_error("Sender: Failed to create raw socket on " + link_config.interface_name + ".");
+        }
+
+        links_.push_back(std::move(link));
     }
 
-    GUARD_L2_DEBUG_LOG("Raw socket created successfully.\n");
+    GUARD_L2_DEBUG_LOG("Raw socket created successfully. links: ", links_.size(), "\n");
 }
 
 GuardL2Sender::~GuardL2Sender()
 {
-    if (sock_fd_ >= 0)
+    listener_threads_.clear(); // 소켓을 닫기 전에 리스너 스레드를 먼저 join
+
+    for (auto &link : links_)
     {
-        close(sock_fd_);
-        GUARD_L2_DEBUG_LOG("Raw socket closed.\n");
+        if (link.sock_fd >= 0)
+        {
+            close(link.sock_fd);
+        }
     }
+    GUARD_L2_DEBUG_LOG("Raw socket closed.\n");
 }
 
-void GuardL2Sender::ack_listener_thread(std::stop_token token)
+void GuardL2Sender::set_latency_profile(const GuardL2LatencyProfile &profile)
 {
-    GUARD_L2_DEBUG_LOG("ACK listener thread started.\n");
-    std::array<uint8_t, 1518> recv_buffer;
-    uint64_t temp_total_data_size = 0;
+    latency_profile_ = profile;
+    for (const auto &link : links_)
+    {
+        guard_l2_enable_busy_poll(link.sock_fd, profile.busy_poll_usec);
+    }
+}
 
-    // 메인 스레드의 total_data_size_가 변경될 수 있으므로, 스레드 시작 시점의 값을 복사해서 사용
+void GuardL2Sender::set_capture(std::shared_ptr<GuardL2Capture> capture)
+{
+    capture_ = std::move(capture);
+    for (auto &link : links_)
     {
-        std::lock_guard<std::mutex> lock(buffer_mutex_);
-        temp_total_data_size = this->total_data_size_;
+        link.capture_interface = capture_ ? capture_->add_interface(link.config.interface_name) : 0;
     }
+}
+
+void GuardL2Sender::ack_listener_thread(std::stop_token token, size_t link_index)
+{
+    GUARD_L2_DEBUG_LOG("ACK listener thread started. link: ", link_index, "\n");
+    guard_l2_pin_current_thread(latency_profile_.ack_cpu);
+    std::array<uint8_t, 1518> recv_buffer;
+    const int sock_fd = links_[link_index].sock_fd;
+    const auto &local_mac = links_[link_index].config.local_mac;
 
     while (!token.stop_requested())
     {
         struct timeval timeout = {0, 200000};
         fd_set read_fds;
         FD_ZERO(&read_fds);
-        FD_SET(sock_fd_, &read_fds);
+        FD_SET(sock_fd, &read_fds);
 
-        if (select(sock_fd_ + 1, &read_fds, nullptr, nullptr, &timeout) > 0)
+        if (guard_l2_select_read(sock_fd, read_fds, timeout, latency_profile_.spin) > 0)
         {
-            ssize_t bytes = recv(sock_fd_, recv_buffer.data(), recv_buffer.size(), 0);
-            if (bytes < sizeof(ether_header) + sizeof(GuardL2Header))
+            ssize_t bytes = recv(sock_fd, recv_buffer.data(), recv_buffer.size(), 0);
+            if (bytes < static_cast<ssize_t>(sizeof(ether_header) + sizeof(GuardL2Header)))
                 continue;
 
             ether_header *eh = (ether_header *)recv_buffer.data();
-            if (std::memcmp(eh->ether_dhost, src_mac_.data(), 6) != 0 || ntohs(eh->ether_type) != ETHERTYPE_GUARDL2)
+            if (std::memcmp(eh->ether_dhost, local_mac.data(), 6) != 0 || ntohs(eh->ether_type) != ETHERTYPE_GUARDL2)
                 continue;
 
+            if (capture_)
+            {
+                capture_->record(links_[link_index].capture_interface, GuardL2CaptureDirection::INBOUND, std::span<const uint8_t>{recv_buffer.data(), static_cast<size_t>(bytes)});
+            }
+
             GuardL2Header *gh = (GuardL2Header *)(recv_buffer.data() + sizeof(ether_header));
             if (ntohl(gh->session_id) != session_id_ || gh->type != GuardL2Header::FrameType::ACK)
                 continue;
@@ -124,20 +313,51 @@ void GuardL2Sender::ack_listener_thread(std::stop_token token)
             // 수신 윈도우 크기 읽기
             uint16_t advertised_window = ntohs(gh->receive_window);
 
+            // START ACK 페이로드 (구버전 수신자는 보내지 않거나 앞쪽 필드만 보냄)
+            uint16_t ack_payload_len = ntohs(gh->payload_length);
+            if (ack_seq != 0 || bytes < static_cast<ssize_t>(sizeof(ether_header) + sizeof(GuardL2Header) + ack_payload_len))
+            {
+                ack_payload_len = 0;
+            }
+
             {
                 std::lock_guard<std::mutex> lock(buffer_mutex_);
+
+                if (ack_payload_len > 0)
+                {
+                    GuardL2StartAckPayload start_ack{};
+                    std::memcpy(&start_ack, recv_buffer.data() + sizeof(ether_header) + sizeof(GuardL2Header), std::min<size_t>(ack_payload_len, sizeof(start_ack)));
+
+                    if (ack_payload_len >= offsetof(GuardL2StartAckPayload, receiver_instance_id) + sizeof(uint32_t))
+                    {
+                        peer_instance_id_ = ntohl(start_ack.receiver_instance_id);
+                    }
+                    if (ack_payload_len >= offsetof(GuardL2StartAckPayload, resume_base) + sizeof(uint32_t))
+                    {
+                        peer_resume_base_ = ntohl(start_ack.resume_base);
+                    }
+                    if (ack_payload_len >= sizeof(GuardL2StartAckPayload))
+                    {
+                        peer_protocol_version_ = start_ack.protocol_version;
+                        peer_capabilities_ = ntohl(start_ack.capabilities);
+                        peer_session_tag_ = ntohs(start_ack.session_tag);
+                    }
+                }
                 if (send_buffer_.contains(ack_seq) && !send_buffer_[ack_seq].acked)
                 {
                     send_buffer_[ack_seq].acked = true;
-                    GUARD_L2_DEBUG_LOG("Received ACK for Seq:", ack_seq, "\n");
-                    
-                    // START(0)와 END(total_packets+1) ACK는 condition_variable을 깨우도록 명시적 처리
-                    uint32_t total_packets = (total_data_size_ + 1400 - 1) / 1400;
-                    
-                    auto now   = std::chrono::steady_clock::now();
-                    auto samp  = now - send_buffer_[ack_seq].time_sent;
-                    update_rtt(samp);                 // RTT 갱신
-                    on_ack_received(ack_seq, advertised_window);
+                    GUARD_L2_DEBUG_LOG("Received ACK for Seq:", ack_seq, " on link ", link_index, "\n");
+
+                    links_[link_index].consecutive_timeouts = 0;
+
+                    // RTT 샘플은 프레임을 마지막으로 보낸 링크가 이 링크일 때만 유효함 (failover 재전송 프레임 제외)
+                    if (send_buffer_[ack_seq].link_index == link_index)
+                    {
+                        auto now   = std::chrono::steady_clock::now();
+                        auto samp  = now - send_buffer_[ack_seq].time_sent;
+                        update_rtt(link_index, samp);     // RTT 갱신
+                    }
+                    on_ack_received(link_index, ack_seq, advertised_window);
 
                     ack_cv_.notify_all(); // 핸드셰이크 ACK는 CV를 깨움
                 }
@@ -148,35 +368,36 @@ void GuardL2Sender::ack_listener_thread(std::stop_token token)
     GUARD_L2_DEBUG_LOG("ACK listener thread stopping.\n");
 }
 
-void GuardL2Sender::update_rtt(std::chrono::steady_clock::duration sample_rtt)
+void GuardL2Sender::update_rtt(size_t link_index, std::chrono::steady_clock::duration sample_rtt)
 {
     using namespace std::chrono;
     const auto samp = duration_cast<microseconds>(sample_rtt);
 
     std::lock_guard lock(rtt_mutex_);
+    LinkState &link = links_[link_index];
 
-    if (srtt_.count() == 0) 
+    if (link.srtt.count() == 0) 
     {
-        srtt_   = samp;
-        rttvar_ = samp / 2;
+        link.srtt   = samp;
+        link.rttvar = samp / 2;
     }
     else 
     {
         // a = 1/8, b = 1/4
-        rttvar_ = microseconds((3 * rttvar_.count() + std::abs(srtt_.count() - samp.count())) / 4);
-        srtt_   = microseconds((7 * srtt_.count() + samp.count()) / 8);
+        link.rttvar = microseconds((3 * link.rttvar.count() + std::abs(link.srtt.count() - samp.count())) / 4);
+        link.srtt   = microseconds((7 * link.srtt.count() + samp.count()) / 8);
     }
 
-    auto new_rto = srtt_ + rttvar_ * 4;
+    auto new_rto = link.srtt + link.rttvar * 4;
     constexpr microseconds RTO_MIN = 200ms;
     constexpr microseconds RTO_MAX = 3000ms;
-    rto_ = std::clamp(new_rto, RTO_MIN, RTO_MAX);
+    link.rto = std::clamp(new_rto, RTO_MIN, RTO_MAX);
 }
 
-std::chrono::milliseconds GuardL2Sender::get_rto()
+std::chrono::milliseconds GuardL2Sender::get_rto(size_t link_index)
 {
     std::lock_guard lock(rtt_mutex_);
-    return std::chrono::duration_cast<std::chrono::milliseconds>(rto_);
+    return std::chrono::duration_cast<std::chrono::milliseconds>(links_[link_index].rto);
 }
 
 int GuardL2Sender::create_raw_socket(const std::string &if_name)
@@ -214,6 +435,37 @@ int GuardL2Sender::create_raw_socket(const std::string &if_name)
     return fd;
 }
 
+std::vector<uint8_t> GuardL2Sender::build_compact_data_frame(uint16_t session_tag, uint32_t seq_num, std::span<const uint8_t> payload)
+{
+    std::array<uint8_t, 10> varints;
+    size_t varint_size = put_varint(varints.data(), seq_num);
+    varint_size += put_varint(varints.data() + varint_size, static_cast<uint32_t>(payload.size()));
+
+    const size_t frame_size = sizeof(ether_header) + sizeof(GuardL2CompactDataHeader) + varint_size + payload.size();
+    std::vector<uint8_t> frame_buffer(frame_size);
+
+    // MAC 주소는 전송할 링크가 정해지는 send_raw_frame()에서 기록
+    ether_header *eh = (ether_header *)frame_buffer.data();
+    eh->ether_type = htons(ETHERTYPE_GUARDL2);
+
+    uint8_t *compact_header_ptr = frame_buffer.data() + sizeof(ether_header);
+    GuardL2CompactDataHeader *ch = (GuardL2CompactDataHeader *)compact_header_ptr;
+    ch->type = GuardL2Header::FrameType::DATA_COMPACT;
+    ch->session_tag = htons(session_tag);
+    ch->crc32 = 0;
+
+    std::memcpy(compact_header_ptr + sizeof(GuardL2CompactDataHeader), varints.data(), varint_size);
+    if (!payload.empty())
+    {
+        std::memcpy(compact_header_ptr + sizeof(GuardL2CompactDataHeader) + varint_size, payload.data(), payload.size());
+    }
+
+    uint32_t crc = compute_crc32(std::span<const uint8_t>{compact_header_ptr, frame_size - sizeof(ether_header)});
+    ch->crc32 = htonl(crc);
+
+    return frame_buffer;
+}
+
 std::vector<uint8_t> GuardL2Sender::build_frame(GuardL2Header::FrameType type, uint32_t seq_num, std::span<const uint8_t> payload)
 {
     size_t payload_size = payload.size();
@@ -224,9 +476,8 @@ std::vector<uint8_t> GuardL2Sender::build_frame(GuardL2Header::FrameType type, u
     uint8_t *guard_header_ptr = eth_header_ptr + sizeof(ether_header);
     uint8_t *payload_ptr = guard_header_ptr + sizeof(GuardL2Header);
 
+    // MAC 주소는 전송할 링크가 정해지는 send_raw_frame()에서 기록
     ether_header *eh = (ether_header *)eth_header_ptr;
-    std::memcpy(eh->ether_shost, src_mac_.data(), 6);
-    std::memcpy(eh->ether_dhost, dst_mac_.data(), 6);
     eh->ether_type = htons(ETHERTYPE_GUARDL2);
 
     if (!payload.empty())
@@ -249,16 +500,28 @@ std::vector<uint8_t> GuardL2Sender::build_frame(GuardL2Header::FrameType type, u
     return frame_buffer;
 }
 
-void GuardL2Sender::send_raw_frame(const std::vector<uint8_t> &frame_data)
+void GuardL2Sender::send_raw_frame(size_t link_index, std::vector<uint8_t> &frame_data)
 {
-    if (sock_fd_ < 0)
+    const LinkState &link = links_[link_index];
+    if (link.sock_fd < 0)
     {
         GUARD_L2_DEBUG_ERROR_LOG("[ERROR]", "Socket is not open. Cannot send frame.\n");
         return;
     }
 
+    // CRC는 GuardL2 헤더부터 계산되므로 Ethernet 헤더의 MAC은 링크에 맞게 자유롭게 바꿀 수 있음
+    ether_header *eh = (ether_header *)frame_data.data();
+    std::memcpy(eh->ether_shost, link.config.local_mac.data(), 6);
+    std::memcpy(eh->ether_dhost, link.config.peer_mac.data(), 6);
+
+    // 응답(ACK)을 받은 리스너 스레드가 먼저 기록하지 않도록 보내기 전에 기록
+    if (capture_)
+    {
+        capture_->record(link.capture_interface, GuardL2CaptureDirection::OUTBOUND, frame_data);
+    }
+
     // send() 시스템 콜을 사용하여 데이터 전송
-    ssize_t sent_bytes = send(sock_fd_, frame_data.data(), frame_data.size(), 0);
+    ssize_t sent_bytes = send(link.sock_fd, frame_data.data(), frame_data.size(), 0);
 
     if (sent_bytes < 0)
     {
@@ -270,9 +533,7 @@ void GuardL2Sender::send_raw_frame(const std::vector<uint8_t> &frame_data)
     }
 }
 
-// GuardL2.cpp 에 추가
-
-void GuardL2Sender::on_ack_received(uint32_t ack_seq, uint16_t advertised_window)
+void GuardL2Sender::on_ack_received(size_t link_index, uint32_t ack_seq, uint16_t advertised_window)
 {
     {
         std::lock_guard<std::mutex> lock(rwnd_mutex_);
@@ -280,6 +541,7 @@ void GuardL2Sender::on_ack_received(uint32_t ack_seq, uint16_t advertised_window
     }
 
     std::lock_guard<std::mutex> lock(cwnd_mutex_);
+    LinkState &link = links_[link_index];
 
     // START(0), END ACK는 윈도우 계산에 포함하지 않음
     if (ack_seq == 0 || ack_seq > (total_data_size_ + 1400 - 1) / 1400) 
@@ -287,36 +549,113 @@ void GuardL2Sender::on_ack_received(uint32_t ack_seq, uint16_t advertised_window
         return;
     }
 
-    if (cwnd_ < ssthresh_) 
+    if (link.cwnd < link.ssthresh) 
     {
         // 느린 시작 (Slow Start): cwnd를 지수적으로 증가
-        cwnd_ += 1.0;
-        GUARD_L2_DEBUG_LOG("Slow Start: cwnd increased to ", cwnd_, "\n");
+        link.cwnd += 1.0;
+        GUARD_L2_DEBUG_LOG("Slow Start: link ", link_index, " cwnd increased to ", link.cwnd, "\n");
     } 
     else
     {
         // 혼잡 회피 (Congestion Avoidance): cwnd를 선형적으로 증가
         // 매 RTT마다 약 1씩 증가하도록 구현
-        ack_count_++;
-        if (ack_count_ >= static_cast<uint32_t>(cwnd_)) 
+        link.ack_count++;
+        if (link.ack_count >= static_cast<uint32_t>(link.cwnd)) 
         {
-            cwnd_ += 1.0;
-            ack_count_ = 0;
-            GUARD_L2_DEBUG_LOG("Congestion Avoidance: cwnd increased to ", cwnd_, "\n");
+            link.cwnd += 1.0;
+            link.ack_count = 0;
+            GUARD_L2_DEBUG_LOG("Congestion Avoidance: link ", link_index, " cwnd increased to ", link.cwnd, "\n");
         }
     }
 }
 
-void GuardL2Sender::on_packet_loss() 
+void GuardL2Sender::on_packet_loss(size_t link_index) 
 {
     std::lock_guard<std::mutex> lock(cwnd_mutex_);
+    LinkState &link = links_[link_index];
     
-    // 타임아웃 발생 시
-    ssthresh_ = std::max(2u, static_cast<uint32_t>(cwnd_ / 2.0)); // ssthresh를 cwnd의 절반으로 줄임 (최소 2)
-    cwnd_ = 1.0;                                                 // cwnd를 1로 리셋 (느린 시작 재시작)
-    ack_count_ = 0;                                              // ack_count_ 리셋
+    // 타임아웃 발생 시 해당 링크의 윈도우만 줄임. 다른 링크의 혼잡 상태는 독립적
+    link.ssthresh = std::max(2u, static_cast<uint32_t>(link.cwnd / 2.0)); // ssthresh를 cwnd의 절반으로 줄임 (최소 2)
+    link.cwnd = 1.0;                                                       // cwnd를 1로 리셋 (느린 시작 재시작)
+    link.ack_count = 0;                                                    // ack_count 리셋
+
+    GUARD_L2_DEBUG_ERROR_LOG("[CONGESTION] Packet loss detected on link", link_index, ". ssthresh:", link.ssthresh, ", cwnd reset to:", link.cwnd, "\n");
+}
 
-    GUARD_L2_DEBUG_ERROR_LOG("[CONGESTION] Packet loss detected. ssthresh: ", ssthresh_, ", cwnd reset to: ", cwnd_, "\n");
+size_t GuardL2Sender::next_alive_link(size_t after) const
+{
+    for (size_t step = 1; step <= links_.size(); ++step)
+    {
+        size_t candidate = (after + step) % links_.size();
+        if (links_[candidate].alive)
+        {
+            return candidate;
+        }
+    }
+    return after;
+}
+
+size_t GuardL2Sender::pick_data_link(const std::vector<uint32_t> &in_flight)
+{
+    // cwnd 대비 전송 중인 프레임 비율이 가장 낮은 링크를 선택하여 링크 속도에 비례하게 분산
+    std::lock_guard<std::mutex> lock(cwnd_mutex_);
+
+    size_t best = 0;
+    double best_load = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < links_.size(); ++i)
+    {
+        if (!links_[i].alive)
+            continue;
+
+        double load = in_flight[i] / links_[i].cwnd;
+        if (load < best_load)
+        {
+            best_load = load;
+            best = i;
+        }
+    }
+    return best;
+}
+
+bool GuardL2Sender::mark_link_failed(size_t link_index)
+{
+    // buffer_mutex_를 잡은 상태에서 호출됨
+    size_t alive_count = std::count_if(links_.begin(), links_.end(), [](const LinkState &link) { return link.alive; });
+    if (!enable_failover_ || !links_[link_index].alive || alive_count <= 1)
+    {
+        return false;
+    }
+
+    links_[link_index].alive = false;
+    GUARD_L2_DEBUG_ERROR_LOG("[FAILOVER] Link", link_index, "(", links_[link_index].config.interface_name, ") removed from session.\n");
+    return true;
+}
+
+bool GuardL2Sender::send_control_frame(uint32_t seq)
+{
+    // START/END는 Stop-and-Wait. failover가 켜져 있으면 재시도마다 다음 살아있는 링크로 옮겨 전송
+    size_t link_index = next_alive_link(links_.size() - 1);
+
+    for (int i = 0; i < 5; ++i) // 5번 재시도
+    {
+        std::unique_lock<std::mutex> buffer_lock(buffer_mutex_);
+        SentPacketInfo &info = send_buffer_.at(seq);
+        info.link_index = link_index;
+        info.time_sent = std::chrono::steady_clock::now();
+        send_raw_frame(link_index, info.frame_data);
+
+        if (ack_cv_.wait_for(buffer_lock, get_rto(link_index), [&] { return send_buffer_.at(seq).acked; }))
+        {
+            return true;
+        }
+
+        GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "Timeout for control frame Seq:", seq, ". Retrying...\n");
+        if (enable_failover_)
+        {
+            link_index = next_alive_link(link_index);
+        }
+    }
+    return false;
 }
 
 bool GuardL2Sender::wait_for_ack(uint32_t expected_seq_num, uint32_t timeout_sec)
@@ -325,16 +664,18 @@ bool GuardL2Sender::wait_for_ack(uint32_t expected_seq_num, uint32_t timeout_sec
 
     fd_set read_fds;
     struct timeval timeout;
+    const int sock_fd = links_.front().sock_fd;
+    const auto &local_mac = links_.front().config.local_mac;
 
     while (true)
     {
         FD_ZERO(&read_fds);
-        FD_SET(sock_fd_, &read_fds);
+        FD_SET(sock_fd, &read_fds);
 
         timeout.tv_sec = timeout_sec;
         timeout.tv_usec = 0;
 
-        int ret = select(sock_fd_ + 1, &read_fds, nullptr, nullptr, &timeout);
+        int ret = guard_l2_select_read(sock_fd, read_fds, timeout, latency_profile_.spin);
 
         if (ret < 0)
         {
@@ -347,12 +688,12 @@ bool GuardL2Sender::wait_for_ack(uint32_t expected_seq_num, uint32_t timeout_sec
             return false;
         }
 
-        if (FD_ISSET(sock_fd_, &read_fds))
+        if (FD_ISSET(sock_fd, &read_fds))
         {
             std::array<uint8_t, 1518> recv_buffer; // Max Ethernet frame size
-            ssize_t bytes_received = recv(sock_fd_, recv_buffer.data(), recv_buffer.size(), 0);
+            ssize_t bytes_received = recv(sock_fd, recv_buffer.data(), recv_buffer.size(), 0);
 
-            if (bytes_received < sizeof(ether_header) + sizeof(GuardL2Header))
+            if (bytes_received < static_cast<ssize_t>(sizeof(ether_header) + sizeof(GuardL2Header)))
                 continue;
 
             ether_header *eh = (ether_header *)recv_buffer.data();
@@ -360,9 +701,14 @@ bool GuardL2Sender::wait_for_ack(uint32_t expected_seq_num, uint32_t timeout_sec
                 continue;
 
             // 우리에게 온 패킷이 맞는지 MAC 주소 확인
-            if (std::memcmp(eh->ether_dhost, src_mac_.data(), 6) != 0)
+            if (std::memcmp(eh->ether_dhost, local_mac.data(), 6) != 0)
                 continue;
 
+            if (capture_)
+            {
+                capture_->record(links_.front().capture_interface, GuardL2CaptureDirection::INBOUND, std::span<const uint8_t>{recv_buffer.data(), static_cast<size_t>(bytes_received)});
+            }
+
             GuardL2Header *gh = (GuardL2Header *)(recv_buffer.data() + sizeof(ether_header));
 
             if (ntohl(gh->session_id) != session_id_)
@@ -383,17 +729,51 @@ bool GuardL2Sender::wait_for_ack(uint32_t expected_seq_num, uint32_t timeout_sec
 
 constexpr static size_t INITIAL_WINDOW_SIZE = 64; // 초기 윈도우 크기 (예: 64 프레임)
 
+static uint32_t generate_session_id()
+{
+    uint32_t session_id = static_cast<uint32_t>(std::chrono::system_clock::now().time_since_epoch().count());
+    return session_id != 0 ? session_id : 1; // 0은 재개 토큰에서 "없음"을 뜻함
+}
+
 bool GuardL2Sender::send_reliable_data(std::span<const uint8_t> data)
 {
+    return send_reliable_data(data, GuardL2ResumeToken{});
+}
+
+bool GuardL2Sender::send_reliable_data(std::span<const uint8_t> data, const GuardL2ResumeToken &resume_from)
+{
+    guard_l2_pin_current_thread(latency_profile_.data_cpu);
     total_data_size_ = data.size();
+    peer_instance_id_ = 0;
+    peer_resume_base_ = 1;
+    peer_protocol_version_ = 1;
+    peer_capabilities_ = 0;
+    peer_session_tag_ = 0;
+
+    // 전체 CRC는 대용량에서 비용이 있으므로 재개 가능 모드에서만 계산
+    uint32_t data_crc32 = 0;
+    bool resuming = false;
+    if (resume_enabled_ || resume_from.valid())
+    {
+        data_crc32 = compute_crc32(data);
+        resuming = resume_from.valid() && resume_from.total_size == data.size() && resume_from.data_crc32 == data_crc32;
+    }
+
+    session_id_ = resuming ? resume_from.session_id : generate_session_id();
+    last_resume_token_ = (resume_enabled_ || resuming) ? GuardL2ResumeToken{session_id_, total_data_size_, data_crc32} : GuardL2ResumeToken{};
     
     // 이전에 남아있을 수 있는 버퍼를 정리
     send_buffer_.clear();
     {
         std::lock_guard<std::mutex> lock(cwnd_mutex_);
-        cwnd_ = 1.0;
-        ssthresh_ = INITIAL_WINDOW_SIZE; // 초기 ssthresh를 이전의 고정 윈도우 크기로 설정
-        ack_count_ = 0;
+        for (auto &link : links_)
+        {
+            link.cwnd = 1.0;
+            link.ssthresh = INITIAL_WINDOW_SIZE; // 초기 ssthresh를 이전의 고정 윈도우 크기로 설정
+            link.ack_count = 0;
+            link.consecutive_timeouts = 0;
+            link.alive = true;
+        }
     }
     
     {
@@ -401,56 +781,106 @@ bool GuardL2Sender::send_reliable_data(std::span<const uint8_t> data)
         rwnd_ = INITIAL_WINDOW_SIZE;
     }
     
-    // 0. ACK 리스너 jthread 시작
-    listener_thread_ = std::jthread(&GuardL2Sender::ack_listener_thread, this);
+    // 0. 링크별 ACK 리스너 jthread 시작
+    listener_threads_.clear();
+    for (size_t i = 0; i < links_.size(); ++i)
+    {
+        listener_threads_.emplace_back([this, i](std::stop_token token) { ack_listener_thread(token, i); });
+    }
+
+    auto stop_listeners = [this]
+    {
+        for (auto &listener : listener_threads_)
+        {
+            listener.request_stop();
+        }
+    };
     
     // --- 1. START 핸드셰이크 (Stop-and-Wait) ---
     uint32_t start_seq = 0;
-    // START 패킷은 페이로드가 없으므로 {} 또는 std::span<const uint8_t>{}를 전달
-    auto start_frame = build_frame(GuardL2Header::FrameType::START, start_seq, {});
+    // 재개 정보와 함께 프로토콜 버전/지원 기능을 알림. 이전 버전 수신자는 START 페이로드를 무시함
+    uint8_t start_flags = 0;
+    if (resuming)
+        start_flags |= GuardL2StartPayload::FLAG_RESUME;
+    if (last_resume_token_.valid())
+        start_flags |= GuardL2StartPayload::FLAG_RESUMABLE;
+
+    const uint32_t offered_capabilities = compact_data_enabled_ ? LOCAL_CAPABILITIES : (LOCAL_CAPABILITIES & ~GUARD_L2_CAP_COMPACT_DATA);
+    GuardL2StartPayload start_payload{start_flags, htonl(data_crc32), GUARD_L2_PROTOCOL_VERSION, htonl(offered_capabilities)};
+    auto start_frame = build_frame(GuardL2Header::FrameType::START, start_seq, std::span<const uint8_t>{(const uint8_t *)&start_payload, sizeof(start_payload)});
     {
         std::lock_guard<std::mutex> buffer_lock(buffer_mutex_);
         send_buffer_[start_seq] = {std::move(start_frame), std::chrono::steady_clock::now(), false};
     }
     
-    bool start_acked = false;
-    for (int i = 0; i < 5; ++i) // 5번 재시도
-    {
-        send_raw_frame(send_buffer_.at(start_seq).frame_data);
-        std::unique_lock<std::mutex> buffer_lock(buffer_mutex_);
-        if (ack_cv_.wait_for(buffer_lock, get_rto(), [&]
-        { return send_buffer_.at(start_seq).acked; }))
-        {
-            start_acked = true;
-            break;
-        }
-        
-        GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "Timeout for START ACK. Retrying...\n");
-    }
-    
-    if (!start_acked)
+    if (!send_control_frame(start_seq))
     {
         GUARD_L2_DEBUG_ERROR_LOG("[ERROR]", "START handshake failed.\n");
-        listener_thread_.request_stop(); // 스레드 중단 요청
+        stop_listeners(); // 스레드 중단 요청
         return false;
     }
     
     // --- 2. 데이터 전송 (Sliding Window) ---
-    uint32_t send_window_base = 1;
-    uint32_t next_seq_num = 1;
     const size_t max_payload_size = 1400;
     uint32_t total_packets = (total_data_size_ + max_payload_size - 1) / max_payload_size;
+
+    // 재개 시 수신자가 이미 가진 부분은 건너뜀
+    uint32_t resume_base = 1;
+    if (resuming)
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        resume_base = std::clamp(peer_resume_base_, 1u, total_packets + 1);
+        GUARD_L2_DEBUG_LOG("Resuming session ", session_id_, " from Seq: ", resume_base, "\n");
+    }
+
+    uint32_t send_window_base = resume_base;
+    uint32_t next_seq_num = resume_base;
+    auto last_progress = std::chrono::steady_clock::now();
+
+    // 수신자가 축약 DATA 프레임을 수락했으면 사용
+    bool use_compact_data = false;
+    uint16_t session_tag = 0;
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        use_compact_data = peer_protocol_version_ >= 2 && (peer_capabilities_ & GUARD_L2_CAP_COMPACT_DATA);
+        session_tag = peer_session_tag_;
+    }
+    GUARD_L2_DEBUG_LOG("Peer protocol version ", static_cast<int>(peer_protocol_version_), ", compact DATA: ", use_compact_data, "\n");
+
+    // 세션 동안 session_id_, total_data_size_는 바뀌지 않으므로 작업 스레드에서 프레임을 만들어도 안전
+    auto build_data_frame = [&, use_compact_data, session_tag](uint32_t seq)
+    {
+        size_t offset = (seq - 1) * max_payload_size;
+        size_t chunk_size = std::min(max_payload_size, data.size() - offset);
+        if (use_compact_data)
+        {
+            return build_compact_data_frame(session_tag, seq, data.subspan(offset, chunk_size));
+        }
+        return build_frame(GuardL2Header::FrameType::DATA, seq, data.subspan(offset, chunk_size));
+    };
+
+    std::optional<GuardL2FramePreparer> frame_preparer;
+    if (frame_workers_ > 0 && resume_base <= total_packets)
+    {
+        frame_preparer.emplace(resume_base, total_packets, frame_workers_, build_data_frame);
+    }
     
     // 모든 패킷이 ACK될 때까지 루프 실행
     while (send_window_base <= total_packets)
     {
         std::vector<std::pair<uint32_t, std::vector<uint8_t>>> frames_to_send;
         {
-            uint32_t current_cwnd;
+            uint32_t current_cwnd = 0;
             {
-                // cwnd_ 값을 읽어오기 위해 짧게 잠금
+                // 살아있는 링크들의 cwnd 합이 본딩 세션 전체의 혼잡 윈도우
                 std::lock_guard<std::mutex> cwnd_lock(cwnd_mutex_);
-                current_cwnd = static_cast<uint32_t>(cwnd_);
+                for (const auto &link : links_)
+                {
+                    if (link.alive)
+                    {
+                        current_cwnd += static_cast<uint32_t>(link.cwnd);
+                    }
+                }
             } // 여기서 cwnd_mutex_ 잠금 해제
             
             uint32_t current_rwnd;
@@ -469,9 +899,7 @@ bool GuardL2Sender::send_reliable_data(std::span<const uint8_t> data)
 
             for(uint32_t seq = next_seq_num; seq < send_window_base + effective_window && seq <= total_packets; ++seq)
             {
-                size_t offset = (seq - 1) * max_payload_size;
-                size_t chunk_size = std::min(max_payload_size, data.size() - offset);
-                frames_to_send.emplace_back(seq, build_frame(GuardL2Header::FrameType::DATA, seq, data.subspan(offset, chunk_size)));
+                frames_to_send.emplace_back(seq, frame_preparer ? frame_preparer->take(seq) : build_data_frame(seq));
             }
         }
 
@@ -479,14 +907,27 @@ bool GuardL2Sender::send_reliable_data(std::span<const uint8_t> data)
         {
             std::lock_guard<std::mutex> lock(buffer_mutex_);
 
-            for (const auto& pair : frames_to_send) 
+            // 링크별로 아직 ACK되지 않은 프레임 수를 세어 새 프레임을 배분
+            std::vector<uint32_t> in_flight(links_.size(), 0);
+            for (uint32_t i = send_window_base; i < next_seq_num; ++i)
+            {
+                auto it = send_buffer_.find(i);
+                if (it != send_buffer_.end() && !it->second.acked)
+                {
+                    in_flight[it->second.link_index]++;
+                }
+            }
+
+            for (auto& pair : frames_to_send) 
             {
                 const uint32_t seq = pair.first;
-                const auto& frame = pair.second;
+                const size_t link_index = pick_data_link(in_flight);
+                in_flight[link_index]++;
                 
-                send_buffer_[seq] = {frame, std::chrono::steady_clock::now(), false};
-                send_raw_frame(frame);
-                GUARD_L2_DEBUG_LOG("Sent DATA Seq:", seq, "\n");
+                SentPacketInfo &info = send_buffer_[seq];
+                info = {std::move(pair.second), std::chrono::steady_clock::now(), false, link_index};
+                send_raw_frame(link_index, info.frame_data);
+                GUARD_L2_DEBUG_LOG("Sent DATA Seq:", seq, " on link ", link_index, "\n");
 
                 if (seq >= next_seq_num) 
                 {
@@ -498,14 +939,20 @@ bool GuardL2Sender::send_reliable_data(std::span<const uint8_t> data)
         // 단계 B: 다음 이벤트(ACK 수신 or 타임아웃)까지 대기
         std::unique_lock<std::mutex> buffer_lock(buffer_mutex_);
 
-        // 가장 빠른 타임아웃 시간 계산
+        // 가장 빠른 타임아웃 시간 계산 (RTO는 프레임을 보낸 링크 기준)
+        std::vector<std::chrono::milliseconds> link_rto(links_.size());
+        for (size_t i = 0; i < links_.size(); ++i)
+        {
+            link_rto[i] = get_rto(i);
+        }
+
         auto next_timeout = std::chrono::steady_clock::time_point::max();
         bool is_waiting_for_ack = false;
         for (uint32_t i = send_window_base; i < next_seq_num; i++) 
         {
             if (send_buffer_.contains(i) && !send_buffer_[i].acked) 
             {
-                next_timeout = std::min(next_timeout, send_buffer_[i].time_sent + get_rto());
+                next_timeout = std::min(next_timeout, send_buffer_[i].time_sent + link_rto[send_buffer_[i].link_index]);
                 is_waiting_for_ack = true;
             }
         }
@@ -522,41 +969,74 @@ bool GuardL2Sender::send_reliable_data(std::span<const uint8_t> data)
         {
             // Zero window probe: 윈도우가 0일 때 상대방이 윈도우를 열어줄 때까지 대기
             GUARD_L2_DEBUG_LOG("Effective window is 0. Probing...\n");
-            ack_cv_.wait_for(buffer_lock, get_rto()); // RTO만큼 대기 후 다시 윈도우 체크
+            ack_cv_.wait_for(buffer_lock, link_rto.front()); // RTO만큼 대기 후 다시 윈도우 체크
         }
 
         // 단계 C: 전송된 패킷들의 타임아웃을 체크하고 필요 시 재전송
-        bool timeout_occurred = false;
         const auto now = std::chrono::steady_clock::now();
         std::vector<uint32_t> retransmit_seqs; // 재전송 목록
+        std::vector<bool> link_timed_out(links_.size(), false);
         for (uint32_t i = send_window_base; i < next_seq_num; ++i) 
         {
-            if (send_buffer_.count(i) && !send_buffer_.at(i).acked && now >= send_buffer_.at(i).time_sent + get_rto()) 
+            if (send_buffer_.count(i) && !send_buffer_.at(i).acked)
             {
-                retransmit_seqs.push_back(i);
-                timeout_occurred = true;
+                const size_t link_index = send_buffer_.at(i).link_index;
+                if (now >= send_buffer_.at(i).time_sent + link_rto[link_index])
+                {
+                    retransmit_seqs.push_back(i);
+                    link_timed_out[link_index] = true;
+                }
             }
         }
 
+        for (size_t link_index = 0; link_index < links_.size(); ++link_index)
+        {
+            if (!link_timed_out[link_index])
+                continue;
+
+            on_packet_loss(link_index); // 타임아웃 발생 시 해당 링크의 혼잡 감지 처리
+
+            if (++links_[link_index].consecutive_timeouts >= LINK_FAILOVER_THRESHOLD)
+            {
+                mark_link_failed(link_index);
+            }
+        }
 
-        if (timeout_occurred) 
+        for (uint32_t seq : retransmit_seqs) 
         {
-            on_packet_loss(); // 타임아웃 발생 시 혼잡 감지 처리
+            SentPacketInfo &info = send_buffer_.at(seq);
 
-            for (uint32_t seq : retransmit_seqs) 
+            // 장애로 제외된 링크에 남아있던 프레임은 살아있는 다른 링크로 옮겨 재전송
+            if (!links_[info.link_index].alive)
             {
-                 GUARD_L2_DEBUG_ERROR_LOG("[WARN] Timeout for DATA Seq: ", seq, ". Retransmitting...\n");
-                 send_raw_frame(send_buffer_.at(seq).frame_data);
-                 send_buffer_.at(seq).time_sent = std::chrono::steady_clock::now();
+                info.link_index = next_alive_link(info.link_index);
             }
+
+            GUARD_L2_DEBUG_ERROR_LOG("[WARN] Timeout for DATA Seq:", seq, ". Retransmitting on link", info.link_index, "...\n");
+            send_raw_frame(info.link_index, info.frame_data);
+            info.time_sent = std::chrono::steady_clock::now();
         }
 
         // 단계 D: ACK된 패킷들을 처리하며 윈도우를 앞으로 슬라이딩
+        const uint32_t previous_base = send_window_base;
         while (send_buffer_.count(send_window_base) && send_buffer_.at(send_window_base).acked) 
         {
             send_buffer_.erase(send_window_base);
             send_window_base++;
         }
+
+        // 링크가 끊겨 윈도우가 오래 멈춰 있으면 포기. 재개 가능 모드라면 resume_token()으로 이어 보낼 수 있음
+        if (send_window_base != previous_base)
+        {
+            last_progress = std::chrono::steady_clock::now();
+        }
+        else if (std::chrono::steady_clock::now() - last_progress > DATA_STALL_TIMEOUT)
+        {
+            GUARD_L2_DEBUG_ERROR_LOG("[ERROR]", "No progress for", DATA_STALL_TIMEOUT.count(), "seconds at Seq:", send_window_base, "\n");
+            buffer_lock.unlock();
+            stop_listeners();
+            return false;
+        }
     }
 
     // --- 3. END 핸드셰이크 (Stop-and-Wait) ---
@@ -567,49 +1047,86 @@ bool GuardL2Sender::send_reliable_data(std::span<const uint8_t> data)
         send_buffer_[end_seq] = {std::move(end_frame), std::chrono::steady_clock::now(), false};
     }
 
-    bool end_acked = false;
-    for (int i = 0; i < 5; ++i)
-    {
-        send_raw_frame(send_buffer_.at(end_seq).frame_data);
-        std::unique_lock<std::mutex> lock(buffer_mutex_);
-        if (ack_cv_.wait_for(lock, get_rto(), [&] { return send_buffer_.at(end_seq).acked; }))
-        {
-            end_acked = true;
-            break;
-        }
-        GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "Timeout for END ACK. Retrying...\n");
-    }
-
-    if (!end_acked)
+    if (!send_control_frame(end_seq))
     {
         GUARD_L2_DEBUG_ERROR_LOG("[ERROR]", "END handshake failed.\n");
-        listener_thread_.request_stop();
+        stop_listeners();
         return false;
     }
 
     GUARD_L2_DEBUG_LOG("Transfer completed successfully.\n");
-    listener_thread_.request_stop(); // ACK 리스너 스레드에 중단 요청
+    stop_listeners(); // ACK 리스너 스레드에 중단 요청
     return true;
 }
 
 GuardL2Receiver::GuardL2Receiver(const std::string &interface_name, const std::array<uint8_t, 6> &my_mac)
-    : interface_name_(interface_name), my_mac_(my_mac)
+    : GuardL2Receiver(std::vector<GuardL2LinkConfig>{{interface_name, my_mac, {}}})
 {
-    sock_fd_ = create_raw_socket(interface_name);
-    if (sock_fd_ < 0)
+}
+
+GuardL2Receiver::GuardL2Receiver(const std::vector<GuardL2LinkConfig> &links)
+{
+    // 0은 "알 수 없음"으로 쓰이므로 피함
+    std::random_device rd;
+    do
     {
-        throw std::runtime_error("Receiver: Failed to create raw socket.");
+        instance_id_ = rd();
+    } while (instance_id_ == 0);
+    next_session_tag_ = static_cast<uint16_t>(rd());
+
+    if (links.empty())
+    {
+        throw std::invalid_argument("Receiver: At least one link is required.");
     }
 
-    GUARD_L2_DEBUG_LOG("Raw socket created successfully for interface ", interface_name, ".\n");
+    links_.reserve(links.size());
+    for (const auto &link_config : links)
+    {
+        LinkState link;
+        link.config = link_config;
+        link.sock_fd = link_config.sock_fd >= 0 ? link_config.sock_fd : create_raw_socket(link_config.interface_name);
+
+        if (link.sock_fd < 0)
+        {
+            for (auto &opened : links_)
+            {
+                close(opened.sock_fd);
+            }
+            throw std::runtime_error("Receiver: Failed to create raw socket on " + link_config.interface_name + ".");
+        }
+
+        links_.push_back(std::move(link));
+        GUARD_L2_DEBUG_LOG("Raw socket created successfully for interface ", link_config.interface_name, ".\n");
+    }
 }
 
 GuardL2Receiver::~GuardL2Receiver()
 {
-    if (sock_fd_ >= 0)
+    for (auto &link : links_)
+    {
+        if (link.sock_fd >= 0)
+        {
+            close(link.sock_fd);
+        }
+    }
+    GUARD_L2_DEBUG_LOG("Raw socket closed.\n");
+}
+
+void GuardL2Receiver::set_latency_profile(const GuardL2LatencyProfile &profile)
+{
+    latency_profile_ = profile;
+    for (const auto &link : links_)
     {
-        close(sock_fd_);
-        GUARD_L2_DEBUG_LOG("Raw socket closed.\n");
+        guard_l2_enable_busy_poll(link.sock_fd, profile.busy_poll_usec);
+    }
+}
+
+void GuardL2Receiver::set_capture(std::shared_ptr<GuardL2Capture> capture)
+{
+    capture_ = std::move(capture);
+    for (auto &link : links_)
+    {
+        link.capture_interface = capture_ ? capture_->add_interface(link.config.interface_name) : 0;
     }
 }
 
@@ -645,16 +1162,23 @@ int GuardL2Receiver::create_raw_socket(const std::string &if_name)
         close(fd);
         return -1;
     }
+
+    // 관리자 권한이면 rmem_max 제한을 넘어 설정 (실패해도 동작에는 지장 없음)
+    if (setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, &RAW_SOCKET_RCVBUF, sizeof(RAW_SOCKET_RCVBUF)) < 0)
+    {
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &RAW_SOCKET_RCVBUF, sizeof(RAW_SOCKET_RCVBUF));
+    }
     return fd;
 }
 
-void GuardL2Receiver::send_ack(const std::array<uint8_t, 6> &dst_mac, uint32_t session_id, uint32_t seq_num)
+void GuardL2Receiver::send_ack(size_t link_index, const std::array<uint8_t, 6> &dst_mac, uint32_t session_id, uint32_t seq_num, std::span<const uint8_t> payload)
 {
-    const size_t frame_size = sizeof(ether_header) + sizeof(GuardL2Header);
+    const LinkState &link = links_[link_index];
+    const size_t frame_size = sizeof(ether_header) + sizeof(GuardL2Header) + payload.size();
     std::vector<uint8_t> frame_buffer(frame_size);
 
     ether_header *eh = (ether_header *)frame_buffer.data();
-    std::memcpy(eh->ether_shost, my_mac_.data(), 6);
+    std::memcpy(eh->ether_shost, link.config.local_mac.data(), 6);
     std::memcpy(eh->ether_dhost, dst_mac.data(), 6);
     eh->ether_type = htons(ETHERTYPE_GUARDL2);
 
@@ -663,18 +1187,28 @@ void GuardL2Receiver::send_ack(const std::array<uint8_t, 6> &dst_mac, uint32_t s
     gh->session_id = htonl(session_id);
     gh->sequence_number = htonl(seq_num);
     gh->total_size = 0;
-    gh->payload_length = 0;
+    gh->payload_length = htons(payload.size());
+
+    if (!payload.empty())
+    {
+        std::memcpy(frame_buffer.data() + sizeof(ether_header) + sizeof(GuardL2Header), payload.data(), payload.size());
+    }
 
     // 가용 윈도우 크기 계산
-    size_t used_buffer_slots = out_of_order_buffer_.size();
-    uint16_t available_window = (RECEIVER_WINDOW_CAPACITY > used_buffer_slots) ? (RECEIVER_WINDOW_CAPACITY - used_buffer_slots) : 0;
+    size_t used_buffer_slots = out_of_order_frames_;
+    uint16_t available_window = (receive_window_ > used_buffer_slots) ? (receive_window_ - used_buffer_slots) : 0;
     gh->receive_window = htons(available_window);
 
     gh->crc32 = 0; // CRC 계산 전 0으로 설정
-    uint32_t crc = compute_crc32(std::span<const uint8_t>{(uint8_t *)gh, sizeof(GuardL2Header)});
+    uint32_t crc = compute_crc32(std::span<const uint8_t>{(uint8_t *)gh, sizeof(GuardL2Header) + payload.size()});
     gh->crc32 = htonl(crc);
 
-    if (send(sock_fd_, frame_buffer.data(), frame_size, 0) < 0)
+    if (capture_)
+    {
+        capture_->record(link.capture_interface, GuardL2CaptureDirection::OUTBOUND, frame_buffer);
+    }
+
+    if (send(link.sock_fd, frame_buffer.data(), frame_size, 0) < 0)
     {
         GUARD_L2_DEBUG_ERROR_LOG("[ERROR]", "ACK send failed\n");
     }
@@ -684,11 +1218,90 @@ void GuardL2Receiver::send_ack(const std::array<uint8_t, 6> &dst_mac, uint32_t s
     }
 }
 
+uint32_t GuardL2Receiver::receive_window_limit() const
+{
+    // 윈도우만큼의 프레임이 소켓 버퍼와 재조립 저장소에 동시에 머물 수 있으므로 남은 메모리 예산을 진행 중인 세션끼리 나눔
+    const size_t budget = GuardL2ReassemblyStore::memory_budget();
+    const size_t in_use = GuardL2ReassemblyStore::memory_in_use();
+    const size_t free_bytes = budget > in_use ? budget - in_use : 0;
+    const size_t sessions = std::max<size_t>(active_sessions_.load(std::memory_order_relaxed), 1);
+
+    return static_cast<uint32_t>(std::clamp<size_t>(free_bytes / sessions / 1400, MIN_RECEIVE_WINDOW, MAX_RECEIVE_WINDOW));
+}
+
+void GuardL2Receiver::reset_receive_window()
+{
+    receive_window_ = std::min(INITIAL_RECEIVE_WINDOW, receive_window_limit());
+    advertised_edge_ = 1 + receive_window_;
+    rtt_probe_edge_ = 0;
+    receiver_rtt_ = {};
+    window_epoch_start_ = std::chrono::steady_clock::now();
+    window_epoch_delivered_ = 0;
+}
+
+void GuardL2Receiver::update_receive_window(uint32_t seq_num, uint32_t receive_window_base, uint32_t delivered)
+{
+    const auto now = std::chrono::steady_clock::now();
+    window_epoch_delivered_ += delivered;
+
+    // RTT 추정: 지금까지 광고한 윈도우 끝 이상의 프레임은 송신자가 측정 시작 이후의 ACK를 받아야만 보낼 수 있으므로
+    // 측정 시작부터 그 프레임이 도착할 때까지의 시간은 RTT의 상한
+    if (rtt_probe_edge_ != 0 && seq_num >= rtt_probe_edge_)
+    {
+        const auto sample = now - rtt_probe_time_;
+        receiver_rtt_ = (receiver_rtt_ == std::chrono::steady_clock::duration::zero()) ? sample : (receiver_rtt_ * 7 + sample) / 8;
+        rtt_probe_edge_ = 0;
+    }
+
+    // RTT마다 그동안 순서대로 빠져나간 양의 두 배를 목표로 함. 송신자가 윈도우에 막혀 있으면 RTT마다 두 배가 되고,
+    // 혼잡 윈도우나 링크 속도에 막혀 있으면 그 두 배에서 멈춤
+    const uint32_t limit = receive_window_limit();
+    if (receiver_rtt_ > std::chrono::steady_clock::duration::zero() && now - window_epoch_start_ >= receiver_rtt_)
+    {
+        if (window_epoch_delivered_ * 2 > receive_window_ && receive_window_ < limit)
+        {
+            receive_window_ = std::min(window_epoch_delivered_ * 2, limit);
+            GUARD_L2_DEBUG_LOG("Receive window grown to ", receive_window_, " frames.\n");
+        }
+        window_epoch_start_ = now;
+        window_epoch_delivered_ = 0;
+    }
+
+    if (receive_window_ > limit)
+    {
+        receive_window_ = limit;
+        GUARD_L2_DEBUG_LOG("Receive window shrunk to ", receive_window_, " frames (memory pressure).\n");
+    }
+
+    const uint32_t edge = receive_window_base + (receive_window_ > out_of_order_frames_ ? receive_window_ - out_of_order_frames_ : 0);
+    if (edge > advertised_edge_)
+    {
+        if (rtt_probe_edge_ == 0)
+        {
+            rtt_probe_edge_ = advertised_edge_;
+            rtt_probe_time_ = now;
+        }
+        advertised_edge_ = edge;
+    }
+}
+
 std::vector<uint8_t> GuardL2Receiver::receive_reliable_data()
+{
+    GuardL2ReassemblyStore store;
+    if (!receive_reliable_data(store))
+    {
+        return {};
+    }
+    return store.to_vector();
+}
+
+bool GuardL2Receiver::receive_reliable_data(GuardL2ReassemblyStore &store)
 {
     GUARD_L2_DEBUG_LOG("\n[*] Waiting for new transmission session...\n");
     std::array<uint8_t, 2048> recv_buffer;
-    std::vector<uint8_t> reassembled_data;
+    constexpr size_t max_payload_size = 1400;
+    GuardL2ActiveSessionCount active_session{active_sessions_};
+    guard_l2_pin_current_thread(latency_profile_.data_cpu);
 
     // 세션 상태 변수 초기화화
     uint32_t current_session_id = 0;
@@ -697,159 +1310,438 @@ std::vector<uint8_t> GuardL2Receiver::receive_reliable_data()
     uint32_t total_packets = 0;
     uint32_t receive_window_base = 0;
     bool end_packet_received = false; // END 패킷 수신 여부
+    uint32_t current_data_crc32 = 0;
+    bool current_resumable = false;   // 송신자가 재개 가능 모드로 시작한 세션
+    bool already_delivered = false;   // 이미 완료해 반환한 세션을 재개 요청으로 다시 받는 중
+    uint32_t current_capabilities = 0; // 송신자와 협상된 기능
+    uint16_t current_session_tag = 0;  // DATA_COMPACT 프레임의 세션 구분 값
 
     while (true)
     {
         struct timeval timeout = {30, 0}; // 30초 타임아웃
         fd_set read_fds;
         FD_ZERO(&read_fds);
-        FD_SET(sock_fd_, &read_fds);
+        int max_fd = -1;
+        for (const auto &link : links_)
+        {
+            FD_SET(link.sock_fd, &read_fds);
+            max_fd = std::max(max_fd, link.sock_fd);
+        }
 
-        int ret = select(sock_fd_ + 1, &read_fds, nullptr, nullptr, &timeout);
+        int ret = guard_l2_select_read(max_fd, read_fds, timeout, latency_profile_.spin);
         if (ret <= 0)
         {
             if (ret == 0)
             {
                 GUARD_L2_DEBUG_ERROR_LOG("[ERROR]", "Session timed out.\n");
+
+                // 연속으로 받은 앞부분만 보관. 윈도우 안의 순서 밖 프레임은 재개 시 다시 받음
+                if (!resume_dir_.empty() && session_active && current_resumable && !already_delivered)
+                {
+                    const uint64_t contiguous = std::min<uint64_t>(static_cast<uint64_t>(receive_window_base - 1) * max_payload_size, total_data_size);
+                    save_resume_state(current_session_id, total_data_size, current_data_crc32, store.data().first(contiguous));
+                }
             }
             else
             {
                 GUARD_L2_DEBUG_ERROR_LOG("[ERROR]", " select() failed\n");
             }
 
-            return {};
+            store.reset();
+            return false;
         }
 
-        ssize_t bytes_received = recv(sock_fd_, recv_buffer.data(), recv_buffer.size(), 0);
+        // 준비된 모든 링크의 프레임을 같은 세션 상태로 처리 (본딩 시 하나의 재조립 버퍼로 합쳐짐)
+        for (size_t link_index = 0; link_index < links_.size(); ++link_index)
+        {
+            if (!FD_ISSET(links_[link_index].sock_fd, &read_fds))
+                continue;
 
-        // 기본적인 패킷 유효성 검사 (길이, MAC 주소, EtherType)
-        if (bytes_received < sizeof(ether_header) + sizeof(GuardL2Header))
-            continue;
+            ssize_t bytes_received = recv(links_[link_index].sock_fd, recv_buffer.data(), recv_buffer.size(), 0);
 
-        ether_header *eh = (ether_header *)recv_buffer.data();
-        if (std::memcmp(eh->ether_dhost, my_mac_.data(), 6) != 0)
-            continue;
-        if (ntohs(eh->ether_type) != ETHERTYPE_GUARDL2)
-            continue;
+            // 기본적인 패킷 유효성 검사 (길이, MAC 주소, EtherType)
+            if (bytes_received < static_cast<ssize_t>(sizeof(ether_header) + sizeof(GuardL2CompactDataHeader)))
+                continue;
 
-        uint8_t *guard_header_ptr = recv_buffer.data() + sizeof(ether_header);
-        GuardL2Header *gh = (GuardL2Header *)guard_header_ptr;
-        uint16_t payload_len = ntohs(gh->payload_length);
+            ether_header *eh = (ether_header *)recv_buffer.data();
+            if (std::memcmp(eh->ether_dhost, links_[link_index].config.local_mac.data(), 6) != 0)
+                continue;
+            if (ntohs(eh->ether_type) != ETHERTYPE_GUARDL2)
+                continue;
 
-        if (bytes_received < sizeof(ether_header) + sizeof(GuardL2Header) + payload_len)
-        {
-            GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "Truncated packet received. Dropped.\n");
-            continue;
-        }
+            if (capture_)
+            {
+                capture_->record(links_[link_index].capture_interface, GuardL2CaptureDirection::INBOUND, std::span<const uint8_t>{recv_buffer.data(), static_cast<size_t>(bytes_received)});
+            }
 
-        // CRC 검증증
-        uint32_t received_crc = ntohl(gh->crc32);
-        gh->crc32 = 0;
-        uint32_t calculated_crc = compute_crc32(std::span<const uint8_t>{guard_header_ptr, sizeof(GuardL2Header) + payload_len});
-        gh->crc32 = htonl(received_crc);
+            uint8_t *guard_header_ptr = recv_buffer.data() + sizeof(ether_header);
+            const size_t guard_frame_size = bytes_received - sizeof(ether_header);
 
-        if (received_crc != calculated_crc)
-        {
-            GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "CRC mismatch. Expected: ", calculated_crc, ", Received: ", received_crc, "Packet dropped.", "\n");
-            continue;
-        }
+            GuardL2Header::FrameType frame_type;
+            uint32_t session_id;
+            uint32_t seq_num;
+            uint64_t frame_total_size = 0;
+            const uint8_t *payload;
+            uint16_t payload_len;
 
-        // 패킷 유형에 따라 처리
-        uint32_t session_id = ntohl(gh->session_id);
-        uint32_t seq_num = ntohl(gh->sequence_number);
-        const uint8_t *payload = guard_header_ptr + sizeof(GuardL2Header);
-        std::array<uint8_t, 6> sender_mac;
-        std::memcpy(sender_mac.data(), eh->ether_shost, 6);
-
-        switch (gh->type)
-        {
-        case GuardL2Header::FrameType::START:
-            if (seq_num == 0)
+            if (guard_header_ptr[0] == static_cast<uint8_t>(GuardL2Header::FrameType::DATA_COMPACT))
             {
-                GUARD_L2_DEBUG_LOG("New session started. ID: ", session_id, "\n");
-                session_active = true;
-                current_session_id = session_id;
-                receive_window_base = 1;
-                total_data_size = ntohll(gh->total_size);
-                total_packets = (total_data_size == 0) ? 0 : (total_data_size + 1400 - 1) / 1400;
-                reassembled_data.clear();
-                reassembled_data.reserve(total_data_size);
-                out_of_order_buffer_.clear();
-                end_packet_received = false; // Reset for the new session
-
-                send_ack(sender_mac, current_session_id, seq_num);
+                // 축약 DATA 프레임은 START ACK로 알려준 태그로 현재 세션을 찾음
+                auto compact = parse_compact_data_frame(std::span<uint8_t>{guard_header_ptr, guard_frame_size});
+                if (!compact || compact->payload.size() > UINT16_MAX)
+                    continue;
+
+                frame_type = GuardL2Header::FrameType::DATA;
+                session_id = (session_active && compact->session_tag == current_session_tag) ? current_session_id : 0;
+                seq_num = compact->seq_num;
+                payload = compact->payload.data();
+                payload_len = static_cast<uint16_t>(compact->payload.size());
             }
-            break;
+            else
+            {
+                if (guard_frame_size < sizeof(GuardL2Header))
+                    continue;
 
-        case GuardL2Header::FrameType::DATA:
-            if (!session_active || current_session_id != session_id)
-                continue;
+                GuardL2Header *gh = (GuardL2Header *)guard_header_ptr;
+                payload_len = ntohs(gh->payload_length);
 
-            if (seq_num >= receive_window_base && seq_num < receive_window_base + RECEIVER_WINDOW_CAPACITY)
-            {
-                send_ack(sender_mac, current_session_id, seq_num);
+                if (guard_frame_size < sizeof(GuardL2Header) + payload_len)
+                {
+                    GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "Truncated packet received. Dropped.\n");
+                    continue;
+                }
 
-                if (seq_num == receive_window_base)
+                // CRC 검증증
+                uint32_t received_crc = ntohl(gh->crc32);
+                gh->crc32 = 0;
+                uint32_t calculated_crc = compute_crc32(std::span<const uint8_t>{guard_header_ptr, sizeof(GuardL2Header) + payload_len});
+                gh->crc32 = htonl(received_crc);
+
+                if (received_crc != calculated_crc)
                 {
-                    reassembled_data.insert(reassembled_data.end(), payload, payload + payload_len);
-                    receive_window_base++;
+                    GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "CRC mismatch. Expected: ", calculated_crc, ", Received: ", received_crc, "Packet dropped.", "\n");
+                    continue;
+                }
 
-                    while (out_of_order_buffer_.contains(receive_window_base))
+                frame_type = gh->type;
+                session_id = ntohl(gh->session_id);
+                seq_num = ntohl(gh->sequence_number);
+                frame_total_size = ntohll(gh->total_size);
+                payload = guard_header_ptr + sizeof(GuardL2Header);
+            }
+
+            // 패킷 유형에 따라 처리
+            std::array<uint8_t, 6> sender_mac;
+            std::memcpy(sender_mac.data(), eh->ether_shost, 6);
+
+            switch (frame_type)
+            {
+            case GuardL2Header::FrameType::START:
+                if (seq_num == 0)
+                {
+                    // START 페이로드: 재개 플래그와 전체 데이터 CRC, 버전 2부터는 프로토콜 버전과 지원 기능 (최초 버전 송신자는 페이로드 없음)
+                    GuardL2StartPayload start_payload{};
+                    std::memcpy(&start_payload, payload, std::min<size_t>(payload_len, sizeof(start_payload)));
+                    const bool has_start_payload = payload_len >= offsetof(GuardL2StartPayload, protocol_version);
+                    const bool has_version = payload_len >= sizeof(GuardL2StartPayload);
+                    const bool resume_requested = has_start_payload && (start_payload.flags & GuardL2StartPayload::FLAG_RESUME);
+                    const uint64_t start_total_size = frame_total_size;
+                    const uint32_t start_data_crc32 = ntohl(start_payload.data_crc32);
+                    const uint32_t peer_capabilities = has_version ? ntohl(start_payload.capabilities) : 0;
+
+                    if (resume_requested && session_active && current_session_id == session_id && total_data_size == start_total_size)
                     {
-                        auto &buffered_data = out_of_order_buffer_.at(receive_window_base);
-                        reassembled_data.insert(reassembled_data.end(), buffered_data.begin(), buffered_data.end());
-                        out_of_order_buffer_.erase(receive_window_base);
-                        receive_window_base++;
+                        // 진행 중인 세션을 그대로 이어받음 (송신자만 재시작한 경우)
+                        GUARD_L2_DEBUG_LOG("Session resumed in place. ID: ", session_id, ", Seq: ", receive_window_base, "\n");
+                    }
+                    else
+                    {
+                        GUARD_L2_DEBUG_LOG("New session started. ID: ", session_id, "\n");
+                        session_active = false;
+                        store.reset();
+                        received_frames_.clear();
+                        out_of_order_frames_ = 0;
+
+                        const uint64_t start_total_packets = (start_total_size + max_payload_size - 1) / max_payload_size;
+                        if (start_total_packets >= UINT32_MAX)
+                        {
+                            GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "START with impossible total size", start_total_size, "rejected.\n");
+                            break;
+                        }
+
+                        current_session_id = session_id;
+                        receive_window_base = 1;
+                        total_data_size = start_total_size;
+                        total_packets = static_cast<uint32_t>(start_total_packets);
+                        current_data_crc32 = start_data_crc32;
+                        // 버전 필드가 없는 재개 페이로드는 항상 재개 가능 세션이었음
+                        current_resumable = has_start_payload && (!has_version || (start_payload.flags & GuardL2StartPayload::FLAG_RESUMABLE));
+                        current_capabilities = peer_capabilities & LOCAL_CAPABILITIES;
+                        if (++next_session_tag_ == 0)
+                            ++next_session_tag_;
+                        current_session_tag = next_session_tag_;
+                        already_delivered = false;
+                        end_packet_received = false; // Reset for the new session
+                        reset_receive_window();
+
+                        auto completed = std::find_if(completed_sessions_.begin(), completed_sessions_.end(), [&](const CompletedSession &c)
+                                                      { return c.session_id == session_id && c.total_size == total_data_size && c.data_crc32 == current_data_crc32; });
+
+                        if (resume_requested && completed != completed_sessions_.end())
+                        {
+                            // END ACK가 유실되어 송신자가 재개를 요청한 경우. 이미 전달했으므로 END만 받아 마무리
+                            GUARD_L2_DEBUG_LOG("Session ", session_id, " already delivered. Skipping to END.\n");
+                            already_delivered = true;
+                            receive_window_base = total_packets + 1;
+                        }
+                        else
+                        {
+                            // 신뢰할 수 없는 total_size이므로 저장소를 확보하지 못하면 START ACK 없이 거부
+                            if (!store.open(total_data_size))
+                            {
+                                GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "Cannot reserve storage for", total_data_size, "bytes. Session", session_id, "rejected.\n");
+                                break;
+                            }
+                            received_frames_.assign(total_packets + 1, false);
+
+                            uint64_t restored = 0;
+                            if (resume_requested && !resume_dir_.empty())
+                            {
+                                restored = load_resume_state(session_id, total_data_size, current_data_crc32, store);
+                            }
+                            if (restored > 0)
+                            {
+                                receive_window_base = (restored == total_data_size) ? total_packets + 1 : static_cast<uint32_t>(restored / max_payload_size) + 1;
+                                GUARD_L2_DEBUG_LOG("Session ", session_id, " resumed from spool. ", restored, " bytes restored, Seq: ", receive_window_base, "\n");
+                            }
+                        }
+                        session_active = true;
                     }
+
+                    GuardL2StartAckPayload start_ack{htonl(instance_id_), htonl(receive_window_base), GUARD_L2_PROTOCOL_VERSION, htonl(current_capabilities), htons(current_session_tag)};
+                    send_ack(link_index, sender_mac, current_session_id, seq_num, std::span<const uint8_t>{(const uint8_t *)&start_ack, sizeof(start_ack)});
                 }
-                else
+                break;
+
+            case GuardL2Header::FrameType::DATA:
+                if (!session_active || current_session_id != session_id)
+                    continue;
+
+                // 윈도우가 줄어들기 전에 보낸 프레임도 받을 수 있도록 최대 윈도우 범위까지 수용 (저장소는 이미 확보됨)
+                if (seq_num >= receive_window_base && seq_num < static_cast<uint64_t>(receive_window_base) + MAX_RECEIVE_WINDOW)
                 {
-                    if (!out_of_order_buffer_.contains(seq_num))
+                    // 프레임이 저장소의 제 위치를 정확히 채우는지 확인 (마지막 프레임만 짧을 수 있음)
+                    if (seq_num > total_packets)
+                        continue;
+                    const uint64_t offset = static_cast<uint64_t>(seq_num - 1) * max_payload_size;
+                    if (payload_len != std::min<uint64_t>(max_payload_size, total_data_size - offset))
+                    {
+                        GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "Unexpected payload length", payload_len, "for Seq:", seq_num, "Dropped.\n");
+                        continue;
+                    }
+
+                    if (!received_frames_[seq_num])
                     {
-                        out_of_order_buffer_[seq_num] = std::vector<uint8_t>(payload, payload + payload_len);
+                        store.write(offset, std::span<const uint8_t>{payload, payload_len});
+                        received_frames_[seq_num] = true;
+                        out_of_order_frames_++;
                     }
+
+                    const uint32_t base_before = receive_window_base;
+                    while (receive_window_base <= total_packets && received_frames_[receive_window_base])
+                    {
+                        out_of_order_frames_--;
+                        receive_window_base++;
+                    }
+
+                    // ACK가 조정된 윈도우를 싣도록 처리 후에 보냄
+                    update_receive_window(seq_num, receive_window_base, receive_window_base - base_before);
+                    send_ack(link_index, sender_mac, current_session_id, seq_num);
                 }
-            }
-            else if (seq_num < receive_window_base)
+                else if (seq_num < receive_window_base)
+                {
+                    send_ack(link_index, sender_mac, current_session_id, seq_num);
+                }
+
+                break;
+
+            case GuardL2Header::FrameType::END:
             {
-                send_ack(sender_mac, current_session_id, seq_num);
+                uint32_t end_seq_num = total_packets + 1;
+                if (session_active && current_session_id == session_id && seq_num == end_seq_num)
+                {
+                    send_ack(link_index, sender_mac, current_session_id, seq_num);
+                    end_packet_received = true; // END 패킷을 받앗음을 표시
+                }
             }
-
             break;
 
-        case GuardL2Header::FrameType::END:
-        {
-            uint32_t end_seq_num = total_packets + 1;
-            if (session_active && current_session_id == session_id && seq_num == end_seq_num)
-            {
-                send_ack(sender_mac, current_session_id, seq_num);
-                end_packet_received = true; // END 패킷을 받앗음을 표시
+            default:
+                break;
             }
-        }
-        break;
 
-        default:
-            break;
-        }
+            active_session.set(session_active);
 
-        // 각 패킷 처리 후 세션 종료 조건을 검사
-        if (session_active && end_packet_received)
-        {
-            uint32_t end_seq_num = total_packets + 1;
-            if (receive_window_base == end_seq_num)
+            // 각 패킷 처리 후 세션 종료 조건을 검사
+            if (session_active && end_packet_received)
             {
-                if (reassembled_data.size() == total_data_size)
-                {
-                    GUARD_L2_DEBUG_LOG("Transfer complete. Total received: ", reassembled_data.size(), " bytes.\n");
-                    return reassembled_data;
-                }
-                else
+                uint32_t end_seq_num = total_packets + 1;
+                if (receive_window_base == end_seq_num)
                 {
-                    GUARD_L2_DEBUG_LOG("[ERROR]", "Received END packet but data size mismatch! Expected: ", total_data_size, ", Got: ", reassembled_data.size(), "\n");
-                    return {};
+                    if (already_delivered)
+                    {
+                        // 중복 전달을 막기 위해 반환하지 않고 다음 세션을 기다림
+                        GUARD_L2_DEBUG_LOG("Duplicate session ", current_session_id, " closed.\n");
+                        session_active = false;
+                        end_packet_received = false;
+                        already_delivered = false;
+                        continue;
+                    }
+
+                    if (store.size() == total_data_size)
+                    {
+                        GUARD_L2_DEBUG_LOG("Transfer complete. Total received: ", store.size(), " bytes.\n");
+                        if (current_resumable)
+                        {
+                            remove_resume_state(current_session_id);
+                            completed_sessions_.push_back({current_session_id, total_data_size, current_data_crc32});
+                            if (completed_sessions_.size() > COMPLETED_SESSION_HISTORY)
+                            {
+                                completed_sessions_.pop_front();
+                            }
+                        }
+                        received_frames_.clear();
+                        return true;
+                    }
+                    else
+                    {
+                        GUARD_L2_DEBUG_LOG("[ERROR]", "Received END packet but data size mismatch! Expected: ", total_data_size, ", Got: ", store.size(), "\n");
+                        store.reset();
+                        return false;
+                    }
                 }
             }
         }
     }
-    return {}; // 실패 시 빈 벡터 반환
-}
\ No newline at end of file
+    return false;
+}
+
+// 재개 보관 파일 헤더. .part 파일(받은 앞부분)을 먼저 쓰고 .meta를 마지막에 써서 .meta가 있으면 완전한 상태임을 보장
+struct GuardL2ResumeMeta
+{
+    std::array<char, 4> magic;
+    uint32_t session_id;
+    uint64_t total_size;
+    uint32_t data_crc32;
+    uint64_t prefix_size;
+    uint32_t prefix_crc32;
+} __attribute__((packed));
+
+constexpr static std::array<char, 4> RESUME_META_MAGIC = {'G', 'R', 'S', '1'};
+
+static std::filesystem::path resume_file_path(const std::filesystem::path &dir, uint32_t session_id, const char *extension)
+{
+    return dir / ("session_" + std::to_string(session_id) + extension);
+}
+
+void GuardL2Receiver::enable_resume(const std::filesystem::path &spool_dir)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(spool_dir, ec);
+    if (ec)
+    {
+        throw std::runtime_error("Receiver: Failed to create resume directory " + spool_dir.string() + ": " + ec.message());
+    }
+    resume_dir_ = spool_dir;
+
+    // 끝내 재개되지 않은 오래된 보관 파일 정리
+    const auto now = std::filesystem::file_time_type::clock::now();
+    for (const auto &entry : std::filesystem::directory_iterator(resume_dir_, ec))
+    {
+        std::error_code entry_ec;
+        auto modified = entry.last_write_time(entry_ec);
+        if (!entry_ec && entry.is_regular_file(entry_ec) && now - modified > RESUME_STATE_MAX_AGE)
+        {
+            std::filesystem::remove(entry.path(), entry_ec);
+        }
+    }
+}
+
+void GuardL2Receiver::save_resume_state(uint32_t session_id, uint64_t total_size, uint32_t data_crc32, std::span<const uint8_t> prefix)
+{
+    if (prefix.empty())
+    {
+        return;
+    }
+
+    GuardL2ResumeMeta meta{RESUME_META_MAGIC, session_id, total_size, data_crc32, prefix.size(), compute_crc32(prefix)};
+
+    std::ofstream part(resume_file_path(resume_dir_, session_id, ".part"), std::ios::binary | std::ios::trunc);
+    part.write((const char *)prefix.data(), prefix.size());
+    part.close();
+
+    std::ofstream meta_file(resume_file_path(resume_dir_, session_id, ".meta"), std::ios::binary | std::ios::trunc);
+    meta_file.write((const char *)&meta, sizeof(meta));
+    meta_file.close();
+
+    if (!part || !meta_file)
+    {
+        GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "Failed to save resume state for session", session_id, "\n");
+        remove_resume_state(session_id);
+        return;
+    }
+    GUARD_L2_DEBUG_LOG("Saved resume state for session ", session_id, " (", prefix.size(), " bytes).\n");
+}
+
+uint64_t GuardL2Receiver::load_resume_state(uint32_t session_id, uint64_t total_size, uint32_t data_crc32, GuardL2ReassemblyStore &store)
+{
+    GuardL2ResumeMeta meta{};
+    std::ifstream meta_file(resume_file_path(resume_dir_, session_id, ".meta"), std::ios::binary);
+    if (!meta_file.read((char *)&meta, sizeof(meta)))
+    {
+        return 0;
+    }
+
+    // 앞부분은 항상 프레임 경계에서 끝나야 함
+    if (meta.magic != RESUME_META_MAGIC || meta.session_id != session_id || meta.total_size != total_size ||
+        meta.data_crc32 != data_crc32 || meta.prefix_size > total_size || (meta.prefix_size % 1400 != 0 && meta.prefix_size != total_size))
+    {
+        // 같은 ID로 다른 데이터가 온 경우. 이전 보관분은 쓸모 없음
+        remove_resume_state(session_id);
+        return 0;
+    }
+
+    // 큰 세션은 저장소가 디스크 스풀이므로 한 번에 메모리로 읽지 않고 나누어 복사
+    std::ifstream part(resume_file_path(resume_dir_, session_id, ".part"), std::ios::binary);
+    std::vector<uint8_t> chunk(1024 * 1024);
+    uint64_t restored = 0;
+    while (part && restored < meta.prefix_size)
+    {
+        size_t len = std::min<uint64_t>(chunk.size(), meta.prefix_size - restored);
+        if (!part.read((char *)chunk.data(), len))
+            break;
+        store.write(restored, std::span<const uint8_t>{chunk.data(), len});
+        restored += len;
+    }
+
+    if (restored != meta.prefix_size || compute_crc32(store.data().first(restored)) != meta.prefix_crc32)
+    {
+        GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "Resume state for session", session_id, "is corrupted. Starting over.\n");
+        remove_resume_state(session_id);
+        return 0;
+    }
+
+    return restored;
+}
+
+void GuardL2Receiver::remove_resume_state(uint32_t session_id)
+{
+    if (resume_dir_.empty())
+    {
+        return;
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(resume_file_path(resume_dir_, session_id, ".part"), ec);
+    std::filesystem::remove(resume_file_path(resume_dir_, session_id, ".meta"), ec);
+}
@@ -0,0 +1,340 @@
+#include "GuardL2Capture.hpp"
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+// pcapng 블록 종류와 옵션 코드 (IETF draft-ietf-opsawg-pcapng)
+constexpr static uint32_t PCAPNG_SECTION_HEADER_BLOCK = 0x0A0D0D0A;
+constexpr static uint32_t PCAPNG_INTERFACE_DESCRIPTION_BLOCK = 0x00000001;
+constexpr static uint32_t PCAPNG_SIMPLE_PACKET_BLOCK = 0x00000003;
+constexpr static uint32_t PCAPNG_ENHANCED_PACKET_BLOCK = 0x00000006;
+constexpr static uint32_t PCAPNG_BYTE_ORDER_MAGIC = 0x1A2B3C4D;
+
+constexpr static uint16_t PCAPNG_OPT_END = 0;
+constexpr static uint16_t PCAPNG_OPT_IF_NAME = 2;
+constexpr static uint16_t PCAPNG_OPT_IF_TSRESOL = 9;
+constexpr static uint16_t PCAPNG_OPT_EPB_FLAGS = 2;
+
+constexpr static uint16_t PCAPNG_LINKTYPE_ETHERNET = 1;
+constexpr static uint8_t PCAPNG_TSRESOL_NANOSECONDS = 9;
+
+constexpr static size_t PCAPNG_MAX_BLOCK_SIZE = 16 * 1024 * 1024;
+
+static size_t pad4(size_t size)
+{
+    return (size + 3) & ~static_cast<size_t>(3);
+}
+
+template <typename T>
+static void append_value(std::vector<uint8_t> &out, T value)
+{
+    const size_t offset = out.size();
+    out.resize(offset + sizeof(T));
+    std::memcpy(out.data() + offset, &value, sizeof(T));
+}
+
+static void append_option(std::vector<uint8_t> &out, uint16_t code, std::span<const uint8_t> value)
+{
+    append_value<uint16_t>(out, code);
+    append_value<uint16_t>(out, static_cast<uint16_t>(value.size()));
+    out.insert(out.end(), value.begin(), value.end());
+    out.resize(pad4(out.size()));
+}
+
+GuardL2Capture::GuardL2Capture(const std::filesystem::path &path)
+    : file_(path, std::ios::binary | std::ios::trunc)
+{
+    if (!file_)
+    {
+        throw std::runtime_error("Cannot open capture file " + path.string());
+    }
+
+    // SHB: 바이트 순서 표식, 버전 1.0, 섹션 길이 미지정(-1)
+    std::vector<uint8_t> body;
+    append_value<uint32_t>(body, PCAPNG_BYTE_ORDER_MAGIC);
+    append_value<uint16_t>(body, 1);
+    append_value<uint16_t>(body, 0);
+    append_value<int64_t>(body, -1);
+    write_block(PCAPNG_SECTION_HEADER_BLOCK, body);
+}
+
+GuardL2Capture::~GuardL2Capture()
+{
+    flush();
+}
+
+uint32_t GuardL2Capture::add_interface(const std::string &interface_name)
+{
+    std::vector<uint8_t> body;
+    append_value<uint16_t>(body, PCAPNG_LINKTYPE_ETHERNET);
+    append_value<uint16_t>(body, 0);
+    append_value<uint32_t>(body, 0); // snaplen 제한 없음
+    append_option(body, PCAPNG_OPT_IF_NAME, std::span<const uint8_t>{(const uint8_t *)interface_name.data(), interface_name.size()});
+    append_option(body, PCAPNG_OPT_IF_TSRESOL, std::span<const uint8_t>{&PCAPNG_TSRESOL_NANOSECONDS, 1});
+    append_option(body, PCAPNG_OPT_END, {});
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_block(PCAPNG_INTERFACE_DESCRIPTION_BLOCK, body);
+    return next_interface_id_++;
+}
+
+void GuardL2Capture::record(uint32_t interface_id, GuardL2CaptureDirection direction, std::span<const uint8_t> frame)
+{
+    const uint64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::system_clock::now().time_since_epoch()).count();
+
+    std::vector<uint8_t> body;
+    body.reserve(20 + pad4(frame.size()) + 12);
+    append_value<uint32_t>(body, interface_id);
+    append_value<uint32_t>(body, static_cast<uint32_t>(timestamp >> 32));
+    append_value<uint32_t>(body, static_cast<uint32_t>(timestamp));
+    append_value<uint32_t>(body, static_cast<uint32_t>(frame.size()));
+    append_value<uint32_t>(body, static_cast<uint32_t>(frame.size()));
+    body.insert(body.end(), frame.begin(), frame.end());
+    body.resize(pad4(body.size()));
+
+    const uint32_t flags = static_cast<uint32_t>(direction);
+    append_option(body, PCAPNG_OPT_EPB_FLAGS, std::span<const uint8_t>{(const uint8_t *)&flags, sizeof(flags)});
+    append_option(body, PCAPNG_OPT_END, {});
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_block(PCAPNG_ENHANCED_PACKET_BLOCK, body);
+    ++frames_recorded_;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - last_flush_ >= FLUSH_INTERVAL)
+    {
+        file_.flush();
+        last_flush_ = now;
+    }
+}
+
+void GuardL2Capture::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.flush();
+}
+
+uint64_t GuardL2Capture::frames_recorded() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return frames_recorded_;
+}
+
+void GuardL2Capture::write_block(uint32_t block_type, std::span<const uint8_t> body)
+{
+    const uint32_t total_length = static_cast<uint32_t>(12 + body.size());
+    file_.write((const char *)&block_type, sizeof(block_type));
+    file_.write((const char *)&total_length, sizeof(total_length));
+    file_.write((const char *)body.data(), body.size());
+    file_.write((const char *)&total_length, sizeof(total_length));
+}
+
+/**
+ * @brief 한 섹션의 바이트 순서에 맞추어 블록 본문의 정수를 읽음
+ */
+class PcapngBlockReader {
+public:
+    PcapngBlockReader(std::span<const uint8_t> body, bool swapped) : body_(body), swapped_(swapped) {}
+
+    template <typename T>
+    T read(size_t offset) const
+    {
+        if (offset + sizeof(T) > body_.size())
+        {
+            throw std::runtime_error("Truncated pcapng block");
+        }
+        T value;
+        std::memcpy(&value, body_.data() + offset, sizeof(T));
+        return swapped_ ? std::byteswap(value) : value;
+    }
+
+    std::span<const uint8_t> bytes(size_t offset, size_t size) const
+    {
+        if (offset + size > body_.size())
+        {
+            throw std::runtime_error("Truncated pcapng block");
+        }
+        return body_.subspan(offset, size);
+    }
+
+    size_t size() const { return body_.size(); }
+
+private:
+    std::span<const uint8_t> body_;
+    bool swapped_;
+};
+
+struct PcapngInterface
+{
+    uint64_t ticks_per_second = 1000000; // 기본 if_tsresol = 6 (마이크로초)
+    uint32_t snaplen = 0;
+};
+
+// 옵션 목록을 돌며 fn(code, value) 호출
+template <typename Fn>
+static void for_each_option(const PcapngBlockReader &reader, size_t offset, Fn &&fn)
+{
+    while (offset + 4 <= reader.size())
+    {
+        uint16_t code = reader.read<uint16_t>(offset);
+        uint16_t length = reader.read<uint16_t>(offset + 2);
+        if (code == PCAPNG_OPT_END)
+        {
+            break;
+        }
+        fn(code, reader.bytes(offset + 4, length));
+        offset += 4 + pad4(length);
+    }
+}
+
+static uint64_t ticks_to_ns(uint64_t ticks, uint64_t ticks_per_second)
+{
+    if (ticks_per_second == 1000000000)
+    {
+        return ticks;
+    }
+    return static_cast<uint64_t>(static_cast<__uint128_t>(ticks) * 1000000000 / ticks_per_second);
+}
+
+std::vector<GuardL2CapturedFrame> read_guard_l2_capture(const std::filesystem::path &path, std::vector<std::string> *interface_names)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Cannot open capture file " + path.string());
+    }
+
+    std::vector<GuardL2CapturedFrame> frames;
+    std::vector<PcapngInterface> interfaces;
+    bool swapped = false;
+    bool section_seen = false;
+    std::vector<uint8_t> body;
+
+    while (true)
+    {
+        uint32_t header[2];
+        if (!file.read((char *)header, sizeof(header)))
+        {
+            break;
+        }
+
+        uint32_t block_type = header[0];
+        if (block_type == PCAPNG_SECTION_HEADER_BLOCK)
+        {
+            // 새 섹션마다 바이트 순서와 인터페이스 번호가 다시 시작됨
+            uint32_t magic;
+            if (!file.read((char *)&magic, sizeof(magic)))
+            {
+                throw std::runtime_error("Truncated pcapng section header");
+            }
+            if (magic == PCAPNG_BYTE_ORDER_MAGIC)
+            {
+                swapped = false;
+            }
+            else if (magic == std::byteswap(PCAPNG_BYTE_ORDER_MAGIC))
+            {
+                swapped = true;
+            }
+            else
+            {
+                throw std::runtime_error("Not a pcapng file: " + path.string());
+            }
+            file.seekg(-static_cast<std::streamoff>(sizeof(magic)), std::ios::cur);
+            interfaces.clear();
+            section_seen = true;
+        }
+        else if (!section_seen)
+        {
+            throw std::runtime_error("Not a pcapng file: " + path.string());
+        }
+
+        uint32_t total_length = swapped ? std::byteswap(header[1]) : header[1];
+        if (total_length < 12 || total_length % 4 != 0 || total_length > PCAPNG_MAX_BLOCK_SIZE)
+        {
+            throw std::runtime_error("Invalid pcapng block length in " + path.string());
+        }
+
+        body.resize(total_length - 12);
+        uint32_t trailer;
+        if (!file.read((char *)body.data(), body.size()) || !file.read((char *)&trailer, sizeof(trailer)))
+        {
+            // 기록 중 중단된 파일은 마지막 완전한 블록까지만 사용
+            break;
+        }
+
+        PcapngBlockReader reader(body, swapped);
+        if (block_type == PCAPNG_INTERFACE_DESCRIPTION_BLOCK)
+        {
+            PcapngInterface interface;
+            interface.snaplen = reader.read<uint32_t>(4);
+            std::string name;
+            for_each_option(reader, 8, [&](uint16_t code, std::span<const uint8_t> value)
+            {
+                if (code == PCAPNG_OPT_IF_NAME)
+                {
+                    name.assign(value.begin(), value.end());
+                }
+                else if (code == PCAPNG_OPT_IF_TSRESOL && value.size() == 1)
+                {
+                    // 최상위 비트가 켜져 있으면 2의 거듭제곱, 아니면 10의 거듭제곱
+                    uint8_t exponent = value[0] & 0x7F;
+                    uint64_t base = (value[0] & 0x80) ? 2 : 10;
+                    uint64_t ticks = 1;
+                    for (uint8_t i = 0; i < exponent && ticks <= UINT64_MAX / base; ++i)
+                    {
+                        ticks *= base;
+                    }
+                    interface.ticks_per_second = ticks;
+                }
+            });
+            interfaces.push_back(interface);
+            if (interface_names)
+            {
+                interface_names->push_back(std::move(name));
+            }
+        }
+        else if (block_type == PCAPNG_ENHANCED_PACKET_BLOCK)
+        {
+            GuardL2CapturedFrame frame;
+            frame.interface_id = reader.read<uint32_t>(0);
+            if (frame.interface_id >= interfaces.size())
+            {
+                throw std::runtime_error("pcapng packet refers to unknown interface");
+            }
+            uint64_t ticks = (static_cast<uint64_t>(reader.read<uint32_t>(4)) << 32) | reader.read<uint32_t>(8);
+            frame.timestamp_ns = ticks_to_ns(ticks, interfaces[frame.interface_id].ticks_per_second);
+
+            uint32_t captured_length = reader.read<uint32_t>(12);
+            std::span<const uint8_t> data = reader.bytes(20, captured_length);
+            frame.data.assign(data.begin(), data.end());
+
+            frame.direction = 0;
+            for_each_option(reader, 20 + pad4(captured_length), [&](uint16_t code, std::span<const uint8_t> value)
+            {
+                if (code == PCAPNG_OPT_EPB_FLAGS && value.size() == 4)
+                {
+                    frame.direction = PcapngBlockReader(value, swapped).read<uint32_t>(0) & 0x03;
+                }
+            });
+            frames.push_back(std::move(frame));
+        }
+        else if (block_type == PCAPNG_SIMPLE_PACKET_BLOCK)
+        {
+            // SPB는 첫 번째 인터페이스의 프레임이며 타임스탬프가 없음
+            if (interfaces.empty())
+            {
+                throw std::runtime_error("pcapng packet refers to unknown interface");
+            }
+            uint32_t original_length = reader.read<uint32_t>(0);
+            uint32_t captured_length = interfaces.front().snaplen != 0 ? std::min(original_length, interfaces.front().snaplen) : original_length;
+            std::span<const uint8_t> data = reader.bytes(4, captured_length);
+
+            GuardL2CapturedFrame frame{frames.empty() ? 0 : frames.back().timestamp_ns, 0, 0, {data.begin(), data.end()}};
+            frames.push_back(std::move(frame));
+        }
+    }
+
+    return frames;
+}
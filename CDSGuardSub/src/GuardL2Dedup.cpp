@@ -0,0 +1,286 @@
+#include "GuardL2Dedup.hpp"
+#include "GuardL2.hpp"
+#include <openssl/evp.h>
+#include <arpa/inet.h>
+#include <algorithm>
+
+constexpr static std::array<uint8_t, 4> DEDUP_MAGIC = {'G', 'D', 'D', '1'};
+constexpr static std::array<uint8_t, 4> SEALED_MAGIC = {'G', 'D', 'E', '1'};
+constexpr static uint8_t RECORD_NEW = 0x01;
+constexpr static uint8_t RECORD_REF = 0x02;
+
+// 청크 크기: 최소 2 KiB, 평균 약 8 KiB, 최대 64 KiB (FastCDC 방식의 정규화 청킹)
+constexpr static size_t MIN_CHUNK_SIZE = 2 * 1024;
+constexpr static size_t AVG_CHUNK_SIZE = 8 * 1024;
+constexpr static size_t MAX_CHUNK_SIZE = 64 * 1024;
+constexpr static uint64_t MASK_SMALL = 0x0000d9f003530000ULL; // 평균 크기 전: 15비트 (경계가 잘 안 생김)
+constexpr static uint64_t MASK_LARGE = 0x0000d90003530000ULL; // 평균 크기 후: 11비트 (경계가 잘 생김)
+
+consteval std::array<uint64_t, 256> generate_gear_table()
+{
+    // splitmix64로 고정된 의사 난수 테이블 생성. 송수신 양쪽이 같은 경계를 얻을 필요는 없지만 실행마다 같아야 인덱스가 재사용됨
+    std::array<uint64_t, 256> table{};
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (auto &entry : table)
+    {
+        state += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        entry = z ^ (z >> 31);
+    }
+    return table;
+}
+
+static constexpr std::array<uint64_t, 256> kGearTable = generate_gear_table();
+
+static size_t next_chunk_size(std::span<const uint8_t> data)
+{
+    if (data.size() <= MIN_CHUNK_SIZE)
+    {
+        return data.size();
+    }
+
+    const size_t limit = std::min(data.size(), MAX_CHUNK_SIZE);
+    const size_t normal = std::min(limit, AVG_CHUNK_SIZE);
+    uint64_t hash = 0;
+    size_t i = MIN_CHUNK_SIZE;
+
+    for (; i < normal; ++i)
+    {
+        hash = (hash << 1) + kGearTable[data[i]];
+        if ((hash & MASK_SMALL) == 0)
+            return i + 1;
+    }
+    for (; i < limit; ++i)
+    {
+        hash = (hash << 1) + kGearTable[data[i]];
+        if ((hash & MASK_LARGE) == 0)
+            return i + 1;
+    }
+    return limit;
+}
+
+static GuardL2ChunkHash hash_chunk(std::span<const uint8_t> chunk)
+{
+    GuardL2ChunkHash hash;
+    unsigned int len = 0;
+    EVP_Digest(chunk.data(), chunk.size(), hash.data(), &len, EVP_sha256(), nullptr);
+    return hash;
+}
+
+GuardL2DedupEncoder::GuardL2DedupEncoder(size_t index_capacity_bytes)
+: index_capacity_bytes_(index_capacity_bytes)
+{
+}
+
+std::vector<uint8_t> GuardL2DedupEncoder::encode(std::span<const uint8_t> data)
+{
+    pending_.clear();
+    last_new_bytes_ = 0;
+    last_ref_bytes_ = 0;
+
+    std::unordered_set<GuardL2ChunkHash, GuardL2ChunkHashHasher> pending_set;
+    std::vector<uint8_t> out;
+    out.reserve(data.size() + DEDUP_MAGIC.size());
+    out.insert(out.end(), DEDUP_MAGIC.begin(), DEDUP_MAGIC.end());
+
+    size_t offset = 0;
+    while (offset < data.size())
+    {
+        std::span<const uint8_t> chunk = data.subspan(offset, next_chunk_size(data.subspan(offset)));
+        GuardL2ChunkHash hash = hash_chunk(chunk);
+        offset += chunk.size();
+
+        // 같은 메시지 안에서 앞서 NEW로 보낸 청크는 수신 측이 순서대로 캐시에 넣으므로 REF로 가리킬 수 있음
+        // 단, 이 메시지의 NEW 청크가 인덱스 용량을 넘으면 수신 캐시에서 오래된 청크가 밀려났을 수 있으므로 REF를 쓰지 않음
+        const bool refs_safe = last_new_bytes_ < index_capacity_bytes_;
+        if (refs_safe && (index_.contains(hash) || pending_set.contains(hash)))
+        {
+            out.push_back(RECORD_REF);
+            out.insert(out.end(), hash.begin(), hash.end());
+            last_ref_bytes_ += chunk.size();
+            continue;
+        }
+
+        uint32_t len_be = htonl(static_cast<uint32_t>(chunk.size()));
+        out.push_back(RECORD_NEW);
+        out.insert(out.end(), (const uint8_t *)&len_be, (const uint8_t *)&len_be + sizeof(len_be));
+        out.insert(out.end(), chunk.begin(), chunk.end());
+
+        pending_set.insert(hash);
+        pending_.emplace_back(hash, chunk.size());
+        last_new_bytes_ += chunk.size();
+    }
+
+    GUARD_L2_DEBUG_LOG("Dedup encode: ", data.size(), " bytes -> ", out.size(), " bytes (new ", last_new_bytes_, ", ref ", last_ref_bytes_, ")\n");
+    return out;
+}
+
+bool GuardL2DedupEncoder::commit(uint32_t peer_instance_id)
+{
+    if (peer_instance_id != 0 && peer_instance_id != peer_instance_id_)
+    {
+        const bool used_stale_refs = peer_instance_id_ != 0 && last_ref_bytes_ > 0;
+
+        // 수신자가 바뀌었으므로 이전 인덱스는 더 이상 수신 캐시와 일치하지 않음
+        index_.clear();
+        index_order_.clear();
+        index_bytes_ = 0;
+        peer_instance_id_ = peer_instance_id;
+
+        if (used_stale_refs)
+        {
+            GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "Dedup peer restarted. Index reset, stream must be re-sent.\n");
+            pending_.clear();
+            return false;
+        }
+    }
+
+    for (const auto &[hash, size] : pending_)
+    {
+        insert_into_index(hash, size);
+    }
+    pending_.clear();
+    return true;
+}
+
+void GuardL2DedupEncoder::discard()
+{
+    pending_.clear();
+}
+
+std::vector<uint8_t> GuardL2DedupEncoder::seal(std::span<const uint8_t> encrypted_stream)
+{
+    std::vector<uint8_t> out;
+    out.reserve(SEALED_MAGIC.size() + encrypted_stream.size());
+    out.insert(out.end(), SEALED_MAGIC.begin(), SEALED_MAGIC.end());
+    out.insert(out.end(), encrypted_stream.begin(), encrypted_stream.end());
+    return out;
+}
+
+void GuardL2DedupEncoder::insert_into_index(const GuardL2ChunkHash &hash, size_t size)
+{
+    if (size > index_capacity_bytes_ || !index_.insert(hash).second)
+    {
+        return;
+    }
+
+    index_order_.emplace_back(hash, size);
+    index_bytes_ += size;
+
+    while (index_bytes_ > index_capacity_bytes_)
+    {
+        auto &[oldest, oldest_size] = index_order_.front();
+        index_.erase(oldest);
+        index_bytes_ -= oldest_size;
+        index_order_.pop_front();
+    }
+}
+
+GuardL2DedupDecoder::GuardL2DedupDecoder(size_t cache_capacity_bytes)
+: cache_capacity_bytes_(cache_capacity_bytes)
+{
+}
+
+bool GuardL2DedupDecoder::is_dedup_stream(std::span<const uint8_t> data)
+{
+    return data.size() >= DEDUP_MAGIC.size() && std::equal(DEDUP_MAGIC.begin(), DEDUP_MAGIC.end(), data.begin());
+}
+
+bool GuardL2DedupDecoder::is_sealed_stream(std::span<const uint8_t> data)
+{
+    return data.size() >= SEALED_MAGIC.size() && std::equal(SEALED_MAGIC.begin(), SEALED_MAGIC.end(), data.begin());
+}
+
+std::span<const uint8_t> GuardL2DedupDecoder::sealed_payload(std::span<const uint8_t> data)
+{
+    return data.subspan(SEALED_MAGIC.size());
+}
+
+std::optional<std::vector<uint8_t>> GuardL2DedupDecoder::decode(std::span<const uint8_t> stream)
+{
+    if (!is_dedup_stream(stream))
+    {
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> out;
+    out.reserve(stream.size());
+    size_t pos = DEDUP_MAGIC.size();
+
+    while (pos < stream.size())
+    {
+        uint8_t record = stream[pos++];
+
+        if (record == RECORD_NEW)
+        {
+            if (stream.size() - pos < sizeof(uint32_t))
+                return std::nullopt;
+
+            uint32_t len_be;
+            std::memcpy(&len_be, stream.data() + pos, sizeof(len_be));
+            size_t len = ntohl(len_be);
+            pos += sizeof(len_be);
+
+            if (stream.size() - pos < len)
+                return std::nullopt;
+
+            std::span<const uint8_t> chunk = stream.subspan(pos, len);
+            pos += len;
+
+            out.insert(out.end(), chunk.begin(), chunk.end());
+            insert_into_cache(hash_chunk(chunk), chunk);
+        }
+        else if (record == RECORD_REF)
+        {
+            if (stream.size() - pos < sizeof(GuardL2ChunkHash))
+                return std::nullopt;
+
+            GuardL2ChunkHash hash;
+            std::memcpy(hash.data(), stream.data() + pos, hash.size());
+            pos += hash.size();
+
+            auto it = cache_.find(hash);
+            if (it == cache_.end())
+            {
+                GUARD_L2_DEBUG_ERROR_LOG("[ERROR]", "Dedup stream references a chunk that is not cached.\n");
+                return std::nullopt;
+            }
+            out.insert(out.end(), it->second.data.begin(), it->second.data.end());
+        }
+        else
+        {
+            return std::nullopt;
+        }
+    }
+
+    return out;
+}
+
+void GuardL2DedupDecoder::insert_into_cache(const GuardL2ChunkHash &hash, std::span<const uint8_t> chunk)
+{
+    if (chunk.size() > cache_capacity_bytes_)
+    {
+        return;
+    }
+
+    // 송신 측은 인덱스에서 밀려난 청크를 NEW로 다시 보내고 맨 뒤에 넣으므로 같은 순서로 옮김
+    if (auto it = cache_.find(hash); it != cache_.end())
+    {
+        cache_order_.splice(cache_order_.end(), cache_order_, it->second.order);
+        return;
+    }
+
+    cache_order_.push_back(hash);
+    cache_.emplace(hash, CachedChunk{std::vector<uint8_t>(chunk.begin(), chunk.end()), std::prev(cache_order_.end())});
+    cache_bytes_ += chunk.size();
+
+    while (cache_bytes_ > cache_capacity_bytes_)
+    {
+        auto it = cache_.find(cache_order_.front());
+        cache_bytes_ -= it->second.data.size();
+        cache_.erase(it);
+        cache_order_.pop_front();
+    }
+}
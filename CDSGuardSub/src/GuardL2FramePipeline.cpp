@@ -0,0 +1,70 @@
+#include "GuardL2FramePipeline.hpp"
+#include <algorithm>
+#include <chrono>
+
+// 링이 가득 차거나 비었을 때: 잠깐 양보하다가 그래도 안 되면 짧게 잠듦 (윈도우가 막혀 있는 동안 CPU를 태우지 않도록)
+constexpr static int SPIN_BEFORE_SLEEP = 64;
+constexpr static std::chrono::microseconds IDLE_SLEEP(50);
+
+static void backoff(int &spins)
+{
+    if (++spins < SPIN_BEFORE_SLEEP)
+    {
+        std::this_thread::yield();
+    }
+    else
+    {
+        std::this_thread::sleep_for(IDLE_SLEEP);
+    }
+}
+
+GuardL2FramePreparer::GuardL2FramePreparer(uint32_t first_seq, uint32_t last_seq, size_t workers, BuildFrameFn build_frame)
+    : first_seq_(first_seq), last_seq_(last_seq), build_frame_(std::move(build_frame))
+{
+    workers = std::max<size_t>(workers, 1);
+    for (size_t i = 0; i < workers; ++i)
+    {
+        workers_.push_back(std::make_unique<Worker>(std::max<size_t>(PIPELINE_DEPTH / workers, 2)));
+    }
+
+    // 모든 링이 준비된 뒤에 스레드 시작
+    for (size_t i = 0; i < workers; ++i)
+    {
+        workers_[i]->thread = std::jthread([this, i](std::stop_token token)
+                                           { worker_loop(token, i); });
+    }
+}
+
+void GuardL2FramePreparer::worker_loop(std::stop_token token, size_t worker_index)
+{
+    auto &ring = workers_[worker_index]->ring;
+    const uint64_t stride = workers_.size();
+
+    for (uint64_t seq = first_seq_ + worker_index; seq <= last_seq_; seq += stride)
+    {
+        std::vector<uint8_t> frame = build_frame_(static_cast<uint32_t>(seq));
+
+        int spins = 0;
+        while (!ring.try_push(std::move(frame)))
+        {
+            if (token.stop_requested())
+                return;
+            backoff(spins);
+        }
+    }
+}
+
+std::vector<uint8_t> GuardL2FramePreparer::take(uint32_t seq)
+{
+    auto &ring = workers_[(seq - first_seq_) % workers_.size()]->ring;
+
+    int spins = 0;
+    while (true)
+    {
+        if (auto frame = ring.try_pop())
+        {
+            return std::move(*frame);
+        }
+        backoff(spins);
+    }
+}
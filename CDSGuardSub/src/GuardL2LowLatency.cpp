@@ -0,0 +1,152 @@
+#include "GuardL2LowLatency.hpp"
+#include "GuardL2.hpp"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+#include <sys/socket.h>
+
+constexpr static int AUTO_BUSY_POLL_USEC = 50;
+
+// "0-3,8,10-11" 형식의 CPU 목록
+static std::vector<int> parse_cpu_list(const std::string &text)
+{
+    std::vector<int> cpus;
+    std::stringstream stream(text);
+    std::string range;
+    while (std::getline(stream, range, ','))
+    {
+        try
+        {
+            size_t dash = range.find('-');
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+        catch (const std::exception &)
+        {
+            // 빈 항목이나 줄바꿈
+        }
+    }
+    return cpus;
+}
+
+std::vector<int> guard_l2_nic_local_cpus(const std::string &interface_name)
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+
+    std::vector<int> cpus;
+    std::ifstream local_cpulist("/sys/class/net/" + interface_name + "/device/local_cpulist");
+    std::string text;
+    if (local_cpulist && std::getline(local_cpulist, text))
+    {
+        for (int cpu : parse_cpu_list(text))
+        {
+            if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))
+            {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+
+    if (cpus.empty())
+    {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &allowed))
+            {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    return cpus;
+}
+
+GuardL2LatencyProfile guard_l2_auto_latency_profile(const std::string &interface_name)
+{
+    GuardL2LatencyProfile profile;
+    profile.busy_poll_usec = AUTO_BUSY_POLL_USEC;
+
+    std::vector<int> cpus = guard_l2_nic_local_cpus(interface_name);
+    if (cpus.size() >= 2)
+    {
+        // 0번 코어는 보통 인터럽트와 다른 프로세스가 몰리므로 가능하면 피함
+        size_t first = cpus.size() >= 3 && cpus.front() == 0 ? 1 : 0;
+        profile.data_cpu = cpus[first];
+        profile.ack_cpu = cpus[first + 1];
+        profile.spin = true;
+    }
+    else if (cpus.size() == 1)
+    {
+        profile.data_cpu = cpus.front();
+        profile.ack_cpu = cpus.front();
+    }
+    return profile;
+}
+
+bool guard_l2_pin_current_thread(int cpu)
+{
+    if (cpu < 0)
+    {
+        return true;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (err != 0)
+    {
+        GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "Cannot pin thread to CPU", cpu, ":", std::strerror(err), "\n");
+        return false;
+    }
+    return true;
+}
+
+bool guard_l2_enable_busy_poll(int sock_fd, int busy_poll_usec)
+{
+    if (busy_poll_usec <= 0)
+    {
+        return true;
+    }
+
+    if (setsockopt(sock_fd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_usec, sizeof(busy_poll_usec)) < 0)
+    {
+        GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "SO_BUSY_POLL not available:", std::strerror(errno), "\n");
+        return false;
+    }
+#ifdef SO_PREFER_BUSY_POLL
+    int prefer = 1;
+    setsockopt(sock_fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &prefer, sizeof(prefer));
+#endif
+    return true;
+}
+
+int guard_l2_select_read(int max_fd, fd_set &read_fds, timeval timeout, bool spin)
+{
+    if (!spin)
+    {
+        return select(max_fd + 1, &read_fds, nullptr, nullptr, &timeout);
+    }
+
+    const fd_set watched = read_fds;
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::seconds(timeout.tv_sec) + std::chrono::microseconds(timeout.tv_usec);
+    while (true)
+    {
+        read_fds = watched;
+        timeval zero = {0, 0};
+        int ret = select(max_fd + 1, &read_fds, nullptr, nullptr, &zero);
+        if (ret != 0 || std::chrono::steady_clock::now() >= deadline)
+        {
+            return ret;
+        }
+    }
+}
@@ -0,0 +1,167 @@
+#include "GuardL2Reassembly.hpp"
+#include "GuardL2.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/mman.h>
+#include <utility>
+#include <unistd.h>
+
+std::atomic<size_t> GuardL2ReassemblyStore::memory_in_use_{0};
+std::atomic<size_t> GuardL2ReassemblyStore::memory_budget_{GuardL2ReassemblyLimits{}.memory_budget};
+std::atomic<uint64_t> GuardL2ReassemblyStore::spool_in_use_{0};
+
+static std::mutex g_limits_mutex;
+static GuardL2ReassemblyLimits g_limits;
+
+void GuardL2ReassemblyStore::set_limits(const GuardL2ReassemblyLimits &limits)
+{
+    std::lock_guard<std::mutex> lock(g_limits_mutex);
+    g_limits = limits;
+    memory_budget_.store(limits.memory_budget, std::memory_order_relaxed);
+}
+
+GuardL2ReassemblyLimits GuardL2ReassemblyStore::limits()
+{
+    std::lock_guard<std::mutex> lock(g_limits_mutex);
+    return g_limits;
+}
+
+GuardL2ReassemblyStore::~GuardL2ReassemblyStore()
+{
+    reset();
+}
+
+GuardL2ReassemblyStore::GuardL2ReassemblyStore(GuardL2ReassemblyStore &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+GuardL2ReassemblyStore &GuardL2ReassemblyStore::operator=(GuardL2ReassemblyStore &&other) noexcept
+{
+    if (this != &other)
+    {
+        reset();
+        memory_ = std::move(other.memory_);
+        base_ = std::exchange(other.base_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        reserved_bytes_ = std::exchange(other.reserved_bytes_, 0);
+        spool_reserved_bytes_ = std::exchange(other.spool_reserved_bytes_, 0);
+        mapped_ = std::exchange(other.mapped_, false);
+    }
+    return *this;
+}
+
+bool GuardL2ReassemblyStore::open(uint64_t total_size)
+{
+    reset();
+    if (total_size == 0)
+    {
+        return true;
+    }
+
+    const GuardL2ReassemblyLimits current = limits();
+    if (total_size > current.max_transfer_size)
+    {
+        GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "Transfer of", total_size, "bytes exceeds the", current.max_transfer_size, "byte limit.\n");
+        return false;
+    }
+
+    // 메모리 예산 예약 (다른 세션과 경쟁하므로 CAS)
+    if (total_size <= current.memory_threshold)
+    {
+        size_t in_use = memory_in_use_.load(std::memory_order_relaxed);
+        while (in_use + total_size <= current.memory_budget)
+        {
+            if (memory_in_use_.compare_exchange_weak(in_use, in_use + total_size, std::memory_order_relaxed))
+            {
+                reserved_bytes_ = total_size;
+                memory_.resize(total_size);
+                base_ = memory_.data();
+                size_ = total_size;
+                return true;
+            }
+        }
+        GUARD_L2_DEBUG_LOG("Reassembly memory budget exhausted (", in_use, " bytes in use). Spooling to disk.\n");
+    }
+
+    // 스풀 예산 예약 (실패하면 파일을 만들기 전에 거부)
+    uint64_t spool_in_use = spool_in_use_.load(std::memory_order_relaxed);
+    do
+    {
+        if (spool_in_use + total_size > current.spool_budget)
+        {
+            GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "Reassembly spool budget exhausted:", spool_in_use, "of", current.spool_budget,
+                                     "bytes in use. Cannot reserve", total_size, "bytes.\n");
+            return false;
+        }
+    } while (!spool_in_use_.compare_exchange_weak(spool_in_use, spool_in_use + total_size, std::memory_order_relaxed));
+    spool_reserved_bytes_ = total_size;
+
+    // 디스크 스풀: 이름 없는 파일이므로 프로세스가 죽어도 남지 않음
+    std::string path_template = (current.spool_dir / "guardl2_reassembly_XXXXXX").string();
+    int fd = mkstemp(path_template.data());
+    if (fd < 0)
+    {
+        GUARD_L2_DEBUG_ERROR_LOG("[ERROR]", "Failed to create spool file in", current.spool_dir.string(), ":", std::strerror(errno), "\n");
+        reset();
+        return false;
+    }
+    unlink(path_template.c_str());
+
+    int err = posix_fallocate(fd, 0, static_cast<off_t>(total_size));
+    if (err != 0)
+    {
+        GUARD_L2_DEBUG_ERROR_LOG("[ERROR]", "Cannot reserve", total_size, "bytes of spool space:", std::strerror(err), "\n");
+        close(fd);
+        reset();
+        return false;
+    }
+
+    void *mapping = mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // 매핑이 파일을 유지함
+    if (mapping == MAP_FAILED)
+    {
+        GUARD_L2_DEBUG_ERROR_LOG("[ERROR]", "Failed to map spool file:", std::strerror(errno), "\n");
+        reset();
+        return false;
+    }
+    madvise(mapping, total_size, MADV_SEQUENTIAL);
+
+    base_ = static_cast<uint8_t *>(mapping);
+    size_ = total_size;
+    mapped_ = true;
+    GUARD_L2_DEBUG_LOG("Reassembling ", total_size, " bytes in disk spool.\n");
+    return true;
+}
+
+void GuardL2ReassemblyStore::reset()
+{
+    if (mapped_)
+    {
+        munmap(base_, size_);
+    }
+    if (reserved_bytes_ > 0)
+    {
+        memory_in_use_.fetch_sub(reserved_bytes_, std::memory_order_relaxed);
+    }
+    if (spool_reserved_bytes_ > 0)
+    {
+        spool_in_use_.fetch_sub(spool_reserved_bytes_, std::memory_order_relaxed);
+    }
+
+    std::vector<uint8_t>().swap(memory_);
+    base_ = nullptr;
+    size_ = 0;
+    reserved_bytes_ = 0;
+    spool_reserved_bytes_ = 0;
+    mapped_ = false;
+}
+
+void GuardL2ReassemblyStore::write(uint64_t offset, std::span<const uint8_t> data)
+{
+    if (!data.empty())
+    {
+        std::memcpy(base_ + offset, data.data(), data.size());
+    }
+}
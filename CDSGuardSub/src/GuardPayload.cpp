@@ -0,0 +1,58 @@
+#include "GuardPayload.hpp"
+#include <array>
+#include "protocol/ShiftModule.h"
+#include "protocol/PaddingModule.h"
+#include "protocol/EncryptionModule.h"
+
+ProtocolEngine GetProtocolEngine(ARIAAlgorithm::Mode cipher_mode)
+{
+    ProtocolEngine engine;
+    engine.addModule(std::make_unique<ShiftModule>(8));
+    engine.addModule(std::make_unique<EncryptionModule>(std::vector<uint8_t>(32, 0x01), cipher_mode)); // 예시로 32바이트 키 사용
+    engine.addModule(std::make_unique<PaddingModule>(std::vector<uint8_t>{0,0,0,0}));
+
+    return engine;
+}
+
+std::optional<std::pair<asio::ip::tcp::endpoint, size_t>> parse_forward_header(std::span<const uint8_t> recv_data)
+{
+    if (recv_data.empty() || (recv_data[0] != 4 && recv_data[0] != 6))
+    {
+        return std::nullopt;
+    }
+    uint8_t src_ip_ver = recv_data[0];
+    uint8_t src_ip_len = src_ip_ver == 4 ? 4 : 16;
+    size_t src_info_size = 1 + src_ip_len + 2; // src_ip_ver + src_ip_len + src_port (2 bytes)
+    if (recv_data.size() <= src_info_size || (recv_data[src_info_size] != 4 && recv_data[src_info_size] != 6))
+    {
+        return std::nullopt;
+    }
+
+    uint8_t dest_ip_ver = recv_data[src_info_size];
+    uint8_t dest_ip_len = dest_ip_ver == 4 ? 4 : 16;
+    size_t dest_info_size = 1 + dest_ip_len + 2; // dest
+    size_t header_size = src_info_size + dest_info_size;
+    if (recv_data.size() < header_size)
+    {
+        return std::nullopt;
+    }
+
+    std::array<uint8_t, 16> dest_ip_bytes_arr{};
+    for (size_t i = 0; i < dest_ip_len; i++)
+    {
+        dest_ip_bytes_arr[i] = recv_data[src_info_size + 1 + i];
+    }
+
+    asio::ip::port_type dest_port = recv_data[src_info_size + 1 + dest_ip_len] << 8 | recv_data[src_info_size + 1 + dest_ip_len + 1];
+    asio::ip::address dest_ip;
+    if (dest_ip_ver == 4)
+    {
+        dest_ip = asio::ip::address_v4(asio::ip::address_v4::bytes_type(std::array<uint8_t, 4>{dest_ip_bytes_arr[0], dest_ip_bytes_arr[1], dest_ip_bytes_arr[2], dest_ip_bytes_arr[3]}));
+    }
+    else
+    {
+        dest_ip = asio::ip::address_v6(asio::ip::address_v6::bytes_type(dest_ip_bytes_arr));
+    }
+
+    return std::make_pair(asio::ip::tcp::endpoint(dest_ip, dest_port), header_size);
+}
@@ -0,0 +1,103 @@
+#include "GuardQos.hpp"
+#include "GuardL2.hpp"
+#include <cstring>
+
+std::vector<uint8_t> build_qos_segment(GuardTrafficClass traffic_class, uint64_t transfer_id, uint64_t total_size,
+                                       uint64_t offset, std::span<const uint8_t> data)
+{
+    GuardQosSegmentHeader header{};
+    header.magic = GUARD_QOS_SEGMENT_MAGIC;
+    header.traffic_class = static_cast<uint8_t>(traffic_class);
+    header.transfer_id = transfer_id;
+    header.total_size = total_size;
+    header.offset = offset;
+
+    std::vector<uint8_t> segment(sizeof(header) + data.size());
+    std::memcpy(segment.data(), &header, sizeof(header));
+    if (!data.empty())
+    {
+        std::memcpy(segment.data() + sizeof(header), data.data(), data.size());
+    }
+    return segment;
+}
+
+bool GuardQosSegmentAssembler::is_segment(std::span<const uint8_t> data)
+{
+    return data.size() >= sizeof(GuardQosSegmentHeader) &&
+           std::memcmp(data.data(), GUARD_QOS_SEGMENT_MAGIC.data(), GUARD_QOS_SEGMENT_MAGIC.size()) == 0;
+}
+
+std::optional<GuardL2ReassemblyStore> GuardQosSegmentAssembler::add(std::span<const uint8_t> segment)
+{
+    expire_stale();
+
+    GuardQosSegmentHeader header;
+    std::memcpy(&header, segment.data(), sizeof(header));
+    std::span<const uint8_t> data = segment.subspan(sizeof(header));
+    const uint64_t transfer_id = header.transfer_id;
+    const uint64_t total_size = header.total_size;
+    const uint64_t offset = header.offset;
+
+    auto it = pending_.find(transfer_id);
+    if (it == pending_.end())
+    {
+        if (offset != 0)
+        {
+            GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "QoS segment at offset", offset, "for unknown transfer", transfer_id, ". Dropped.\n");
+            return std::nullopt;
+        }
+
+        if (pending_.size() >= MAX_PENDING_TRANSFERS)
+        {
+            // 가장 오래 진척이 없는 전송을 버림
+            auto oldest = pending_.begin();
+            for (auto candidate = pending_.begin(); candidate != pending_.end(); ++candidate)
+            {
+                if (candidate->second.last_update < oldest->second.last_update)
+                {
+                    oldest = candidate;
+                }
+            }
+            GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "Too many interleaved transfers. Dropping transfer", oldest->first, "\n");
+            pending_.erase(oldest);
+        }
+
+        PendingTransfer pending;
+        if (!pending.store.open(total_size))
+        {
+            GUARD_L2_DEBUG_ERROR_LOG("[ERROR]", "Cannot reserve", total_size, "bytes for segmented transfer. Dropped.\n");
+            return std::nullopt;
+        }
+        it = pending_.emplace(transfer_id, std::move(pending)).first;
+    }
+
+    PendingTransfer &pending = it->second;
+    if (offset != pending.received || total_size != pending.store.size() ||
+        data.size() > pending.store.size() - pending.received)
+    {
+        // 조각은 전송마다 순서대로 오므로 어긋났다면 송신 측이 그 전송을 포기하고 다시 시작한 것
+        GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "Out-of-sequence QoS segment for transfer", transfer_id, ". Dropped.\n");
+        pending_.erase(it);
+        return std::nullopt;
+    }
+
+    pending.store.write(pending.received, data);
+    pending.received += data.size();
+    pending.last_update = std::chrono::steady_clock::now();
+
+    if (pending.received < pending.store.size())
+    {
+        return std::nullopt;
+    }
+
+    GuardL2ReassemblyStore complete = std::move(pending.store);
+    pending_.erase(it);
+    return complete;
+}
+
+void GuardQosSegmentAssembler::expire_stale()
+{
+    const auto now = std::chrono::steady_clock::now();
+    std::erase_if(pending_, [now](const auto &entry)
+                  { return now - entry.second.last_update > TRANSFER_TIMEOUT; });
+}
@@ -0,0 +1,392 @@
+#include "GuardUring.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+// 연결된 send_frame() 요청의 user_data
+constexpr static uint64_t SEND_FRAME_HEADER = ~0ULL - 1;
+constexpr static uint64_t SEND_FRAME_PAYLOAD = ~0ULL - 2;
+constexpr static uint64_t SEND_FRAME_TIMEOUT = ~0ULL - 4; // PROVIDE_BUFFERS_USER_DATA(~0 - 3) 다음
+
+static int io_uring_setup(unsigned entries, io_uring_params *params)
+{
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int io_uring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+    return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+static int io_uring_register(int ring_fd, unsigned opcode, void *arg, unsigned nr_args)
+{
+    return static_cast<int>(syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+}
+
+static void *map_or_throw(size_t size, int fd, off_t offset, const char *what)
+{
+    void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    if (memory == MAP_FAILED)
+    {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+    return memory;
+}
+
+GuardUring::GuardUring(unsigned entries)
+{
+    io_uring_params params{};
+    ring_fd_ = io_uring_setup(entries, &params);
+    if (ring_fd_ < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "io_uring_setup");
+    }
+
+    try
+    {
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+        {
+            sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        }
+
+        sq_ring_ = map_or_throw(sq_ring_size_, ring_fd_, IORING_OFF_SQ_RING, "io_uring SQ ring mmap");
+        cq_ring_ = (params.features & IORING_FEAT_SINGLE_MMAP)
+            ? sq_ring_
+            : map_or_throw(cq_ring_size_, ring_fd_, IORING_OFF_CQ_RING, "io_uring CQ ring mmap");
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe *>(map_or_throw(sqes_size_, ring_fd_, IORING_OFF_SQES, "io_uring SQE mmap"));
+
+        uint8_t *sq = static_cast<uint8_t *>(sq_ring_);
+        sq_head_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sq_entries_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_entries);
+        sqe_tail_ = *sq_tail_;
+
+        // SQE 번호와 배열 위치를 1:1로 고정하여 제출할 때마다 배열을 채우지 않음
+        unsigned *sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        for (unsigned i = 0; i < sq_entries_; ++i)
+        {
+            sq_array[i] = i;
+        }
+
+        uint8_t *cq = static_cast<uint8_t *>(cq_ring_);
+        cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+        // 프레임 헤더처럼 작은 쓰기를 위한 고정 버퍼 0번
+        fixed_region_ = static_cast<uint8_t *>(mmap(nullptr, FIXED_REGION_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (fixed_region_ == MAP_FAILED)
+        {
+            fixed_region_ = nullptr;
+            throw std::system_error(errno, std::generic_category(), "io_uring fixed buffer mmap");
+        }
+        iovec fixed{fixed_region_, FIXED_REGION_SIZE};
+        if (io_uring_register(ring_fd_, IORING_REGISTER_BUFFERS, &fixed, 1) < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "IORING_REGISTER_BUFFERS");
+        }
+    }
+    catch (...)
+    {
+        release();
+        throw;
+    }
+}
+
+GuardUring::~GuardUring()
+{
+    release();
+}
+
+void GuardUring::release()
+{
+    // 링을 닫으면 등록한 버퍼와 버퍼 링도 함께 해제됨
+    if (ring_fd_ >= 0)
+    {
+        close(ring_fd_);
+        ring_fd_ = -1;
+    }
+    if (sqes_)
+    {
+        munmap(sqes_, sqes_size_);
+        sqes_ = nullptr;
+    }
+    if (cq_ring_ && cq_ring_ != sq_ring_)
+    {
+        munmap(cq_ring_, cq_ring_size_);
+    }
+    cq_ring_ = nullptr;
+    if (sq_ring_)
+    {
+        munmap(sq_ring_, sq_ring_size_);
+        sq_ring_ = nullptr;
+    }
+    if (buffers_)
+    {
+        munmap(buffers_, buffers_size_);
+        buffers_ = nullptr;
+    }
+    if (fixed_region_)
+    {
+        munmap(fixed_region_, FIXED_REGION_SIZE);
+        fixed_region_ = nullptr;
+    }
+}
+
+bool GuardUring::supported()
+{
+    static const bool result = []
+    {
+        // 멀티샷 recv는 6.0부터. 플래그는 probe로 알 수 없으므로 버전으로 판단
+        utsname name{};
+        int major = 0, minor = 0;
+        if (uname(&name) != 0 || std::sscanf(name.release, "%d.%d", &major, &minor) != 2 || major < 6)
+        {
+            return false;
+        }
+
+        try
+        {
+            GuardUring probe_ring(8);
+
+            constexpr unsigned PROBE_OPS = 256;
+            std::vector<uint8_t> probe_memory(sizeof(io_uring_probe) + PROBE_OPS * sizeof(io_uring_probe_op));
+            io_uring_probe *probe = reinterpret_cast<io_uring_probe *>(probe_memory.data());
+            if (io_uring_register(probe_ring.ring_fd_, IORING_REGISTER_PROBE, probe, PROBE_OPS) < 0)
+            {
+                return false;
+            }
+            for (uint8_t op : {IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SEND, IORING_OP_WRITE_FIXED, IORING_OP_READ,
+                               IORING_OP_ASYNC_CANCEL, IORING_OP_PROVIDE_BUFFERS})
+            {
+                if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        catch (const std::exception &)
+        {
+            // 컨테이너 seccomp, io_uring_disabled sysctl 등
+            return false;
+        }
+    }();
+    return result;
+}
+
+io_uring_sqe *GuardUring::get_sqe()
+{
+    if (sqe_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_)
+    {
+        submit();
+        if (sqe_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_)
+        {
+            return nullptr;
+        }
+    }
+    io_uring_sqe *sqe = &sqes_[sqe_tail_ & sq_mask_];
+    std::memset(sqe, 0, sizeof(*sqe));
+    ++sqe_tail_;
+    return sqe;
+}
+
+int GuardUring::submit(unsigned wait_nr)
+{
+    const unsigned to_submit = sqe_tail_ - *sq_tail_;
+    __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+
+    int ret = io_uring_enter(ring_fd_, to_submit, wait_nr, wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0);
+    if (ret < 0)
+    {
+        return errno == EINTR ? 0 : -errno;
+    }
+    return ret;
+}
+
+void GuardUring::provide_buffers(uint16_t group, unsigned count, size_t buffer_size)
+{
+    buffers_size_ = count * buffer_size;
+    void *buffers = mmap(nullptr, buffers_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffers == MAP_FAILED)
+    {
+        throw std::system_error(errno, std::generic_category(), "io_uring provided buffers mmap");
+    }
+    buffers_ = static_cast<uint8_t *>(buffers);
+    buffer_size_ = buffer_size;
+    buffer_group_ = group;
+
+    io_uring_sqe *sqe = get_sqe();
+    sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe->fd = static_cast<int>(count);
+    sqe->addr = reinterpret_cast<uint64_t>(buffers_);
+    sqe->len = static_cast<uint32_t>(buffer_size);
+    sqe->off = 0; // 첫 버퍼 번호
+    sqe->buf_group = group;
+    sqe->flags = IOSQE_CQE_SKIP_SUCCESS;
+    sqe->user_data = PROVIDE_BUFFERS_USER_DATA;
+}
+
+std::span<const uint8_t> GuardUring::provided_buffer(uint16_t buffer_id, size_t length) const
+{
+    return {buffers_ + static_cast<size_t>(buffer_id) * buffer_size_, std::min(length, buffer_size_)};
+}
+
+void GuardUring::recycle_buffer(uint16_t buffer_id)
+{
+    io_uring_sqe *sqe = get_sqe();
+    sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe->fd = 1;
+    sqe->addr = reinterpret_cast<uint64_t>(buffers_ + static_cast<size_t>(buffer_id) * buffer_size_);
+    sqe->len = static_cast<uint32_t>(buffer_size_);
+    sqe->off = buffer_id;
+    sqe->buf_group = buffer_group_;
+    sqe->flags = IOSQE_CQE_SKIP_SUCCESS;
+    sqe->user_data = PROVIDE_BUFFERS_USER_DATA;
+}
+
+void GuardUring::prep_multishot_accept(int listen_fd, uint64_t user_data)
+{
+    io_uring_sqe *sqe = get_sqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listen_fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = user_data;
+}
+
+void GuardUring::prep_multishot_recv(int fd, uint16_t group, uint64_t user_data)
+{
+    io_uring_sqe *sqe = get_sqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = group;
+    sqe->user_data = user_data;
+}
+
+void GuardUring::prep_read(int fd, void *buffer, size_t length, uint64_t user_data)
+{
+    io_uring_sqe *sqe = get_sqe();
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(buffer);
+    sqe->len = static_cast<uint32_t>(length);
+    sqe->off = static_cast<uint64_t>(-1);
+    sqe->user_data = user_data;
+}
+
+void GuardUring::prep_cancel(uint64_t target_user_data, uint64_t user_data)
+{
+    io_uring_sqe *sqe = get_sqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = target_user_data;
+    sqe->user_data = user_data;
+}
+
+asio::error_code GuardUring::send_frame(int fd, std::span<const uint8_t> header, std::span<const uint8_t> payload,
+                                        std::chrono::milliseconds timeout, size_t &payload_sent)
+{
+    payload_sent = 0;
+    if (header.size() > FIXED_REGION_SIZE)
+    {
+        return asio::error::message_size;
+    }
+    std::memcpy(fixed_region_, header.data(), header.size());
+
+    // 두 요청이 공유하는 시간 제한. 커널이 제출 시점에 읽으므로 고정 버퍼처럼 멤버에 둠
+    send_deadline_.tv_sec = timeout.count() / 1000;
+    send_deadline_.tv_nsec = (timeout.count() % 1000) * 1000000;
+
+    auto prep_link_timeout = [&](bool link_next)
+    {
+        io_uring_sqe *timeout_sqe = get_sqe();
+        timeout_sqe->opcode = IORING_OP_LINK_TIMEOUT;
+        timeout_sqe->fd = -1;
+        timeout_sqe->addr = reinterpret_cast<uint64_t>(&send_deadline_);
+        timeout_sqe->len = 1;
+        timeout_sqe->flags = link_next ? IOSQE_IO_LINK : 0;
+        timeout_sqe->user_data = SEND_FRAME_TIMEOUT;
+    };
+
+    io_uring_sqe *header_sqe = get_sqe();
+    header_sqe->opcode = IORING_OP_WRITE_FIXED;
+    header_sqe->fd = fd;
+    header_sqe->addr = reinterpret_cast<uint64_t>(fixed_region_);
+    header_sqe->len = static_cast<uint32_t>(header.size());
+    header_sqe->off = static_cast<uint64_t>(-1);
+    header_sqe->buf_index = 0;
+    header_sqe->flags = IOSQE_IO_LINK; // 헤더가 다 나가야 페이로드를 보냄
+    header_sqe->user_data = SEND_FRAME_HEADER;
+    prep_link_timeout(true);
+
+    io_uring_sqe *payload_sqe = get_sqe();
+    payload_sqe->opcode = IORING_OP_SEND;
+    payload_sqe->fd = fd;
+    payload_sqe->addr = reinterpret_cast<uint64_t>(payload.data());
+    payload_sqe->len = static_cast<uint32_t>(payload.size());
+    payload_sqe->msg_flags = MSG_WAITALL | MSG_NOSIGNAL;
+    payload_sqe->flags = IOSQE_IO_LINK;
+    payload_sqe->user_data = SEND_FRAME_PAYLOAD;
+    prep_link_timeout(false);
+
+    int header_result = -ECANCELED;
+    int payload_result = -ECANCELED;
+    bool timed_out = false;
+    unsigned completed = 0;
+    while (completed < 4)
+    {
+        int ret = submit(1);
+        if (ret < 0)
+        {
+            return asio::error_code(-ret, asio::error::get_system_category());
+        }
+        completed += for_each_cqe([&](const io_uring_cqe &cqe)
+        {
+            if (cqe.user_data == SEND_FRAME_TIMEOUT)
+            {
+                timed_out |= cqe.res == -ETIME;
+            }
+            else
+            {
+                (cqe.user_data == SEND_FRAME_HEADER ? header_result : payload_result) = cqe.res;
+            }
+        });
+    }
+
+    if (header_result != static_cast<int>(header.size()))
+    {
+        // 헤더가 잘렸으면 스트림이 어긋났으므로 연결을 버리게 함
+        if (timed_out)
+        {
+            return asio::error::timed_out;
+        }
+        return asio::error_code(header_result < 0 ? -header_result : EIO, asio::error::get_system_category());
+    }
+    if (payload_result < 0)
+    {
+        if (timed_out)
+        {
+            return asio::error::timed_out;
+        }
+        return asio::error_code(-payload_result, asio::error::get_system_category());
+    }
+
+    payload_sent = static_cast<size_t>(payload_result);
+    return {};
+}
@@ -0,0 +1,249 @@
+#include "GuardUringIngest.hpp"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <system_error>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// user_data 상위 8비트는 요청 종류, 나머지는 연결 번호
+enum class UringIngestKind : uint64_t {
+    ACCEPT = 1,
+    RECV   = 2,
+    WAKE   = 3,
+    CANCEL = 4,
+};
+
+constexpr static int KIND_SHIFT = 56;
+constexpr static uint64_t CONNECTION_MASK = (uint64_t{1} << KIND_SHIFT) - 1;
+
+static uint64_t make_user_data(UringIngestKind kind, uint64_t id = 0)
+{
+    return (static_cast<uint64_t>(kind) << KIND_SHIFT) | (id & CONNECTION_MASK);
+}
+
+static std::string peer_name(int fd)
+{
+    sockaddr_storage address{};
+    socklen_t length = sizeof(address);
+    if (getpeername(fd, reinterpret_cast<sockaddr *>(&address), &length) != 0)
+    {
+        return "unknown";
+    }
+
+    char text[INET6_ADDRSTRLEN] = {};
+    uint16_t port = 0;
+    if (address.ss_family == AF_INET6)
+    {
+        const sockaddr_in6 *in6 = reinterpret_cast<const sockaddr_in6 *>(&address);
+        inet_ntop(AF_INET6, &in6->sin6_addr, text, sizeof(text));
+        port = ntohs(in6->sin6_port);
+    }
+    else
+    {
+        const sockaddr_in *in = reinterpret_cast<const sockaddr_in *>(&address);
+        inet_ntop(AF_INET, &in->sin_addr, text, sizeof(text));
+        port = ntohs(in->sin_port);
+    }
+    return std::string(text) + ":" + std::to_string(port);
+}
+
+GuardUringIngest::GuardUringIngest(int listen_fd, SendTransferQueue &queue, Completion on_complete)
+    : listen_fd_(listen_fd), queue_(queue), on_complete_(std::move(on_complete)), wake_fd_(eventfd(0, EFD_CLOEXEC))
+{
+    if (wake_fd_ < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "eventfd");
+    }
+}
+
+GuardUringIngest::~GuardUringIngest()
+{
+    for (auto &[id, connection] : connections_)
+    {
+        close(connection.fd);
+    }
+    close(wake_fd_);
+}
+
+void GuardUringIngest::run(std::stop_token token)
+{
+    GuardUring ring(RING_ENTRIES);
+    ring.provide_buffers(BUFFER_GROUP, BUFFER_COUNT, BUFFER_SIZE);
+
+    std::stop_callback wake_on_stop(token, [this]
+    {
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t n = write(wake_fd_, &one, sizeof(one));
+    });
+
+    ring.prep_multishot_accept(listen_fd_, make_user_data(UringIngestKind::ACCEPT));
+    ring.prep_read(wake_fd_, &wake_value_, sizeof(wake_value_), make_user_data(UringIngestKind::WAKE));
+
+    while (!token.stop_requested())
+    {
+        int ret = ring.submit(1);
+        if (ret < 0)
+        {
+            throw std::system_error(-ret, std::generic_category(), "io_uring_enter");
+        }
+
+        ring.for_each_cqe([&](const io_uring_cqe &cqe)
+        {
+            const uint64_t id = cqe.user_data & CONNECTION_MASK;
+            switch (static_cast<UringIngestKind>(cqe.user_data >> KIND_SHIFT))
+            {
+            case UringIngestKind::ACCEPT:
+                on_accept(ring, cqe);
+                break;
+            case UringIngestKind::RECV:
+                on_recv(ring, id, cqe);
+                break;
+            case UringIngestKind::WAKE:
+                ring.prep_read(wake_fd_, &wake_value_, sizeof(wake_value_), make_user_data(UringIngestKind::WAKE));
+                resume_connections(ring);
+                break;
+            case UringIngestKind::CANCEL:
+                break; // 취소된 recv 자체의 완료(-ECANCELED)에서 처리
+            default:
+                if (cqe.user_data == GuardUring::PROVIDE_BUFFERS_USER_DATA)
+                {
+                    std::cerr << "[SendMode] io_uring buffer provide failed: " << std::strerror(-cqe.res) << std::endl;
+                }
+                break;
+            }
+        });
+    }
+}
+
+void GuardUringIngest::on_accept(GuardUring &ring, const io_uring_cqe &cqe)
+{
+    if (!(cqe.flags & IORING_CQE_F_MORE))
+    {
+        // 멀티샷이 끝남 (오류 또는 커널이 멈춤). 다시 걸어 둠
+        ring.prep_multishot_accept(listen_fd_, make_user_data(UringIngestKind::ACCEPT));
+    }
+
+    if (cqe.res < 0)
+    {
+        std::cerr << "[SendMode] Accept error: " << std::strerror(-cqe.res) << std::endl;
+        return;
+    }
+
+    const uint64_t id = next_connection_id_++;
+    Connection &connection = connections_[id];
+    connection.fd = cqe.res;
+    connection.source = peer_name(cqe.res);
+    arm_recv(ring, id, connection);
+}
+
+void GuardUringIngest::on_recv(GuardUring &ring, uint64_t id, const io_uring_cqe &cqe)
+{
+    auto it = connections_.find(id);
+    if (it == connections_.end())
+    {
+        return;
+    }
+    Connection &connection = it->second;
+
+    if (!(cqe.flags & IORING_CQE_F_MORE))
+    {
+        connection.armed = false;
+    }
+
+    if (cqe.flags & IORING_CQE_F_BUFFER)
+    {
+        const uint16_t buffer_id = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+        if (cqe.res > 0)
+        {
+            std::span<const uint8_t> data = ring.provided_buffer(buffer_id, static_cast<size_t>(cqe.res));
+            connection.buffer.insert(connection.buffer.end(), data.begin(), data.end());
+            queue_.add_ingress(data.size());
+        }
+        ring.recycle_buffer(buffer_id);
+    }
+
+    if (cqe.res == 0)
+    {
+        std::vector<uint8_t> payload = std::move(connection.buffer);
+        const std::string source = std::move(connection.source);
+        close_connection(id);
+        on_complete_(std::move(payload), source);
+        return;
+    }
+
+    // ENOBUFS: 제공 버퍼가 잠시 모자랐음. ECANCELED: 예산 대기로 취소함. 둘 다 연결은 유지
+    if (cqe.res < 0 && cqe.res != -ENOBUFS && cqe.res != -ECANCELED)
+    {
+        std::cerr << "[SendMode] Read error from " << connection.source << ": " << std::strerror(-cqe.res) << std::endl;
+        queue_.drop_ingress(connection.buffer.size());
+        close_connection(id);
+        return;
+    }
+
+    if (!connection.paused && queue_.should_pause())
+    {
+        // 이미 받은 완료는 그대로 쌓고, 더 받지 않도록 recv를 취소한 뒤 예산이 풀리기를 기다림
+        connection.paused = true;
+        if (connection.armed)
+        {
+            ring.prep_cancel(make_user_data(UringIngestKind::RECV, id), make_user_data(UringIngestKind::CANCEL, id));
+        }
+        queue_.wait_for_budget([this, id]
+        {
+            {
+                std::lock_guard<std::mutex> lock(resumed_mutex_);
+                resumed_.push_back(id);
+            }
+            uint64_t one = 1;
+            [[maybe_unused]] ssize_t n = write(wake_fd_, &one, sizeof(one));
+        });
+        return;
+    }
+
+    if (!connection.paused && !connection.armed)
+    {
+        arm_recv(ring, id, connection);
+    }
+}
+
+void GuardUringIngest::arm_recv(GuardUring &ring, uint64_t id, Connection &connection)
+{
+    ring.prep_multishot_recv(connection.fd, BUFFER_GROUP, make_user_data(UringIngestKind::RECV, id));
+    connection.armed = true;
+}
+
+void GuardUringIngest::resume_connections(GuardUring &ring)
+{
+    std::vector<uint64_t> resumed;
+    {
+        std::lock_guard<std::mutex> lock(resumed_mutex_);
+        resumed.swap(resumed_);
+    }
+
+    for (uint64_t id : resumed)
+    {
+        auto it = connections_.find(id);
+        if (it == connections_.end())
+        {
+            continue; // 기다리는 사이 EOF로 끝난 연결
+        }
+        it->second.paused = false;
+        if (!it->second.armed)
+        {
+            arm_recv(ring, id, it->second);
+        }
+    }
+}
+
+void GuardUringIngest::close_connection(uint64_t id)
+{
+    auto it = connections_.find(id);
+    if (it != connections_.end())
+    {
+        close(it->second.fd);
+        connections_.erase(it);
+    }
+}
@@ -1,4 +1,11 @@
+#include "RecvMode.h"
 #include "GuardL2.hpp"
+#include "GuardL2Dedup.hpp"
+#include "GuardQos.hpp"
+#include "ForwardConnectionPool.hpp"
+#include "BoundedQueue.hpp"
+#include "ForwardSpool.hpp"
+#include "GuardPayload.hpp"
 #include "Utils.hpp"
 #include <iostream>
 #include <vector>
@@ -8,152 +15,366 @@
 #include <chrono>
 #include <iomanip>
 #include <sstream>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <optional>
+#include <thread>
 #include <asio.hpp>
-#include "protocol/ProtocolEngine.h"
-#include "protocol/ShiftModule.h"
-#include "protocol/PaddingModule.h"
-#include "protocol/EncryptionModule.h"
 
-ProtocolEngine GetProtocolEngine()
+// 단계 사이 대기열 크기 (전송 건수). 재조립 저장소가 메모리 예산을 계속 점유하므로 너무 크게 잡지 않음
+constexpr static size_t RECV_STAGE_QUEUE_CAPACITY = 32;
+
+/**
+ * @brief L2로 받은 전송 하나. 복원 단계에서 순서 번호를 받고, 재조립 저장소를 그대로 넘겨 복사하지 않음
+ */
+struct RecvTransfer
 {
-    ProtocolEngine engine;
-    engine.addModule(std::make_unique<ShiftModule>(8));
-    engine.addModule(std::make_unique<EncryptionModule>(std::vector<uint8_t>(32, 0x01))); // 예시로 32바이트 키 사용
-    engine.addModule(std::make_unique<PaddingModule>(std::vector<uint8_t>{0,0,0,0}));
+    uint64_t seq = 0;
+    GuardL2ReassemblyStore store;
+    std::optional<std::vector<uint8_t>> restored; // dedup 스트림이면 복원된 데이터
+    bool plaintext = false;                       // 봉인된 dedup 스트림에서 복원하여 이미 복호화된 페이로드
 
-    return engine;
-}
+    std::span<const uint8_t> data() const
+    {
+        return restored ? std::span<const uint8_t>(*restored) : store.data();
+    }
+};
 
-void run_recv_mode(const std::string &interface_name)
+/**
+ * @brief 복호화를 마친 전달 대상. 헤더가 잘못된 전송도 순서를 채우기 위해 endpoint 없이 전달 단계로 보냄
+ */
+struct ForwardItem
 {
-    const static ProtocolEngine protocol_engine = GetProtocolEngine();
+    uint64_t seq = 0;
+    std::optional<asio::ip::tcp::endpoint> endpoint;
+    std::vector<uint8_t> payload;
+};
 
-    std::cout << "[*] RECV MODE: Listening on L2 for frames on interface " << interface_name << "...\n";
+/**
+ * @brief 수신 → 복원 → 복호화(작업 스레드 N개) → 전달 단계 사이의 대기열
+ * @details 수신 스레드는 전송을 넘기기만 하므로 복호화나 목적지 I/O를 기다리지 않음.
+ *          모든 단계가 밀려 대기열이 차면 그때만 수신 스레드가 멈춤
+ */
+struct RecvPipeline
+{
+    BoundedQueue<RecvTransfer> restore_queue{RECV_STAGE_QUEUE_CAPACITY};
+    BoundedQueue<RecvTransfer> decrypt_queue{RECV_STAGE_QUEUE_CAPACITY};
+    BoundedQueue<ForwardItem> forward_queue{RECV_STAGE_QUEUE_CAPACITY};
+    std::atomic<size_t> reorder_pending{0}; // 앞 순번을 기다리며 전달 단계에 묶여 있는 수
 
-    try
+    void log_depths() const
     {
-        std::array<uint8_t, 6> self_mac = get_mac_address(interface_name);
+        std::cout << "[RECV-MODE] Stage queues: restore " << restore_queue.depth() << "/" << restore_queue.capacity()
+                  << " (max " << restore_queue.high_watermark() << ")"
+                  << ", decrypt " << decrypt_queue.depth() << "/" << decrypt_queue.capacity()
+                  << " (max " << decrypt_queue.high_watermark() << ")"
+                  << ", forward " << forward_queue.depth() << "/" << forward_queue.capacity()
+                  << " (max " << forward_queue.high_watermark() << ")"
+                  << ", reorder " << reorder_pending.load(std::memory_order_relaxed) << "\n";
+    }
+};
 
-        char mac_str[18];
-        snprintf(mac_str, sizeof(mac_str), "%02x:%02x:%02x:%02x:%02x:%02x",
-                 self_mac[0], self_mac[1], self_mac[2], self_mac[3], self_mac[4], self_mac[5]);
-        std::cout << "[*] My MAC address is: " << mac_str << "\n";
+/**
+ * @brief 복원 단계: dedup 청크 캐시는 송신 순서대로 갱신되어야 하므로 스레드 하나에서 처리하고 순서 번호를 매김
+ * @details --qos 조각은 여기서 원래 전송으로 합치며, 완성된 순서대로 번호를 받음.
+ *          봉인된 dedup 스트림은 캐시 순서 때문에 복호화 작업 스레드로 넘기지 못하고 여기서 풀어 평문으로 복원함
+ */
+static void restore_stage(std::stop_token token, RecvPipeline &pipeline, const ProtocolEngine &protocol_engine)
+{
+    GuardL2DedupDecoder dedup_decoder;
+    GuardQosSegmentAssembler segment_assembler;
+    uint64_t next_seq = 0;
 
-        // GuardL2Receiver 객체를 생성. 생성자에서 Raw 소켓 생성 및 바인딩이 이루어짐짐
-        GuardL2Receiver l2_receiver(interface_name, self_mac);
-        asio::io_context ctx;
+    while (std::optional<RecvTransfer> transfer = pipeline.restore_queue.pop(token))
+    {
+        // 송신 측이 --dedup으로 보낸 스트림이면 복호화한 뒤 청크 캐시로 원래 페이로드(평문)를 복원
+        if (GuardL2DedupDecoder::is_sealed_stream(transfer->store.data()))
+        {
+            std::vector<uint8_t> stream;
+            try
+            {
+                stream = protocol_engine.decrypt(GuardL2DedupDecoder::sealed_payload(transfer->store.data()));
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "[RECV-MODE] Failed to decrypt deduplicated stream: " << e.what() << ". Dropped.\n";
+                continue;
+            }
 
-        // 3무한 루프를 돌며 계속해서 새로운 데이터 전송을 대기
-        while (true)
+            transfer->restored = dedup_decoder.decode(stream);
+            if (!transfer->restored)
+            {
+                std::cerr << "[RECV-MODE] Failed to restore deduplicated stream. Dropped.\n";
+                continue;
+            }
+            transfer->plaintext = true;
+            transfer->store.reset(); // 복원본만 있으면 되므로 재조립 예산을 바로 돌려줌
+        }
+
+        // 송신 측이 --qos로 나누어 보낸 조각이면 모든 조각이 모일 때까지 보관
+        if (GuardQosSegmentAssembler::is_segment(transfer->data()))
         {
-            // 데이터 수신을 시작합니다.  START -> DATA -> END 프로토콜 전체가 완료될 때까지 블로킹됩니다.
-            std::vector<uint8_t> recv_data = l2_receiver.receive_reliable_data();
+            std::optional<GuardL2ReassemblyStore> assembled = segment_assembler.add(transfer->data());
+            if (!assembled)
+            {
+                continue;
+            }
+            transfer->restored.reset();
+            transfer->store = std::move(*assembled);
+            std::cout << "[RECV-MODE] Reassembled " << transfer->store.size() << " bytes from segments ("
+                      << segment_assembler.pending_transfers() << " interleaved transfer(s) still open).\n";
+        }
 
-            // 데이터 수신 성공 여부를 확인
-            if (!recv_data.empty())
+        transfer->seq = next_seq++;
+        if (!pipeline.decrypt_queue.push(std::move(*transfer), token))
+        {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 복호화 단계: 작업 스레드 여러 개가 동시에 처리하므로 전달 단계에는 순서가 섞여 도착함
+ */
+static void decrypt_stage(std::stop_token token, RecvPipeline &pipeline, const ProtocolEngine &protocol_engine)
+{
+    while (std::optional<RecvTransfer> transfer = pipeline.decrypt_queue.pop(token))
+    {
+        ForwardItem item;
+        item.seq = transfer->seq;
+
+        std::span<const uint8_t> recv_data = transfer->data();
+        auto header = parse_forward_header(recv_data);
+        if (!header)
+        {
+            std::cerr << "[RECV-MODE] Malformed forwarding header (" << recv_data.size() << " bytes). Dropped.\n";
+        }
+        else
+        {
+            try
+            {
+                std::span<const uint8_t> body = recv_data.subspan(header->second);
+                item.payload = transfer->plaintext ? std::vector<uint8_t>(body.begin(), body.end()) : protocol_engine.decrypt(body);
+                item.endpoint = header->first;
+            }
+            catch (const std::exception &e)
             {
-                std::cout << "\n[RECV-MODE] Successfully received " << recv_data.size() << " bytes of data.\n";
+                std::cerr << "[RECV-MODE] Decryption failed: " << e.what() << ". Dropped.\n";
+            }
+        }
 
-                uint8_t src_ip_ver = recv_data[0];
-                uint8_t src_ip_len = src_ip_ver == 4 ? 4 : 16;
-                uint8_t dest_ip_ver = recv_data[1 + src_ip_len + 2];
-                uint8_t dest_ip_len = dest_ip_ver == 4 ? 4 : 16;
+        transfer.reset(); // 저장소(메모리 예산/스풀 매핑)를 전달 대기 전에 반납
+        if (!pipeline.forward_queue.push(std::move(item), token))
+        {
+            return;
+        }
+    }
+}
 
-                size_t src_info_size = 1 + src_ip_len + 2; // src_ip_ver + src_ip_len + src_port (2 bytes)
-                size_t dest_info_size = 1 + dest_ip_len + 2; // dest
-                size_t header_size = src_info_size + dest_info_size;
+/**
+ * @brief 전달 전용 연결로 한 번 보내고 닫음 (--forward-pool 미지정 시)
+ * length_framing이면 지속 연결과 같은 8바이트 빅엔디언 길이를 앞에 붙임
+ */
+static asio::error_code forward_once(asio::io_context &ctx, const asio::ip::tcp::endpoint &dest_endpoint, std::span<const uint8_t> payload,
+                                     bool length_framing)
+{
+    asio::ip::tcp::socket send_sock(ctx);
+    asio::error_code ec = ForwardConnectionPool::connect_with_timeout(send_sock, dest_endpoint, FORWARD_CONNECT_TIMEOUT);
+    if (!ec)
+    {
+        std::array<uint8_t, ForwardConnectionPool::FRAME_HEADER_SIZE> header{};
+        for (size_t i = 0; i < header.size(); ++i)
+        {
+            header[i] = static_cast<uint8_t>(static_cast<uint64_t>(payload.size()) >> (8 * (header.size() - 1 - i)));
+        }
+        std::array<asio::const_buffer, 2> buffers = {asio::buffer(header), asio::buffer(payload.data(), payload.size())};
+        // 연결만 받고 읽지 않는 목적지에 묶이지 않도록 쓰기도 시간 제한. 실패하면 호출자가 스풀/백오프로 넘김
+        std::span<const asio::const_buffer> frame = length_framing ? std::span<const asio::const_buffer>(buffers)
+                                                                   : std::span<const asio::const_buffer>(buffers).subspan(1);
+        ec = ForwardConnectionPool::write_with_timeout(send_sock, frame, FORWARD_WRITE_TIMEOUT);
+    }
 
-                std::array<uint8_t, 16> src_ip_bytes_arr;
-                std::array<uint8_t, 16> dest_ip_bytes_arr;
+    asio::error_code ignored;
+    send_sock.close(ignored);
+    return ec;
+}
 
-                for (size_t i = 0; i < src_ip_len; i++)
-                {
-                    src_ip_bytes_arr[i] = recv_data[1 + i];
-                }
-                
-                for (size_t i = 0; i < dest_ip_len; i++)
-                {
-                    dest_ip_bytes_arr[i] = recv_data[src_info_size + 1 + i];
-                }
-                
-                asio::ip::port_type src_port = recv_data[1 + src_ip_len] << 8 | recv_data[1 + src_ip_len + 1];
-                asio::ip::port_type dest_port = recv_data[src_info_size + 1 + dest_ip_len] << 8 | recv_data[src_info_size + 1 + dest_ip_len + 1];
-                asio::ip::address src_ip;
-                asio::ip::address dest_ip;
+/**
+ * @brief 전달 단계: 복호화가 끝난 순서대로가 아니라 수신한 순서대로 목적지에 씀
+ */
+static void forward_stage(std::stop_token token, RecvPipeline &pipeline, const GuardOptions &options)
+{
+    asio::io_context ctx;
 
-                if (src_ip_ver == 4)
-                {
-                    src_ip = asio::ip::address_v4(asio::ip::address_v4::bytes_type(std::array<uint8_t, 4>{src_ip_bytes_arr[0], src_ip_bytes_arr[1], src_ip_bytes_arr[2], src_ip_bytes_arr[3]}));
-                }
-                else if (src_ip_ver == 6)
-                {
-                    src_ip = asio::ip::address_v6(asio::ip::address_v6::bytes_type(src_ip_bytes_arr));
-                }
-                
-                if (dest_ip_ver == 4)
-                {
-                    dest_ip = asio::ip::address_v4(asio::ip::address_v4::bytes_type(std::array<uint8_t, 4>{dest_ip_bytes_arr[0], dest_ip_bytes_arr[1], dest_ip_bytes_arr[2], dest_ip_bytes_arr[3]}));
-                }
-                else if (dest_ip_ver == 6)
-                {
-                    dest_ip = asio::ip::address_v6(asio::ip::address_v6::bytes_type(dest_ip_bytes_arr));
-                }
-                
-                asio::ip::tcp::endpoint dest_endpoint(dest_ip, dest_port);
-                std::error_code ec;
-                
-                asio::ip::tcp::socket send_sock(ctx);
-                send_sock.open(dest_endpoint.protocol(), ec);
-                
-                std::vector<uint8_t> decrypted_data = protocol_engine.decrypt(std::span<const uint8_t>{recv_data.begin() + header_size, recv_data.end()});
-
-                if (ec)
-                {
-                    std::cerr << "[RECV-MODE] Error opening socket: " << ec.message() << "\n";
-                    continue; // 소켓 열기에 실패하면 다음 루프로 넘어갑니다.
-                }
+    // --forward-pool: 목적지별 지속 연결로 전달 (지정하지 않으면 전달마다 연결 후 종료, 경계는 --forward-framing)
+    std::optional<ForwardConnectionPool> forward_pool;
+    if (options.forward_pool_size > 0)
+    {
+        ForwardPoolConfig pool_config;
+        pool_config.max_idle_per_destination = options.forward_pool_size;
+        pool_config.use_io_uring = options.io_uring;
+        forward_pool.emplace(ctx, pool_config);
+    }
 
-                send_sock.connect(dest_endpoint, ec);
-                if (ec)
-                {
-                    std::cerr << "[RECV-MODE] Error connecting to " << dest_endpoint << ": " << ec.message() << "\n";
-                    send_sock.close();
-                    continue;
-                }
+    auto send = [&](const asio::ip::tcp::endpoint &endpoint, std::span<const uint8_t> payload)
+    {
+        return forward_pool ? forward_pool->send(endpoint, payload) : forward_once(ctx, endpoint, payload, options.forward_length_framing);
+    };
 
-                asio::write(send_sock, asio::buffer(decrypted_data), ec);
+    // 송신 측은 다시 보낼 수 없으므로 전달하지 못한 페이로드는 디스크에 보관했다가 목적지가 살아나면 순서대로 보냄
+    std::optional<ForwardSpool> spool;
+    if (options.forward_spool_mb > 0)
+    {
+        ForwardSpoolConfig spool_config;
+        spool_config.dir = std::filesystem::path(options.spool_dir) / "forward";
+        spool_config.max_bytes = options.forward_spool_mb * 1024 * 1024;
+        spool_config.sync = options.spool_sync;
+        spool.emplace(spool_config);
+    }
 
-                if (ec)
-                {
-                    std::cerr << "[RECV-MODE] Error sending data: " << ec.message() << "\n";
-                }
-                else
+    std::map<uint64_t, ForwardItem> reorder;
+    uint64_t next_seq = 0;
+
+    while (!token.stop_requested())
+    {
+        // 스풀에 재전달/동기화할 것이 있으면 그때까지만 기다림
+        std::optional<std::chrono::milliseconds> wakeup = spool ? spool->next_wakeup() : std::nullopt;
+        std::optional<ForwardItem> arrived = wakeup ? pipeline.forward_queue.pop_for(*wakeup, token)
+                                                    : pipeline.forward_queue.pop(token);
+        if (arrived)
+        {
+            reorder.emplace(arrived->seq, std::move(*arrived));
+        }
+
+        for (auto it = reorder.find(next_seq); it != reorder.end(); it = reorder.find(next_seq))
+        {
+            ForwardItem item = std::move(it->second);
+            reorder.erase(it);
+            ++next_seq;
+
+            if (!item.endpoint)
+            {
+                continue;
+            }
+
+            // 보관된 것이 남은 목적지는 순서를 지키기 위해 뒤에 붙임
+            if (spool && spool->has_pending(*item.endpoint))
+            {
+                if (!spool->append(*item.endpoint, item.payload))
                 {
-                    std::cout << "[RECV-MODE] Data sent successfully to " << dest_ip.to_string() << ":" << dest_port << "\n";
+                    std::cerr << "[RECV-MODE] Cannot spool payload for " << *item.endpoint << ". Dropped.\n";
                 }
-                
-                send_sock.close();
-                // 수신된 데이터를 고유한 이름의 파일로 저장
-                
-                // 파일 이름 생성을 위한 타임스탬프
-                // auto now = std::chrono::system_clock::now();
-                // auto in_time_t = std::chrono::system_clock::to_time_t(now);
-                // std::stringstream ss;
-                // ss << "received_file_" << std::put_time(std::localtime(&in_time_t), "%Y%m%d_%H%M%S") << ".bin";
-                // std::string filename = ss.str();
-
-                // std::cout << "[RECV-MODE] Saving data to file: " << filename << "\n";
-                // std::ofstream output_file(filename, std::ios::binary);
-                // if (output_file)
-                // {
-                //     output_file.write(reinterpret_cast<const char*>(recv_data.data()), recv_data.size());
-                //     output_file.close();
-                //     std::cout << "[RECV-MODE] File saved successfully.\n";
-                // }
-                // else
-                // {
-                //     std::cerr << "[RECV-MODE] Error: Could not open file " << filename << " for writing.\n";
-                // }
+                continue;
+            }
+
+            asio::error_code ec = send(*item.endpoint, item.payload);
+            if (!ec)
+            {
+                std::cout << "[RECV-MODE] Data sent successfully to " << item.endpoint->address().to_string() << ":" << item.endpoint->port() << "\n";
+                continue;
+            }
+
+            std::cerr << "[RECV-MODE] Error forwarding to " << *item.endpoint << ": " << ec.message() << "\n";
+            if (spool && spool->append(*item.endpoint, item.payload))
+            {
+                std::cerr << "[RECV-MODE] Payload spooled for later delivery (" << spool->pending_records() << " waiting).\n";
+            }
+            else
+            {
+                std::cerr << "[RECV-MODE] Payload dropped.\n";
+            }
+        }
+        pipeline.reorder_pending.store(reorder.size(), std::memory_order_relaxed);
+
+        if (spool)
+        {
+            spool->replay(send);
+            spool->flush_if_due();
+        }
+    }
+}
+
+void run_recv_mode(const std::string &interface_name, const GuardOptions &options)
+{
+    ARIAAlgorithm::setDefaultProvider(options.crypto_provider);
+    const static ProtocolEngine protocol_engine = GetProtocolEngine(options.cipher_mode);
+    std::cout << "[*] ARIA provider: " << ARIAAlgorithm::providerName(options.crypto_provider) << "\n";
+
+    std::cout << "[*] RECV MODE: Listening on L2 for frames on interface " << interface_name << "...\n";
+
+    try
+    {
+        std::vector<GuardL2LinkConfig> links;
+        for (const auto &link_name : split_comma_list(interface_name))
+        {
+            std::array<uint8_t, 6> self_mac = get_mac_address(link_name);
+
+            char mac_str[18];
+            snprintf(mac_str, sizeof(mac_str), "%02x:%02x:%02x:%02x:%02x:%02x",
+                     self_mac[0], self_mac[1], self_mac[2], self_mac[3], self_mac[4], self_mac[5]);
+            std::cout << "[*] My MAC address on " << link_name << " is: " << mac_str << "\n";
+
+            links.push_back({link_name, self_mac, {}});
+        }
+
+        // GuardL2Receiver 객체를 생성. 생성자에서 Raw 소켓 생성 및 바인딩이 이루어짐짐
+        // 큰 전송은 메모리 대신 스풀 파일에 재조립
+        GuardL2ReassemblyLimits reassembly_limits;
+        reassembly_limits.spool_dir = std::filesystem::path(options.spool_dir) / "reassembly";
+        reassembly_limits.max_transfer_size = options.max_transfer_mb * 1024 * 1024;
+        reassembly_limits.spool_budget = options.reassembly_spool_mb * 1024 * 1024;
+        std::filesystem::create_directories(reassembly_limits.spool_dir);
+        GuardL2ReassemblyStore::set_limits(reassembly_limits);
+
+        GuardL2Receiver l2_receiver(links);
+        l2_receiver.set_latency_profile(latency_profile_from_options(options, links.front().interface_name));
+        std::shared_ptr<GuardL2Capture> capture;
+        if (!options.capture_path.empty())
+        {
+            capture = std::make_shared<GuardL2Capture>(options.capture_path);
+            l2_receiver.set_capture(capture);
+        }
+        if (options.resume)
+        {
+            l2_receiver.enable_resume(std::filesystem::path(options.spool_dir) / "resume");
+        }
+
+        // 단계 스레드들. 함수를 벗어나면 pipeline보다 먼저 중단/join됨
+        RecvPipeline pipeline;
+        size_t decrypt_workers = options.decrypt_workers;
+        if (decrypt_workers == 0)
+        {
+            size_t cores = std::thread::hardware_concurrency();
+            decrypt_workers = cores > 1 ? cores - 1 : 1;
+        }
+        std::vector<std::jthread> stages;
+        stages.emplace_back(restore_stage, std::ref(pipeline), std::cref(protocol_engine));
+        for (size_t i = 0; i < decrypt_workers; ++i)
+        {
+            stages.emplace_back(decrypt_stage, std::ref(pipeline), std::cref(protocol_engine));
+        }
+        stages.emplace_back(forward_stage, std::ref(pipeline), std::cref(options));
+        std::cout << "[*] RECV MODE: " << decrypt_workers << " decrypt worker(s).\n";
+
+        // 3무한 루프를 돌며 계속해서 새로운 데이터 전송을 대기
+        while (true)
+        {
+            // 데이터 수신을 시작합니다.  START -> DATA -> END 프로토콜 전체가 완료될 때까지 블로킹됩니다.
+            // 실패 시 저장소는 비어있음
+            RecvTransfer transfer;
+            l2_receiver.receive_reliable_data(transfer.store);
+            if (capture)
+            {
+                capture->flush(); // 세션 단위로 캡처가 디스크에 남도록
+            }
+
+            // 데이터 수신 성공 여부를 확인
+            if (transfer.store.size() > 0)
+            {
+                std::cout << "\n[RECV-MODE] Successfully received " << transfer.store.size() << " bytes of data.\n";
+                pipeline.restore_queue.push(std::move(transfer), std::stop_token{});
+                pipeline.log_depths();
             }
             else
             {
@@ -168,4 +389,4 @@ void run_recv_mode(const std::string &interface_name)
         // GuardL2Receiver 생성자 등에서 발생할 수 있는 치명적 오류 처리
         std::cerr << "[RECV-MODE:FATAL] A critical error occurred: " << e.what() << std::endl;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,558 @@
+#include "ReplayMode.h"
+#include "GuardL2.hpp"
+#include <arpa/inet.h>
+#include <endian.h>
+#include <netinet/ether.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <thread>
+
+constexpr static auto REPLAY_HANDSHAKE_WAIT = std::chrono::seconds(5); // 재생 대상이 START/START ACK를 내보내기를 기다리는 최대 시간
+
+namespace
+{
+    struct ReplayFrame
+    {
+        uint64_t offset_ns; // 캡처의 첫 GuardL2 프레임 기준
+        uint32_t interface_id;
+        GuardL2Header::FrameType type;
+        std::vector<uint8_t> data;
+    };
+
+    std::optional<GuardL2Header::FrameType> guard_frame_type(std::span<const uint8_t> frame)
+    {
+        if (frame.size() < sizeof(ether_header) + sizeof(GuardL2CompactDataHeader))
+        {
+            return std::nullopt;
+        }
+        ether_header eh;
+        std::memcpy(&eh, frame.data(), sizeof(eh));
+        if (ntohs(eh.ether_type) != ETHERTYPE_GUARDL2)
+        {
+            return std::nullopt;
+        }
+        return static_cast<GuardL2Header::FrameType>(frame[sizeof(ether_header)]);
+    }
+
+    // 전체 헤더 프레임(DATA_COMPACT 제외)의 헤더
+    std::optional<GuardL2Header> full_header(std::span<const uint8_t> frame)
+    {
+        auto type = guard_frame_type(frame);
+        if (!type || *type == GuardL2Header::FrameType::DATA_COMPACT || frame.size() < sizeof(ether_header) + sizeof(GuardL2Header))
+        {
+            return std::nullopt;
+        }
+        GuardL2Header header;
+        std::memcpy(&header, frame.data() + sizeof(ether_header), sizeof(header));
+        return header;
+    }
+
+    // START ACK 페이로드의 세션 태그
+    std::optional<uint16_t> start_ack_session_tag(std::span<const uint8_t> frame)
+    {
+        auto header = full_header(frame);
+        if (!header || header->type != GuardL2Header::FrameType::ACK || ntohl(header->sequence_number) != 0 ||
+            ntohs(header->payload_length) < sizeof(GuardL2StartAckPayload) ||
+            frame.size() < sizeof(ether_header) + sizeof(GuardL2Header) + sizeof(GuardL2StartAckPayload))
+        {
+            return std::nullopt;
+        }
+        GuardL2StartAckPayload payload;
+        std::memcpy(&payload, frame.data() + sizeof(ether_header) + sizeof(GuardL2Header), sizeof(payload));
+        return ntohs(payload.session_tag);
+    }
+
+    // DATA_COMPACT 프레임의 시퀀스 번호 (헤더 뒤 LEB128 varint)
+    std::optional<uint32_t> compact_sequence_number(std::span<const uint8_t> frame)
+    {
+        uint32_t value = 0;
+        for (size_t pos = sizeof(ether_header) + sizeof(GuardL2CompactDataHeader), shift = 0; pos < frame.size() && shift < 35; ++pos, shift += 7)
+        {
+            value |= static_cast<uint32_t>(frame[pos] & 0x7F) << shift;
+            if (!(frame[pos] & 0x80))
+            {
+                return value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::vector<ReplayFrame> load_replay_frames(const std::string &capture_path, size_t &link_count)
+    {
+        std::vector<std::string> interface_names;
+        std::vector<GuardL2CapturedFrame> captured = read_guard_l2_capture(capture_path, &interface_names);
+        link_count = std::max<size_t>(interface_names.size(), 1);
+
+        std::vector<ReplayFrame> frames;
+        uint64_t first_timestamp = 0;
+        for (auto &frame : captured)
+        {
+            auto type = guard_frame_type(frame.data);
+            if (!type)
+            {
+                continue;
+            }
+            if (frames.empty())
+            {
+                first_timestamp = frame.timestamp_ns;
+            }
+            const uint64_t offset = frame.timestamp_ns > first_timestamp ? frame.timestamp_ns - first_timestamp : 0;
+            frames.push_back({offset, frame.interface_id, *type, std::move(frame.data)});
+        }
+        return frames;
+    }
+
+    /**
+     * @brief 링크마다 socketpair 하나. 한쪽은 재생 대상(GuardL2Sender/Receiver)이 raw 소켓 대신 쓰고 다른 쪽은 하네스가 씀
+     * @details SOCK_SEQPACKET이라 프레임 경계가 유지됨. 하네스 쪽으로 나오는 프레임은 drain 스레드가 계속 읽어
+     *          재생 대상의 send()가 막히지 않게 함
+     */
+    class ReplayLinks
+    {
+    public:
+        explicit ReplayLinks(size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                int fds[2];
+                if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) < 0)
+                {
+                    close_all();
+                    throw std::runtime_error("socketpair failed");
+                }
+                target_fds_.push_back(fds[0]);
+                harness_fds_.push_back(fds[1]);
+            }
+        }
+
+        ~ReplayLinks()
+        {
+            drain_thread_ = {};
+            close_all();
+        }
+
+        // 재생 대상에 넘길 쪽. 넘긴 뒤에는 재생 대상이 닫음
+        int release_target_fd(size_t link)
+        {
+            return std::exchange(target_fds_[link], -1);
+        }
+
+        void send(size_t link, std::span<const uint8_t> frame)
+        {
+            if (::send(harness_fds_[link], frame.data(), frame.size(), MSG_NOSIGNAL) < 0)
+            {
+                GUARD_L2_DEBUG_ERROR_LOG("[WARN]", "Replay send failed on link", link, "\n");
+            }
+        }
+
+        void start_drain(std::function<void(size_t, std::span<const uint8_t>)> on_frame)
+        {
+            drain_thread_ = std::jthread([this, on_frame = std::move(on_frame)](std::stop_token token)
+            {
+                std::vector<pollfd> poll_fds;
+                for (int fd : harness_fds_)
+                {
+                    poll_fds.push_back({fd, POLLIN, 0});
+                }
+
+                std::array<uint8_t, 2048> buffer;
+                while (!token.stop_requested())
+                {
+                    if (poll(poll_fds.data(), poll_fds.size(), 100) <= 0)
+                    {
+                        continue;
+                    }
+                    for (size_t link = 0; link < poll_fds.size(); ++link)
+                    {
+                        if (!(poll_fds[link].revents & POLLIN))
+                        {
+                            continue;
+                        }
+                        ssize_t bytes = recv(poll_fds[link].fd, buffer.data(), buffer.size(), MSG_DONTWAIT);
+                        if (bytes > 0)
+                        {
+                            on_frame(link, std::span<const uint8_t>{buffer.data(), static_cast<size_t>(bytes)});
+                        }
+                    }
+                }
+            });
+        }
+
+    private:
+        void close_all()
+        {
+            for (int fd : target_fds_)
+            {
+                if (fd >= 0)
+                {
+                    close(fd);
+                }
+            }
+            for (int fd : harness_fds_)
+            {
+                close(fd);
+            }
+            target_fds_.clear();
+            harness_fds_.clear();
+        }
+
+        std::vector<int> target_fds_;
+        std::vector<int> harness_fds_;
+        std::jthread drain_thread_;
+    };
+
+    /**
+     * @brief 캡처 시각 간격을 speed배로 줄여 기다림. speed가 0이면 기다리지 않음
+     */
+    void pace(std::chrono::steady_clock::time_point start, uint64_t offset_ns, size_t speed)
+    {
+        if (speed == 0)
+        {
+            return;
+        }
+        std::this_thread::sleep_until(start + std::chrono::nanoseconds(offset_ns / speed));
+    }
+
+    double elapsed_ms(std::chrono::steady_clock::time_point since)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+    }
+
+    /**
+     * @brief 캡처의 START/DATA/END를 GuardL2Receiver에 넣고 재조립 결과를 확인
+     * @details 캡처의 ACK는 넣지 않음. 세션 태그는 수신자가 새로 정하므로 캡처의 START ACK에서 옛 태그를,
+     *          재생 중인 수신자의 START ACK에서 새 태그를 읽어 DATA_COMPACT 프레임의 태그를 바꿔 넣음
+     */
+    void replay_into_receiver(const std::vector<ReplayFrame> &frames, size_t link_count, const GuardOptions &options)
+    {
+        std::vector<GuardL2LinkConfig> configs(link_count);
+        ReplayLinks links(link_count);
+        for (size_t i = 0; i < link_count; ++i)
+        {
+            configs[i].interface_name = "replay" + std::to_string(i);
+            configs[i].sock_fd = links.release_target_fd(i);
+        }
+        for (const auto &frame : frames)
+        {
+            auto &config = configs[frame.interface_id];
+            if (frame.type != GuardL2Header::FrameType::ACK && config.local_mac == std::array<uint8_t, 6>{})
+            {
+                std::memcpy(config.local_mac.data(), frame.data.data(), 6); // 수신자로 가는 프레임의 목적지 MAC
+            }
+        }
+
+        // 재생할 수신 세션 수 (재전송된 START는 같은 세션)
+        size_t expected_sessions = 0;
+        uint32_t previous_start = 0;
+        for (const auto &frame : frames)
+        {
+            auto header = full_header(frame.data);
+            if (header && header->type == GuardL2Header::FrameType::START && ntohl(header->session_id) != previous_start)
+            {
+                previous_start = ntohl(header->session_id);
+                ++expected_sessions;
+            }
+        }
+
+        GuardL2ReassemblyLimits reassembly_limits;
+        reassembly_limits.spool_dir = std::filesystem::path(options.spool_dir) / "reassembly";
+        reassembly_limits.max_transfer_size = options.max_transfer_mb * 1024 * 1024;
+        reassembly_limits.spool_budget = options.reassembly_spool_mb * 1024 * 1024;
+        std::filesystem::create_directories(reassembly_limits.spool_dir);
+        GuardL2ReassemblyStore::set_limits(reassembly_limits);
+
+        GuardL2Receiver receiver(configs);
+        receiver.set_latency_profile(latency_profile_from_options(options, configs.front().interface_name));
+
+        std::mutex tag_mutex;
+        std::condition_variable tag_cv;
+        std::map<uint32_t, uint16_t> live_tags; // 세션 -> 재생 중인 수신자가 정한 태그
+        std::atomic<uint64_t> acks_sent{0};
+        links.start_drain([&](size_t, std::span<const uint8_t> frame)
+        {
+            acks_sent.fetch_add(1, std::memory_order_relaxed);
+            if (auto tag = start_ack_session_tag(frame))
+            {
+                std::lock_guard<std::mutex> lock(tag_mutex);
+                live_tags[ntohl(full_header(frame)->session_id)] = *tag;
+                tag_cv.notify_all();
+            }
+        });
+
+        std::atomic<uint64_t> frames_replayed{0};
+        const auto start = std::chrono::steady_clock::now();
+        std::jthread feeder([&](std::stop_token token)
+        {
+            std::map<uint16_t, uint32_t> captured_tags; // 캡처의 태그 -> 세션
+            for (const auto &frame : frames)
+            {
+                if (token.stop_requested())
+                {
+                    return;
+                }
+                if (frame.type == GuardL2Header::FrameType::ACK)
+                {
+                    if (auto tag = start_ack_session_tag(frame.data))
+                    {
+                        captured_tags[*tag] = ntohl(full_header(frame.data)->session_id);
+                    }
+                    continue;
+                }
+
+                pace(start, frame.offset_ns, options.replay_speed);
+                std::vector<uint8_t> data = frame.data;
+                if (frame.type == GuardL2Header::FrameType::DATA_COMPACT)
+                {
+                    GuardL2CompactDataHeader *ch = (GuardL2CompactDataHeader *)(data.data() + sizeof(ether_header));
+                    auto session = captured_tags.find(ntohs(ch->session_tag));
+                    if (session != captured_tags.end())
+                    {
+                        std::unique_lock<std::mutex> lock(tag_mutex);
+                        if (tag_cv.wait_for(lock, REPLAY_HANDSHAKE_WAIT, [&] { return live_tags.contains(session->second); }))
+                        {
+                            ch->session_tag = htons(live_tags[session->second]);
+                            guard_l2_refresh_frame_crc(std::span<uint8_t>{data}.subspan(sizeof(ether_header)));
+                        }
+                    }
+                }
+                links.send(frame.interface_id, data);
+                frames_replayed.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+
+        size_t completed = 0;
+        uint64_t bytes = 0;
+        for (size_t i = 0; i < expected_sessions; ++i)
+        {
+            const auto session_start = std::chrono::steady_clock::now();
+            GuardL2ReassemblyStore store;
+            if (receiver.receive_reliable_data(store))
+            {
+                ++completed;
+                bytes += store.size();
+                std::cout << "[REPLAY] session " << i + 1 << "/" << expected_sessions << ": received " << store.size()
+                          << " bytes in " << elapsed_ms(session_start) << " ms\n";
+            }
+            else
+            {
+                std::cout << "[REPLAY] session " << i + 1 << "/" << expected_sessions << ": failed\n";
+            }
+        }
+        const double total_ms = elapsed_ms(start);
+        feeder.request_stop();
+        feeder.join();
+
+        std::cout << "[REPLAY] receiver: " << completed << "/" << expected_sessions << " sessions, " << bytes << " bytes, "
+                  << frames_replayed.load() << " frames in, " << acks_sent.load() << " ACKs out, " << total_ms << " ms (captured "
+                  << (frames.empty() ? 0.0 : frames.back().offset_ns / 1e6) << " ms), "
+                  << (total_ms > 0 ? bytes * 8 / total_ms / 1000 : 0.0) << " Mbps\n";
+    }
+
+    /**
+     * @brief 캡처의 세션을 같은 크기로 GuardL2Sender가 다시 보내게 하고, 캡처의 ACK를 같은 시각 간격으로 돌려줌
+     * @details ACK는 기록된 시각(START 기준)과 송신자가 그 시퀀스 번호를 실제로 보낸 시각 중 늦은 때 돌려줌.
+     *          캡처에 없는 ACK(손실)는 끝내 오지 않으므로 혼잡 제어/RTO 조정이 같은 ACK 흐름(손실, 지연, 윈도우 광고)에
+     *          어떻게 반응하는지 비교하는 데 씀. 세션 ID는 송신자가 새로 정하므로 ACK의 세션 ID를 바꾸고 CRC를 다시 계산함
+     */
+    void replay_into_sender(const std::vector<ReplayFrame> &frames, size_t link_count, const GuardOptions &options)
+    {
+        struct CapturedSession
+        {
+            uint32_t session_id;
+            uint64_t total_size;
+            uint64_t start_offset_ns;
+            uint64_t end_offset_ns;
+            std::vector<const ReplayFrame *> acks;
+        };
+
+        std::vector<CapturedSession> sessions;
+        std::map<uint32_t, size_t> session_index;
+        std::vector<GuardL2LinkConfig> configs(link_count);
+        ReplayLinks links(link_count);
+        for (size_t i = 0; i < link_count; ++i)
+        {
+            configs[i].interface_name = "replay" + std::to_string(i);
+            configs[i].sock_fd = links.release_target_fd(i);
+        }
+
+        // 송신 측 캡처에서는 START ACK가 START보다 먼저 기록될 수 있으므로 세션을 먼저 모은 뒤 ACK를 나눔
+        for (const auto &frame : frames)
+        {
+            auto header = full_header(frame.data);
+            if (header && header->type == GuardL2Header::FrameType::START && !session_index.contains(ntohl(header->session_id)))
+            {
+                session_index[ntohl(header->session_id)] = sessions.size();
+                sessions.push_back({ntohl(header->session_id), be64toh(header->total_size), frame.offset_ns, frame.offset_ns, {}});
+            }
+        }
+        for (const auto &frame : frames)
+        {
+            auto header = full_header(frame.data);
+            if (!header || header->type != GuardL2Header::FrameType::ACK || !session_index.contains(ntohl(header->session_id)))
+            {
+                continue;
+            }
+            CapturedSession &session = sessions[session_index[ntohl(header->session_id)]];
+            session.acks.push_back(&frame);
+            session.end_offset_ns = std::max(session.end_offset_ns, frame.offset_ns);
+
+            // 송신자 MAC은 ACK의 목적지, 수신자 MAC은 ACK의 출발지
+            auto &config = configs[frame.interface_id];
+            if (config.local_mac == std::array<uint8_t, 6>{})
+            {
+                std::memcpy(config.local_mac.data(), frame.data.data(), 6);
+                std::memcpy(config.peer_mac.data(), frame.data.data() + 6, 6);
+            }
+        }
+
+        GuardL2Sender sender(configs, options.link_failover);
+        sender.set_latency_profile(latency_profile_from_options(options, configs.front().interface_name));
+
+        std::mutex live_mutex;
+        std::condition_variable live_cv;
+        uint32_t live_session = 0;
+        std::chrono::steady_clock::time_point live_start;
+        std::set<uint32_t> live_sent;  // 현재 세션에서 송신자가 보낸 시퀀스 번호
+        bool live_finished = false;    // send_reliable_data()가 끝남
+        std::atomic<uint64_t> frames_sent{0};
+        links.start_drain([&](size_t, std::span<const uint8_t> frame)
+        {
+            frames_sent.fetch_add(1, std::memory_order_relaxed);
+            std::optional<uint32_t> seq;
+            auto header = full_header(frame);
+            std::lock_guard<std::mutex> lock(live_mutex);
+            if (header && header->type == GuardL2Header::FrameType::START && ntohl(header->session_id) != live_session)
+            {
+                live_session = ntohl(header->session_id);
+                live_start = std::chrono::steady_clock::now();
+                live_sent.clear();
+            }
+            if (header && ntohl(header->session_id) == live_session)
+            {
+                seq = ntohl(header->sequence_number);
+            }
+            else if (!header && guard_frame_type(frame) == GuardL2Header::FrameType::DATA_COMPACT)
+            {
+                seq = compact_sequence_number(frame);
+            }
+            if (seq)
+            {
+                live_sent.insert(*seq);
+                live_cv.notify_all();
+            }
+        });
+
+        size_t completed = 0;
+        uint64_t bytes = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < sessions.size(); ++i)
+        {
+            const CapturedSession &session = sessions[i];
+            const auto session_start = std::chrono::steady_clock::now();
+            uint32_t previous_session;
+            {
+                std::lock_guard<std::mutex> lock(live_mutex);
+                previous_session = live_session;
+            }
+
+            std::vector<uint8_t> payload(session.total_size);
+            bool ok = false;
+            {
+                std::lock_guard<std::mutex> lock(live_mutex);
+                live_finished = false;
+            }
+            std::jthread send_thread([&]
+            {
+                ok = sender.send_reliable_data(payload);
+                std::lock_guard<std::mutex> lock(live_mutex);
+                live_finished = true;
+                live_cv.notify_all();
+            });
+
+            uint32_t session_id;
+            std::chrono::steady_clock::time_point session_t0;
+            {
+                std::unique_lock<std::mutex> lock(live_mutex);
+                live_cv.wait_for(lock, REPLAY_HANDSHAKE_WAIT, [&] { return live_session != previous_session; });
+                session_id = live_session;
+                session_t0 = live_start;
+            }
+
+            for (const ReplayFrame *ack : session.acks)
+            {
+                pace(session_t0, ack->offset_ns - std::min(ack->offset_ns, session.start_offset_ns), options.replay_speed);
+                std::vector<uint8_t> data = ack->data;
+                GuardL2Header *gh = (GuardL2Header *)(data.data() + sizeof(ether_header));
+                {
+                    const uint32_t ack_seq = ntohl(gh->sequence_number);
+                    std::unique_lock<std::mutex> lock(live_mutex);
+                    live_cv.wait(lock, [&] { return live_finished || live_sent.contains(ack_seq); });
+                    if (live_finished)
+                    {
+                        break;
+                    }
+                }
+                gh->session_id = htonl(session_id);
+                guard_l2_refresh_frame_crc(std::span<uint8_t>{data}.subspan(sizeof(ether_header)));
+                links.send(ack->interface_id, data);
+            }
+            send_thread.join();
+
+            if (ok)
+            {
+                ++completed;
+                bytes += session.total_size;
+            }
+            std::cout << "[REPLAY] session " << i + 1 << "/" << sessions.size() << ": " << session.total_size << " bytes "
+                      << (ok ? "sent" : "failed") << " in " << elapsed_ms(session_start) << " ms (captured "
+                      << (session.end_offset_ns - session.start_offset_ns) / 1e6 << " ms)\n";
+        }
+        const double total_ms = elapsed_ms(start);
+
+        std::cout << "[REPLAY] sender: " << completed << "/" << sessions.size() << " sessions, " << bytes << " bytes, "
+                  << frames_sent.load() << " frames out, " << total_ms << " ms, "
+                  << (total_ms > 0 ? bytes * 8 / total_ms / 1000 : 0.0) << " Mbps\n";
+    }
+}
+
+void run_replay_mode(const std::string &capture_path, const std::string &target, const GuardOptions &options)
+{
+    try
+    {
+        size_t link_count = 0;
+        std::vector<ReplayFrame> frames = load_replay_frames(capture_path, link_count);
+        std::cout << "[REPLAY] " << frames.size() << " GuardL2 frames on " << link_count << " link(s) from " << capture_path
+                  << ", speed " << (options.replay_speed == 0 ? std::string("unpaced") : std::to_string(options.replay_speed) + "x") << "\n";
+        if (frames.empty())
+        {
+            return;
+        }
+
+        if (target == "recv")
+        {
+            replay_into_receiver(frames, link_count, options);
+        }
+        else if (target == "send")
+        {
+            replay_into_sender(frames, link_count, options);
+        }
+        else
+        {
+            std::cerr << "[REPLAY] Unknown replay target: " << target << " (recv or send)\n";
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "[REPLAY] " << e.what() << "\n";
+    }
+}
@@ -1,6 +1,8 @@
 #include "SendMode.h"
 #include "Utils.hpp"
 #include "GuardL2.hpp"
+#include "GuardL2Dedup.hpp"
+#include "GuardPayload.hpp"
 
 #include <iostream>
 #include <vector>
@@ -9,71 +11,374 @@
 #include <cstring>
 #include <sys/ioctl.h>
 #include <arpa/inet.h>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <random>
 #include "CdsGuardServer.hpp"
+#include "SendTransferQueue.hpp"
+#include "GuardQos.hpp"
+#include "GuardUringIngest.hpp"
 #include "asio.hpp"
-#include "Utils.hpp"
 
-void run_send_mode(const std::string &interface_name, const std::string &dst_mac_str)
+constexpr static int RESUME_MAX_ATTEMPTS = 5;
+constexpr static size_t INGEST_READ_CHUNK = std::numeric_limits<unsigned short>::max();
+constexpr static size_t INGEST_BYTE_BUDGET = 256 * 1024 * 1024; // 수신 중 + 전송 대기 중인 데이터 총량
+constexpr static size_t QOS_SEGMENT_SIZE = 1024 * 1024;          // --qos에서 이보다 큰 전송은 이 크기 조각으로 나누어 보냄
+
+/**
+ * @brief --resume이면 실패 시 잠시 기다렸다가 수신 측이 가진 지점부터 이어서 재전송
+ */
+static bool send_with_resume(GuardL2Sender &l2_sender, std::span<const uint8_t> payload, bool resume)
 {
-    
-    std::array<uint8_t, 6> src_mac = get_mac_address(interface_name);
-    std::array<uint8_t, 6> dst_mac = mac_str_to_bytes(dst_mac_str);
+    if (!resume)
+    {
+        return l2_sender.send_reliable_data(payload);
+    }
+
+    l2_sender.enable_resume(true);
+    if (l2_sender.send_reliable_data(payload))
+    {
+        return true;
+    }
+
+    std::chrono::seconds backoff(1);
+    for (int attempt = 1; attempt < RESUME_MAX_ATTEMPTS; ++attempt)
+    {
+        std::cerr << "[*] L2 transmission interrupted. Resuming in " << backoff.count() << "s (attempt " << attempt << ")...\n";
+        std::this_thread::sleep_for(backoff);
+        backoff = std::min(backoff * 2, std::chrono::seconds(30));
+
+        if (l2_sender.send_reliable_data(payload, l2_sender.resume_token()))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief --dedup: 게이트웨이 암호문은 메시지마다 IV가 달라 청크가 겹치지 않으므로 평문으로 풀어 둠
+ * @details 주소 헤더는 그대로 두고 본문만 복호화. 링크에 나갈 때는 transmit_payload()에서 다시 암호화함
+ * @return 게이트웨이 페이로드 형식이 아니거나 복호화에 실패하면 false (원래 암호문을 그대로 보냄)
+ */
+static bool open_for_dedup(SendTransfer &transfer, const ProtocolEngine &protocol_engine)
+{
+    std::span<const uint8_t> data = transfer.data();
+    auto header = parse_forward_header(data);
+    if (!header)
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> body;
+    try
+    {
+        body = protocol_engine.decrypt(data.subspan(header->second));
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "[SendMode] Cannot decrypt payload for dedup (" << e.what() << "). Sending it as received.\n";
+        return false;
+    }
+    // CBC/CTR 엔진은 실패를 예외 대신 빈 결과로 알림 (--cipher가 게이트웨이와 다를 때)
+    if (body.empty())
+    {
+        std::cerr << "[SendMode] Cannot decrypt payload for dedup (check --cipher). Sending it as received.\n";
+        return false;
+    }
+
+    std::vector<uint8_t> plain;
+    plain.reserve(header->second + body.size());
+    plain.insert(plain.end(), data.begin(), data.begin() + header->second);
+    plain.insert(plain.end(), body.begin(), body.end());
+    // 대기열 예산은 원래 크기로 잡혀 있으므로 그보다 커지면 바꾸지 않음 (복호화 결과는 암호문보다 짧음)
+    if (plain.size() > transfer.payload.size())
+    {
+        return false;
+    }
+
+    transfer.payload = std::move(plain);
+    transfer.data_offset = 0;
+    transfer.opened = true;
+    return true;
+}
+
+/**
+ * @brief dedup_engine이 있으면 평문을 dedup 인코딩하고 그 스트림을 암호화하여 봉인한 뒤 L2 세션 하나로 보냄
+ */
+static bool transmit_payload(GuardL2Sender &l2_sender, GuardL2DedupEncoder &dedup_encoder, const ProtocolEngine *dedup_engine,
+                             std::span<const uint8_t> payload, bool resume)
+{
+    if (!dedup_engine)
+    {
+        return send_with_resume(l2_sender, payload, resume);
+    }
+
+    // 수신자가 재시작되어 인덱스가 무효였다면 초기화된 인덱스로 한 번 더 보냄
+    bool sent = false;
+    for (int attempt = 0; attempt < 2 && !sent; ++attempt)
+    {
+        std::vector<uint8_t> dedup_stream = dedup_encoder.encode(payload);
+        std::vector<uint8_t> sealed = GuardL2DedupEncoder::seal(dedup_engine->encrypt(dedup_stream));
+        std::cout << "[*] Dedup: " << payload.size() << " bytes -> " << dedup_stream.size() << " bytes (" << sealed.size() << " bytes encrypted on the wire).\n";
+
+        if (!send_with_resume(l2_sender, sealed, resume))
+        {
+            dedup_encoder.discard();
+            break;
+        }
+        sent = dedup_encoder.commit(l2_sender.peer_instance_id());
+    }
+    return sent;
+}
+
+/**
+ * @brief EOF까지 받은 연결 데이터를 클래스 태그로 분류하여 전송 대기열에 넣음 (asio/io_uring 수신 공용)
+ */
+static void queue_ingested_payload(SendTransferQueue &queue, std::vector<uint8_t> &&payload, const std::string &source)
+{
+    std::cout << "[SendMode] Connection from " << source << " closed by peer.\n";
+    if (payload.empty())
+    {
+        return;
+    }
+
+    const size_t received = payload.size();
+
+    SendTransfer transfer{std::move(payload), source};
+    // 게이트웨이가 붙인 클래스 태그가 있으면 떼어내고, 없으면(이전 게이트웨이) 크기로 분류
+    if (std::optional<GuardTrafficClass> tagged = parse_traffic_class_tag(transfer.payload[0]))
+    {
+        transfer.traffic_class = *tagged;
+        transfer.data_offset = 1;
+    }
+    else
+    {
+        transfer.traffic_class = classify_by_size(transfer.payload.size());
+    }
+
+    std::cout << "[*] Received " << received << " bytes via TCP from " << source << ". Queued for L2 transmission as "
+              << traffic_class_name(transfer.traffic_class) << " (queue: " << queue.queued_transfers() + 1 << ").\n";
+    queue.push(std::move(transfer));
+}
+
+/**
+ * @brief TCP 연결 하나를 EOF까지 비동기로 읽어 전송 대기열에 넣음
+ * @details 대기열 예산이 찼으면 읽기를 멈추고 예산이 풀릴 때 다시 읽음
+ */
+class IngestConnection : public std::enable_shared_from_this<IngestConnection>
+{
+public:
+    IngestConnection(asio::ip::tcp::socket socket, SendTransferQueue &queue)
+        : socket_(std::move(socket)), queue_(queue)
+    {
+        asio::error_code ec;
+        auto remote = socket_.remote_endpoint(ec);
+        source_ = ec ? std::string("unknown") : remote.address().to_string() + ":" + std::to_string(remote.port());
+    }
+
+    void start() { read_more(); }
+
+private:
+    void read_more()
+    {
+        if (queue_.should_pause())
+        {
+            queue_.wait_for_budget([self = shared_from_this()] { self->read_more(); });
+            return;
+        }
+
+        if (buffer_.size() - filled_ < INGEST_READ_CHUNK)
+        {
+            buffer_.resize(std::max(buffer_.size() * 2, filled_ + INGEST_READ_CHUNK));
+        }
+
+        socket_.async_read_some(asio::buffer(buffer_.data() + filled_, buffer_.size() - filled_),
+                                [self = shared_from_this()](const asio::error_code &ec, size_t bytes)
+                                { self->on_read(ec, bytes); });
+    }
+
+    void on_read(const asio::error_code &ec, size_t bytes)
+    {
+        filled_ += bytes;
+        queue_.add_ingress(bytes);
+
+        if (!ec)
+        {
+            read_more();
+            return;
+        }
+
+        if (ec != asio::error::eof)
+        {
+            std::cerr << "[SendMode] Read error from " << source_ << ": " << ec.message() << std::endl;
+            queue_.drop_ingress(filled_);
+            return;
+        }
+
+        buffer_.resize(filled_);
+        queue_ingested_payload(queue_, std::move(buffer_), source_);
+    }
+
+    asio::ip::tcp::socket socket_;
+    SendTransferQueue &queue_;
+    std::string source_;
+    std::vector<uint8_t> buffer_;
+    size_t filled_ = 0;
+};
+
+static void start_accept(asio::ip::tcp::acceptor &acceptor, SendTransferQueue &queue)
+{
+    acceptor.async_accept([&acceptor, &queue](const asio::error_code &ec, asio::ip::tcp::socket socket)
+                          {
+        if (!ec)
+        {
+            std::make_shared<IngestConnection>(std::move(socket), queue)->start();
+        }
+        else
+        {
+            std::cerr << "[SendMode] Accept error: " << ec.message() << std::endl;
+        }
+        start_accept(acceptor, queue); });
+}
+
+void run_send_mode(const std::string &interface_name, const std::string &dst_mac_str, const GuardOptions &options)
+{
+    std::vector<std::string> interface_names = split_comma_list(interface_name);
+    std::vector<std::string> dst_mac_strs = split_comma_list(dst_mac_str);
+
+    if (interface_names.empty() || interface_names.size() != dst_mac_strs.size())
+    {
+        throw std::invalid_argument("The number of interfaces and destination MACs must match");
+    }
+
+    if (options.dedup)
+    {
+        // 평문 중복 제거를 위해 게이트웨이 페이로드를 풀고 다시 암호화하므로 수신 측과 같은 --cipher가 필요
+        ARIAAlgorithm::setDefaultProvider(options.crypto_provider);
+        std::cout << "[*] Dedup on plaintext: ARIA " << ARIAAlgorithm::providerName(options.crypto_provider) << " provider.\n";
+    }
+
+    std::vector<GuardL2LinkConfig> links;
+    for (size_t i = 0; i < interface_names.size(); ++i)
+    {
+        links.push_back({interface_names[i], get_mac_address(interface_names[i]), mac_str_to_bytes(dst_mac_strs[i])});
+    }
     
     asio::io_context ctx;
     asio::ip::tcp::acceptor acceptor(ctx, asio::ip::tcp::endpoint(asio::ip::tcp::v4(), 0));
     asio::ip::port_type recv_port = acceptor.local_endpoint().port();
     
     std::jthread discorvery_thread(CdsGuardStartDiscoveryResponder(ctx, recv_port));
-    
-    std::cout << "[*] SEND MODE: Listening on TCP:" << recv_port << " for encrypted L2 payloads...\n";
-    
-    while (true)
-    {
-        asio::ip::tcp::socket recv_sock(ctx);  // 새로 생성된 소켓
-        acceptor.accept(recv_sock);            // 클라이언트 연결 수락
-        constexpr size_t recv_data_block_size = std::numeric_limits<unsigned short>::max();
-        std::vector<uint8_t> recv_data(recv_data_block_size);
-        asio::error_code ec;
-        size_t readed_byte_size = 0;
 
-        while (true)
+    SendTransferQueue transfer_queue(ctx, INGEST_BYTE_BUDGET);
+
+    // L2 전송은 하나의 송신자로 순서대로 처리하고, 그동안 io_context 스레드는 계속 연결을 받아 읽음
+    std::jthread transmit_thread([&links, &options, &transfer_queue](std::stop_token token)
+                                 {
+        GuardL2Sender l2_sender(links, options.link_failover);
+        l2_sender.set_latency_profile(latency_profile_from_options(options, links.front().interface_name));
+        std::shared_ptr<GuardL2Capture> capture;
+        if (!options.capture_path.empty())
+        {
+            capture = std::make_shared<GuardL2Capture>(options.capture_path);
+            l2_sender.set_capture(capture);
+        }
+
+        // 수신 측 청크 캐시와 맞춰야 하므로 연결마다가 아니라 프로세스 수명 동안 유지
+        GuardL2DedupEncoder dedup_encoder;
+        std::optional<ProtocolEngine> dedup_engine;
+        if (options.dedup)
         {
-            asio::mutable_buffer tcp_sock_buffer(recv_data.data() + readed_byte_size, recv_data.size() - readed_byte_size);
-            readed_byte_size += recv_sock.read_some(tcp_sock_buffer, ec);
+            dedup_engine.emplace(GetProtocolEngine(options.cipher_mode));
+        }
+
+        // 수신 측 조각 재조립 키. 재시작한 송신자의 ID와 겹치지 않도록 임의 값에서 시작
+        std::random_device random_device;
+        uint64_t next_transfer_id = (static_cast<uint64_t>(random_device()) << 32) | random_device();
 
-            if (ec)
+        while (std::optional<SendTransfer> transfer = transfer_queue.pop(token))
+        {
+            if (dedup_engine && transfer->sent_offset == 0 && !transfer->opened)
             {
-                if (asio::error::eof == ec)
+                const size_t received = transfer->payload.size();
+                if (open_for_dedup(*transfer, *dedup_engine))
                 {
-                    std::cout << "[SendMode] Connection closed by peer.\n";
-                    break;
+                    transfer_queue.complete(received - transfer->payload.size()); // 줄어든 만큼 예산을 바로 돌려줌
                 }
-                else
+            }
+
+            std::span<const uint8_t> data = transfer->data();
+            std::span<const uint8_t> wire = data;
+            std::vector<uint8_t> segment;
+
+            // --qos: 큰 전송은 조각 하나만 보내고 대기열로 돌려보내 그 사이에 높은 클래스 전송이 나가게 함
+            if (options.qos && data.size() > QOS_SEGMENT_SIZE)
+            {
+                if (transfer->sent_offset == 0)
                 {
-                    std::cerr << "Read error: " << ec.message() << std::endl;
-                    break;
+                    transfer->transfer_id = next_transfer_id++;
                 }
+                std::span<const uint8_t> piece = data.subspan(transfer->sent_offset, std::min(QOS_SEGMENT_SIZE, data.size() - transfer->sent_offset));
+                segment = build_qos_segment(transfer->traffic_class, transfer->transfer_id, data.size(), transfer->sent_offset, piece);
+                wire = segment;
+                std::cout << "[*] Sending " << traffic_class_name(transfer->traffic_class) << " segment " << transfer->sent_offset / QOS_SEGMENT_SIZE + 1
+                          << "/" << (data.size() + QOS_SEGMENT_SIZE - 1) / QOS_SEGMENT_SIZE << " of " << data.size() << " bytes from " << transfer->source << " via L2...\n";
+                transfer->sent_offset += piece.size();
             }
-            else if (readed_byte_size == recv_data.size())
+            else
             {
-                recv_data.resize(recv_data.size() * 2);
+                std::cout << "[*] Sending " << data.size() << " bytes (" << traffic_class_name(transfer->traffic_class) << ") from " << transfer->source << " via L2...\n";
+                transfer->sent_offset = data.size();
             }
-        }
-        recv_data.resize(readed_byte_size);
 
-        if (!recv_data.empty()) 
-        {
-            std::cout << "[*] Received " << recv_data.size() << " bytes via TCP. Preparing to send via L2...\n";
+            bool sent = transmit_payload(l2_sender, dedup_encoder, transfer->opened ? &*dedup_engine : nullptr, wire, options.resume);
+            if (capture)
+            {
+                capture->flush(); // 세션 단위로 캡처가 디스크에 남도록
+            }
+
+            if (sent && transfer->sent_offset < data.size())
+            {
+                transfer_queue.requeue(std::move(*transfer));
+                continue;
+            }
 
-            GuardL2Sender l2_sender(interface_name, src_mac, dst_mac);
-            if (l2_sender.send_reliable_data(recv_data)) 
+            if (sent) 
             {
                 std::cout << "[*] L2 transmission successful.\n";
             } 
             else 
             {
+                // 조각 전송 중이었다면 나머지 조각도 버림 (수신 측은 미완성 전송을 시간 초과로 정리)
                 std::cerr << "[*] L2 transmission failed.\n";
             }
+
+            transfer_queue.complete(transfer->payload.size());
+        } });
+
+    std::cout << "[*] SEND MODE: Listening on TCP:" << recv_port << " for encrypted L2 payloads...\n";
+
+    // --io-uring: 지원하는 커널이면 수신을 io_uring 루프가 맡고, io_context 스레드는 예산 대기 콜백만 처리
+    std::optional<GuardUringIngest> uring_ingest;
+    std::jthread uring_thread;
+    if (options.io_uring && GuardUring::supported())
+    {
+        uring_ingest.emplace(acceptor.native_handle(), transfer_queue, [&transfer_queue](std::vector<uint8_t> &&payload, const std::string &source)
+                             { queue_ingested_payload(transfer_queue, std::move(payload), source); });
+        uring_thread = std::jthread([&uring_ingest](std::stop_token token) { uring_ingest->run(token); });
+        std::cout << "[SendMode] TCP ingest backend: io_uring (multishot accept/recv).\n";
+    }
+    else
+    {
+        if (options.io_uring)
+        {
+            std::cerr << "[SendMode] io_uring is not available on this kernel. Falling back to asio.\n";
         }
+        start_accept(acceptor, transfer_queue);
     }
-}
\ No newline at end of file
+
+    auto work_guard = asio::make_work_guard(ctx);
+    ctx.run();
+}
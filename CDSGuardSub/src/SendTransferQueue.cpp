@@ -0,0 +1,133 @@
+#include "SendTransferQueue.hpp"
+#include <algorithm>
+
+SendTransferQueue::SendTransferQueue(asio::io_context &ctx, size_t byte_budget)
+    : ctx_(ctx), byte_budget_(byte_budget)
+{
+}
+
+bool SendTransferQueue::should_pause() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_bytes_ > 0 && ingress_bytes_ + pending_bytes_ >= byte_budget_;
+}
+
+void SendTransferQueue::wait_for_budget(std::function<void()> resume)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_bytes_ == 0 || ingress_bytes_ + pending_bytes_ < byte_budget_)
+    {
+        // 확인과 대기 사이에 예산이 풀린 경우
+        asio::post(ctx_, std::move(resume));
+        return;
+    }
+    waiters_.push_back(std::move(resume));
+}
+
+void SendTransferQueue::add_ingress(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ingress_bytes_ += bytes;
+}
+
+void SendTransferQueue::drop_ingress(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ingress_bytes_ -= bytes;
+    wake_waiters_locked();
+}
+
+void SendTransferQueue::push(SendTransfer &&transfer)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ingress_bytes_ -= transfer.payload.size();
+        pending_bytes_ += transfer.payload.size();
+        queues_[static_cast<size_t>(transfer.traffic_class)].push_back(std::move(transfer));
+    }
+    queue_cv_.notify_one();
+}
+
+void SendTransferQueue::requeue(SendTransfer &&transfer)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queues_[static_cast<size_t>(transfer.traffic_class)].push_front(std::move(transfer));
+    }
+    queue_cv_.notify_one();
+}
+
+std::optional<SendTransfer> SendTransferQueue::pop(std::stop_token token)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto has_transfer = [this]
+    {
+        return std::ranges::any_of(queues_, [](const auto &queue) { return !queue.empty(); });
+    };
+    if (!queue_cv_.wait(lock, token, has_transfer))
+    {
+        return std::nullopt;
+    }
+
+    auto &queue = queues_[select_class_locked()];
+    SendTransfer transfer = std::move(queue.front());
+    queue.pop_front();
+    return transfer;
+}
+
+size_t SendTransferQueue::select_class_locked()
+{
+    const size_t interactive = static_cast<size_t>(GuardTrafficClass::INTERACTIVE);
+    if (!queues_[interactive].empty())
+    {
+        return interactive;
+    }
+
+    // 비어 있지 않은 클래스가 있으므로 몫을 새로 채우면 반드시 하나는 선택됨
+    while (true)
+    {
+        for (size_t c = interactive + 1; c < GUARD_TRAFFIC_CLASS_COUNT; ++c)
+        {
+            if (!queues_[c].empty() && credits_[c] > 0)
+            {
+                credits_[c]--;
+                return c;
+            }
+        }
+        credits_ = CLASS_WEIGHTS;
+    }
+}
+
+void SendTransferQueue::complete(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_bytes_ -= bytes;
+    wake_waiters_locked();
+}
+
+size_t SendTransferQueue::queued_transfers() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto &queue : queues_)
+    {
+        count += queue.size();
+    }
+    return count;
+}
+
+size_t SendTransferQueue::budget_in_use() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ingress_bytes_ + pending_bytes_;
+}
+
+void SendTransferQueue::wake_waiters_locked()
+{
+    // 깨어난 연결은 읽기 전에 should_pause()를 다시 확인하므로 예산 초과는 연결당 읽기 한 번 분량 이내
+    for (auto &resume : waiters_)
+    {
+        asio::post(ctx_, std::move(resume));
+    }
+    waiters_.clear();
+}
@@ -2,14 +2,39 @@
 #include <string>
 #include "SendMode.h"
 #include "RecvMode.h"
+#include "ReplayMode.h"
+#include "GuardOptions.hpp"
 
 void printUsage()
 {
     std::cerr << "Usage:\n"
-              << "  SendMode: ./CDSGuard send <L2_iface> <Dst_MAC>\n"
-              << "  RecvMode: ./CDSGuard recv <L2_iface>\n\n"
+              << "  SendMode: ./CDSGuard send <L2_iface> <Dst_MAC> [options]\n"
+              << "  RecvMode: ./CDSGuard recv <L2_iface> [options]\n"
+              << "  Replay  : ./CDSGuard replay <capture.pcapng> <recv|send> [options]\n\n"
               << "  - <L2_iface>   : 인터페이스 이름 (예: enp0s8) for raw L2 receive\n"
-              << "  - <Dst_MAC>    : SendMode에서 사용할 목적지 MAC 문자열 (aa:bb:cc:dd:ee:ff)\n";
+              << "                   쉼표로 여러 개를 지정하면 본딩 모드 (예: enp0s8,enp0s9)\n"
+              << "  - <Dst_MAC>    : SendMode에서 사용할 목적지 MAC 문자열 (aa:bb:cc:dd:ee:ff)\n"
+              << "                   본딩 모드에서는 인터페이스 순서대로 쉼표로 구분\n\n"
+              << "Options:\n"
+              << "  --failover     : 본딩 모드에서 장애 링크를 세션에서 제외하고 다른 링크로 재전송\n"
+              << "  --dedup        : (send) 페이로드를 평문으로 풀어 수신 측이 최근에 받은 청크는 참조로 대체하고 다시 암호화하여 전송\n"
+              << "  --resume       : 끊긴 전송을 수신 측이 가진 지점부터 이어서 전송 (송수신 양쪽에 지정)\n"
+              << "  --qos          : (send) 큰 전송을 1MiB 조각으로 나누어 우선순위가 높은 전송이 사이에 끼어들게 함\n"
+              << "  --spool-dir <dir> : (recv) 재개용 부분 수신 데이터 보관 위치 (기본: /var/tmp/cdsguard)\n"
+              << "  --max-transfer-mb <n> : (recv) 전송 하나의 크기 상한 MiB, 넘으면 START를 거부 (기본: 4096)\n"
+              << "  --reassembly-spool-mb <n> : (recv) 큰 전송 재조립용 디스크 스풀의 전체 상한 MiB (기본: 8192)\n"
+              << "  --forward-pool <n> : (recv) 목적지별 지속 연결을 최대 n개 유지 (--forward-framing length와 함께 지정)\n"
+              << "  --forward-framing <close|length> : (recv) 목적지 메시지 경계: 연결 종료(기본) 또는 8바이트 빅엔디언 길이 프레임\n"
+              << "  --forward-spool-mb <n> : (recv) 전달하지 못한 페이로드를 보관할 디스크 스풀 상한 MiB (기본: 1024, 0이면 버림)\n"
+              << "  --spool-fsync <always|interval|none> : (recv) 전달 스풀 디스크 동기화 정책 (기본: interval)\n"
+              << "  --decrypt-workers <n> : (recv) 복호화 작업 스레드 수 (기본: 코어 수 - 1)\n"
+              << "  --cipher <cbc|ctr|gcm> : (recv, send --dedup) 페이로드 ARIA 운용 모드 (기본: cbc, CDSGateway의 --cipher와 같아야 함)\n"
+              << "  --crypto-provider <builtin|openssl> : (recv, send --dedup) ARIA 구현 (기본: 빌드 설정, 보통 builtin)\n"
+              << "  --low-latency  : L2 스레드를 NIC 근처 코어에 고정하고 busy poll과 spin으로 대기 (코어 하나를 계속 사용)\n"
+              << "  --pin-cpus <data>[,<ack>] : L2 데이터 스레드와 ACK 리스너를 고정할 코어 번호\n"
+              << "  --capture <file> : 송수신하는 모든 GuardL2 프레임을 타임스탬프와 함께 pcapng로 기록\n"
+              << "  --replay-speed <n> : (replay) 캡처 시각 간격을 n배 빠르게 재생 (기본: 1, 0이면 기다리지 않음)\n"
+              << "  --io-uring     : TCP 수신(send)과 --forward-pool 전달(recv)에 io_uring 사용 (커널 6.0 미만이면 asio)\n";
 }
 
 int main(int argc, char *argv[])
@@ -21,30 +46,50 @@ int main(int argc, char *argv[])
     }
 
     std::string_view mode = argv[1];
+    GuardOptions options;
 
-    if (mode == "send")
+    try
     {
-        std::string dst_mac = argv[3];
+        options = parse_guard_options(argc, argv, mode == "send" || mode == "replay" ? 4 : 3);
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cerr << e.what() << "\n";
+        printUsage();
+        return 1;
+    }
 
-        if (argc != 4)
+    if (mode == "send")
+    {
+        if (argc < 4)
         {
             printUsage();
             return 1;
         }
 
         std::string l2_iface = argv[2];
+        std::string dst_mac = argv[3];
 
-        run_send_mode(l2_iface, dst_mac);
+        run_send_mode(l2_iface, dst_mac, options);
     }
     else if (mode == "recv")
     {
-        if (argc != 3)
+        if (argc < 3)
         {
             printUsage();
             return 1;
         }
         std::string l2_iface = argv[2];
-        run_recv_mode(l2_iface);
+        run_recv_mode(l2_iface, options);
+    }
+    else if (mode == "replay")
+    {
+        if (argc < 4)
+        {
+            printUsage();
+            return 1;
+        }
+        run_replay_mode(argv[2], argv[3], options);
     }
     else
     {
@@ -0,0 +1,71 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cstring>
+#include "GuardL2Dedup.hpp"
+
+// 송신 인덱스와 수신 캐시의 내보내는 순서가 어긋나 REF가 캐시에 없는 청크를 가리키는지 확인
+// 기본 용량(인덱스 32MiB, 캐시 64MiB)에서 X 1MiB -> 새 데이터 50MiB -> X -> 새 데이터 25MiB -> X 순서로 전송
+
+constexpr static size_t MESSAGE_SIZE = 1024 * 1024;
+
+static std::mt19937_64 rng(20260109);
+
+static std::vector<uint8_t> random_message()
+{
+    std::vector<uint8_t> msg(MESSAGE_SIZE);
+    for (size_t i = 0; i < msg.size(); i += sizeof(uint64_t))
+    {
+        uint64_t value = rng();
+        std::memcpy(msg.data() + i, &value, sizeof(value));
+    }
+    return msg;
+}
+
+static bool transfer(GuardL2DedupEncoder &encoder, GuardL2DedupDecoder &decoder, const std::vector<uint8_t> &msg, const char *label)
+{
+    std::vector<uint8_t> stream = encoder.encode(msg);
+    std::optional<std::vector<uint8_t>> restored = decoder.decode(stream);
+    if (!restored || *restored != msg)
+    {
+        std::cerr << "[FAIL] " << label << ": restore failed (new " << encoder.last_new_bytes() << ", ref " << encoder.last_ref_bytes() << ")\n";
+        return false;
+    }
+    encoder.commit(1);
+    return true;
+}
+
+static bool send_fresh(GuardL2DedupEncoder &encoder, GuardL2DedupDecoder &decoder, size_t megabytes)
+{
+    for (size_t i = 0; i < megabytes; ++i)
+    {
+        if (!transfer(encoder, decoder, random_message(), "fresh data"))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    GuardL2DedupEncoder encoder;
+    GuardL2DedupDecoder decoder;
+    const std::vector<uint8_t> x = random_message();
+
+    bool ok = transfer(encoder, decoder, x, "X (1st)")
+           && send_fresh(encoder, decoder, 50)
+           && transfer(encoder, decoder, x, "X (2nd, evicted from index -> NEW)")
+           && send_fresh(encoder, decoder, 25)
+           && transfer(encoder, decoder, x, "X (3rd, REF)");
+
+    if (ok && encoder.last_ref_bytes() != x.size())
+    {
+        std::cerr << "[FAIL] X (3rd) was expected to be sent as REF only (ref " << encoder.last_ref_bytes() << ")\n";
+        ok = false;
+    }
+
+    std::cout << (ok ? "[PASS] dedup cache eviction order matches index\n" : "[FAIL] dedup cache eviction order\n");
+    return ok ? 0 : 1;
+}
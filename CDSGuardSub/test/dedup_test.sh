@@ -0,0 +1,9 @@
+set -e
+
+echo ">> Compiling TestDedupCache.cpp …"
+g++ -std=c++23 -O2 TestDedupCache.cpp ../src/GuardL2Dedup.cpp -o TestDedupCache \
+    -I ../include \
+    -lcrypto
+
+echo ">> Running TestDedupCache …"
+./TestDedupCache
@@ -0,0 +1,133 @@
+#include "encryption/ARIAReference.h"
+#include "encryption/ARIATable.h"
+#include "encryption/ARIASimd.h"
+#include "encryption/ARIAAlgorithm.h"
+#include "common/WorkerPool.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <array>
+#include <x86intrin.h>
+
+// ARIA 블록 코어 단독 처리량 비교 (참조 구현, T-테이블, SIMD 백엔드별).
+// 키 길이별로 ECB처럼 블록을 연속 처리하고 MiB/s와 cycles/byte(TSC 기준)를 출력.
+// 이어서 ARIA-256 CBC 복호화를 직렬과 작업 스레드 수별 조각 병렬로 비교 (cycles/byte는 모든 코어 합이 아닌 경과 TSC)하고,
+// 마지막으로 모드별 메시지 암호화/복호화를 provider(builtin, openssl)별로 비교
+// 사용법: ARIACoreBench [MiB] [반복 횟수]
+
+struct Result {
+    double mib_per_sec = 0;
+    double cycles_per_byte = 0;
+};
+
+static Result best_of(std::vector<uint8_t>& data, int iterations, const std::function<void()>& fn) {
+    Result best;
+    for (int i = 0; i < iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        unsigned long long tsc_start = __rdtsc();
+        fn();
+        unsigned long long tsc = __rdtsc() - tsc_start;
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        double mib = data.size() / (1024.0 * 1024.0) / elapsed.count();
+        if (mib > best.mib_per_sec) {
+            best = {mib, static_cast<double>(tsc) / data.size()};
+        }
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t mib = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8;
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 3;
+
+    std::mt19937 rng(42);
+    std::vector<uint8_t> key(32);
+    std::vector<uint8_t> data(mib * 1024 * 1024);
+    for (auto& b : key) b = static_cast<uint8_t>(rng());
+    for (auto& b : data) b = static_cast<uint8_t>(rng());
+    const size_t blocks = data.size() / 16;
+
+    std::printf("payload %zu MiB, best of %d, best SIMD backend: %s\n",
+                mib, iterations, ARIASimdBackendName(ARIASimdBestBackend()));
+    std::printf("%-10s %-12s %10s %12s\n", "", "core", "MiB/s", "cycles/byte");
+    for (int key_bits : {128, 192, 256}) {
+        Byte round_keys[16 * 17];
+        int rounds = EncKeySetup(key.data(), round_keys, key_bits);
+        auto print = [&](const char* name, Result r) {
+            std::printf("ARIA-%-5d %-12s %10.1f %12.2f\n", key_bits, name, r.mib_per_sec, r.cycles_per_byte);
+        };
+
+        print("reference", best_of(data, iterations, [&] {
+            for (size_t off = 0; off < data.size(); off += 16) {
+                Crypt(data.data() + off, rounds, round_keys, data.data() + off);
+            }
+        }));
+        print("table", best_of(data, iterations, [&] {
+            for (size_t off = 0; off < data.size(); off += 16) {
+                CryptTable(data.data() + off, rounds, round_keys, data.data() + off);
+            }
+        }));
+        for (ARIASimdBackend backend : {ARIASimdBackend::AesniAvx, ARIASimdBackend::GfniAvx2, ARIASimdBackend::GfniAvx512}) {
+            if (!ARIASimdSupported(backend)) {
+                continue;
+            }
+            print(ARIASimdBackendName(backend), best_of(data, iterations, [&] {
+                CryptBlocks(backend, data.data(), data.data(), blocks, rounds, round_keys);
+            }));
+        }
+    }
+
+    ARIAAlgorithm aria(key);
+    std::array<uint8_t, 16> iv{};
+    auto cbc_decrypt = [&](WorkerPool* pool) {
+        ARIAAlgorithm::CbcState state = aria.beginDecrypt(iv);
+        if (pool) {
+            ARIAAlgorithm::decryptBlocksParallel(state, data, *pool);
+        } else {
+            ARIAAlgorithm::decryptBlocks(state, data);
+        }
+    };
+    std::printf("\nARIA-256 CBC decrypt, %u hardware threads\n", std::thread::hardware_concurrency());
+    Result serial = best_of(data, iterations, [&] { cbc_decrypt(nullptr); });
+    std::printf("%-22s %10.1f %12.2f\n", "serial", serial.mib_per_sec, serial.cycles_per_byte);
+    for (unsigned workers = 1; workers < std::max(2u, std::thread::hardware_concurrency()); workers *= 2) {
+        WorkerPool pool(workers);
+        Result r = best_of(data, iterations, [&] { cbc_decrypt(&pool); });
+        char name[32];
+        std::snprintf(name, sizeof(name), "parallel, %u+1 threads", workers);
+        std::printf("%-22s %10.1f %12.2f  x%.2f\n", name, r.mib_per_sec, r.cycles_per_byte, r.mib_per_sec / serial.mib_per_sec);
+    }
+
+    // 메시지 단위 (encryptInPlace/decryptInPlace), 복호화 행은 매번 암호문을 다시 만들어 두고 잼
+    std::printf("\nARIA-256 message, provider comparison\n");
+    for (ARIAAlgorithm::Mode mode : {ARIAAlgorithm::Mode::Cbc, ARIAAlgorithm::Mode::Ctr, ARIAAlgorithm::Mode::Gcm}) {
+        const char* mode_name = mode == ARIAAlgorithm::Mode::Cbc ? "cbc" : (mode == ARIAAlgorithm::Mode::Ctr ? "ctr" : "gcm");
+        for (ARIAAlgorithm::Provider provider : {ARIAAlgorithm::Provider::Builtin, ARIAAlgorithm::Provider::OpenSsl}) {
+            if (!ARIAAlgorithm::providerAvailable(provider)) {
+                continue;
+            }
+            ARIAAlgorithm message_aria(key, mode, ARIAAlgorithm::Core::Simd, provider);
+            std::vector<uint8_t> message(ARIAAlgorithm::ciphertextSize(mode, data.size()));
+            Result enc = best_of(data, iterations, [&] { message_aria.encryptInPlace(message, data.size()); });
+            Result dec;
+            for (int i = 0; i < iterations; ++i) {
+                message_aria.encryptInPlace(message, data.size());
+                Result r = best_of(data, 1, [&] { message_aria.decryptInPlace(message); });
+                if (r.mib_per_sec > dec.mib_per_sec) {
+                    dec = r;
+                }
+            }
+            char name[32];
+            std::snprintf(name, sizeof(name), "%s %s encrypt", mode_name, ARIAAlgorithm::providerName(provider));
+            std::printf("%-22s %10.1f %12.2f\n", name, enc.mib_per_sec, enc.cycles_per_byte);
+            std::snprintf(name, sizeof(name), "%s %s decrypt", mode_name, ARIAAlgorithm::providerName(provider));
+            std::printf("%-22s %10.1f %12.2f\n", name, dec.mib_per_sec, dec.cycles_per_byte);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,227 @@
+#include "encryption/ARIAAlgorithm.h"
+#include "encryption/ARIAReference.h"
+#include "encryption/ARIATable.h"
+#include "encryption/ARIASimd.h"
+#include "protocol/ProtocolEngine.h"
+#include "protocol/ProtocolBuffer.h"
+#include "protocol/ShiftModule.h"
+#include "protocol/PaddingModule.h"
+#include "protocol/EncryptionModule.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Google Benchmark 모음: 키 확장, 블록 코어, 메시지 암복호화(CBC 64B~256MiB), 모듈별 처리, 엔진 왕복.
+// ARIACoreBench/ProtocolPipelineBench는 표로 보는 비교용이고, 이것은 결과를 모아 두고 추적하는 용도.
+// JSON으로 남기려면: PacketProcessorBench --benchmark_out=result.json --benchmark_out_format=json
+// (cmake --build . --target bench_json 은 빌드 디렉터리에 PacketProcessorBench.json을 씀)
+
+static std::vector<uint8_t> random_bytes(size_t len) {
+    std::vector<uint8_t> v(len);
+    std::mt19937 rng(42);
+    for (auto& b : v) b = static_cast<uint8_t>(rng());
+    return v;
+}
+
+static const std::vector<uint8_t>& bench_key() {
+    static const std::vector<uint8_t> key = random_bytes(32);
+    return key;
+}
+
+static void set_bytes(benchmark::State& state, size_t bytes) {
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(bytes));
+}
+
+// 키 확장 (암호화 + 복호화 라운드 키), 인자는 키 비트 수
+static void BM_KeySetup(benchmark::State& state) {
+    const int key_bits = static_cast<int>(state.range(0));
+    Byte enc_keys[16 * 17], dec_keys[16 * 17];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(EncKeySetup(bench_key().data(), enc_keys, key_bits));
+        benchmark::DoNotOptimize(DecKeySetup(bench_key().data(), dec_keys, key_bits));
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_KeySetup)->Arg(128)->Arg(192)->Arg(256);
+
+// ARIAAlgorithm 생성 (키 확장 + 모드별 준비, GCM은 H 계산과 GHASH 표)
+template <ARIAAlgorithm::Mode Mode>
+static void BM_AlgorithmSetup(benchmark::State& state) {
+    for (auto _ : state) {
+        ARIAAlgorithm aria(bench_key(), Mode);
+        benchmark::DoNotOptimize(&aria);
+    }
+}
+BENCHMARK_TEMPLATE(BM_AlgorithmSetup, ARIAAlgorithm::Mode::Cbc);
+BENCHMARK_TEMPLATE(BM_AlgorithmSetup, ARIAAlgorithm::Mode::Gcm);
+
+// 블록 하나씩 암호화/복호화 (참조, T-테이블). 4KiB를 블록마다 호출
+template <ARIAAlgorithm::BlockFn Fn, bool Decrypt>
+static void BM_BlockCore(benchmark::State& state) {
+    Byte round_keys[16 * 17];
+    const int rounds = Decrypt ? DecKeySetup(bench_key().data(), round_keys, 256)
+                               : EncKeySetup(bench_key().data(), round_keys, 256);
+    std::vector<uint8_t> data = random_bytes(4096);
+    for (auto _ : state) {
+        for (size_t off = 0; off < data.size(); off += 16) {
+            Fn(data.data() + off, rounds, round_keys, data.data() + off);
+        }
+        benchmark::ClobberMemory();
+    }
+    set_bytes(state, data.size());
+}
+BENCHMARK_TEMPLATE(BM_BlockCore, Crypt, false)->Name("BM_BlockEncrypt/reference");
+BENCHMARK_TEMPLATE(BM_BlockCore, Crypt, true)->Name("BM_BlockDecrypt/reference");
+BENCHMARK_TEMPLATE(BM_BlockCore, CryptTable, false)->Name("BM_BlockEncrypt/table");
+BENCHMARK_TEMPLATE(BM_BlockCore, CryptTable, true)->Name("BM_BlockDecrypt/table");
+
+// SIMD 백엔드 묶음 처리 (ECB처럼 4KiB), 인자는 ARIASimdBackend. 이 CPU에서 못 쓰는 백엔드는 건너뜀
+template <bool Decrypt>
+static void BM_BlockSimd(benchmark::State& state) {
+    const auto backend = static_cast<ARIASimdBackend>(state.range(0));
+    if (!ARIASimdSupported(backend)) {
+        state.SkipWithError("backend not supported on this CPU");
+        return;
+    }
+    state.SetLabel(ARIASimdBackendName(backend));
+    Byte round_keys[16 * 17];
+    const int rounds = Decrypt ? DecKeySetup(bench_key().data(), round_keys, 256)
+                               : EncKeySetup(bench_key().data(), round_keys, 256);
+    std::vector<uint8_t> data = random_bytes(4096);
+    for (auto _ : state) {
+        CryptBlocks(backend, data.data(), data.data(), data.size() / 16, rounds, round_keys);
+        benchmark::ClobberMemory();
+    }
+    set_bytes(state, data.size());
+}
+static void simd_backends(benchmark::internal::Benchmark* b) {
+    for (ARIASimdBackend backend : {ARIASimdBackend::AesniAvx, ARIASimdBackend::GfniAvx2, ARIASimdBackend::GfniAvx512}) {
+        b->Arg(static_cast<int64_t>(backend));
+    }
+}
+BENCHMARK_TEMPLATE(BM_BlockSimd, false)->Name("BM_BlockEncrypt/simd")->Apply(simd_backends);
+BENCHMARK_TEMPLATE(BM_BlockSimd, true)->Name("BM_BlockDecrypt/simd")->Apply(simd_backends);
+
+// 메시지 암호화/복호화 (encryptInPlace/decryptInPlace), 인자는 평문 크기.
+// 복호화는 두 번째 반복부터 앞 반복의 출력을 다시 넣으므로 패딩/태그 확인은 실패하지만 처리하는 양은 같음
+template <ARIAAlgorithm::Mode Mode, bool Decrypt>
+static void BM_Message(benchmark::State& state) {
+    const size_t size = static_cast<size_t>(state.range(0));
+    const ARIAAlgorithm aria(bench_key(), Mode);
+    std::vector<uint8_t> buffer(ARIAAlgorithm::ciphertextSize(Mode, size));
+    aria.encryptInPlace(buffer, size);
+    for (auto _ : state) {
+        if constexpr (Decrypt) {
+            benchmark::DoNotOptimize(aria.decryptInPlace(buffer));
+        } else {
+            aria.encryptInPlace(buffer, size);
+        }
+        benchmark::ClobberMemory();
+    }
+    set_bytes(state, size);
+}
+BENCHMARK_TEMPLATE(BM_Message, ARIAAlgorithm::Mode::Cbc, false)->Name("BM_CbcEncrypt")
+    ->RangeMultiplier(8)->Range(64, 256 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Message, ARIAAlgorithm::Mode::Cbc, true)->Name("BM_CbcDecrypt")
+    ->RangeMultiplier(8)->Range(64, 256 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Message, ARIAAlgorithm::Mode::Ctr, false)->Name("BM_CtrEncrypt")
+    ->RangeMultiplier(16)->Range(64, 16 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Message, ARIAAlgorithm::Mode::Gcm, false)->Name("BM_GcmEncrypt")
+    ->RangeMultiplier(16)->Range(64, 16 << 20)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Message, ARIAAlgorithm::Mode::Gcm, true)->Name("BM_GcmDecrypt")
+    ->RangeMultiplier(16)->Range(64, 16 << 20)->Unit(benchmark::kMicrosecond);
+
+// 모듈 하나의 vector API와 제자리 API, 인자는 데이터 크기
+static std::unique_ptr<IProtocolModule> make_shift() { return std::make_unique<ShiftModule>(8); }
+static std::unique_ptr<IProtocolModule> make_padding() { return std::make_unique<PaddingModule>(std::vector<uint8_t>{0, 0, 0, 0}); }
+static std::unique_ptr<IProtocolModule> make_encryption() { return std::make_unique<EncryptionModule>(bench_key()); }
+
+template <std::unique_ptr<IProtocolModule> (*Make)()>
+static void BM_ModuleVector(benchmark::State& state) {
+    const std::unique_ptr<IProtocolModule> module = Make();
+    const std::vector<uint8_t> data = random_bytes(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(module->reverse(module->process(data)));
+    }
+    set_bytes(state, data.size());
+}
+
+template <std::unique_ptr<IProtocolModule> (*Make)()>
+static void BM_ModuleInPlace(benchmark::State& state) {
+    const std::unique_ptr<IProtocolModule> module = Make();
+    const std::vector<uint8_t> data = random_bytes(static_cast<size_t>(state.range(0)));
+    ProtocolBuffer buffer(data, module->headroom(), module->tailroom());
+    for (auto _ : state) {
+        module->processInPlace(buffer);
+        module->reverseInPlace(buffer);
+        benchmark::ClobberMemory();
+    }
+    set_bytes(state, data.size());
+}
+BENCHMARK_TEMPLATE(BM_ModuleVector, make_shift)->Name("BM_ShiftModule/vector")->Range(64, 1 << 20);
+BENCHMARK_TEMPLATE(BM_ModuleInPlace, make_shift)->Name("BM_ShiftModule/inplace")->Range(64, 1 << 20);
+BENCHMARK_TEMPLATE(BM_ModuleVector, make_padding)->Name("BM_PaddingModule/vector")->Range(64, 1 << 20);
+BENCHMARK_TEMPLATE(BM_ModuleInPlace, make_padding)->Name("BM_PaddingModule/inplace")->Range(64, 1 << 20);
+BENCHMARK_TEMPLATE(BM_ModuleVector, make_encryption)->Name("BM_EncryptionModule/vector")->Range(64, 1 << 20);
+BENCHMARK_TEMPLATE(BM_ModuleInPlace, make_encryption)->Name("BM_EncryptionModule/inplace")->Range(64, 1 << 20);
+
+// Shift → ARIA-CBC → Padding 엔진 왕복 (encrypt 후 decrypt), 인자는 데이터 크기
+static ProtocolEngine make_engine() {
+    ProtocolEngine engine;
+    engine.addModule(make_shift());
+    engine.addModule(make_encryption());
+    engine.addModule(make_padding());
+    return engine;
+}
+
+static void BM_EngineRoundTrip(benchmark::State& state) {
+    const ProtocolEngine engine = make_engine();
+    const std::vector<uint8_t> data = random_bytes(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine.decrypt(engine.encrypt(data)));
+    }
+    set_bytes(state, data.size());
+}
+BENCHMARK(BM_EngineRoundTrip)->RangeMultiplier(8)->Range(64, 16 << 20)->Unit(benchmark::kMicrosecond);
+
+static void BM_EngineRoundTripInPlace(benchmark::State& state) {
+    const ProtocolEngine engine = make_engine();
+    const std::vector<uint8_t> data = random_bytes(static_cast<size_t>(state.range(0)));
+    ProtocolBuffer buffer(data, engine.headroom(), engine.tailroom());
+    for (auto _ : state) {
+        engine.encryptInPlace(buffer);
+        engine.decryptInPlace(buffer);
+        benchmark::ClobberMemory();
+    }
+    set_bytes(state, data.size());
+}
+BENCHMARK(BM_EngineRoundTripInPlace)->RangeMultiplier(8)->Range(64, 16 << 20)->Unit(benchmark::kMicrosecond);
+
+// 스트리밍 왕복, 64KiB 조각
+static void BM_EngineStreamRoundTrip(benchmark::State& state) {
+    const ProtocolEngine engine = make_engine();
+    const std::vector<uint8_t> data = random_bytes(static_cast<size_t>(state.range(0)));
+    constexpr size_t CHUNK = 64 * 1024;
+    std::vector<uint8_t> cipher, plain;
+    for (auto _ : state) {
+        cipher.clear();
+        plain.clear();
+        ProtocolEngine::Stream enc = engine.beginEncrypt();
+        for (size_t off = 0; off < data.size(); off += CHUNK) {
+            enc.update(std::span<const uint8_t>(data).subspan(off, std::min(CHUNK, data.size() - off)), cipher);
+        }
+        enc.finish(cipher);
+        ProtocolEngine::Stream dec = engine.beginDecrypt();
+        for (size_t off = 0; off < cipher.size(); off += CHUNK) {
+            dec.update(std::span<const uint8_t>(cipher).subspan(off, std::min(CHUNK, cipher.size() - off)), plain);
+        }
+        dec.finish(plain);
+        benchmark::DoNotOptimize(plain.data());
+    }
+    set_bytes(state, data.size());
+}
+BENCHMARK(BM_EngineStreamRoundTrip)->RangeMultiplier(16)->Range(64 << 10, 16 << 20)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
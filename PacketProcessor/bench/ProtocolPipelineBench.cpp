@@ -0,0 +1,95 @@
+#include "protocol/ProtocolEngine.h"
+#include "protocol/ShiftModule.h"
+#include "protocol/PaddingModule.h"
+#include "protocol/EncryptionModule.h"
+#include "protocol/FusedPipeline.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// 같은 Shift → ARIA-CBC → Padding 구성을 세 방식으로 처리하여 처리량 비교
+//  - module chain : 모듈 vector API를 차례로 호출 (단계마다 새 vector, user-041 이전 엔진과 같은 복사 수)
+//  - engine       : ProtocolEngine (제자리 처리, 단계마다 가상 호출 + 버퍼 전체 한 번씩)
+//  - fused        : FusedPipeline (shift와 암호화를 4KB 조각마다 이어서)
+// 사용법: ProtocolPipelineBench [MiB] [반복 횟수]
+
+template <typename Fn>
+static double best_mib_per_sec(size_t bytes, int iterations, Fn&& fn) {
+    double best = 0;
+    for (int i = 0; i < iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::max(best, bytes / (1024.0 * 1024.0) / elapsed.count());
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t mib = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16;
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 3;
+
+    std::vector<uint8_t> key(32);
+    std::vector<uint8_t> data(mib * 1024 * 1024);
+    std::mt19937 rng(42);
+    for (auto& b : key) b = static_cast<uint8_t>(rng());
+    for (auto& b : data) b = static_cast<uint8_t>(rng());
+
+    ShiftModule shift(8);
+    EncryptionModule encryption(key);
+    PaddingModule padding(std::vector<uint8_t>{0,0,0,0});
+
+    ProtocolEngine engine;
+    engine.addModule(std::make_unique<ShiftModule>(8));
+    engine.addModule(std::make_unique<EncryptionModule>(key));
+    engine.addModule(std::make_unique<PaddingModule>(std::vector<uint8_t>{0,0,0,0}));
+
+    auto fused = makeFusedPipeline(ShiftStage{8}, AriaCbcStage(key), PaddingStage{{0,0,0,0}});
+
+    std::vector<uint8_t> cipher = engine.encrypt(data);
+    std::vector<uint8_t> out;
+
+    std::printf("payload %zu MiB, best of %d\n", mib, iterations);
+    std::printf("%-14s %12s %12s\n", "", "encrypt MiB/s", "decrypt MiB/s");
+
+    double chain_enc = best_mib_per_sec(data.size(), iterations, [&] { out = padding.process(encryption.process(shift.process(data))); });
+    double chain_dec = best_mib_per_sec(data.size(), iterations, [&] { out = shift.reverse(encryption.reverse(padding.reverse(cipher))); });
+    std::printf("%-14s %12.1f %12.1f\n", "module chain", chain_enc, chain_dec);
+
+    double engine_enc = best_mib_per_sec(data.size(), iterations, [&] { out = engine.encrypt(data); });
+    double engine_dec = best_mib_per_sec(data.size(), iterations, [&] { out = engine.decrypt(cipher); });
+    std::printf("%-14s %12.1f %12.1f\n", "engine", engine_enc, engine_dec);
+
+    double fused_enc = best_mib_per_sec(data.size(), iterations, [&] { out = fused.encrypt(data); });
+    double fused_dec = best_mib_per_sec(data.size(), iterations, [&] { out = fused.decrypt(cipher); });
+    std::printf("%-14s %12.1f %12.1f\n", "fused", fused_enc, fused_dec);
+
+    // 스트리밍: 1MiB 조각마다 출력을 비우므로 메모리는 조각 크기만큼만 씀
+    constexpr size_t STREAM_CHUNK = 1024 * 1024;
+    auto stream_through = [&](ProtocolEngine::Stream stream, const std::vector<uint8_t>& in) {
+        for (size_t off = 0; off < in.size(); off += STREAM_CHUNK) {
+            out.clear();
+            stream.update(std::span<const uint8_t>(in).subspan(off, std::min(STREAM_CHUNK, in.size() - off)), out);
+        }
+        stream.finish(out);
+    };
+    double stream_enc = best_mib_per_sec(data.size(), iterations, [&] { stream_through(engine.beginEncrypt(), data); });
+    double stream_dec = best_mib_per_sec(data.size(), iterations, [&] { stream_through(engine.beginDecrypt(), cipher); });
+    std::printf("%-14s %12.1f %12.1f\n", "engine stream", stream_enc, stream_dec);
+
+    // 같은 엔진 구성에서 암호 운용 모드만 바꾼 비교
+    for (ARIAAlgorithm::Mode mode : {ARIAAlgorithm::Mode::Ctr, ARIAAlgorithm::Mode::Gcm}) {
+        ProtocolEngine mode_engine;
+        mode_engine.addModule(std::make_unique<ShiftModule>(8));
+        mode_engine.addModule(std::make_unique<EncryptionModule>(key, mode));
+        mode_engine.addModule(std::make_unique<PaddingModule>(std::vector<uint8_t>{0,0,0,0}));
+        std::vector<uint8_t> mode_cipher = mode_engine.encrypt(data);
+        double mode_enc = best_mib_per_sec(data.size(), iterations, [&] { out = mode_engine.encrypt(data); });
+        double mode_dec = best_mib_per_sec(data.size(), iterations, [&] { out = mode_engine.decrypt(mode_cipher); });
+        std::printf("%-14s %12.1f %12.1f\n", mode == ARIAAlgorithm::Mode::Ctr ? "engine (ctr)" : "engine (gcm)", mode_enc, mode_dec);
+    }
+
+    return out.empty() ? 1 : 0;
+}
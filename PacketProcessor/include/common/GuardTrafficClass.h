@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+// 게이트웨이(CDSGateway)와 가드(CDSGuardSub)가 함께 쓰는 트래픽 클래스와 페이로드 태그 정의.
+// 양쪽이 같은 값을 보도록 이 헤더 하나에만 둠
+
+/**
+ * @brief 가드를 지나는 전송의 우선순위 분류 (작을수록 먼저)
+ */
+enum class GuardTrafficClass : uint8_t {
+    INTERACTIVE = 0, // 텍스트 메시지 등 지연에 민감한 작은 전송
+    DOCUMENT    = 1, // 일반 문서
+    BULK        = 2, // 대용량 파일
+};
+
+constexpr size_t GUARD_TRAFFIC_CLASS_COUNT = 3;
+
+/**
+ * 게이트웨이가 가드로 보내는 페이로드 맨 앞에 붙이는 클래스 태그 (0xC0 | class)
+ * 주소 헤더의 첫 바이트(IP 버전 4/6)와 겹치지 않으므로 태그가 없는 이전 게이트웨이와도 구분됨
+ */
+constexpr uint8_t GUARD_TRAFFIC_CLASS_TAG = 0xC0;
+
+constexpr size_t GUARD_INTERACTIVE_MAX_SIZE = 64 * 1024;        // 태그가 없을 때 이 크기 이하는 INTERACTIVE
+constexpr size_t GUARD_DOCUMENT_MAX_SIZE = 16 * 1024 * 1024;    // 이 크기를 넘는 파일은 BULK (게이트웨이 태그, 가드 크기 분류 공통)
+
+constexpr uint8_t make_traffic_class_tag(GuardTrafficClass traffic_class)
+{
+    return GUARD_TRAFFIC_CLASS_TAG | static_cast<uint8_t>(traffic_class);
+}
+
+inline std::optional<GuardTrafficClass> parse_traffic_class_tag(uint8_t tag)
+{
+    if ((tag & 0xF0) != GUARD_TRAFFIC_CLASS_TAG || (tag & 0x0F) >= GUARD_TRAFFIC_CLASS_COUNT)
+    {
+        return std::nullopt;
+    }
+    return static_cast<GuardTrafficClass>(tag & 0x0F);
+}
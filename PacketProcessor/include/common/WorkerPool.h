@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+// 고정 크기 작업 스레드 풀 (fork-join).
+// run(n, fn)은 fn(0) ... fn(n-1)을 작업 스레드와 호출한 스레드가 나누어 실행하고 모두 끝나야 돌아옴.
+// 호출한 스레드도 작업을 가져가므로 풀이 다른 호출로 바쁘거나 작업 스레드가 0개여도 멈추지 않으며,
+// 여러 스레드가 동시에 run을 불러도 됨
+class WorkerPool {
+public:
+    explicit WorkerPool(size_t workers);
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // 작업 스레드 수 (호출한 스레드 제외)
+    size_t workers() const { return threads_.size(); }
+    void run(size_t tasks, const std::function<void(size_t)>& fn);
+
+    // 프로세스 공용 풀. 작업 스레드는 코어 수 - 1개 (처음 쓸 때 만듦)
+    static WorkerPool& shared();
+
+private:
+    struct Job;
+    void workerLoop();
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::shared_ptr<Job>> jobs_;
+    bool stop_ = false;
+    std::vector<std::thread> threads_;
+};
@@ -1,13 +1,166 @@
-#pragma once
-#include <vector>
-#include <cstdint>
-
-class ARIAAlgorithm {
-public:
-    explicit ARIAAlgorithm(const std::vector<uint8_t>& key);
-    std::vector<uint8_t> encrypt(const std::vector<uint8_t>& data);
-    std::vector<uint8_t> decrypt(const std::vector<uint8_t>& data);
-    static constexpr size_t BLOCK_SIZE = 16;
-private:
-    std::vector<uint8_t> key_;
-};
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <memory>
+#include <optional>
+#include <span>
+#include "encryption/GHash.h"
+
+class WorkerPool;
+class ARIAOpenSsl;
+
+// 생성할 때 암호화/복호화 라운드 키를 한 번만 만들어 둠.
+// 생성 뒤에는 바뀌지 않으므로 여러 스레드가 같은 객체를 함께 써도 됨 (키 교체는 ARIAContextSlot)
+class ARIAAlgorithm {
+public:
+    // 블록 암호 코어.
+    //  - Simd      : CBC 복호화처럼 블록끼리 독립인 곳은 SIMD 다중 블록 코어(ARIASimd), 나머지는 Table
+    //  - Table     : 32비트 T-테이블 구현
+    //  - Reference : RFC 참조 구현 (검증/비교용)
+    enum class Core { Reference, Table, Simd };
+
+    // 운용 모드 (메시지 형식).
+    //  - Cbc : [IV 16][암호문 + PKCS#7 패딩]   기존 형식. 암호화는 블록마다 직렬
+    //  - Ctr : [카운터 블록 16][암호문]        패딩 없음, 블록끼리 독립 (무결성 없음)
+    //  - Gcm : [nonce 12][암호문][태그 16]     CTR + GHASH 인증. 복호화할 때 태그가 맞지 않으면 실패
+    enum class Mode { Cbc, Ctr, Gcm };
+
+    // 메시지 단위 처리(encryptInPlace/decryptInPlace, encrypt/decrypt)를 맡는 구현.
+    //  - Builtin : 이 라이브러리의 코어 (Core로 고름)
+    //  - OpenSsl : OpenSSL EVP (EVP_aria_*_cbc/ctr/gcm). USE_OPENSSL_ARIA로 빌드했고 OpenSSL이 ARIA를 제공할 때만
+    // 두 구현의 메시지 형식은 같음. 스트림, CbcState, ctrXor는 Provider와 관계없이 Builtin 코어를 씀
+    enum class Provider { Builtin, OpenSsl };
+
+    // provider를 생략하면 defaultProvider(). 쓸 수 없는 provider면 std::invalid_argument
+    explicit ARIAAlgorithm(const std::vector<uint8_t>& key, Mode mode = Mode::Cbc, Core core = Core::Simd);
+    ARIAAlgorithm(const std::vector<uint8_t>& key, Mode mode, Core core, Provider provider);
+    Mode mode() const { return mode_; }
+    Provider provider() const { return openssl_ ? Provider::OpenSsl : Provider::Builtin; }
+
+    static bool providerAvailable(Provider provider);
+    static const char* providerName(Provider provider);
+    // 이후 provider를 생략하고 만드는 ARIAAlgorithm의 구현 (처음 값은 빌드 설정 ARIA_DEFAULT_PROVIDER).
+    // 쓸 수 없는 provider면 std::invalid_argument
+    static void setDefaultProvider(Provider provider);
+    static Provider defaultProvider();
+    std::vector<uint8_t> encrypt(const std::vector<uint8_t>& data) const;
+    std::vector<uint8_t> decrypt(const std::vector<uint8_t>& data) const;
+
+    static constexpr size_t BLOCK_SIZE = 16;
+    static constexpr size_t GCM_NONCE_SIZE = 12;
+    static constexpr size_t GCM_TAG_SIZE = 16;
+
+    // 평문 plain_len 바이트를 CBC로 암호화한 결과 크기 (IV + PKCS#7 패딩 포함)
+    static size_t ciphertextSize(size_t plain_len);
+    static size_t ciphertextSize(Mode mode, size_t plain_len);
+    // 평문 앞에 붙는 크기 (IV/nonce)와 뒤에 붙는 최대 크기 (패딩/태그)
+    static size_t headerSize(Mode mode);
+    static size_t maxTrailerSize(Mode mode);
+
+    // buffer = [머리 자리][평문 plain_len][꼬리 자리], 크기는 ciphertextSize(mode(), plain_len).
+    // IV/nonce를 새로 만들고 (CBC는 패딩을 채운 뒤) 제자리에서 암호화함
+    void encryptInPlace(std::span<uint8_t> buffer, size_t plain_len) const;
+    // 암호화 결과를 제자리에서 복호화. 평문은 buffer[headerSize(mode())]부터이며 그 길이를 돌려줌.
+    // 길이나 패딩이 잘못되었거나 GCM 태그가 맞지 않으면 std::nullopt
+    // (GCM은 평문 자리를 0으로 지움, 그 밖의 모드는 buffer 내용이 정의되지 않음)
+    std::optional<size_t> decryptInPlace(std::span<uint8_t> buffer) const;
+
+    // CTR 키스트림: counter부터 블록마다 하위 32비트를 1씩 늘리며 E(counter)를 data에 XOR (암호화/복호화 같음).
+    // counter는 쓴 블록 수만큼 늘어나므로 조각으로 나누어 이어 부를 수 있음 (마지막 조각 외에는 블록 배수)
+    void ctrXor(std::array<uint8_t, BLOCK_SIZE>& counter, std::span<uint8_t> data) const;
+
+    // 메시지를 여러 조각으로 나누어 CBC 처리할 때 쓰는 상태 (라운드 키 + 직전 암호문 블록).
+    // 라운드 키는 ARIAAlgorithm 것을 가리키므로 상태를 쓰는 동안 ARIAAlgorithm이 살아 있어야 함
+    using BlockFn = void (*)(const unsigned char* in, int rounds, const unsigned char* roundKeys, unsigned char* out);
+    struct CbcState {
+        BlockFn crypt = nullptr;
+        bool batched = false;   // decryptBlocks가 여러 블록을 한 번에 복호화함 (Core::Simd)
+        const uint8_t* roundKeys = nullptr;
+        int rounds = 0;
+        std::array<uint8_t, BLOCK_SIZE> chain{};
+    };
+    static std::array<uint8_t, BLOCK_SIZE> generateIv();
+    CbcState beginEncrypt(std::span<const uint8_t, BLOCK_SIZE> iv) const;
+    CbcState beginDecrypt(std::span<const uint8_t, BLOCK_SIZE> iv) const;
+    // blocks(블록 배수)를 제자리에서 이어서 암호화/복호화
+    static void encryptBlocks(CbcState& state, std::span<uint8_t> blocks);
+    static void decryptBlocks(CbcState& state, std::span<uint8_t> blocks);
+    // decryptBlocks와 같은 결과를 PARALLEL_CHUNK_SIZE 조각으로 나누어 pool에서 복호화.
+    // CBC 복호화는 직전 암호문 블록만 있으면 되므로 조각 경계의 암호문 블록을 먼저 모아 두고 조각마다 따로 처리함.
+    // 조각이 둘 미만이거나 pool에 작업 스레드가 없으면 decryptBlocks 그대로
+    static constexpr size_t PARALLEL_CHUNK_SIZE = 256 * 1024;
+    static void decryptBlocksParallel(CbcState& state, std::span<uint8_t> blocks, WorkerPool& pool);
+    // PKCS#7 패딩 길이 (데이터가 블록 배수여도 한 블록을 붙임)
+    static size_t padLength(size_t plain_len);
+    // 복호화한 마지막 블록들에서 패딩을 확인하고 패딩을 뺀 길이, 잘못되었으면 std::nullopt
+    static std::optional<size_t> unpaddedLength(std::span<const uint8_t> plain);
+
+    // 스트림이 호출 사이에 이어 가는 상태 (Encryptor/Decryptor 공통)
+    struct StreamState {
+        const ARIAAlgorithm* aria = nullptr;
+        std::vector<uint8_t> header;              // 암호화: 아직 내보내지 않은 IV/nonce, 복호화: 모으는 중인 IV/nonce
+        bool started = false;                     // header를 내보냈음/다 모았음
+        std::vector<uint8_t> pending;             // 블록 배수가 안 되었거나 끝을 위해 붙잡아 둔 바이트
+        CbcState cbc;
+        std::array<uint8_t, BLOCK_SIZE> counter{};
+        std::array<uint8_t, BLOCK_SIZE> j0{};
+        GHashKey::Block y{};
+        uint64_t body_bytes = 0;                  // GCM 길이 블록에 넣을 암호문 길이
+    };
+
+    // 스트리밍 암호화/복호화. 메시지 전체를 메모리에 두지 않고 조각으로 나누어 넣을 수 있음.
+    // CBC 체인, 블록 배수가 안 되어 남은 바이트, CTR 카운터, GHASH 누적값을 호출 사이에 이어 가며,
+    // update/finish의 출력을 이어 붙이면 한 번에 encrypt/decrypt한 것과 같은 형식이 됨 (출력은 out 뒤에 붙임).
+    // 스트림은 만든 ARIAAlgorithm을 가리키므로 스트림을 쓰는 동안 ARIAAlgorithm이 살아 있어야 함
+    class Encryptor {
+    public:
+        explicit Encryptor(const ARIAAlgorithm& aria);
+        void update(std::span<const uint8_t> data, std::vector<uint8_t>& out);
+        // 남은 바이트와 패딩(CBC) 또는 태그(GCM)를 내보냄. 그 뒤에는 스트림을 다시 쓰지 않음
+        void finish(std::vector<uint8_t>& out);
+
+    private:
+        StreamState state_;
+    };
+
+    class Decryptor {
+    public:
+        explicit Decryptor(const ARIAAlgorithm& aria);
+        // CBC는 패딩 확인을 위해 마지막 블록을, GCM은 태그를 위해 마지막 16바이트를 finish까지 붙잡아 둠
+        void update(std::span<const uint8_t> data, std::vector<uint8_t>& out);
+        // 잘렸거나 패딩이 잘못되었거나 GCM 태그가 맞지 않으면 false.
+        // 이미 update가 내보낸 평문은 검증되지 않은 것이므로 false면 호출자가 버려야 함
+        bool finish(std::vector<uint8_t>& out);
+
+    private:
+        StreamState state_;
+    };
+
+    Encryptor beginEncryptStream() const { return Encryptor(*this); }
+    Decryptor beginDecryptStream() const { return Decryptor(*this); }
+
+private:
+    static void decryptBlocksBatched(CbcState& state, std::span<uint8_t> blocks);
+    // 암호화 라운드 키로 블록들을 독립적으로 처리 (CTR 키스트림, GCM의 H/E(J0))
+    void encryptEcb(const uint8_t* in, uint8_t* out, size_t blocks) const;
+
+    void encryptCbc(std::span<uint8_t> buffer, size_t plain_len) const;
+    std::optional<size_t> decryptCbc(std::span<uint8_t> buffer) const;
+    void encryptCtr(std::span<uint8_t> buffer, size_t plain_len) const;
+    std::optional<size_t> decryptCtr(std::span<uint8_t> buffer) const;
+    void encryptGcm(std::span<uint8_t> buffer, size_t plain_len) const;
+    std::optional<size_t> decryptGcm(std::span<uint8_t> buffer) const;
+    std::array<uint8_t, BLOCK_SIZE> gcmTag(std::span<const uint8_t, BLOCK_SIZE> j0, GHashKey::Block y) const;
+
+    Mode mode_;
+
+    std::vector<uint8_t> encRoundKeys_;
+    std::vector<uint8_t> decRoundKeys_;
+    int rounds_ = 0;
+    BlockFn crypt_;
+    bool batched_;
+    std::optional<GHashKey> ghash_;   // GCM일 때만, H = E(0)
+    std::shared_ptr<const ARIAOpenSsl> openssl_;   // Provider::OpenSsl일 때만
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include "encryption/ARIAAlgorithm.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// 현재 키로 만든 ARIAAlgorithm(라운드 키를 미리 만들어 둔 컨텍스트)을 담아 두고 교체하는 자리.
+// 처리하는 쪽은 current()로 컨텍스트를 잡아 그 호출 동안 씀. 도중에 rotate()해도
+// 이미 잡은 호출은 이전 키로 끝나고, 이전 컨텍스트는 마지막 사용자가 놓을 때 해제됨
+class ARIAContextSlot {
+public:
+    explicit ARIAContextSlot(const std::vector<uint8_t>& key, ARIAAlgorithm::Mode mode = ARIAAlgorithm::Mode::Cbc)
+      : mode_(mode),
+        current_(std::make_shared<const ARIAAlgorithm>(key, mode)) {}
+
+    // 파이프라인 단계가 tuple로 옮겨질 수 있게 이동만 허용 (옮기는 중에는 다른 스레드가 쓰지 않아야 함)
+    ARIAContextSlot(ARIAContextSlot&& other) noexcept
+      : mode_(other.mode_),
+        current_(other.current_.load()) {}
+    ARIAContextSlot(const ARIAContextSlot&) = delete;
+    ARIAContextSlot& operator=(const ARIAContextSlot&) = delete;
+
+    std::shared_ptr<const ARIAAlgorithm> current() const {
+        return current_.load(std::memory_order_acquire);
+    }
+
+    // 새 키로 라운드 키를 만든 뒤 한 번에 바꿔 끼움 (키 확장은 처리 경로 밖에서 한 번만). 운용 모드는 그대로
+    void rotate(const std::vector<uint8_t>& key) {
+        current_.store(std::make_shared<const ARIAAlgorithm>(key, mode_), std::memory_order_release);
+    }
+
+    ARIAAlgorithm::Mode mode() const { return mode_; }
+
+private:
+    ARIAAlgorithm::Mode mode_;
+    std::atomic<std::shared_ptr<const ARIAAlgorithm>> current_;
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include "encryption/ARIAAlgorithm.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+typedef struct evp_cipher_ctx_st EVP_CIPHER_CTX;
+
+// OpenSSL EVP(EVP_aria_*_cbc/ctr/gcm)로 처리하는 ARIA 메시지 구현 (ARIAAlgorithm::Provider::OpenSsl).
+// 메시지 형식은 ARIAAlgorithm과 같음. USE_OPENSSL_ARIA로 빌드했을 때만 들어감.
+// 키를 넣어 초기화한 컨텍스트를 템플릿으로 두고 호출마다 복사해 IV만 넣으므로 키 확장은 만들 때 한 번뿐이며,
+// 템플릿은 바뀌지 않으므로 여러 스레드가 같은 객체를 함께 써도 됨
+class ARIAOpenSsl {
+public:
+    ARIAOpenSsl(const std::vector<uint8_t>& key, ARIAAlgorithm::Mode mode);
+    ~ARIAOpenSsl();
+    ARIAOpenSsl(const ARIAOpenSsl&) = delete;
+    ARIAOpenSsl& operator=(const ARIAOpenSsl&) = delete;
+
+    // ARIAAlgorithm::encryptInPlace/decryptInPlace와 같은 약속
+    void encryptInPlace(std::span<uint8_t> buffer, size_t plain_len) const;
+    std::optional<size_t> decryptInPlace(std::span<uint8_t> buffer) const;
+
+    // 실행 중인 OpenSSL이 ARIA를 제공하는지 (no-aria로 빌드된 OpenSSL이면 false)
+    static bool available();
+
+private:
+    void ctrXor(std::span<const uint8_t, ARIAAlgorithm::BLOCK_SIZE> iv, std::span<uint8_t> data) const;
+
+    ARIAAlgorithm::Mode mode_;
+    EVP_CIPHER_CTX* encrypt_ = nullptr;
+    EVP_CIPHER_CTX* decrypt_ = nullptr;
+};
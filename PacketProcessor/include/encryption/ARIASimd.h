@@ -0,0 +1,27 @@
+#pragma once
+#include "encryption/ARIAReference.h"
+#include <cstddef>
+
+// 여러 블록을 한 번에 처리하는 ARIA 코어 (블록마다 독립인 ECB 처리).
+// CBC 복호화, CTR처럼 블록끼리 의존하지 않는 모드에서 씀.
+// SIMD 백엔드는 바이트 슬라이스 방식이라 테이블 조회가 없고 (캐시 타이밍에 안전) 실행 중 CPU를 보고 고름
+enum class ARIASimdBackend
+{
+    Portable,    // CryptTable을 블록마다 호출 (SIMD가 없을 때)
+    AesniAvx,    // 16블록, AVX + AES-NI
+    GfniAvx2,    // 32블록, AVX2 + GFNI
+    GfniAvx512,  // 64블록, AVX-512BW + GFNI
+};
+
+// 이 CPU에서 쓸 수 있는 가장 빠른 백엔드 (처음 부를 때 한 번 확인)
+ARIASimdBackend ARIASimdBestBackend();
+bool ARIASimdSupported(ARIASimdBackend backend);
+const char *ARIASimdBackendName(ARIASimdBackend backend);
+// 백엔드가 한 번에 처리하는 블록 수
+size_t ARIASimdBatchBlocks(ARIASimdBackend backend);
+
+// in의 blocks개 블록을 처리하여 out에 씀 (in == out 가능). 라운드 키는 Crypt와 같은 형식.
+// 쓸 수 있는 SIMD 백엔드를 넓은 것부터 차례로 쓰며, 묶음에 모자라는 끝 블록도 SIMD 경로로 처리함
+void CryptBlocks(const Byte *in, Byte *out, size_t blocks, int R, const Byte *e);
+// 지정한 백엔드 하나로만 처리 (검증/벤치마크용, 지원 여부는 호출자가 확인)
+void CryptBlocks(ARIASimdBackend backend, const Byte *in, Byte *out, size_t blocks, int R, const Byte *e);
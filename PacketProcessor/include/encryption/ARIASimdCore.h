@@ -0,0 +1,172 @@
+#pragma once
+#include "encryption/ARIAReference.h"
+#include <cstddef>
+#include <cstdint>
+
+// ARIA 바이트 슬라이스 코어 (ARIASimd*.cpp 내부용).
+// 블록들을 전치하여 레지스터 j에 각 블록의 j번째 바이트를 모으면 (레인 하나가 블록 하나)
+//  - 라운드 키 덧셈은 키 바이트를 브로드캐스트한 XOR,
+//  - 확산 계층(DL)은 레지스터 16개 사이의 XOR,
+//  - 치환 계층은 레지스터마다 S-box 하나 (GFNI 아핀 명령 또는 AES-NI)
+// 가 되어 테이블 조회 없이 상수 시간으로 처리됨.
+//
+// 각 백엔드 .cpp는 #pragma GCC target으로 명령어 집합을 켠 뒤 이 헤더를 include하고
+// 벡터 특성 V를 넘겨 crypt_batch<V>를 인스턴스화함. V는 다음을 제공함:
+//   type, LANES(128비트 레인 수, 한 묶음 = 16 * LANES 블록),
+//   load(in, i) / store(out, i, x): 레인 g에 블록 16g+i를 읽고 씀,
+//   lo8/hi8/lo16/hi16/lo32/hi32/lo64/hi64 (레인 안 unpack), xor_, broadcast(바이트),
+//   sb1/sb2/sb1_inv/sb2_inv
+
+// 백엔드별 한 묶음(16 * LANES 블록) 처리. 라운드 키는 Crypt와 같은 형식
+void CryptBatchAesniAvx(const Byte *in, Byte *out, int R, const Byte *e);
+void CryptBatchGfniAvx2(const Byte *in, Byte *out, int R, const Byte *e);
+void CryptBatchGfniAvx512(const Byte *in, Byte *out, int R, const Byte *e);
+
+namespace aria_simd
+{
+// GFNI 아핀 행렬 (참조 구현 S-box에서 구함).
+// SB1(x) = M1·x^-1 + 0x63, SB2(x) = M2·x^-1 + 0xE2,
+// SB1^-1(x) = (N1·x + 0x05)^-1, SB2^-1(x) = (N2·x + 0x2C)^-1
+constexpr uint64_t GFNI_M1 = 0xf1e3c78f1f3e7cf8ULL;
+constexpr uint64_t GFNI_M2 = 0xeafcb7c3c273c66fULL;
+constexpr uint64_t GFNI_N1 = 0xa44992254a942952ULL;
+constexpr uint64_t GFNI_N2 = 0x186450c737d6bdc9ULL;
+constexpr uint64_t GFNI_IDENTITY = 0x0102040810204080ULL;
+
+// 16x16 바이트 전치 (128비트 레인마다). 두 번 적용하면 원래대로 돌아옴
+template <typename V>
+inline void transpose(typename V::type (&x)[16])
+{
+    using T = typename V::type;
+    T a[16], b[16];
+    for (int i = 0; i < 8; ++i)
+    {
+        a[i] = V::lo8(x[2 * i], x[2 * i + 1]);
+        a[i + 8] = V::hi8(x[2 * i], x[2 * i + 1]);
+    }
+    for (int h = 0; h < 2; ++h)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            b[8 * h + i] = V::lo16(a[8 * h + 2 * i], a[8 * h + 2 * i + 1]);
+            b[8 * h + i + 4] = V::hi16(a[8 * h + 2 * i], a[8 * h + 2 * i + 1]);
+        }
+    }
+    for (int q = 0; q < 4; ++q)
+    {
+        T lo01 = V::lo32(b[4 * q], b[4 * q + 1]);
+        T hi01 = V::hi32(b[4 * q], b[4 * q + 1]);
+        T lo23 = V::lo32(b[4 * q + 2], b[4 * q + 3]);
+        T hi23 = V::hi32(b[4 * q + 2], b[4 * q + 3]);
+        x[4 * q] = V::lo64(lo01, lo23);
+        x[4 * q + 1] = V::hi64(lo01, lo23);
+        x[4 * q + 2] = V::lo64(hi01, hi23);
+        x[4 * q + 3] = V::hi64(hi01, hi23);
+    }
+}
+
+// 홀수 라운드 치환: 바이트 j에 SB1, SB2, SB1^-1, SB2^-1 순서
+template <typename V>
+inline void subst_odd(typename V::type (&x)[16])
+{
+    for (int j = 0; j < 16; j += 4)
+    {
+        x[j] = V::sb1(x[j]);
+        x[j + 1] = V::sb2(x[j + 1]);
+        x[j + 2] = V::sb1_inv(x[j + 2]);
+        x[j + 3] = V::sb2_inv(x[j + 3]);
+    }
+}
+
+// 짝수 라운드 치환: SB1^-1, SB2^-1, SB1, SB2 순서
+template <typename V>
+inline void subst_even(typename V::type (&x)[16])
+{
+    for (int j = 0; j < 16; j += 4)
+    {
+        x[j] = V::sb1_inv(x[j]);
+        x[j + 1] = V::sb2_inv(x[j + 1]);
+        x[j + 2] = V::sb1(x[j + 2]);
+        x[j + 3] = V::sb2(x[j + 3]);
+    }
+}
+
+// 확산 계층 DL. 출력 바이트마다 입력 7바이트의 XOR (참조 구현 DL과 같은 식)
+template <typename V>
+inline void diffuse(typename V::type (&x)[16])
+{
+    using T = typename V::type;
+    auto x7 = [&](int a, int b, int c, int d, int e, int f, int g) {
+        T t = V::xor_(V::xor_(x[a], x[b]), V::xor_(x[c], x[d]));
+        return V::xor_(V::xor_(t, x[e]), V::xor_(x[f], x[g]));
+    };
+    T y[16] = {
+        x7(3, 4, 6, 8, 9, 13, 14),
+        x7(2, 5, 7, 8, 9, 12, 15),
+        x7(1, 4, 6, 10, 11, 12, 15),
+        x7(0, 5, 7, 10, 11, 13, 14),
+        x7(0, 2, 5, 8, 11, 14, 15),
+        x7(1, 3, 4, 9, 10, 14, 15),
+        x7(0, 2, 7, 9, 10, 12, 13),
+        x7(1, 3, 6, 8, 11, 12, 13),
+        x7(0, 1, 4, 7, 10, 13, 15),
+        x7(0, 1, 5, 6, 11, 12, 14),
+        x7(2, 3, 5, 6, 8, 13, 15),
+        x7(2, 3, 4, 7, 9, 12, 14),
+        x7(1, 2, 6, 7, 9, 11, 12),
+        x7(0, 3, 6, 7, 8, 10, 13),
+        x7(0, 3, 4, 5, 9, 11, 14),
+        x7(1, 2, 4, 5, 8, 10, 15),
+    };
+    for (int j = 0; j < 16; ++j)
+    {
+        x[j] = y[j];
+    }
+}
+
+template <typename V>
+inline void add_round_key(typename V::type (&x)[16], const Byte *rk)
+{
+    for (int j = 0; j < 16; ++j)
+    {
+        x[j] = V::xor_(x[j], V::broadcast(rk[j]));
+    }
+}
+
+// 16 * V::LANES 블록을 in에서 읽어 out에 씀 (in == out 가능). 라운드 구성은 참조 구현 Crypt와 같음
+template <typename V>
+inline void crypt_batch(const Byte *in, Byte *out, int R, const Byte *e)
+{
+    typename V::type x[16];
+    for (int i = 0; i < 16; ++i)
+    {
+        x[i] = V::load(in, i);
+    }
+    transpose<V>(x);
+
+    for (int r = 0; r < R; ++r)
+    {
+        add_round_key<V>(x, e + 16 * r);
+        if (r % 2 == 0)
+        {
+            subst_odd<V>(x);
+        }
+        else
+        {
+            subst_even<V>(x);
+        }
+        // 마지막 라운드는 확산 없이 키만 더함
+        if (r != R - 1)
+        {
+            diffuse<V>(x);
+        }
+    }
+    add_round_key<V>(x, e + 16 * R);
+
+    transpose<V>(x);
+    for (int i = 0; i < 16; ++i)
+    {
+        V::store(out, i, x[i]);
+    }
+}
+} // namespace aria_simd
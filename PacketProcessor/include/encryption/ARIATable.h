@@ -0,0 +1,8 @@
+#pragma once
+#include "encryption/ARIAReference.h"
+
+// 32비트 T-테이블 ARIA 코어 (RFC 5794 최적화 구현 방식).
+// 치환 계층과 확산 계층의 바이트 패턴을 테이블 4개(S1, S2, X1, X2)에 합쳐 두고,
+// 나머지 확산은 워드 단위 XOR/회전으로 처리함.
+// 라운드 키 형식과 호출 규약은 ARIAReference의 Crypt와 같으므로 EncKeySetup/DecKeySetup 결과를 그대로 씀
+void CryptTable(const Byte *p, int R, const Byte *e, Byte *c);
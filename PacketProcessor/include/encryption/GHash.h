@@ -0,0 +1,31 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// GCM 인증에 쓰는 GHASH (GF(2^128)에서 H를 곱해 나감).
+// H로 만든 뒤에는 바뀌지 않으므로 여러 스레드가 함께 써도 됨.
+// PCLMULQDQ가 있으면 캐리 없는 곱셈으로, 없으면 4비트 테이블(Shoup 방식)로 처리함
+class GHashKey {
+public:
+    static constexpr size_t BLOCK_SIZE = 16;
+    using Block = std::array<uint8_t, BLOCK_SIZE>;
+
+    // allow_clmul이 false면 CPU와 관계없이 테이블 구현을 씀 (검증용)
+    explicit GHashKey(std::span<const uint8_t, BLOCK_SIZE> h, bool allow_clmul = true);
+
+    // data를 블록 단위로 y에 누적 (y = (y ^ 블록) · H).
+    // 끝이 블록 배수가 아니면 0으로 채워 처리하므로, 나누어 넣을 때는 마지막 조각만 블록 배수가 아니어야 함
+    void absorb(Block& y, std::span<const uint8_t> data) const;
+    // 마지막 길이 블록 (AAD/암호문 길이, 비트 단위)
+    void absorbLengths(Block& y, uint64_t aad_bytes, uint64_t cipher_bytes) const;
+
+private:
+    void multiplyTable(Block& y) const;
+
+    bool clmul_ = false;
+    Block h_{};
+    uint64_t hl_[16] = {};
+    uint64_t hh_[16] = {};
+};
@@ -1,13 +1,32 @@
-#pragma once
-
-#include "IProtocolModule.h"
-#include <vector>
-
-class EncryptionModule : public IProtocolModule {
-public:
-    explicit EncryptionModule(const std::vector<uint8_t>& key);
-    std::vector<uint8_t> process(const std::vector<uint8_t>& data) override;
-    std::vector<uint8_t> reverse(const std::vector<uint8_t>& data) override;
-private:
-    std::vector<uint8_t> key_;
-};
\ No newline at end of file
+#pragma once
+
+#include "IProtocolModule.h"
+#include "encryption/ARIAContext.h"
+#include <vector>
+
+// ARIA 암호화 단계. 운용 모드는 ARIAAlgorithm::Mode (기본 CBC, 기존 형식).
+// 복호화에 실패하면 CBC/CTR은 빈 결과를 내지만, GCM은 변조된 데이터를 조용히 넘기지 않도록
+// std::runtime_error를 던짐. 스트리밍 복호화는 이미 내보낸 평문을 거둘 수 없으므로 모드와 관계없이
+// 실패하면 finish에서 std::runtime_error를 던짐 (그때까지 받은 평문은 호출자가 버려야 함)
+class EncryptionModule : public IProtocolModule {
+public:
+    explicit EncryptionModule(const std::vector<uint8_t>& key, ARIAAlgorithm::Mode mode = ARIAAlgorithm::Mode::Cbc);
+    std::vector<uint8_t> process(const std::vector<uint8_t>& data) override;
+    std::vector<uint8_t> reverse(const std::vector<uint8_t>& data) override;
+
+    size_t headroom() const override;   // IV/nonce
+    size_t tailroom() const override;   // 최대 PKCS#7 패딩 또는 GCM 태그
+    void processInPlace(ProtocolBuffer& buffer) override;
+    void reverseInPlace(ProtocolBuffer& buffer) override;
+    // 시작할 때의 키로 메시지 끝까지 처리함 (도중에 setKey해도 그 스트림은 이전 키)
+    std::unique_ptr<IProtocolStream> beginProcess() override;
+    std::unique_ptr<IProtocolStream> beginReverse() override;
+
+    // 키 교체. 파이프라인을 다시 만들 필요 없고, 처리 중인 다른 스레드의 호출과 함께 불러도 됨
+    void setKey(const std::vector<uint8_t>& key);
+private:
+    // 복호화 실패 처리 (GCM이면 예외)
+    void decryptFailed() const;
+
+    ARIAContextSlot context_;
+};
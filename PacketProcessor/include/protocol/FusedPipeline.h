@@ -0,0 +1,310 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <vector>
+#include "ProtocolBuffer.h"
+#include "encryption/ARIAAlgorithm.h"
+#include "encryption/ARIAContext.h"
+
+// 컴파일 시간에 단계 구성이 정해진 파이프라인.
+// ProtocolEngine은 단계마다 가상 호출로 버퍼 전체를 한 번씩 훑지만, 여기서는
+// 암호 단계 바로 앞의 바이트 단위 단계들을 CHUNK_SIZE 조각마다 이어서 적용하여(예: shift 후 바로 그 4KB를 암호화)
+// 조각이 캐시에 있는 동안 모든 처리를 끝냄. 단계 호출은 모두 인라인되며 가상 호출이 없음.
+// 출력 형식은 같은 순서로 모듈을 넣은 ProtocolEngine과 같음 (서로 복호화 가능).
+//
+// 단계 종류:
+//  - ChunkStage  : 크기를 바꾸지 않는 바이트 단위 변환. 임의의 조각에 forwardChunk/reverseChunk
+//  - FrameStage  : 내용과 무관하게 앞뒤만 붙이거나 뗌 (본문을 훑지 않음)
+//  - CipherStage : 메시지 전체에 걸친 연쇄 처리. 앞 ChunkStage들을 조각마다 함께 적용
+
+template <typename S>
+concept ChunkStage = requires(const S& stage, std::span<uint8_t> chunk) {
+    stage.forwardChunk(chunk);
+    stage.reverseChunk(chunk);
+};
+
+template <typename S>
+concept FrameStage = requires(const S& stage, ProtocolBuffer& buffer) {
+    stage.frame(buffer);
+    stage.unframe(buffer);
+};
+
+template <typename S>
+concept CipherStage = requires(const S& stage) {
+    { stage.headroom() } -> std::convertible_to<size_t>;
+    { stage.tailroom() } -> std::convertible_to<size_t>;
+};
+
+// ShiftModule과 같음
+struct ShiftStage {
+    int offset;
+
+    void forwardChunk(std::span<uint8_t> chunk) const {
+        for (auto& b : chunk) {
+            b = static_cast<uint8_t>(b + offset);
+        }
+    }
+    void reverseChunk(std::span<uint8_t> chunk) const {
+        for (auto& b : chunk) {
+            b = static_cast<uint8_t>(b - offset);
+        }
+    }
+};
+
+// PaddingModule과 같음
+struct PaddingStage {
+    std::vector<uint8_t> pad;
+
+    size_t headroom() const { return pad.size(); }
+    void frame(ProtocolBuffer& buffer) const {
+        std::span<uint8_t> head = buffer.pushFront(pad.size());
+        std::copy(pad.begin(), pad.end(), head.begin());
+    }
+    void unframe(ProtocolBuffer& buffer) const {
+        std::span<const uint8_t> data = buffer.data();
+        if (data.size() >= pad.size() && std::equal(pad.begin(), pad.end(), data.begin())) {
+            buffer.popFront(pad.size());
+        }
+    }
+};
+
+// EncryptionModule과 같음 (ARIA-CBC, 앞에 IV, PKCS#7 패딩)
+class AriaCbcStage {
+public:
+    explicit AriaCbcStage(const std::vector<uint8_t>& key) : context_(key) {}
+
+    // 키 교체 (EncryptionModule::setKey와 같음)
+    void setKey(const std::vector<uint8_t>& key) { context_.rotate(key); }
+
+    size_t headroom() const { return ARIAAlgorithm::BLOCK_SIZE; }
+    size_t tailroom() const { return ARIAAlgorithm::BLOCK_SIZE; }
+
+    // pre(조각)를 원래 데이터 부분에만 적용한 뒤 그 조각을 바로 암호화
+    template <typename Pre>
+    void encrypt(ProtocolBuffer& buffer, Pre&& pre, size_t chunk_size) const {
+        constexpr size_t B = ARIAAlgorithm::BLOCK_SIZE;
+        const size_t plain_len = buffer.size();
+        const size_t pad_len = ARIAAlgorithm::padLength(plain_len);
+
+        std::span<uint8_t> iv = buffer.pushFront(B);
+        std::span<uint8_t> pad = buffer.pushBack(pad_len);
+        std::fill(pad.begin(), pad.end(), static_cast<uint8_t>(pad_len));
+        const auto iv_arr = ARIAAlgorithm::generateIv();
+        std::copy(iv_arr.begin(), iv_arr.end(), iv.begin());
+
+        const auto algo = context_.current();
+        ARIAAlgorithm::CbcState state = algo->beginEncrypt(iv_arr);
+        std::span<uint8_t> body = buffer.data().subspan(B);
+        for (size_t off = 0; off < body.size(); off += chunk_size) {
+            std::span<uint8_t> chunk = body.subspan(off, std::min(chunk_size, body.size() - off));
+            if (off < plain_len) {
+                pre(chunk.first(std::min(chunk.size(), plain_len - off)));
+            }
+            ARIAAlgorithm::encryptBlocks(state, chunk);
+        }
+    }
+
+    // 조각을 복호화한 뒤 바로 post(조각)를 적용. 마지막 조각은 패딩을 확인하고 패딩을 뺀 부분에만 적용.
+    // 형식이 잘못되면 EncryptionModule처럼 빈 결과
+    template <typename Post>
+    void decrypt(ProtocolBuffer& buffer, Post&& post, size_t chunk_size) const {
+        constexpr size_t B = ARIAAlgorithm::BLOCK_SIZE;
+        std::span<uint8_t> data = buffer.data();
+        if (data.size() < 2 * B || (data.size() - B) % B != 0) {
+            buffer.clear();
+            return;
+        }
+
+        const auto algo = context_.current();
+        ARIAAlgorithm::CbcState state = algo->beginDecrypt(data.first<B>());
+        std::span<uint8_t> body = data.subspan(B);
+        size_t plain_len = 0;
+        for (size_t off = 0; off < body.size(); off += chunk_size) {
+            std::span<uint8_t> chunk = body.subspan(off, std::min(chunk_size, body.size() - off));
+            ARIAAlgorithm::decryptBlocks(state, chunk);
+            if (off + chunk.size() < body.size()) {
+                post(chunk);
+                continue;
+            }
+
+            // 패딩 확인은 마지막 블록만 보면 됨
+            std::optional<size_t> last = ARIAAlgorithm::unpaddedLength(chunk.last(B));
+            if (!last) {
+                buffer.clear();
+                return;
+            }
+            const size_t tail_len = chunk.size() - B + *last;
+            post(chunk.first(tail_len));
+            plain_len = off + tail_len;
+        }
+        buffer.popFront(B);
+        buffer.popBack(buffer.size() - plain_len);
+    }
+
+private:
+    ARIAContextSlot context_;
+};
+
+template <typename... Stages>
+class FusedPipeline {
+public:
+    static constexpr size_t CHUNK_SIZE = 4096;   // L1에 들어가는 조각 (블록 크기의 배수)
+    static_assert(CHUNK_SIZE % ARIAAlgorithm::BLOCK_SIZE == 0);
+    static_assert(((ChunkStage<Stages> || FrameStage<Stages> || CipherStage<Stages>) && ...),
+                  "FusedPipeline stage must be a chunk, frame or cipher stage");
+
+    explicit FusedPipeline(Stages... stages) : stages_(std::move(stages)...) {}
+
+    std::vector<uint8_t> encrypt(std::span<const uint8_t> data) const {
+        ProtocolBuffer buffer(data, headroom(), tailroom());
+        encryptInPlace(buffer);
+        return buffer.release();
+    }
+
+    std::vector<uint8_t> decrypt(std::span<const uint8_t> data) const {
+        ProtocolBuffer buffer(data, 0, 0);
+        decryptInPlace(buffer);
+        return buffer.release();
+    }
+
+    void encryptInPlace(ProtocolBuffer& buffer) const { encryptFrom<0>(buffer); }
+    void decryptInPlace(ProtocolBuffer& buffer) const { decryptDownTo<sizeof...(Stages)>(buffer); }
+
+    static constexpr size_t size() { return sizeof...(Stages); }
+
+    size_t headroom() const {
+        return std::apply([](const auto&... stage) { return (roomOf(stage, true) + ... + size_t{0}); }, stages_);
+    }
+    size_t tailroom() const {
+        return std::apply([](const auto&... stage) { return (roomOf(stage, false) + ... + size_t{0}); }, stages_);
+    }
+
+    // I번째 단계 (예: 암호 단계의 키 교체)
+    template <size_t I>
+    auto& stage() { return std::get<I>(stages_); }
+
+private:
+    template <size_t I>
+    using StageAt = std::tuple_element_t<I, std::tuple<Stages...>>;
+
+    template <typename S>
+    static size_t roomOf(const S& stage, bool head) {
+        if constexpr (CipherStage<S>) {
+            return head ? stage.headroom() : stage.tailroom();
+        } else if constexpr (FrameStage<S>) {
+            return head ? stage.headroom() : 0;
+        } else {
+            return 0;
+        }
+    }
+
+    // [I, 끝) 중 I부터 이어지는 ChunkStage 구간의 끝
+    template <size_t I>
+    static constexpr size_t chunkRunEnd() {
+        if constexpr (I < sizeof...(Stages)) {
+            if constexpr (ChunkStage<StageAt<I>>) {
+                return chunkRunEnd<I + 1>();
+            }
+        }
+        return I;
+    }
+
+    // [0, I) 중 I 바로 앞에서 끝나는 ChunkStage 구간의 시작
+    template <size_t I>
+    static constexpr size_t chunkRunBegin() {
+        if constexpr (I > 0) {
+            if constexpr (ChunkStage<StageAt<I - 1>>) {
+                return chunkRunBegin<I - 1>();
+            }
+        }
+        return I;
+    }
+
+    // I번째 단계가 앞의 ChunkStage들을 함께 처리하는 암호 단계인지
+    template <size_t I>
+    static constexpr bool fusesIntoCipher() {
+        if constexpr (I < sizeof...(Stages)) {
+            return CipherStage<StageAt<I>> && !FrameStage<StageAt<I>>;
+        }
+        return false;
+    }
+
+    template <size_t From, size_t To>
+    void forwardChunks(std::span<uint8_t> chunk) const {
+        if constexpr (From < To) {
+            std::get<From>(stages_).forwardChunk(chunk);
+            forwardChunks<From + 1, To>(chunk);
+        }
+    }
+
+    // To-1부터 From까지 거꾸로
+    template <size_t From, size_t To>
+    void reverseChunks(std::span<uint8_t> chunk) const {
+        if constexpr (From < To) {
+            std::get<To - 1>(stages_).reverseChunk(chunk);
+            reverseChunks<From, To - 1>(chunk);
+        }
+    }
+
+    template <typename Op>
+    static void forEachChunk(std::span<uint8_t> data, Op&& op) {
+        for (size_t off = 0; off < data.size(); off += CHUNK_SIZE) {
+            op(data.subspan(off, std::min(CHUNK_SIZE, data.size() - off)));
+        }
+    }
+
+    template <size_t I>
+    void encryptFrom(ProtocolBuffer& buffer) const {
+        if constexpr (I < sizeof...(Stages)) {
+            constexpr size_t run_end = chunkRunEnd<I>();
+            if constexpr (run_end > I) {
+                if constexpr (fusesIntoCipher<run_end>()) {
+                    // ChunkStage들 + 바로 뒤 암호 단계를 한 번에
+                    std::get<run_end>(stages_).encrypt(buffer, [this](std::span<uint8_t> chunk) { forwardChunks<I, run_end>(chunk); }, CHUNK_SIZE);
+                    encryptFrom<run_end + 1>(buffer);
+                } else {
+                    // 뒤에 암호 단계가 없으면 ChunkStage들끼리만 합쳐서 한 번 훑음
+                    forEachChunk(buffer.data(), [this](std::span<uint8_t> chunk) { forwardChunks<I, run_end>(chunk); });
+                    encryptFrom<run_end>(buffer);
+                }
+            } else if constexpr (FrameStage<StageAt<I>>) {
+                std::get<I>(stages_).frame(buffer);
+                encryptFrom<I + 1>(buffer);
+            } else {
+                std::get<I>(stages_).encrypt(buffer, [](std::span<uint8_t>) {}, CHUNK_SIZE);
+                encryptFrom<I + 1>(buffer);
+            }
+        }
+    }
+
+    // 단계 [0, I)를 거꾸로 되돌림
+    template <size_t I>
+    void decryptDownTo(ProtocolBuffer& buffer) const {
+        if constexpr (I > 0) {
+            using S = StageAt<I - 1>;
+            if constexpr (ChunkStage<S>) {
+                // 뒤에 암호 단계가 없는 ChunkStage 구간 (암호 단계 앞의 구간은 그 암호 단계가 처리)
+                forEachChunk(buffer.data(), [this](std::span<uint8_t> chunk) { reverseChunks<chunkRunBegin<I>(), I>(chunk); });
+                decryptDownTo<chunkRunBegin<I>()>(buffer);
+            } else if constexpr (FrameStage<S>) {
+                std::get<I - 1>(stages_).unframe(buffer);
+                decryptDownTo<I - 1>(buffer);
+            } else {
+                std::get<I - 1>(stages_).decrypt(buffer, [this](std::span<uint8_t> chunk) { reverseChunks<chunkRunBegin<I - 1>(), I - 1>(chunk); }, CHUNK_SIZE);
+                decryptDownTo<chunkRunBegin<I - 1>()>(buffer);
+            }
+        }
+    }
+
+    std::tuple<Stages...> stages_;
+};
+
+template <typename... Stages>
+FusedPipeline<Stages...> makeFusedPipeline(Stages... stages) {
+    return FusedPipeline<Stages...>(std::move(stages)...);
+}
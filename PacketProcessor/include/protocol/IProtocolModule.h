@@ -1,11 +1,70 @@
-#pragma once
-
-#include <vector>
-#include <cstdint>
-
-class IProtocolModule {
-public:
-    virtual ~IProtocolModule() = default;
-    virtual std::vector<uint8_t> process(const std::vector<uint8_t>& data) = 0;
-    virtual std::vector<uint8_t> reverse(const std::vector<uint8_t>& data) = 0;
-};
\ No newline at end of file
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include "ProtocolBuffer.h"
+
+// 메시지 하나를 조각으로 나누어 처리하는 상태.
+// update 출력들 뒤에 finish 출력을 이어 붙이면 한 번에 process/reverse한 결과와 같음 (출력은 out 뒤에 붙임)
+class IProtocolStream {
+public:
+    virtual ~IProtocolStream() = default;
+    virtual void update(std::span<const uint8_t> data, std::vector<uint8_t>& out) = 0;
+    virtual void finish(std::vector<uint8_t>& out) = 0;
+};
+
+class IProtocolModule {
+public:
+    virtual ~IProtocolModule() = default;
+    virtual std::vector<uint8_t> process(const std::vector<uint8_t>& data) = 0;
+    virtual std::vector<uint8_t> reverse(const std::vector<uint8_t>& data) = 0;
+
+    // process()가 데이터 앞/뒤에 붙이는 최대 바이트 (엔진이 버퍼를 한 번에 잡는 데 씀)
+    virtual size_t headroom() const { return 0; }
+    virtual size_t tailroom() const { return 0; }
+
+    // 제자리 처리. 기본 구현은 vector 버전을 거치므로, 복사를 없애려면 모듈이 재정의함
+    virtual void processInPlace(ProtocolBuffer& buffer) {
+        const auto data = buffer.data();
+        buffer = ProtocolBuffer(process(std::vector<uint8_t>(data.begin(), data.end())));
+    }
+    virtual void reverseInPlace(ProtocolBuffer& buffer) {
+        const auto data = buffer.data();
+        buffer = ProtocolBuffer(reverse(std::vector<uint8_t>(data.begin(), data.end())));
+    }
+
+    // 스트리밍 처리. 기본 구현은 finish까지 모았다가 vector 버전으로 처리하므로 메모리가 메시지 크기만큼 들고,
+    // 조각마다 바로 내보내려면 모듈이 재정의함. 스트림은 모듈을 가리키므로 모듈이 더 오래 살아 있어야 함
+    virtual std::unique_ptr<IProtocolStream> beginProcess();
+    virtual std::unique_ptr<IProtocolStream> beginReverse();
+};
+
+// 기본 스트림: 전부 모은 뒤 finish에서 한 번에 처리
+class BufferedProtocolStream : public IProtocolStream {
+public:
+    BufferedProtocolStream(IProtocolModule& module, bool reverse) : module_(module), reverse_(reverse) {}
+
+    void update(std::span<const uint8_t> data, std::vector<uint8_t>&) override {
+        data_.insert(data_.end(), data.begin(), data.end());
+    }
+    void finish(std::vector<uint8_t>& out) override {
+        std::vector<uint8_t> result = reverse_ ? module_.reverse(data_) : module_.process(data_);
+        out.insert(out.end(), result.begin(), result.end());
+        data_.clear();
+    }
+
+private:
+    IProtocolModule& module_;
+    bool reverse_;
+    std::vector<uint8_t> data_;
+};
+
+inline std::unique_ptr<IProtocolStream> IProtocolModule::beginProcess() {
+    return std::make_unique<BufferedProtocolStream>(*this, false);
+}
+
+inline std::unique_ptr<IProtocolStream> IProtocolModule::beginReverse() {
+    return std::make_unique<BufferedProtocolStream>(*this, true);
+}
@@ -1,14 +1,20 @@
-#pragma once
-
-#include "IProtocolModule.h"
-#include <vector>
-
-class PaddingModule : public IProtocolModule {
-public:
-    explicit PaddingModule(const std::vector<uint8_t>& pad);
-    std::vector<uint8_t> process(const std::vector<uint8_t>& data) override;
-    std::vector<uint8_t> reverse(const std::vector<uint8_t>& data) override;
-
-private:
-    std::vector<uint8_t> pad_;
-};
+#pragma once
+
+#include "IProtocolModule.h"
+#include <vector>
+
+class PaddingModule : public IProtocolModule {
+public:
+    explicit PaddingModule(const std::vector<uint8_t>& pad);
+    std::vector<uint8_t> process(const std::vector<uint8_t>& data) override;
+    std::vector<uint8_t> reverse(const std::vector<uint8_t>& data) override;
+
+    size_t headroom() const override { return pad_.size(); }
+    void processInPlace(ProtocolBuffer& buffer) override;
+    void reverseInPlace(ProtocolBuffer& buffer) override;
+    std::unique_ptr<IProtocolStream> beginProcess() override;
+    std::unique_ptr<IProtocolStream> beginReverse() override;
+
+private:
+    std::vector<uint8_t> pad_;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// 모듈들이 한 저장소 안에서 제자리로 처리하는 버퍼.
+// 데이터 앞(headroom)과 뒤(tailroom)에 여유를 두어 헤더/패딩/IV를 붙여도 다시 할당하거나 옮기지 않음.
+// 여유가 모자라면 저장소를 늘려서라도 처리함 (결과는 같고 복사만 한 번 더 생김)
+class ProtocolBuffer {
+public:
+    ProtocolBuffer() = default;
+    // data를 한 번 복사하고 앞뒤에 여유를 둠
+    ProtocolBuffer(std::span<const uint8_t> data, size_t headroom, size_t tailroom);
+    // 저장소를 넘겨받음 (여유 없음)
+    explicit ProtocolBuffer(std::vector<uint8_t>&& data);
+
+    std::span<uint8_t> data() { return {storage_.data() + offset_, length_}; }
+    std::span<const uint8_t> data() const { return {storage_.data() + offset_, length_}; }
+    size_t size() const { return length_; }
+    bool empty() const { return length_ == 0; }
+
+    size_t headroom() const { return offset_; }
+    size_t tailroom() const { return storage_.size() - offset_ - length_; }
+
+    // 앞에 n바이트를 늘리고 그 영역을 돌려줌 (내용은 호출자가 채움)
+    std::span<uint8_t> pushFront(size_t n);
+    // 뒤에 n바이트를 늘리고 그 영역을 돌려줌
+    std::span<uint8_t> pushBack(size_t n);
+    void popFront(size_t n);
+    void popBack(size_t n);
+    void clear() { length_ = 0; }
+
+    // 처리 결과를 꺼냄. 앞 여유가 남아 있으면 저장소 안에서 앞으로 당김 (새로 할당하지 않음)
+    std::vector<uint8_t> release();
+
+private:
+    void grow(size_t headroom, size_t tailroom);
+
+    std::vector<uint8_t> storage_;
+    size_t offset_ = 0;
+    size_t length_ = 0;
+};
@@ -1,28 +1,57 @@
-#pragma once
-
-#include <vector>
-#include <memory>
-#include <span>
-#include "IProtocolModule.h"
-#include "common/Debug.h"
-
-class ProtocolEngine {
-public:
-    ProtocolEngine();
-    ~ProtocolEngine();
-    ProtocolEngine(ProtocolEngine&&) noexcept = default;
-    ProtocolEngine& operator=(ProtocolEngine&&) noexcept = default;
-    ProtocolEngine(const ProtocolEngine&) = delete;
-    ProtocolEngine& operator=(const ProtocolEngine&) = delete;
-
-    std::vector<uint8_t> encrypt(const std::vector<uint8_t>& data) const;
-    std::vector<uint8_t> decrypt(const std::vector<uint8_t>& data) const;
-
-    std::vector<uint8_t> encrypt(std::span<const uint8_t> data) const;
-    std::vector<uint8_t> decrypt(std::span<const uint8_t> data) const;
-
-    void addModule(std::unique_ptr<IProtocolModule> module);
-
-private:
-    std::vector<std::unique_ptr<IProtocolModule>> modules_;
-};
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <span>
+#include "IProtocolModule.h"
+#include "ProtocolBuffer.h"
+#include "common/Debug.h"
+
+class ProtocolEngine {
+public:
+    ProtocolEngine();
+    ~ProtocolEngine();
+    ProtocolEngine(ProtocolEngine&&) noexcept = default;
+    ProtocolEngine& operator=(ProtocolEngine&&) noexcept = default;
+    ProtocolEngine(const ProtocolEngine&) = delete;
+    ProtocolEngine& operator=(const ProtocolEngine&) = delete;
+
+    std::vector<uint8_t> encrypt(const std::vector<uint8_t>& data) const;
+    std::vector<uint8_t> decrypt(const std::vector<uint8_t>& data) const;
+
+    std::vector<uint8_t> encrypt(std::span<const uint8_t> data) const;
+    std::vector<uint8_t> decrypt(std::span<const uint8_t> data) const;
+
+    // 모든 모듈을 한 버퍼 위에서 제자리로 적용. encrypt()/decrypt()도 입력을 한 번 복사한 뒤 이것을 씀
+    void encryptInPlace(ProtocolBuffer& buffer) const;
+    void decryptInPlace(ProtocolBuffer& buffer) const;
+    // encrypt 결과를 한 번도 다시 할당하지 않고 담을 수 있는 앞/뒤 여유
+    size_t headroom() const;
+    size_t tailroom() const;
+
+    // 메시지 하나의 스트리밍 암호화/복호화. 조각을 모듈 스트림에 차례로 통과시키므로
+    // 모든 모듈이 스트리밍을 지원하면 메모리는 메시지가 아니라 조각 크기에 비례함.
+    // update/finish 출력을 이어 붙이면 encrypt()/decrypt() 결과와 같음 (출력은 out 뒤에 붙임).
+    // 스트림은 엔진의 모듈을 가리키므로 엔진이 더 오래 살아 있어야 함
+    class Stream {
+    public:
+        void update(std::span<const uint8_t> data, std::vector<uint8_t>& out);
+        void finish(std::vector<uint8_t>& out);
+
+    private:
+        friend class ProtocolEngine;
+        // stages_[first]부터 끝까지 data를 통과시킴
+        void feed(size_t first, std::span<const uint8_t> data, std::vector<uint8_t>& out);
+
+        std::vector<std::unique_ptr<IProtocolStream>> stages_;
+        std::vector<uint8_t> scratch_[2];   // 단계 사이 출력 (번갈아 씀, 조각 크기로 재사용)
+        std::vector<uint8_t> tail_;         // finish 중인 단계의 출력
+    };
+    Stream beginEncrypt() const;
+    Stream beginDecrypt() const;
+
+    void addModule(std::unique_ptr<IProtocolModule> module);
+
+private:
+    std::vector<std::unique_ptr<IProtocolModule>> modules_;
+};
@@ -0,0 +1,124 @@
+#include "common/WorkerPool.h"
+#include <algorithm>
+#include <atomic>
+
+// 작업 하나 (run 호출 하나). next로 번호를 나누어 가지고, done이 tasks가 되면 호출한 스레드를 깨움
+struct WorkerPool::Job
+{
+    const std::function<void(size_t)> *fn = nullptr;
+    size_t tasks = 0;
+    std::atomic<size_t> next{0};
+    size_t done = 0;   // mutex_ 안에서만 바뀜
+    std::condition_variable finished;
+
+    // 남은 번호를 가져가 실행하고 실행한 개수를 돌려줌
+    size_t drain()
+    {
+        size_t executed = 0;
+        for (size_t i = next.fetch_add(1); i < tasks; i = next.fetch_add(1))
+        {
+            (*fn)(i);
+            ++executed;
+        }
+        return executed;
+    }
+};
+
+WorkerPool::WorkerPool(size_t workers)
+{
+    threads_.reserve(workers);
+    for (size_t i = 0; i < workers; ++i)
+    {
+        threads_.emplace_back([this] { workerLoop(); });
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto &t : threads_)
+    {
+        t.join();
+    }
+}
+
+WorkerPool &WorkerPool::shared()
+{
+    static WorkerPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+void WorkerPool::run(size_t tasks, const std::function<void(size_t)> &fn)
+{
+    if (tasks == 0)
+    {
+        return;
+    }
+    if (tasks == 1 || threads_.empty())
+    {
+        for (size_t i = 0; i < tasks; ++i)
+        {
+            fn(i);
+        }
+        return;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->fn = &fn;
+    job->tasks = tasks;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(job);
+    }
+    cv_.notify_all();
+
+    size_t executed = job->drain();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    // 번호를 다 나누어 주었으므로 새 작업 스레드가 이 작업을 가져가지 않게 뺌
+    auto it = std::find(jobs_.begin(), jobs_.end(), job);
+    if (it != jobs_.end())
+    {
+        jobs_.erase(it);
+    }
+    job->done += executed;
+    job->finished.wait(lock, [&] { return job->done == job->tasks; });
+}
+
+void WorkerPool::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;)
+    {
+        cv_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+        if (stop_)
+        {
+            return;
+        }
+        std::shared_ptr<Job> job = jobs_.front();
+        lock.unlock();
+
+        size_t executed = job->drain();
+
+        lock.lock();
+        if (executed == 0)
+        {
+            // 번호가 다 나갔는데 아직 대기열에 있으면 다른 스레드가 빼기 전까지 돌지 않게 뺌
+            auto it = std::find(jobs_.begin(), jobs_.end(), job);
+            if (it != jobs_.end())
+            {
+                jobs_.erase(it);
+            }
+            continue;
+        }
+        job->done += executed;
+        if (job->done == job->tasks)
+        {
+            job->finished.notify_all();
+        }
+    }
+}
@@ -1,190 +1,836 @@
-#include "encryption/ARIAAlgorithm.h"
-#include "encryption/ARIAReference.h"
-#include "common/Debug.h"
-#include <cstring>
-#include <random>
-#include <algorithm>
-#include <array>
-#include <vector>
-#include <cstdint>
-
-ARIAAlgorithm::ARIAAlgorithm(const std::vector<uint8_t> &key)
-    : key_(key)
-{
-    DBG_PRINT("ARIAAlgorithm created (key_len=%zu bytes)", key_.size());
-}
-
-static std::vector<uint8_t> pkcs7_pad(const std::vector<uint8_t> &data)
-{
-    size_t orig_len = data.size();
-    size_t rem = orig_len % ARIAAlgorithm::BLOCK_SIZE;
-    size_t pad_len = (rem == 0) ? ARIAAlgorithm::BLOCK_SIZE : (ARIAAlgorithm::BLOCK_SIZE - rem);
-
-    std::vector<uint8_t> out;
-    out.reserve(orig_len + pad_len);
-    out.insert(out.end(), data.begin(), data.end());
-
-    out.insert(out.end(), pad_len, static_cast<uint8_t>(pad_len));
-    return out;
-}
-
-static std::vector<uint8_t> pkcs7_unpad(const std::vector<uint8_t> &data)
-{
-    size_t sz = data.size();
-    if (sz == 0 || (sz % ARIAAlgorithm::BLOCK_SIZE) != 0)
-    {
-        return {};
-    }
-    uint8_t pad_byte = data[sz - 1];
-    if (pad_byte == 0 || pad_byte > ARIAAlgorithm::BLOCK_SIZE)
-    {
-
-        return {};
-    }
-
-    for (size_t i = 0; i < pad_byte; ++i)
-    {
-        if (data[sz - 1 - i] != pad_byte)
-        {
-
-            return {};
-        }
-    }
-    std::vector<uint8_t> out;
-    out.insert(out.end(), data.begin(), data.begin() + (sz - pad_byte));
-    return out;
-}
-
-static std::array<uint8_t, ARIAAlgorithm::BLOCK_SIZE> generate_random_iv()
-{
-    std::array<uint8_t, ARIAAlgorithm::BLOCK_SIZE> iv;
-    std::random_device rd;
-    for (size_t i = 0; i < ARIAAlgorithm::BLOCK_SIZE; ++i)
-    {
-        iv[i] = static_cast<uint8_t>(rd());
-    }
-    return iv;
-}
-
-std::vector<uint8_t> ARIAAlgorithm::encrypt(const std::vector<uint8_t> &data)
-{
-    DBG_PRINT("ARIAAlgorithm::encrypt (CBC) start (%zu bytes)", data.size());
-
-    std::vector<uint8_t> padded = pkcs7_pad(data);
-    size_t total_size = padded.size();
-    size_t num_blocks = total_size / BLOCK_SIZE;
-
-    int keyBits = static_cast<int>(key_.size() * 8);
-    int maxRounds = (keyBits + 256) / 32;
-    std::vector<Byte> roundKeys(16 * (maxRounds + 1));
-    int R = EncKeySetup(reinterpret_cast<const Byte *>(key_.data()),
-                        roundKeys.data(),
-                        keyBits);
-    DBG_PRINT("  EncKeySetup → rounds = %d", R);
-
-    auto iv_arr = generate_random_iv();
-
-    std::vector<uint8_t> out;
-    out.reserve(BLOCK_SIZE + total_size);
-
-    out.insert(out.end(), iv_arr.begin(), iv_arr.end());
-
-    std::array<uint8_t, BLOCK_SIZE> prev_block;
-    std::copy(iv_arr.begin(), iv_arr.end(), prev_block.begin());
-
-    for (size_t bi = 0; bi < num_blocks; ++bi)
-    {
-
-        const uint8_t *pblock = padded.data() + bi * BLOCK_SIZE;
-
-        uint8_t xored[ARIAAlgorithm::BLOCK_SIZE];
-        for (size_t j = 0; j < BLOCK_SIZE; ++j)
-        {
-            xored[j] = static_cast<uint8_t>(pblock[j] ^ prev_block[j]);
-        }
-
-        uint8_t cipher_block[ARIAAlgorithm::BLOCK_SIZE];
-        Crypt(reinterpret_cast<const Byte *>(xored),
-              R,
-              roundKeys.data(),
-              reinterpret_cast<Byte *>(cipher_block));
-
-        out.insert(out.end(), cipher_block, cipher_block + BLOCK_SIZE);
-
-        std::copy(cipher_block, cipher_block + BLOCK_SIZE, prev_block.begin());
-        DBG_PRINT("  └─ block %zu encrypted (CBC)", bi);
-    }
-
-    DBG_PRINT("ARIAAlgorithm::encrypt done, output size=%zu", out.size());
-    return out;
-}
-
-std::vector<uint8_t> ARIAAlgorithm::decrypt(const std::vector<uint8_t> &data)
-{
-    DBG_PRINT("ARIAAlgorithm::decrypt (CBC) start (%zu bytes)", data.size());
-
-    if (data.size() < 2 * BLOCK_SIZE)
-    {
-        DBG_PRINT("  decrypt input too short");
-        return {};
-    }
-    size_t total_size = data.size();
-
-    const uint8_t *iv_ptr = data.data();
-    std::array<uint8_t, BLOCK_SIZE> iv_arr;
-    std::copy(iv_ptr, iv_ptr + BLOCK_SIZE, iv_arr.begin());
-
-    size_t cipher_len = total_size - BLOCK_SIZE;
-    if (cipher_len % BLOCK_SIZE != 0)
-    {
-        DBG_PRINT("  decrypt input not multiple of block size after IV");
-        return {};
-    }
-    size_t num_blocks = cipher_len / BLOCK_SIZE;
-
-    int keyBits = static_cast<int>(key_.size() * 8);
-    int maxRounds = (keyBits + 256) / 32;
-    std::vector<Byte> roundKeys(16 * (maxRounds + 1));
-    int R = DecKeySetup(reinterpret_cast<const Byte *>(key_.data()),
-                        roundKeys.data(),
-                        keyBits);
-    DBG_PRINT("  DecKeySetup → rounds = %d", R);
-
-    std::vector<uint8_t> decrypted;
-    decrypted.reserve(cipher_len);
-
-    std::array<uint8_t, BLOCK_SIZE> prev_block;
-    std::copy(iv_arr.begin(), iv_arr.end(), prev_block.begin());
-
-    for (size_t bi = 0; bi < num_blocks; ++bi)
-    {
-        const uint8_t *cblock = data.data() + BLOCK_SIZE + bi * BLOCK_SIZE;
-
-        uint8_t interm[ARIAAlgorithm::BLOCK_SIZE];
-        Crypt(reinterpret_cast<const Byte *>(cblock),
-              R,
-              roundKeys.data(),
-              reinterpret_cast<Byte *>(interm));
-
-        uint8_t plain_block[ARIAAlgorithm::BLOCK_SIZE];
-        for (size_t j = 0; j < BLOCK_SIZE; ++j)
-        {
-            plain_block[j] = static_cast<uint8_t>(interm[j] ^ prev_block[j]);
-        }
-
-        decrypted.insert(decrypted.end(), plain_block, plain_block + BLOCK_SIZE);
-
-        std::copy(cblock, cblock + BLOCK_SIZE, prev_block.begin());
-        DBG_PRINT("  └─ block %zu decrypted (CBC)", bi);
-    }
-
-    std::vector<uint8_t> unpadded = pkcs7_unpad(decrypted);
-    if (unpadded.empty() && !decrypted.empty())
-    {
-        DBG_PRINT("  padding invalid or zero-length after unpad");
-        return {};
-    }
-
-    DBG_PRINT("ARIAAlgorithm::decrypt done, output size=%zu", unpadded.size());
-    return unpadded;
-}
+#include "encryption/ARIAAlgorithm.h"
+#include "encryption/ARIAReference.h"
+#include "encryption/ARIATable.h"
+#include "encryption/ARIASimd.h"
+#include "common/Debug.h"
+#include "common/WorkerPool.h"
+#ifdef USE_OPENSSL_ARIA
+#include "encryption/ARIAOpenSsl.h"
+#endif
+#include <atomic>
+#include <cstring>
+#include <random>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+constexpr size_t GCM_CHUNK_SIZE = 4096;   // GCM은 조각마다 암호화와 GHASH를 이어서 처리 (조각이 캐시에 있는 동안)
+
+uint32_t load_be32(const uint8_t *p)
+{
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+void store_be32(uint8_t *p, uint32_t v)
+{
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+// 태그 비교는 일치하는 바이트 수에 따라 시간이 달라지지 않게 전부 비교
+bool tags_equal(const uint8_t *a, const uint8_t *b)
+{
+    uint8_t diff = 0;
+    for (size_t j = 0; j < ARIAAlgorithm::GCM_TAG_SIZE; ++j)
+    {
+        diff |= static_cast<uint8_t>(a[j] ^ b[j]);
+    }
+    return diff == 0;
+}
+
+// 스트림 입력을 pending 뒤에 data를 이어 붙인 것으로 보고, 끝의 holdback 바이트 이상을 남긴 채
+// 앞에서 블록 배수만큼을 out 뒤로 옮김. 옮긴 영역(처리할 곳)을 돌려주고 나머지는 pending에 남김
+std::span<uint8_t> take_blocks(std::vector<uint8_t> &pending, std::span<const uint8_t> data, size_t holdback,
+                               std::vector<uint8_t> &out)
+{
+    constexpr size_t BLOCK = ARIAAlgorithm::BLOCK_SIZE;
+    const size_t total = pending.size() + data.size();
+    const size_t n = total > holdback ? (total - holdback) / BLOCK * BLOCK : 0;
+    if (n == 0)
+    {
+        pending.insert(pending.end(), data.begin(), data.end());
+        return {};
+    }
+
+    const size_t start = out.size();
+    out.resize(start + n);
+    const size_t from_pending = std::min(n, pending.size());
+    std::copy_n(pending.begin(), from_pending, out.begin() + start);
+    std::copy_n(data.begin(), n - from_pending, out.begin() + start + from_pending);
+    pending.erase(pending.begin(), pending.begin() + from_pending);
+    pending.insert(pending.end(), data.begin() + (n - from_pending), data.end());
+    return {out.data() + start, n};
+}
+
+// provider를 생략한 생성자가 쓰는 구현. 빌드 설정으로 정하고 실행 중에 setDefaultProvider로 바꿈
+#if defined(ARIA_DEFAULT_PROVIDER_OPENSSL) && defined(USE_OPENSSL_ARIA)
+std::atomic<ARIAAlgorithm::Provider> default_provider{ARIAAlgorithm::Provider::OpenSsl};
+#else
+std::atomic<ARIAAlgorithm::Provider> default_provider{ARIAAlgorithm::Provider::Builtin};
+#endif
+} // namespace
+
+bool ARIAAlgorithm::providerAvailable(Provider provider)
+{
+    if (provider == Provider::Builtin)
+    {
+        return true;
+    }
+#ifdef USE_OPENSSL_ARIA
+    return ARIAOpenSsl::available();
+#else
+    return false;
+#endif
+}
+
+const char *ARIAAlgorithm::providerName(Provider provider)
+{
+    return provider == Provider::OpenSsl ? "openssl" : "builtin";
+}
+
+void ARIAAlgorithm::setDefaultProvider(Provider provider)
+{
+    if (!providerAvailable(provider))
+    {
+        throw std::invalid_argument(std::string("ARIA provider not available: ") + providerName(provider));
+    }
+    default_provider.store(provider, std::memory_order_relaxed);
+}
+
+ARIAAlgorithm::Provider ARIAAlgorithm::defaultProvider()
+{
+    return default_provider.load(std::memory_order_relaxed);
+}
+
+ARIAAlgorithm::ARIAAlgorithm(const std::vector<uint8_t> &key, Mode mode, Core core)
+    : ARIAAlgorithm(key, mode, core, defaultProvider())
+{
+}
+
+ARIAAlgorithm::ARIAAlgorithm(const std::vector<uint8_t> &key, Mode mode, Core core, Provider provider)
+    : mode_(mode),
+      crypt_((core == Core::Reference) ? Crypt : CryptTable),
+      batched_(core == Core::Simd)
+{
+    int keyBits = static_cast<int>(key.size() * 8);
+    int maxRounds = (keyBits + 256) / 32;
+    encRoundKeys_.resize(16 * (maxRounds + 1));
+    decRoundKeys_.resize(16 * (maxRounds + 1));
+    rounds_ = EncKeySetup(reinterpret_cast<const Byte *>(key.data()), encRoundKeys_.data(), keyBits);
+    DecKeySetup(reinterpret_cast<const Byte *>(key.data()), decRoundKeys_.data(), keyBits);
+    DBG_PRINT("ARIAAlgorithm created (key_len=%zu bytes, rounds=%d, core=%s, provider=%s)",
+              key.size(), rounds_,
+              core == Core::Simd ? "simd" : (core == Core::Table ? "table" : "reference"),
+              providerName(provider));
+
+    if (mode_ == Mode::Gcm)
+    {
+        std::array<uint8_t, BLOCK_SIZE> h{};
+        encryptEcb(h.data(), h.data(), 1);
+        ghash_.emplace(h);
+    }
+
+    if (provider == Provider::OpenSsl)
+    {
+#ifdef USE_OPENSSL_ARIA
+        if (ARIAOpenSsl::available())
+        {
+            openssl_ = std::make_shared<const ARIAOpenSsl>(key, mode);
+        }
+#endif
+        if (!openssl_)
+        {
+            throw std::invalid_argument("ARIA provider not available: openssl");
+        }
+    }
+}
+
+void ARIAAlgorithm::encryptEcb(const uint8_t *in, uint8_t *out, size_t blocks) const
+{
+    if (batched_)
+    {
+        CryptBlocks(in, out, blocks, rounds_, encRoundKeys_.data());
+        return;
+    }
+    for (size_t i = 0; i < blocks; ++i)
+    {
+        crypt_(in + i * BLOCK_SIZE, rounds_, encRoundKeys_.data(), out + i * BLOCK_SIZE);
+    }
+}
+
+size_t ARIAAlgorithm::padLength(size_t plain_len)
+{
+    size_t rem = plain_len % BLOCK_SIZE;
+    return (rem == 0) ? BLOCK_SIZE : (BLOCK_SIZE - rem);
+}
+
+std::optional<size_t> ARIAAlgorithm::unpaddedLength(std::span<const uint8_t> plain)
+{
+    size_t sz = plain.size();
+    if (sz == 0 || (sz % BLOCK_SIZE) != 0)
+    {
+        return std::nullopt;
+    }
+    uint8_t pad_byte = plain[sz - 1];
+    if (pad_byte == 0 || pad_byte > BLOCK_SIZE)
+    {
+
+        return std::nullopt;
+    }
+
+    for (size_t i = 0; i < pad_byte; ++i)
+    {
+        if (plain[sz - 1 - i] != pad_byte)
+        {
+
+            return std::nullopt;
+        }
+    }
+    return sz - pad_byte;
+}
+
+std::array<uint8_t, ARIAAlgorithm::BLOCK_SIZE> ARIAAlgorithm::generateIv()
+{
+    // random_device는 스레드마다 한 번만 열고, 한 번 호출에 32비트씩 씀
+    thread_local std::random_device rd;
+    std::array<uint8_t, BLOCK_SIZE> iv;
+    for (size_t i = 0; i < BLOCK_SIZE; i += sizeof(uint32_t))
+    {
+        uint32_t r = rd();
+        std::memcpy(iv.data() + i, &r, sizeof(r));
+    }
+    return iv;
+}
+
+ARIAAlgorithm::CbcState ARIAAlgorithm::beginEncrypt(std::span<const uint8_t, BLOCK_SIZE> iv) const
+{
+    CbcState state;
+    state.crypt = crypt_;
+    state.roundKeys = encRoundKeys_.data();
+    state.rounds = rounds_;
+    std::copy(iv.begin(), iv.end(), state.chain.begin());
+    return state;
+}
+
+ARIAAlgorithm::CbcState ARIAAlgorithm::beginDecrypt(std::span<const uint8_t, BLOCK_SIZE> iv) const
+{
+    CbcState state;
+    state.crypt = crypt_;
+    state.batched = batched_;
+    state.roundKeys = decRoundKeys_.data();
+    state.rounds = rounds_;
+    std::copy(iv.begin(), iv.end(), state.chain.begin());
+    return state;
+}
+
+void ARIAAlgorithm::encryptBlocks(CbcState &state, std::span<uint8_t> blocks)
+{
+    // 각 평문 블록을 직전 암호문 블록(첫 블록은 IV)과 XOR한 뒤 그 자리에 암호문을 씀
+    for (size_t off = 0; off + BLOCK_SIZE <= blocks.size(); off += BLOCK_SIZE)
+    {
+        uint8_t *pblock = blocks.data() + off;
+
+        uint8_t xored[ARIAAlgorithm::BLOCK_SIZE];
+        for (size_t j = 0; j < BLOCK_SIZE; ++j)
+        {
+            xored[j] = static_cast<uint8_t>(pblock[j] ^ state.chain[j]);
+        }
+
+        state.crypt(reinterpret_cast<const Byte *>(xored),
+              state.rounds,
+              state.roundKeys,
+              reinterpret_cast<Byte *>(pblock));
+        std::copy(pblock, pblock + BLOCK_SIZE, state.chain.begin());
+    }
+}
+
+void ARIAAlgorithm::decryptBlocks(CbcState &state, std::span<uint8_t> blocks)
+{
+    if (state.batched)
+    {
+        decryptBlocksBatched(state, blocks);
+        return;
+    }
+
+    // 평문을 암호문 블록 자리에 덮어쓰므로 다음 블록에 쓸 암호문 블록은 따로 보관
+    for (size_t off = 0; off + BLOCK_SIZE <= blocks.size(); off += BLOCK_SIZE)
+    {
+        uint8_t *cblock = blocks.data() + off;
+
+        std::array<uint8_t, BLOCK_SIZE> cipher_block;
+        std::copy(cblock, cblock + BLOCK_SIZE, cipher_block.begin());
+
+        uint8_t interm[ARIAAlgorithm::BLOCK_SIZE];
+        state.crypt(reinterpret_cast<const Byte *>(cipher_block.data()),
+              state.rounds,
+              state.roundKeys,
+              reinterpret_cast<Byte *>(interm));
+
+        for (size_t j = 0; j < BLOCK_SIZE; ++j)
+        {
+            cblock[j] = static_cast<uint8_t>(interm[j] ^ state.chain[j]);
+        }
+        state.chain = cipher_block;
+    }
+}
+
+void ARIAAlgorithm::decryptBlocksBatched(CbcState &state, std::span<uint8_t> blocks)
+{
+    // CBC 복호화는 블록끼리 독립이므로 BATCH_BYTES씩 한 번에 복호화한 뒤 직전 암호문 블록과 XOR.
+    // 평문이 암호문 자리에 덮어쓰이므로 XOR에 쓸 암호문은 먼저 복사해 둠
+    constexpr size_t BATCH_BYTES = 64 * BLOCK_SIZE;
+    uint8_t cipher_copy[BATCH_BYTES];
+    const size_t usable = blocks.size() - blocks.size() % BLOCK_SIZE;
+    for (size_t off = 0; off < usable; off += BATCH_BYTES)
+    {
+        const size_t len = std::min(BATCH_BYTES, usable - off);
+        uint8_t *p = blocks.data() + off;
+        std::memcpy(cipher_copy, p, len);
+
+        CryptBlocks(reinterpret_cast<const Byte *>(cipher_copy),
+                    reinterpret_cast<Byte *>(p),
+                    len / BLOCK_SIZE,
+                    state.rounds,
+                    state.roundKeys);
+
+        for (size_t j = 0; j < BLOCK_SIZE; ++j)
+        {
+            p[j] = static_cast<uint8_t>(p[j] ^ state.chain[j]);
+        }
+        for (size_t j = BLOCK_SIZE; j < len; ++j)
+        {
+            p[j] = static_cast<uint8_t>(p[j] ^ cipher_copy[j - BLOCK_SIZE]);
+        }
+        std::copy(cipher_copy + len - BLOCK_SIZE, cipher_copy + len, state.chain.begin());
+    }
+}
+
+void ARIAAlgorithm::decryptBlocksParallel(CbcState &state, std::span<uint8_t> blocks, WorkerPool &pool)
+{
+    const size_t usable = blocks.size() - blocks.size() % BLOCK_SIZE;
+    const size_t chunks = (usable + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+    if (chunks < 2 || pool.workers() == 0)
+    {
+        decryptBlocks(state, blocks);
+        return;
+    }
+
+    // 조각 k의 체인 블록 = 조각 k-1의 마지막 암호문 블록. 제자리 복호화가 덮어쓰기 전에 모아 둠
+    std::vector<std::array<uint8_t, BLOCK_SIZE>> chains(chunks);
+    chains[0] = state.chain;
+    for (size_t k = 1; k < chunks; ++k)
+    {
+        const uint8_t *last = blocks.data() + k * PARALLEL_CHUNK_SIZE - BLOCK_SIZE;
+        std::copy(last, last + BLOCK_SIZE, chains[k].begin());
+    }
+    std::array<uint8_t, BLOCK_SIZE> next_chain;
+    std::copy(blocks.data() + usable - BLOCK_SIZE, blocks.data() + usable, next_chain.begin());
+
+    pool.run(chunks, [&](size_t k) {
+        CbcState chunk_state = state;
+        chunk_state.chain = chains[k];
+        const size_t off = k * PARALLEL_CHUNK_SIZE;
+        decryptBlocks(chunk_state, blocks.subspan(off, std::min(PARALLEL_CHUNK_SIZE, usable - off)));
+    });
+    state.chain = next_chain;
+}
+
+size_t ARIAAlgorithm::ciphertextSize(size_t plain_len)
+{
+    return BLOCK_SIZE + plain_len + padLength(plain_len);
+}
+
+size_t ARIAAlgorithm::ciphertextSize(Mode mode, size_t plain_len)
+{
+    switch (mode)
+    {
+    case Mode::Ctr:
+        return BLOCK_SIZE + plain_len;
+    case Mode::Gcm:
+        return GCM_NONCE_SIZE + plain_len + GCM_TAG_SIZE;
+    case Mode::Cbc:
+        break;
+    }
+    return ciphertextSize(plain_len);
+}
+
+size_t ARIAAlgorithm::headerSize(Mode mode)
+{
+    return mode == Mode::Gcm ? GCM_NONCE_SIZE : BLOCK_SIZE;
+}
+
+size_t ARIAAlgorithm::maxTrailerSize(Mode mode)
+{
+    switch (mode)
+    {
+    case Mode::Ctr:
+        return 0;
+    case Mode::Gcm:
+        return GCM_TAG_SIZE;
+    case Mode::Cbc:
+        break;
+    }
+    return BLOCK_SIZE;
+}
+
+void ARIAAlgorithm::encryptInPlace(std::span<uint8_t> buffer, size_t plain_len) const
+{
+    if (buffer.size() != ciphertextSize(mode_, plain_len))
+    {
+        throw std::invalid_argument("ARIAAlgorithm::encryptInPlace buffer size mismatch");
+    }
+#ifdef USE_OPENSSL_ARIA
+    if (openssl_)
+    {
+        openssl_->encryptInPlace(buffer, plain_len);
+        return;
+    }
+#endif
+
+    switch (mode_)
+    {
+    case Mode::Ctr:
+        encryptCtr(buffer, plain_len);
+        break;
+    case Mode::Gcm:
+        encryptGcm(buffer, plain_len);
+        break;
+    case Mode::Cbc:
+        encryptCbc(buffer, plain_len);
+        break;
+    }
+    DBG_PRINT("ARIAAlgorithm::encryptInPlace done, output size=%zu", buffer.size());
+}
+
+std::optional<size_t> ARIAAlgorithm::decryptInPlace(std::span<uint8_t> buffer) const
+{
+#ifdef USE_OPENSSL_ARIA
+    if (openssl_)
+    {
+        return openssl_->decryptInPlace(buffer);
+    }
+#endif
+
+    std::optional<size_t> plain_len;
+    switch (mode_)
+    {
+    case Mode::Ctr:
+        plain_len = decryptCtr(buffer);
+        break;
+    case Mode::Gcm:
+        plain_len = decryptGcm(buffer);
+        break;
+    case Mode::Cbc:
+        plain_len = decryptCbc(buffer);
+        break;
+    }
+    if (plain_len)
+    {
+        DBG_PRINT("ARIAAlgorithm::decryptInPlace done, output size=%zu", *plain_len);
+    }
+    return plain_len;
+}
+
+void ARIAAlgorithm::encryptCbc(std::span<uint8_t> buffer, size_t plain_len) const
+{
+    DBG_PRINT("ARIAAlgorithm::encryptInPlace (CBC) start (%zu bytes)", plain_len);
+
+    size_t pad_len = padLength(plain_len);
+    std::fill_n(buffer.data() + BLOCK_SIZE + plain_len, pad_len, static_cast<uint8_t>(pad_len));
+
+    auto iv_arr = generateIv();
+    std::copy(iv_arr.begin(), iv_arr.end(), buffer.begin());
+
+    CbcState state = beginEncrypt(iv_arr);
+    encryptBlocks(state, buffer.subspan(BLOCK_SIZE));
+}
+
+std::optional<size_t> ARIAAlgorithm::decryptCbc(std::span<uint8_t> buffer) const
+{
+    DBG_PRINT("ARIAAlgorithm::decryptInPlace (CBC) start (%zu bytes)", buffer.size());
+
+    if (buffer.size() < 2 * BLOCK_SIZE)
+    {
+        DBG_PRINT("  decrypt input too short");
+        return std::nullopt;
+    }
+
+    size_t cipher_len = buffer.size() - BLOCK_SIZE;
+    if (cipher_len % BLOCK_SIZE != 0)
+    {
+        DBG_PRINT("  decrypt input not multiple of block size after IV");
+        return std::nullopt;
+    }
+
+    CbcState state = beginDecrypt(buffer.first<BLOCK_SIZE>());
+    decryptBlocksParallel(state, buffer.subspan(BLOCK_SIZE), WorkerPool::shared());
+
+    std::optional<size_t> plain_len = unpaddedLength(buffer.subspan(BLOCK_SIZE));
+    if (!plain_len)
+    {
+        DBG_PRINT("  padding invalid");
+        return std::nullopt;
+    }
+    return plain_len;
+}
+
+void ARIAAlgorithm::ctrXor(std::array<uint8_t, BLOCK_SIZE> &counter, std::span<uint8_t> data) const
+{
+    // 카운터 블록을 BATCH_BLOCKS개씩 만들어 한 번에 암호화(SIMD 묶음)한 뒤 데이터에 XOR
+    constexpr size_t BATCH_BLOCKS = 64;
+    uint8_t stream[BATCH_BLOCKS * BLOCK_SIZE];
+    uint32_t ctr = load_be32(counter.data() + 12);
+
+    for (size_t off = 0; off < data.size(); off += sizeof(stream))
+    {
+        const size_t len = std::min(sizeof(stream), data.size() - off);
+        const size_t blocks = (len + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        for (size_t b = 0; b < blocks; ++b)
+        {
+            std::memcpy(stream + b * BLOCK_SIZE, counter.data(), 12);
+            store_be32(stream + b * BLOCK_SIZE + 12, ctr++);
+        }
+        encryptEcb(stream, stream, blocks);
+
+        uint8_t *p = data.data() + off;
+        for (size_t j = 0; j < len; ++j)
+        {
+            p[j] = static_cast<uint8_t>(p[j] ^ stream[j]);
+        }
+    }
+    store_be32(counter.data() + 12, ctr);
+}
+
+void ARIAAlgorithm::encryptCtr(std::span<uint8_t> buffer, size_t plain_len) const
+{
+    DBG_PRINT("ARIAAlgorithm::encryptInPlace (CTR) start (%zu bytes)", plain_len);
+
+    std::array<uint8_t, BLOCK_SIZE> counter = generateIv();
+    std::copy(counter.begin(), counter.end(), buffer.begin());
+    ctrXor(counter, buffer.subspan(BLOCK_SIZE, plain_len));
+}
+
+std::optional<size_t> ARIAAlgorithm::decryptCtr(std::span<uint8_t> buffer) const
+{
+    DBG_PRINT("ARIAAlgorithm::decryptInPlace (CTR) start (%zu bytes)", buffer.size());
+
+    if (buffer.size() < BLOCK_SIZE)
+    {
+        DBG_PRINT("  decrypt input too short");
+        return std::nullopt;
+    }
+    std::array<uint8_t, BLOCK_SIZE> counter;
+    std::copy_n(buffer.begin(), BLOCK_SIZE, counter.begin());
+    ctrXor(counter, buffer.subspan(BLOCK_SIZE));
+    return buffer.size() - BLOCK_SIZE;
+}
+
+std::array<uint8_t, ARIAAlgorithm::BLOCK_SIZE> ARIAAlgorithm::gcmTag(std::span<const uint8_t, BLOCK_SIZE> j0, GHashKey::Block y) const
+{
+    std::array<uint8_t, BLOCK_SIZE> tag;
+    encryptEcb(j0.data(), tag.data(), 1);
+    for (size_t j = 0; j < BLOCK_SIZE; ++j)
+    {
+        tag[j] ^= y[j];
+    }
+    return tag;
+}
+
+void ARIAAlgorithm::encryptGcm(std::span<uint8_t> buffer, size_t plain_len) const
+{
+    DBG_PRINT("ARIAAlgorithm::encryptInPlace (GCM) start (%zu bytes)", plain_len);
+
+    // J0 = nonce || 1, 본문은 inc32(J0)부터
+    std::array<uint8_t, BLOCK_SIZE> j0 = generateIv();
+    store_be32(j0.data() + GCM_NONCE_SIZE, 1);
+    std::copy_n(j0.begin(), GCM_NONCE_SIZE, buffer.begin());
+    std::array<uint8_t, BLOCK_SIZE> counter = j0;
+    store_be32(counter.data() + GCM_NONCE_SIZE, 2);
+
+    std::span<uint8_t> body = buffer.subspan(GCM_NONCE_SIZE, plain_len);
+    GHashKey::Block y{};
+    for (size_t off = 0; off < body.size(); off += GCM_CHUNK_SIZE)
+    {
+        std::span<uint8_t> chunk = body.subspan(off, std::min(GCM_CHUNK_SIZE, body.size() - off));
+        ctrXor(counter, chunk);
+        ghash_->absorb(y, chunk);
+    }
+    ghash_->absorbLengths(y, 0, plain_len);
+
+    const std::array<uint8_t, BLOCK_SIZE> tag = gcmTag(j0, y);
+    std::copy(tag.begin(), tag.end(), buffer.begin() + GCM_NONCE_SIZE + plain_len);
+}
+
+std::optional<size_t> ARIAAlgorithm::decryptGcm(std::span<uint8_t> buffer) const
+{
+    DBG_PRINT("ARIAAlgorithm::decryptInPlace (GCM) start (%zu bytes)", buffer.size());
+
+    if (buffer.size() < GCM_NONCE_SIZE + GCM_TAG_SIZE)
+    {
+        DBG_PRINT("  decrypt input too short");
+        return std::nullopt;
+    }
+    const size_t cipher_len = buffer.size() - GCM_NONCE_SIZE - GCM_TAG_SIZE;
+
+    std::array<uint8_t, BLOCK_SIZE> j0{};
+    std::copy_n(buffer.begin(), GCM_NONCE_SIZE, j0.begin());
+    store_be32(j0.data() + GCM_NONCE_SIZE, 1);
+    std::array<uint8_t, BLOCK_SIZE> counter = j0;
+    store_be32(counter.data() + GCM_NONCE_SIZE, 2);
+
+    // 한 번 훑으며 조각마다 암호문을 GHASH에 넣은 뒤 바로 복호화
+    std::span<uint8_t> body = buffer.subspan(GCM_NONCE_SIZE, cipher_len);
+    GHashKey::Block y{};
+    for (size_t off = 0; off < body.size(); off += GCM_CHUNK_SIZE)
+    {
+        std::span<uint8_t> chunk = body.subspan(off, std::min(GCM_CHUNK_SIZE, body.size() - off));
+        ghash_->absorb(y, chunk);
+        ctrXor(counter, chunk);
+    }
+    ghash_->absorbLengths(y, 0, cipher_len);
+
+    const std::array<uint8_t, BLOCK_SIZE> tag = gcmTag(j0, y);
+    if (!tags_equal(tag.data(), buffer.data() + GCM_NONCE_SIZE + cipher_len))
+    {
+        DBG_PRINT("  GCM tag mismatch");
+        std::fill(body.begin(), body.end(), 0);
+        return std::nullopt;
+    }
+    return cipher_len;
+}
+
+ARIAAlgorithm::Encryptor::Encryptor(const ARIAAlgorithm &aria)
+{
+    state_.aria = &aria;
+    const std::array<uint8_t, BLOCK_SIZE> iv = generateIv();
+    switch (aria.mode_)
+    {
+    case Mode::Cbc:
+        state_.cbc = aria.beginEncrypt(iv);
+        break;
+    case Mode::Ctr:
+        state_.counter = iv;
+        break;
+    case Mode::Gcm:
+        state_.j0 = iv;
+        store_be32(state_.j0.data() + GCM_NONCE_SIZE, 1);
+        state_.counter = state_.j0;
+        store_be32(state_.counter.data() + GCM_NONCE_SIZE, 2);
+        break;
+    }
+    state_.header.assign(iv.begin(), iv.begin() + headerSize(aria.mode_));
+}
+
+void ARIAAlgorithm::Encryptor::update(std::span<const uint8_t> data, std::vector<uint8_t> &out)
+{
+    const ARIAAlgorithm &aria = *state_.aria;
+    if (!state_.started)
+    {
+        out.insert(out.end(), state_.header.begin(), state_.header.end());
+        state_.started = true;
+    }
+
+    std::span<uint8_t> blocks = take_blocks(state_.pending, data, 0, out);
+    switch (aria.mode_)
+    {
+    case Mode::Cbc:
+        encryptBlocks(state_.cbc, blocks);
+        break;
+    case Mode::Ctr:
+        aria.ctrXor(state_.counter, blocks);
+        break;
+    case Mode::Gcm:
+        for (size_t off = 0; off < blocks.size(); off += GCM_CHUNK_SIZE)
+        {
+            std::span<uint8_t> chunk = blocks.subspan(off, std::min(GCM_CHUNK_SIZE, blocks.size() - off));
+            aria.ctrXor(state_.counter, chunk);
+            aria.ghash_->absorb(state_.y, chunk);
+        }
+        state_.body_bytes += blocks.size();
+        break;
+    }
+}
+
+void ARIAAlgorithm::Encryptor::finish(std::vector<uint8_t> &out)
+{
+    const ARIAAlgorithm &aria = *state_.aria;
+    update({}, out);
+
+    std::vector<uint8_t> &tail = state_.pending;   // 블록 하나 미만
+    switch (aria.mode_)
+    {
+    case Mode::Cbc:
+    {
+        const size_t pad_len = padLength(tail.size());
+        tail.resize(tail.size() + pad_len, static_cast<uint8_t>(pad_len));
+        encryptBlocks(state_.cbc, tail);
+        out.insert(out.end(), tail.begin(), tail.end());
+        break;
+    }
+    case Mode::Ctr:
+        aria.ctrXor(state_.counter, tail);
+        out.insert(out.end(), tail.begin(), tail.end());
+        break;
+    case Mode::Gcm:
+    {
+        aria.ctrXor(state_.counter, tail);
+        aria.ghash_->absorb(state_.y, tail);
+        aria.ghash_->absorbLengths(state_.y, 0, state_.body_bytes + tail.size());
+        out.insert(out.end(), tail.begin(), tail.end());
+        const std::array<uint8_t, BLOCK_SIZE> tag = aria.gcmTag(state_.j0, state_.y);
+        out.insert(out.end(), tag.begin(), tag.end());
+        break;
+    }
+    }
+    tail.clear();
+}
+
+ARIAAlgorithm::Decryptor::Decryptor(const ARIAAlgorithm &aria)
+{
+    state_.aria = &aria;
+    state_.header.reserve(headerSize(aria.mode_));
+}
+
+void ARIAAlgorithm::Decryptor::update(std::span<const uint8_t> data, std::vector<uint8_t> &out)
+{
+    const ARIAAlgorithm &aria = *state_.aria;
+    if (!state_.started)
+    {
+        // 조각이 IV/nonce 중간에서 끊겨 들어올 수 있으므로 다 모일 때까지 쌓음
+        const size_t need = headerSize(aria.mode_) - state_.header.size();
+        const size_t n = std::min(need, data.size());
+        state_.header.insert(state_.header.end(), data.begin(), data.begin() + n);
+        data = data.subspan(n);
+        if (n < need)
+        {
+            return;
+        }
+
+        state_.started = true;
+        switch (aria.mode_)
+        {
+        case Mode::Cbc:
+            state_.cbc = aria.beginDecrypt(std::span<const uint8_t, BLOCK_SIZE>(state_.header.data(), BLOCK_SIZE));
+            break;
+        case Mode::Ctr:
+            std::copy_n(state_.header.begin(), BLOCK_SIZE, state_.counter.begin());
+            break;
+        case Mode::Gcm:
+            std::copy_n(state_.header.begin(), GCM_NONCE_SIZE, state_.j0.begin());
+            store_be32(state_.j0.data() + GCM_NONCE_SIZE, 1);
+            state_.counter = state_.j0;
+            store_be32(state_.counter.data() + GCM_NONCE_SIZE, 2);
+            break;
+        }
+    }
+
+    // CBC는 마지막 블록(패딩)을, GCM은 태그가 될 수 있는 끝 16바이트를 남겨 둠
+    const size_t holdback = aria.mode_ == Mode::Cbc ? 1 : (aria.mode_ == Mode::Gcm ? GCM_TAG_SIZE : 0);
+    std::span<uint8_t> blocks = take_blocks(state_.pending, data, holdback, out);
+    switch (aria.mode_)
+    {
+    case Mode::Cbc:
+        decryptBlocksParallel(state_.cbc, blocks, WorkerPool::shared());
+        break;
+    case Mode::Ctr:
+        aria.ctrXor(state_.counter, blocks);
+        break;
+    case Mode::Gcm:
+        for (size_t off = 0; off < blocks.size(); off += GCM_CHUNK_SIZE)
+        {
+            std::span<uint8_t> chunk = blocks.subspan(off, std::min(GCM_CHUNK_SIZE, blocks.size() - off));
+            aria.ghash_->absorb(state_.y, chunk);
+            aria.ctrXor(state_.counter, chunk);
+        }
+        state_.body_bytes += blocks.size();
+        break;
+    }
+}
+
+bool ARIAAlgorithm::Decryptor::finish(std::vector<uint8_t> &out)
+{
+    const ARIAAlgorithm &aria = *state_.aria;
+    if (!state_.started)
+    {
+        DBG_PRINT("  stream ended inside IV/nonce");
+        return false;
+    }
+
+    std::vector<uint8_t> &tail = state_.pending;
+    switch (aria.mode_)
+    {
+    case Mode::Cbc:
+    {
+        if (tail.size() != BLOCK_SIZE)
+        {
+            DBG_PRINT("  stream not multiple of block size after IV");
+            return false;
+        }
+        decryptBlocks(state_.cbc, tail);
+        std::optional<size_t> plain_len = unpaddedLength(tail);
+        if (!plain_len)
+        {
+            DBG_PRINT("  padding invalid");
+            return false;
+        }
+        out.insert(out.end(), tail.begin(), tail.begin() + *plain_len);
+        break;
+    }
+    case Mode::Ctr:
+        aria.ctrXor(state_.counter, tail);
+        out.insert(out.end(), tail.begin(), tail.end());
+        break;
+    case Mode::Gcm:
+    {
+        if (tail.size() < GCM_TAG_SIZE)
+        {
+            DBG_PRINT("  stream too short for GCM tag");
+            return false;
+        }
+        std::span<uint8_t> body(tail.data(), tail.size() - GCM_TAG_SIZE);
+        aria.ghash_->absorb(state_.y, body);
+        aria.ghash_->absorbLengths(state_.y, 0, state_.body_bytes + body.size());
+        const std::array<uint8_t, BLOCK_SIZE> tag = aria.gcmTag(state_.j0, state_.y);
+        if (!tags_equal(tag.data(), tail.data() + body.size()))
+        {
+            DBG_PRINT("  GCM tag mismatch");
+            return false;
+        }
+        aria.ctrXor(state_.counter, body);
+        out.insert(out.end(), body.begin(), body.end());
+        break;
+    }
+    }
+    tail.clear();
+    return true;
+}
+
+std::vector<uint8_t> ARIAAlgorithm::encrypt(const std::vector<uint8_t> &data) const
+{
+    std::vector<uint8_t> out(ciphertextSize(mode_, data.size()));
+    std::copy(data.begin(), data.end(), out.begin() + headerSize(mode_));
+    encryptInPlace(out, data.size());
+    return out;
+}
+
+std::vector<uint8_t> ARIAAlgorithm::decrypt(const std::vector<uint8_t> &data) const
+{
+    std::vector<uint8_t> out = data;
+    std::optional<size_t> plain_len = decryptInPlace(out);
+    if (!plain_len)
+    {
+        return {};
+    }
+    out.erase(out.begin(), out.begin() + headerSize(mode_));
+    out.resize(*plain_len);
+    return out;
+}
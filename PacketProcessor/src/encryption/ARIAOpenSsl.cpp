@@ -0,0 +1,218 @@
+#ifdef USE_OPENSSL_ARIA
+
+#include "encryption/ARIAOpenSsl.h"
+#include "common/Debug.h"
+#include <openssl/evp.h>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <stdexcept>
+
+namespace
+{
+using CtxPtr = std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)>;
+
+// EVP 길이 인자가 int이므로 이 크기씩 나누어 넣음 (블록 배수)
+constexpr size_t MAX_UPDATE_BYTES = size_t{1} << 30;
+
+const EVP_CIPHER *aria_cipher(size_t key_bytes, ARIAAlgorithm::Mode mode)
+{
+    switch (key_bytes)
+    {
+    case 16:
+        return mode == ARIAAlgorithm::Mode::Cbc ? EVP_aria_128_cbc()
+             : mode == ARIAAlgorithm::Mode::Ctr ? EVP_aria_128_ctr() : EVP_aria_128_gcm();
+    case 24:
+        return mode == ARIAAlgorithm::Mode::Cbc ? EVP_aria_192_cbc()
+             : mode == ARIAAlgorithm::Mode::Ctr ? EVP_aria_192_ctr() : EVP_aria_192_gcm();
+    case 32:
+        return mode == ARIAAlgorithm::Mode::Cbc ? EVP_aria_256_cbc()
+             : mode == ARIAAlgorithm::Mode::Ctr ? EVP_aria_256_ctr() : EVP_aria_256_gcm();
+    default:
+        throw std::invalid_argument("ARIAOpenSsl: key must be 16, 24 or 32 bytes");
+    }
+}
+
+// 키만 넣은 템플릿을 복사하고 IV를 넣은 호출용 컨텍스트
+CtxPtr begin(EVP_CIPHER_CTX *tmpl, const uint8_t *iv)
+{
+    CtxPtr ctx(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+    if (!ctx || EVP_CIPHER_CTX_copy(ctx.get(), tmpl) != 1 ||
+        EVP_CipherInit_ex(ctx.get(), nullptr, nullptr, nullptr, iv, -1) != 1)
+    {
+        throw std::runtime_error("ARIAOpenSsl: EVP context setup failed");
+    }
+    return ctx;
+}
+
+// data를 제자리에서 처리 (CBC는 패딩을 끈 상태라 입력과 출력 길이가 같음)
+void update_in_place(EVP_CIPHER_CTX *ctx, std::span<uint8_t> data)
+{
+    for (size_t off = 0; off < data.size(); off += MAX_UPDATE_BYTES)
+    {
+        const int len = static_cast<int>(std::min(MAX_UPDATE_BYTES, data.size() - off));
+        int out_len = 0;
+        if (EVP_CipherUpdate(ctx, data.data() + off, &out_len, data.data() + off, len) != 1 || out_len != len)
+        {
+            throw std::runtime_error("ARIAOpenSsl: EVP_CipherUpdate failed");
+        }
+    }
+}
+
+uint32_t load_be32(const uint8_t *p)
+{
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+} // namespace
+
+ARIAOpenSsl::ARIAOpenSsl(const std::vector<uint8_t> &key, ARIAAlgorithm::Mode mode)
+    : mode_(mode)
+{
+    const EVP_CIPHER *cipher = aria_cipher(key.size(), mode);
+    encrypt_ = EVP_CIPHER_CTX_new();
+    decrypt_ = EVP_CIPHER_CTX_new();
+    if (!encrypt_ || !decrypt_ ||
+        EVP_EncryptInit_ex(encrypt_, cipher, nullptr, key.data(), nullptr) != 1 ||
+        EVP_DecryptInit_ex(decrypt_, cipher, nullptr, key.data(), nullptr) != 1)
+    {
+        EVP_CIPHER_CTX_free(encrypt_);
+        EVP_CIPHER_CTX_free(decrypt_);
+        throw std::runtime_error("ARIAOpenSsl: OpenSSL does not provide ARIA");
+    }
+    // PKCS#7 패딩은 내장 구현과 같은 코드로 직접 붙이고 확인함 (제자리 처리에서 출력이 입력보다 늦지 않게)
+    EVP_CIPHER_CTX_set_padding(encrypt_, 0);
+    EVP_CIPHER_CTX_set_padding(decrypt_, 0);
+    DBG_PRINT("ARIAOpenSsl created (key_len=%zu bytes, cipher=%s)", key.size(), EVP_CIPHER_name(cipher));
+}
+
+ARIAOpenSsl::~ARIAOpenSsl()
+{
+    EVP_CIPHER_CTX_free(encrypt_);
+    EVP_CIPHER_CTX_free(decrypt_);
+}
+
+bool ARIAOpenSsl::available()
+{
+    static const bool supported = []
+    {
+        const uint8_t key[16] = {};
+        CtxPtr ctx(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+        return ctx && EVP_EncryptInit_ex(ctx.get(), EVP_aria_128_gcm(), nullptr, key, key) == 1;
+    }();
+    return supported;
+}
+
+void ARIAOpenSsl::ctrXor(std::span<const uint8_t, ARIAAlgorithm::BLOCK_SIZE> iv, std::span<uint8_t> data) const
+{
+    // EVP CTR은 128비트 전체를 1씩 늘리지만 이 형식은 하위 32비트만 늘림 (GCM inc32와 같음).
+    // 하위 32비트가 넘칠 때마다 하위 32비트를 0으로 하여 다시 시작함
+    std::array<uint8_t, ARIAAlgorithm::BLOCK_SIZE> counter;
+    std::copy(iv.begin(), iv.end(), counter.begin());
+    for (size_t off = 0; off < data.size();)
+    {
+        const uint64_t blocks_to_wrap = (uint64_t{1} << 32) - load_be32(counter.data() + 12);
+        const size_t len = static_cast<size_t>(std::min<uint64_t>(data.size() - off, blocks_to_wrap * ARIAAlgorithm::BLOCK_SIZE));
+        CtxPtr ctx = begin(encrypt_, counter.data());
+        update_in_place(ctx.get(), data.subspan(off, len));
+        off += len;
+        std::fill(counter.begin() + 12, counter.end(), 0);
+    }
+}
+
+void ARIAOpenSsl::encryptInPlace(std::span<uint8_t> buffer, size_t plain_len) const
+{
+    DBG_PRINT("ARIAOpenSsl::encryptInPlace start (%zu bytes)", plain_len);
+
+    constexpr size_t BLOCK_SIZE = ARIAAlgorithm::BLOCK_SIZE;
+    const std::array<uint8_t, BLOCK_SIZE> iv = ARIAAlgorithm::generateIv();
+    switch (mode_)
+    {
+    case ARIAAlgorithm::Mode::Cbc:
+    {
+        const size_t pad_len = ARIAAlgorithm::padLength(plain_len);
+        std::fill_n(buffer.data() + BLOCK_SIZE + plain_len, pad_len, static_cast<uint8_t>(pad_len));
+        std::copy(iv.begin(), iv.end(), buffer.begin());
+        CtxPtr ctx = begin(encrypt_, iv.data());
+        update_in_place(ctx.get(), buffer.subspan(BLOCK_SIZE));
+        break;
+    }
+    case ARIAAlgorithm::Mode::Ctr:
+        std::copy(iv.begin(), iv.end(), buffer.begin());
+        ctrXor(iv, buffer.subspan(BLOCK_SIZE));
+        break;
+    case ARIAAlgorithm::Mode::Gcm:
+    {
+        std::copy_n(iv.begin(), ARIAAlgorithm::GCM_NONCE_SIZE, buffer.begin());
+        CtxPtr ctx = begin(encrypt_, iv.data());
+        update_in_place(ctx.get(), buffer.subspan(ARIAAlgorithm::GCM_NONCE_SIZE, plain_len));
+        int final_len = 0;
+        uint8_t *tag = buffer.data() + ARIAAlgorithm::GCM_NONCE_SIZE + plain_len;
+        if (EVP_EncryptFinal_ex(ctx.get(), tag, &final_len) != 1 ||
+            EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_GCM_GET_TAG, ARIAAlgorithm::GCM_TAG_SIZE, tag) != 1)
+        {
+            throw std::runtime_error("ARIAOpenSsl: GCM finalization failed");
+        }
+        break;
+    }
+    }
+}
+
+std::optional<size_t> ARIAOpenSsl::decryptInPlace(std::span<uint8_t> buffer) const
+{
+    DBG_PRINT("ARIAOpenSsl::decryptInPlace start (%zu bytes)", buffer.size());
+
+    constexpr size_t BLOCK_SIZE = ARIAAlgorithm::BLOCK_SIZE;
+    switch (mode_)
+    {
+    case ARIAAlgorithm::Mode::Cbc:
+    {
+        if (buffer.size() < 2 * BLOCK_SIZE || (buffer.size() - BLOCK_SIZE) % BLOCK_SIZE != 0)
+        {
+            DBG_PRINT("  decrypt input length invalid");
+            return std::nullopt;
+        }
+        CtxPtr ctx = begin(decrypt_, buffer.data());
+        update_in_place(ctx.get(), buffer.subspan(BLOCK_SIZE));
+        return ARIAAlgorithm::unpaddedLength(buffer.subspan(BLOCK_SIZE));
+    }
+    case ARIAAlgorithm::Mode::Ctr:
+    {
+        if (buffer.size() < BLOCK_SIZE)
+        {
+            DBG_PRINT("  decrypt input too short");
+            return std::nullopt;
+        }
+        ctrXor(buffer.first<BLOCK_SIZE>(), buffer.subspan(BLOCK_SIZE));
+        return buffer.size() - BLOCK_SIZE;
+    }
+    case ARIAAlgorithm::Mode::Gcm:
+        break;
+    }
+
+    if (buffer.size() < ARIAAlgorithm::GCM_NONCE_SIZE + ARIAAlgorithm::GCM_TAG_SIZE)
+    {
+        DBG_PRINT("  decrypt input too short");
+        return std::nullopt;
+    }
+    const size_t cipher_len = buffer.size() - ARIAAlgorithm::GCM_NONCE_SIZE - ARIAAlgorithm::GCM_TAG_SIZE;
+    std::array<uint8_t, BLOCK_SIZE> iv{};
+    std::copy_n(buffer.begin(), ARIAAlgorithm::GCM_NONCE_SIZE, iv.begin());
+    std::array<uint8_t, ARIAAlgorithm::GCM_TAG_SIZE> tag;
+    std::copy_n(buffer.begin() + ARIAAlgorithm::GCM_NONCE_SIZE + cipher_len, tag.size(), tag.begin());
+
+    CtxPtr ctx = begin(decrypt_, iv.data());
+    std::span<uint8_t> body = buffer.subspan(ARIAAlgorithm::GCM_NONCE_SIZE, cipher_len);
+    update_in_place(ctx.get(), body);
+    int final_len = 0;
+    if (EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_GCM_SET_TAG, static_cast<int>(tag.size()), tag.data()) != 1 ||
+        EVP_DecryptFinal_ex(ctx.get(), tag.data(), &final_len) != 1)
+    {
+        DBG_PRINT("  GCM tag mismatch");
+        std::fill(body.begin(), body.end(), 0);
+        return std::nullopt;
+    }
+    return cipher_len;
+}
+
+#endif // USE_OPENSSL_ARIA
@@ -0,0 +1,182 @@
+#include "encryption/ARIASimd.h"
+#include "encryption/ARIASimdCore.h"
+#include "encryption/ARIATable.h"
+#include "common/Debug.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+constexpr size_t BLOCK_BYTES = 16;
+constexpr size_t MAX_BATCH_BLOCKS = 64;
+
+using BatchFn = void (*)(const Byte *, Byte *, int, const Byte *);
+
+BatchFn batchFunction(ARIASimdBackend backend)
+{
+    switch (backend)
+    {
+    case ARIASimdBackend::AesniAvx:
+        return CryptBatchAesniAvx;
+    case ARIASimdBackend::GfniAvx2:
+        return CryptBatchGfniAvx2;
+    case ARIASimdBackend::GfniAvx512:
+        return CryptBatchGfniAvx512;
+    case ARIASimdBackend::Portable:
+        break;
+    }
+    return nullptr;
+}
+
+// 묶음을 채울 수 있는 만큼 처리하고 처리한 블록 수를 돌려줌
+size_t cryptFullBatches(ARIASimdBackend backend, const Byte *in, Byte *out, size_t blocks, int R, const Byte *e)
+{
+    const BatchFn batch = batchFunction(backend);
+    const size_t batch_blocks = ARIASimdBatchBlocks(backend);
+    size_t done = 0;
+    for (; done + batch_blocks <= blocks; done += batch_blocks)
+    {
+        batch(in + done * BLOCK_BYTES, out + done * BLOCK_BYTES, R, e);
+    }
+    return done;
+}
+
+// 묶음보다 적은 끝 블록은 0으로 채운 묶음에 넣어 같은 SIMD 경로로 처리 (테이블 코어로 넘기지 않음)
+void cryptPaddedTail(ARIASimdBackend backend, const Byte *in, Byte *out, size_t blocks, int R, const Byte *e)
+{
+    if (blocks == 0)
+    {
+        return;
+    }
+    const size_t rest = blocks * BLOCK_BYTES;
+    Byte tail[MAX_BATCH_BLOCKS * BLOCK_BYTES] = {};
+    std::memcpy(tail, in, rest);
+    batchFunction(backend)(tail, tail, R, e);
+    std::memcpy(out, tail, rest);
+}
+
+// 쓸 수 있는 SIMD 백엔드를 넓은 것부터
+std::vector<ARIASimdBackend> supportedLadder()
+{
+    std::vector<ARIASimdBackend> ladder;
+    for (ARIASimdBackend backend : {ARIASimdBackend::GfniAvx512, ARIASimdBackend::GfniAvx2, ARIASimdBackend::AesniAvx})
+    {
+        if (ARIASimdSupported(backend))
+        {
+            ladder.push_back(backend);
+        }
+    }
+    return ladder;
+}
+
+ARIASimdBackend detectBackend()
+{
+    __builtin_cpu_init();
+    ARIASimdBackend best = ARIASimdBackend::Portable;
+    if (ARIASimdSupported(ARIASimdBackend::GfniAvx512))
+    {
+        best = ARIASimdBackend::GfniAvx512;
+    }
+    else if (ARIASimdSupported(ARIASimdBackend::GfniAvx2))
+    {
+        best = ARIASimdBackend::GfniAvx2;
+    }
+    else if (ARIASimdSupported(ARIASimdBackend::AesniAvx))
+    {
+        best = ARIASimdBackend::AesniAvx;
+    }
+    DBG_PRINT("ARIA SIMD backend: %s", ARIASimdBackendName(best));
+    return best;
+}
+} // namespace
+
+bool ARIASimdSupported(ARIASimdBackend backend)
+{
+    __builtin_cpu_init();
+    switch (backend)
+    {
+    case ARIASimdBackend::Portable:
+        return true;
+    case ARIASimdBackend::AesniAvx:
+        return __builtin_cpu_supports("avx") && __builtin_cpu_supports("aes");
+    case ARIASimdBackend::GfniAvx2:
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("gfni");
+    case ARIASimdBackend::GfniAvx512:
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+               __builtin_cpu_supports("gfni");
+    }
+    return false;
+}
+
+ARIASimdBackend ARIASimdBestBackend()
+{
+    static const ARIASimdBackend best = detectBackend();
+    return best;
+}
+
+const char *ARIASimdBackendName(ARIASimdBackend backend)
+{
+    switch (backend)
+    {
+    case ARIASimdBackend::Portable:
+        return "portable";
+    case ARIASimdBackend::AesniAvx:
+        return "avx+aesni";
+    case ARIASimdBackend::GfniAvx2:
+        return "avx2+gfni";
+    case ARIASimdBackend::GfniAvx512:
+        return "avx512+gfni";
+    }
+    return "unknown";
+}
+
+size_t ARIASimdBatchBlocks(ARIASimdBackend backend)
+{
+    switch (backend)
+    {
+    case ARIASimdBackend::AesniAvx:
+        return 16;
+    case ARIASimdBackend::GfniAvx2:
+        return 32;
+    case ARIASimdBackend::GfniAvx512:
+        return 64;
+    case ARIASimdBackend::Portable:
+        break;
+    }
+    return 1;
+}
+
+void CryptBlocks(const Byte *in, Byte *out, size_t blocks, int R, const Byte *e)
+{
+    // 넓은 백엔드부터 묶음을 채우고 남은 블록은 더 좁은 백엔드로 넘김.
+    // 짧은 메시지가 64블록 묶음을 통째로 쓰지 않게 끝은 가장 좁은 묶음에 채워 처리함
+    static const std::vector<ARIASimdBackend> ladder = supportedLadder();
+    if (ladder.empty())
+    {
+        CryptBlocks(ARIASimdBackend::Portable, in, out, blocks, R, e);
+        return;
+    }
+
+    size_t done = 0;
+    for (ARIASimdBackend backend : ladder)
+    {
+        done += cryptFullBatches(backend, in + done * BLOCK_BYTES, out + done * BLOCK_BYTES, blocks - done, R, e);
+    }
+    cryptPaddedTail(ladder.back(), in + done * BLOCK_BYTES, out + done * BLOCK_BYTES, blocks - done, R, e);
+}
+
+void CryptBlocks(ARIASimdBackend backend, const Byte *in, Byte *out, size_t blocks, int R, const Byte *e)
+{
+    if (batchFunction(backend) == nullptr)
+    {
+        for (size_t i = 0; i < blocks; ++i)
+        {
+            CryptTable(in + i * BLOCK_BYTES, R, e, out + i * BLOCK_BYTES);
+        }
+        return;
+    }
+
+    size_t done = cryptFullBatches(backend, in, out, blocks, R, e);
+    cryptPaddedTail(backend, in + done * BLOCK_BYTES, out + done * BLOCK_BYTES, blocks - done, R, e);
+}
@@ -0,0 +1,78 @@
+// AVX + AES-NI 백엔드 (GFNI가 없는 CPU용): xmm 레지스터로 16블록을 한 번에 처리.
+// SB1/SB1^-1은 AESENCLAST/AESDECLAST의 SubBytes/InvSubBytes를 쓰고 (ShiftRows는 미리 반대로 섞어 상쇄),
+// SB2/SB2^-1은 그 앞뒤에 아핀 변환을 니블 테이블 두 개(pshufb)로 붙여 만듦
+#pragma GCC target("avx,aes")
+#include "encryption/ARIASimdCore.h"
+#include <immintrin.h>
+
+namespace
+{
+struct AvxAesni
+{
+    using type = __m128i;
+    static constexpr int LANES = 1;
+
+    static type load(const Byte *in, int i)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 16 * i));
+    }
+    static void store(Byte *out, int i, type x)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16 * i), x);
+    }
+
+    static type lo8(type a, type b) { return _mm_unpacklo_epi8(a, b); }
+    static type hi8(type a, type b) { return _mm_unpackhi_epi8(a, b); }
+    static type lo16(type a, type b) { return _mm_unpacklo_epi16(a, b); }
+    static type hi16(type a, type b) { return _mm_unpackhi_epi16(a, b); }
+    static type lo32(type a, type b) { return _mm_unpacklo_epi32(a, b); }
+    static type hi32(type a, type b) { return _mm_unpackhi_epi32(a, b); }
+    static type lo64(type a, type b) { return _mm_unpacklo_epi64(a, b); }
+    static type hi64(type a, type b) { return _mm_unpackhi_epi64(a, b); }
+    static type xor_(type a, type b) { return _mm_xor_si128(a, b); }
+    static type broadcast(Byte b) { return _mm_set1_epi8(static_cast<char>(b)); }
+
+    // 아핀 변환 f(x) = lo[x & 0x0f] ^ hi[x >> 4]
+    static type affine(type x, type lo, type hi)
+    {
+        const type mask = _mm_set1_epi8(0x0f);
+        type l = _mm_shuffle_epi8(lo, _mm_and_si128(x, mask));
+        type h = _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi16(x, 4), mask));
+        return _mm_xor_si128(l, h);
+    }
+
+    static type sb1(type x)
+    {
+        const type inv_shift_rows = _mm_setr_epi8(0, 13, 10, 7, 4, 1, 14, 11, 8, 5, 2, 15, 12, 9, 6, 3);
+        return _mm_aesenclast_si128(_mm_shuffle_epi8(x, inv_shift_rows), _mm_setzero_si128());
+    }
+    static type sb1_inv(type x)
+    {
+        const type shift_rows = _mm_setr_epi8(0, 5, 10, 15, 4, 9, 14, 3, 8, 13, 2, 7, 12, 1, 6, 11);
+        return _mm_aesdeclast_si128(_mm_shuffle_epi8(x, shift_rows), _mm_setzero_si128());
+    }
+    // SB2 = P∘SB1, P(y) = SB2(SB1^-1(y))
+    static type sb2(type x)
+    {
+        const type p_lo = _mm_setr_epi8(0x88, 0x0d, 0x37, 0xb2, 0x00, 0x85, 0xbf, 0x3a,
+                                        0xa8, 0x2d, 0x17, 0x92, 0x20, 0xa5, 0x9f, 0x1a);
+        const type p_hi = _mm_setr_epi8(0x00, 0x3e, 0xd4, 0xea, 0x84, 0xba, 0x50, 0x6e,
+                                        0xcd, 0xf3, 0x19, 0x27, 0x49, 0x77, 0x9d, 0xa3);
+        return affine(sb1(x), p_lo, p_hi);
+    }
+    // SB2^-1 = SB1^-1∘Q, Q(x) = SB1(SB2^-1(x))
+    static type sb2_inv(type x)
+    {
+        const type q_lo = _mm_setr_epi8(0x04, 0x45, 0xee, 0xaf, 0x17, 0x56, 0xfd, 0xbc,
+                                        0x53, 0x12, 0xb9, 0xf8, 0x40, 0x01, 0xaa, 0xeb);
+        const type q_hi = _mm_setr_epi8(0x00, 0xb6, 0x08, 0xbe, 0xd6, 0x60, 0xde, 0x68,
+                                        0x53, 0xe5, 0x5b, 0xed, 0x85, 0x33, 0x8d, 0x3b);
+        return sb1_inv(affine(x, q_lo, q_hi));
+    }
+};
+} // namespace
+
+void CryptBatchAesniAvx(const Byte *in, Byte *out, int R, const Byte *e)
+{
+    aria_simd::crypt_batch<AvxAesni>(in, out, R, e);
+}
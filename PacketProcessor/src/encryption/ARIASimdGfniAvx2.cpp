@@ -0,0 +1,60 @@
+// AVX2 + GFNI 백엔드: ymm 레지스터로 32블록을 한 번에 처리
+#pragma GCC target("avx2,gfni")
+#include "encryption/ARIASimdCore.h"
+#include <immintrin.h>
+
+namespace
+{
+struct Avx2Gfni
+{
+    using type = __m256i;
+    static constexpr int LANES = 2;
+
+    static type load(const Byte *in, int i)
+    {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 16 * i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 16 * (16 + i)));
+        return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+    }
+    static void store(Byte *out, int i, type x)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16 * i), _mm256_castsi256_si128(x));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16 * (16 + i)), _mm256_extracti128_si256(x, 1));
+    }
+
+    static type lo8(type a, type b) { return _mm256_unpacklo_epi8(a, b); }
+    static type hi8(type a, type b) { return _mm256_unpackhi_epi8(a, b); }
+    static type lo16(type a, type b) { return _mm256_unpacklo_epi16(a, b); }
+    static type hi16(type a, type b) { return _mm256_unpackhi_epi16(a, b); }
+    static type lo32(type a, type b) { return _mm256_unpacklo_epi32(a, b); }
+    static type hi32(type a, type b) { return _mm256_unpackhi_epi32(a, b); }
+    static type lo64(type a, type b) { return _mm256_unpacklo_epi64(a, b); }
+    static type hi64(type a, type b) { return _mm256_unpackhi_epi64(a, b); }
+    static type xor_(type a, type b) { return _mm256_xor_si256(a, b); }
+    static type broadcast(Byte b) { return _mm256_set1_epi8(static_cast<char>(b)); }
+
+    static type sb1(type x)
+    {
+        return _mm256_gf2p8affineinv_epi64_epi8(x, _mm256_set1_epi64x(aria_simd::GFNI_M1), 0x63);
+    }
+    static type sb2(type x)
+    {
+        return _mm256_gf2p8affineinv_epi64_epi8(x, _mm256_set1_epi64x(aria_simd::GFNI_M2), 0xe2);
+    }
+    static type sb1_inv(type x)
+    {
+        x = _mm256_gf2p8affine_epi64_epi8(x, _mm256_set1_epi64x(aria_simd::GFNI_N1), 0x05);
+        return _mm256_gf2p8affineinv_epi64_epi8(x, _mm256_set1_epi64x(aria_simd::GFNI_IDENTITY), 0);
+    }
+    static type sb2_inv(type x)
+    {
+        x = _mm256_gf2p8affine_epi64_epi8(x, _mm256_set1_epi64x(aria_simd::GFNI_N2), 0x2c);
+        return _mm256_gf2p8affineinv_epi64_epi8(x, _mm256_set1_epi64x(aria_simd::GFNI_IDENTITY), 0);
+    }
+};
+} // namespace
+
+void CryptBatchGfniAvx2(const Byte *in, Byte *out, int R, const Byte *e)
+{
+    aria_simd::crypt_batch<Avx2Gfni>(in, out, R, e);
+}
@@ -0,0 +1,66 @@
+// AVX-512 + GFNI 백엔드: zmm 레지스터로 64블록을 한 번에 처리
+#pragma GCC target("avx512f,avx512bw,gfni")
+#include "encryption/ARIASimdCore.h"
+#include <immintrin.h>
+
+// GCC 12의 _mm512_unpack*_epi32가 _mm512_undefined_epi32()로 -Wuninitialized 오탐을 냄
+#pragma GCC diagnostic ignored "-Wuninitialized"
+
+namespace
+{
+struct Avx512Gfni
+{
+    using type = __m512i;
+    static constexpr int LANES = 4;
+
+    static type load(const Byte *in, int i)
+    {
+        type x = _mm512_zextsi128_si512(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 16 * i)));
+        x = _mm512_inserti32x4(x, _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 16 * (16 + i))), 1);
+        x = _mm512_inserti32x4(x, _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 16 * (32 + i))), 2);
+        return _mm512_inserti32x4(x, _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 16 * (48 + i))), 3);
+    }
+    static void store(Byte *out, int i, type x)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16 * i), _mm512_castsi512_si128(x));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16 * (16 + i)), _mm512_extracti32x4_epi32(x, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16 * (32 + i)), _mm512_extracti32x4_epi32(x, 2));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16 * (48 + i)), _mm512_extracti32x4_epi32(x, 3));
+    }
+
+    static type lo8(type a, type b) { return _mm512_unpacklo_epi8(a, b); }
+    static type hi8(type a, type b) { return _mm512_unpackhi_epi8(a, b); }
+    static type lo16(type a, type b) { return _mm512_unpacklo_epi16(a, b); }
+    static type hi16(type a, type b) { return _mm512_unpackhi_epi16(a, b); }
+    static type lo32(type a, type b) { return _mm512_unpacklo_epi32(a, b); }
+    static type hi32(type a, type b) { return _mm512_unpackhi_epi32(a, b); }
+    static type lo64(type a, type b) { return _mm512_unpacklo_epi64(a, b); }
+    static type hi64(type a, type b) { return _mm512_unpackhi_epi64(a, b); }
+    static type xor_(type a, type b) { return _mm512_xor_si512(a, b); }
+    static type broadcast(Byte b) { return _mm512_set1_epi8(static_cast<char>(b)); }
+
+    static type sb1(type x)
+    {
+        return _mm512_gf2p8affineinv_epi64_epi8(x, _mm512_set1_epi64(aria_simd::GFNI_M1), 0x63);
+    }
+    static type sb2(type x)
+    {
+        return _mm512_gf2p8affineinv_epi64_epi8(x, _mm512_set1_epi64(aria_simd::GFNI_M2), 0xe2);
+    }
+    static type sb1_inv(type x)
+    {
+        x = _mm512_gf2p8affine_epi64_epi8(x, _mm512_set1_epi64(aria_simd::GFNI_N1), 0x05);
+        return _mm512_gf2p8affineinv_epi64_epi8(x, _mm512_set1_epi64(aria_simd::GFNI_IDENTITY), 0);
+    }
+    static type sb2_inv(type x)
+    {
+        x = _mm512_gf2p8affine_epi64_epi8(x, _mm512_set1_epi64(aria_simd::GFNI_N2), 0x2c);
+        return _mm512_gf2p8affineinv_epi64_epi8(x, _mm512_set1_epi64(aria_simd::GFNI_IDENTITY), 0);
+    }
+};
+} // namespace
+
+void CryptBatchGfniAvx512(const Byte *in, Byte *out, int R, const Byte *e)
+{
+    aria_simd::crypt_batch<Avx512Gfni>(in, out, R, e);
+}
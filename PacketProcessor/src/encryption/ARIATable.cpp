@@ -0,0 +1,143 @@
+#include "encryption/ARIATable.h"
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+struct ARIATables
+{
+    std::array<uint32_t, 256> S1, S2, X1, X2;
+
+    // 참조 구현의 S-box에서 생성 (S[0]=SB1, S[1]=SB2, S[2]=SB1^-1, S[3]=SB2^-1)
+    ARIATables()
+    {
+        for (uint32_t x = 0; x < 256; ++x)
+        {
+            S1[x] = 0x00010101u * S[0][x];
+            S2[x] = 0x01000101u * S[1][x];
+            X1[x] = 0x01010001u * S[2][x];
+            X2[x] = 0x01010100u * S[3][x];
+        }
+    }
+};
+
+const ARIATables &tables()
+{
+    static const ARIATables instance;
+    return instance;
+}
+
+inline uint32_t load_be32(const Byte *p)
+{
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+inline void store_be32(Byte *p, uint32_t v)
+{
+    p[0] = static_cast<Byte>(v >> 24);
+    p[1] = static_cast<Byte>(v >> 16);
+    p[2] = static_cast<Byte>(v >> 8);
+    p[3] = static_cast<Byte>(v);
+}
+
+inline uint32_t rotr32(uint32_t v, int n)
+{
+    return (v >> n) | (v << (32 - n));
+}
+
+inline uint32_t b0(uint32_t v) { return v >> 24; }
+inline uint32_t b1(uint32_t v) { return (v >> 16) & 0xff; }
+inline uint32_t b2(uint32_t v) { return (v >> 8) & 0xff; }
+inline uint32_t b3(uint32_t v) { return v & 0xff; }
+
+inline void add_round_key(const Byte *rk, uint32_t &t0, uint32_t &t1, uint32_t &t2, uint32_t &t3)
+{
+    t0 ^= load_be32(rk);
+    t1 ^= load_be32(rk + 4);
+    t2 ^= load_be32(rk + 8);
+    t3 ^= load_be32(rk + 12);
+}
+
+// 확산 계층 중 워드 사이 XOR
+inline void diff_word(uint32_t &t0, uint32_t &t1, uint32_t &t2, uint32_t &t3)
+{
+    t1 ^= t2;
+    t2 ^= t3;
+    t0 ^= t1;
+    t3 ^= t1;
+    t2 ^= t0;
+    t1 ^= t2;
+}
+
+// 확산 계층 중 워드 안 바이트 자리 바꿈
+inline void diff_byte(uint32_t &, uint32_t &t1, uint32_t &t2, uint32_t &t3)
+{
+    t1 = ((t1 << 8) & 0xff00ff00u) ^ ((t1 >> 8) & 0x00ff00ffu);
+    t2 = rotr32(t2, 16);
+    t3 = __builtin_bswap32(t3);
+}
+
+// 홀수 라운드: SB1 SB2 SB1^-1 SB2^-1 + 확산
+inline void subst_diff_odd(const ARIATables &t, uint32_t &t0, uint32_t &t1, uint32_t &t2, uint32_t &t3)
+{
+    t0 = t.S1[b0(t0)] ^ t.S2[b1(t0)] ^ t.X1[b2(t0)] ^ t.X2[b3(t0)];
+    t1 = t.S1[b0(t1)] ^ t.S2[b1(t1)] ^ t.X1[b2(t1)] ^ t.X2[b3(t1)];
+    t2 = t.S1[b0(t2)] ^ t.S2[b1(t2)] ^ t.X1[b2(t2)] ^ t.X2[b3(t2)];
+    t3 = t.S1[b0(t3)] ^ t.S2[b1(t3)] ^ t.X1[b2(t3)] ^ t.X2[b3(t3)];
+    diff_word(t0, t1, t2, t3);
+    diff_byte(t0, t1, t2, t3);
+    diff_word(t0, t1, t2, t3);
+}
+
+// 짝수 라운드: SB1^-1 SB2^-1 SB1 SB2 + 확산
+inline void subst_diff_even(const ARIATables &t, uint32_t &t0, uint32_t &t1, uint32_t &t2, uint32_t &t3)
+{
+    t0 = t.X1[b0(t0)] ^ t.X2[b1(t0)] ^ t.S1[b2(t0)] ^ t.S2[b3(t0)];
+    t1 = t.X1[b0(t1)] ^ t.X2[b1(t1)] ^ t.S1[b2(t1)] ^ t.S2[b3(t1)];
+    t2 = t.X1[b0(t2)] ^ t.X2[b1(t2)] ^ t.S1[b2(t2)] ^ t.S2[b3(t2)];
+    t3 = t.X1[b0(t3)] ^ t.X2[b1(t3)] ^ t.S1[b2(t3)] ^ t.S2[b3(t3)];
+    diff_word(t0, t1, t2, t3);
+    diff_byte(t2, t3, t0, t1);
+    diff_word(t0, t1, t2, t3);
+}
+
+// 마지막 라운드는 확산 없이 짝수 치환만
+inline uint32_t final_subst(uint32_t v)
+{
+    return (static_cast<uint32_t>(S[2][b0(v)]) << 24) | (static_cast<uint32_t>(S[3][b1(v)]) << 16) |
+           (static_cast<uint32_t>(S[0][b2(v)]) << 8) | static_cast<uint32_t>(S[1][b3(v)]);
+}
+} // namespace
+
+void CryptTable(const Byte *p, int R, const Byte *e, Byte *c)
+{
+    const ARIATables &t = tables();
+
+    uint32_t t0 = load_be32(p);
+    uint32_t t1 = load_be32(p + 4);
+    uint32_t t2 = load_be32(p + 8);
+    uint32_t t3 = load_be32(p + 12);
+
+    add_round_key(e, t0, t1, t2, t3);
+    e += 16;
+    subst_diff_odd(t, t0, t1, t2, t3);
+    add_round_key(e, t0, t1, t2, t3);
+    e += 16;
+
+    for (int round = R - 2; round > 0; round -= 2)
+    {
+        subst_diff_even(t, t0, t1, t2, t3);
+        add_round_key(e, t0, t1, t2, t3);
+        e += 16;
+        subst_diff_odd(t, t0, t1, t2, t3);
+        add_round_key(e, t0, t1, t2, t3);
+        e += 16;
+    }
+
+    store_be32(c, final_subst(t0) ^ load_be32(e));
+    store_be32(c + 4, final_subst(t1) ^ load_be32(e + 4));
+    store_be32(c + 8, final_subst(t2) ^ load_be32(e + 8));
+    store_be32(c + 12, final_subst(t3) ^ load_be32(e + 12));
+}
@@ -0,0 +1,184 @@
+#include "encryption/GHash.h"
+#include <algorithm>
+#include <cstring>
+#include <immintrin.h>
+
+namespace
+{
+uint64_t load_be64(const uint8_t *p)
+{
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+void store_be64(uint8_t *p, uint64_t v)
+{
+    for (int i = 7; i >= 0; --i)
+    {
+        p[i] = static_cast<uint8_t>(v);
+        v >>= 8;
+    }
+}
+
+// 4비트씩 밀 때 떨어지는 비트의 환원 값
+constexpr uint64_t LAST4[16] = {
+    0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+    0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0,
+};
+
+// 바이트 순서를 뒤집은(비트 반사) 표현에서의 GF(2^128) 곱셈 (Intel CLMUL 백서의 gfmul)
+__attribute__((target("pclmul,ssse3"))) __m128i gfmul(__m128i a, __m128i b)
+{
+    __m128i t3 = _mm_clmulepi64_si128(a, b, 0x00);
+    __m128i t4 = _mm_clmulepi64_si128(a, b, 0x10);
+    __m128i t5 = _mm_clmulepi64_si128(a, b, 0x01);
+    __m128i t6 = _mm_clmulepi64_si128(a, b, 0x11);
+
+    t4 = _mm_xor_si128(t4, t5);
+    t5 = _mm_slli_si128(t4, 8);
+    t4 = _mm_srli_si128(t4, 8);
+    t3 = _mm_xor_si128(t3, t5);
+    t6 = _mm_xor_si128(t6, t4);
+
+    // 256비트 결과를 1비트 왼쪽으로 (비트 반사 보정)
+    __m128i t7 = _mm_srli_epi32(t3, 31);
+    __m128i t8 = _mm_srli_epi32(t6, 31);
+    t3 = _mm_slli_epi32(t3, 1);
+    t6 = _mm_slli_epi32(t6, 1);
+    __m128i t9 = _mm_srli_si128(t7, 12);
+    t8 = _mm_slli_si128(t8, 4);
+    t7 = _mm_slli_si128(t7, 4);
+    t3 = _mm_or_si128(t3, t7);
+    t6 = _mm_or_si128(t6, t8);
+    t6 = _mm_or_si128(t6, t9);
+
+    // x^128 + x^7 + x^2 + x + 1로 환원
+    t7 = _mm_slli_epi32(t3, 31);
+    t8 = _mm_slli_epi32(t3, 30);
+    t9 = _mm_slli_epi32(t3, 25);
+    t7 = _mm_xor_si128(t7, t8);
+    t7 = _mm_xor_si128(t7, t9);
+    t8 = _mm_srli_si128(t7, 4);
+    t7 = _mm_slli_si128(t7, 12);
+    t3 = _mm_xor_si128(t3, t7);
+
+    __m128i t2 = _mm_srli_epi32(t3, 1);
+    t4 = _mm_srli_epi32(t3, 2);
+    t5 = _mm_srli_epi32(t3, 7);
+    t2 = _mm_xor_si128(t2, t4);
+    t2 = _mm_xor_si128(t2, t5);
+    t2 = _mm_xor_si128(t2, t8);
+    t3 = _mm_xor_si128(t3, t2);
+    return _mm_xor_si128(t6, t3);
+}
+
+__attribute__((target("pclmul,ssse3"))) void absorbClmul(const uint8_t *h, uint8_t *y, const uint8_t *data, size_t len)
+{
+    const __m128i bswap = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    const __m128i hv = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(h)), bswap);
+    __m128i acc = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(y)), bswap);
+
+    size_t off = 0;
+    for (; off + GHashKey::BLOCK_SIZE <= len; off += GHashKey::BLOCK_SIZE)
+    {
+        __m128i x = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + off)), bswap);
+        acc = gfmul(_mm_xor_si128(acc, x), hv);
+    }
+    if (off < len)
+    {
+        uint8_t last[GHashKey::BLOCK_SIZE] = {};
+        std::memcpy(last, data + off, len - off);
+        __m128i x = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(last)), bswap);
+        acc = gfmul(_mm_xor_si128(acc, x), hv);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(y), _mm_shuffle_epi8(acc, bswap));
+}
+} // namespace
+
+GHashKey::GHashKey(std::span<const uint8_t, BLOCK_SIZE> h, bool allow_clmul)
+{
+    std::memcpy(h_.data(), h.data(), BLOCK_SIZE);
+    __builtin_cpu_init();
+    clmul_ = allow_clmul && __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+
+    // 4비트 테이블: 인덱스 i(비트 반사)에 대한 i·H
+    uint64_t vh = load_be64(h_.data());
+    uint64_t vl = load_be64(h_.data() + 8);
+    hl_[8] = vl;
+    hh_[8] = vh;
+    for (int i = 4; i > 0; i >>= 1)
+    {
+        uint64_t t = (vl & 1) * 0xe1000000ULL;
+        vl = (vh << 63) | (vl >> 1);
+        vh = (vh >> 1) ^ (t << 32);
+        hl_[i] = vl;
+        hh_[i] = vh;
+    }
+    for (int i = 2; i <= 8; i *= 2)
+    {
+        for (int j = 1; j < i; ++j)
+        {
+            hh_[i + j] = hh_[i] ^ hh_[j];
+            hl_[i + j] = hl_[i] ^ hl_[j];
+        }
+    }
+}
+
+void GHashKey::multiplyTable(Block &y) const
+{
+    uint8_t lo = y[15] & 0x0f;
+    uint64_t zh = hh_[lo];
+    uint64_t zl = hl_[lo];
+
+    for (int i = 15; i >= 0; --i)
+    {
+        lo = y[i] & 0x0f;
+        uint8_t hi = static_cast<uint8_t>(y[i] >> 4);
+        if (i != 15)
+        {
+            uint8_t rem = static_cast<uint8_t>(zl & 0x0f);
+            zl = (zh << 60) | (zl >> 4);
+            zh = (zh >> 4) ^ (LAST4[rem] << 48);
+            zh ^= hh_[lo];
+            zl ^= hl_[lo];
+        }
+        uint8_t rem = static_cast<uint8_t>(zl & 0x0f);
+        zl = (zh << 60) | (zl >> 4);
+        zh = (zh >> 4) ^ (LAST4[rem] << 48);
+        zh ^= hh_[hi];
+        zl ^= hl_[hi];
+    }
+    store_be64(y.data(), zh);
+    store_be64(y.data() + 8, zl);
+}
+
+void GHashKey::absorb(Block &y, std::span<const uint8_t> data) const
+{
+    if (clmul_)
+    {
+        absorbClmul(h_.data(), y.data(), data.data(), data.size());
+        return;
+    }
+
+    for (size_t off = 0; off < data.size(); off += BLOCK_SIZE)
+    {
+        const size_t n = std::min(BLOCK_SIZE, data.size() - off);
+        for (size_t j = 0; j < n; ++j)
+        {
+            y[j] ^= data[off + j];
+        }
+        multiplyTable(y);
+    }
+}
+
+void GHashKey::absorbLengths(Block &y, uint64_t aad_bytes, uint64_t cipher_bytes) const
+{
+    uint8_t lengths[BLOCK_SIZE];
+    store_be64(lengths, aad_bytes * 8);
+    store_be64(lengths + 8, cipher_bytes * 8);
+    absorb(y, lengths);
+}
@@ -1,21 +1,118 @@
-#include "protocol/EncryptionModule.h"
-#include "encryption/ARIAAlgorithm.h"
-#include "common/Debug.h"
-
-EncryptionModule::EncryptionModule(const std::vector<uint8_t>& key)
-  : key_(key)
-{
-    DBG_PRINT("EncryptionModule created (key_len=%zu)", key_.size());
-}
-
-std::vector<uint8_t> EncryptionModule::process(const std::vector<uint8_t>& data) {
-    DBG_PRINT("EncryptionModule::process");
-    ARIAAlgorithm algo(key_);
-    return algo.encrypt(data);
-}
-
-std::vector<uint8_t> EncryptionModule::reverse(const std::vector<uint8_t>& data) {
-    DBG_PRINT("EncryptionModule::reverse");
-    ARIAAlgorithm algo(key_);
-    return algo.decrypt(data);
-}
+#include "protocol/EncryptionModule.h"
+#include "encryption/ARIAAlgorithm.h"
+#include "common/Debug.h"
+#include <stdexcept>
+
+namespace {
+// 스트림 동안 컨텍스트를 잡아 두어 키를 교체해도 이 메시지는 같은 키로 끝남
+class EncryptStream : public IProtocolStream {
+public:
+    explicit EncryptStream(std::shared_ptr<const ARIAAlgorithm> aria)
+      : aria_(std::move(aria)), encryptor_(aria_->beginEncryptStream()) {}
+    void update(std::span<const uint8_t> data, std::vector<uint8_t>& out) override {
+        encryptor_.update(data, out);
+    }
+    void finish(std::vector<uint8_t>& out) override {
+        encryptor_.finish(out);
+    }
+
+private:
+    std::shared_ptr<const ARIAAlgorithm> aria_;
+    ARIAAlgorithm::Encryptor encryptor_;
+};
+
+class DecryptStream : public IProtocolStream {
+public:
+    explicit DecryptStream(std::shared_ptr<const ARIAAlgorithm> aria)
+      : aria_(std::move(aria)), decryptor_(aria_->beginDecryptStream()) {}
+    void update(std::span<const uint8_t> data, std::vector<uint8_t>& out) override {
+        decryptor_.update(data, out);
+    }
+    void finish(std::vector<uint8_t>& out) override {
+        if (!decryptor_.finish(out)) {
+            throw std::runtime_error(aria_->mode() == ARIAAlgorithm::Mode::Gcm
+                                         ? "ARIA-GCM authentication failed"
+                                         : "ARIA stream decryption failed (truncated or bad padding)");
+        }
+    }
+
+private:
+    std::shared_ptr<const ARIAAlgorithm> aria_;
+    ARIAAlgorithm::Decryptor decryptor_;
+};
+}
+
+EncryptionModule::EncryptionModule(const std::vector<uint8_t>& key, ARIAAlgorithm::Mode mode)
+  : context_(key, mode)
+{
+    DBG_PRINT("EncryptionModule created (key_len=%zu, mode=%d)", key.size(), static_cast<int>(mode));
+}
+
+void EncryptionModule::setKey(const std::vector<uint8_t>& key) {
+    DBG_PRINT("EncryptionModule::setKey (key_len=%zu)", key.size());
+    context_.rotate(key);
+}
+
+void EncryptionModule::decryptFailed() const {
+    if (context_.mode() == ARIAAlgorithm::Mode::Gcm) {
+        throw std::runtime_error("ARIA-GCM authentication failed");
+    }
+}
+
+std::vector<uint8_t> EncryptionModule::process(const std::vector<uint8_t>& data) {
+    DBG_PRINT("EncryptionModule::process");
+    return context_.current()->encrypt(data);
+}
+
+std::vector<uint8_t> EncryptionModule::reverse(const std::vector<uint8_t>& data) {
+    DBG_PRINT("EncryptionModule::reverse");
+    std::vector<uint8_t> out = data;
+    std::optional<size_t> plain_len = context_.current()->decryptInPlace(out);
+    if (!plain_len) {
+        decryptFailed();
+        return {};
+    }
+    out.erase(out.begin(), out.begin() + ARIAAlgorithm::headerSize(context_.mode()));
+    out.resize(*plain_len);
+    return out;
+}
+
+size_t EncryptionModule::headroom() const {
+    return ARIAAlgorithm::headerSize(context_.mode());
+}
+
+size_t EncryptionModule::tailroom() const {
+    return ARIAAlgorithm::maxTrailerSize(context_.mode());
+}
+
+void EncryptionModule::processInPlace(ProtocolBuffer& buffer) {
+    DBG_PRINT("EncryptionModule::processInPlace");
+    const ARIAAlgorithm::Mode mode = context_.mode();
+    const size_t plain_len = buffer.size();
+    const size_t cipher_len = ARIAAlgorithm::ciphertextSize(mode, plain_len);
+    buffer.pushFront(ARIAAlgorithm::headerSize(mode));
+    buffer.pushBack(cipher_len - ARIAAlgorithm::headerSize(mode) - plain_len);
+
+    context_.current()->encryptInPlace(buffer.data(), plain_len);
+}
+
+void EncryptionModule::reverseInPlace(ProtocolBuffer& buffer) {
+    DBG_PRINT("EncryptionModule::reverseInPlace");
+    std::optional<size_t> plain_len = context_.current()->decryptInPlace(buffer.data());
+    if (!plain_len) {
+        // vector 버전과 같이 실패하면 빈 결과 (GCM은 예외)
+        buffer.clear();
+        decryptFailed();
+        return;
+    }
+    buffer.popFront(ARIAAlgorithm::headerSize(context_.mode()));
+    buffer.popBack(buffer.size() - *plain_len);
+}
+
+std::unique_ptr<IProtocolStream> EncryptionModule::beginProcess() {
+    return std::make_unique<EncryptStream>(context_.current());
+}
+
+std::unique_ptr<IProtocolStream> EncryptionModule::beginReverse() {
+    return std::make_unique<DecryptStream>(context_.current());
+}
@@ -1,26 +1,102 @@
-#include "protocol/PaddingModule.h"
-#include "common/Debug.h"
-#include <algorithm>
-
-PaddingModule::PaddingModule(const std::vector<uint8_t>& pad)
-  : pad_(pad)
-{}
-
-std::vector<uint8_t> PaddingModule::process(const std::vector<uint8_t>& in) {
-    DBG_PRINT("PaddingModule::process pad_len=%zu", pad_.size());
-    std::vector<uint8_t> out = in;
-    out.insert(out.begin(), pad_.begin(), pad_.end());
-    return out;
-}
-
-std::vector<uint8_t> PaddingModule::reverse(const std::vector<uint8_t>& in) {
-    DBG_PRINT("PaddingModule::reverse pad_len=%zu", pad_.size());
-    std::vector<uint8_t> out = in;
-    if (out.size() >= pad_.size()
-        && std::equal(pad_.begin(), pad_.end(), out.begin())) {
-        out.erase(out.begin(), out.begin() + pad_.size());
-    } else {
-        DBG_PRINT("PaddingModule: padding mismatch!");
-    }
-    return out;
-}
+#include "protocol/PaddingModule.h"
+#include "common/Debug.h"
+#include <algorithm>
+
+namespace {
+// 처음 조각 앞에 패딩을 붙임
+class PaddingProcessStream : public IProtocolStream {
+public:
+    explicit PaddingProcessStream(const std::vector<uint8_t>& pad) : pad_(pad) {}
+    void update(std::span<const uint8_t> data, std::vector<uint8_t>& out) override {
+        if (!started_) {
+            out.insert(out.end(), pad_.begin(), pad_.end());
+            started_ = true;
+        }
+        out.insert(out.end(), data.begin(), data.end());
+    }
+    void finish(std::vector<uint8_t>& out) override { update({}, out); }
+
+private:
+    const std::vector<uint8_t>& pad_;
+    bool started_ = false;
+};
+
+// 앞 pad 길이만큼 모아 비교한 뒤 나머지는 그대로 넘김. 맞지 않으면 reverseInPlace처럼 떼지 않음
+class PaddingReverseStream : public IProtocolStream {
+public:
+    explicit PaddingReverseStream(const std::vector<uint8_t>& pad) : pad_(pad) {}
+    void update(std::span<const uint8_t> data, std::vector<uint8_t>& out) override {
+        if (!checked_) {
+            const size_t n = std::min(pad_.size() - head_.size(), data.size());
+            head_.insert(head_.end(), data.begin(), data.begin() + n);
+            data = data.subspan(n);
+            if (head_.size() < pad_.size()) {
+                return;
+            }
+            check(out);
+        }
+        out.insert(out.end(), data.begin(), data.end());
+    }
+    void finish(std::vector<uint8_t>& out) override {
+        if (!checked_) {
+            // 패딩보다 짧은 메시지
+            check(out);
+        }
+    }
+
+private:
+    void check(std::vector<uint8_t>& out) {
+        checked_ = true;
+        if (head_ != pad_) {
+            DBG_PRINT("PaddingModule: padding mismatch!");
+            out.insert(out.end(), head_.begin(), head_.end());
+        }
+        head_.clear();
+    }
+
+    const std::vector<uint8_t>& pad_;
+    std::vector<uint8_t> head_;
+    bool checked_ = false;
+};
+}
+
+PaddingModule::PaddingModule(const std::vector<uint8_t>& pad)
+  : pad_(pad)
+{}
+
+std::vector<uint8_t> PaddingModule::process(const std::vector<uint8_t>& in) {
+    ProtocolBuffer buffer(in, headroom(), tailroom());
+    processInPlace(buffer);
+    return buffer.release();
+}
+
+std::vector<uint8_t> PaddingModule::reverse(const std::vector<uint8_t>& in) {
+    ProtocolBuffer buffer(in, 0, 0);
+    reverseInPlace(buffer);
+    return buffer.release();
+}
+
+void PaddingModule::processInPlace(ProtocolBuffer& buffer) {
+    DBG_PRINT("PaddingModule::process pad_len=%zu", pad_.size());
+    std::span<uint8_t> head = buffer.pushFront(pad_.size());
+    std::copy(pad_.begin(), pad_.end(), head.begin());
+}
+
+void PaddingModule::reverseInPlace(ProtocolBuffer& buffer) {
+    DBG_PRINT("PaddingModule::reverse pad_len=%zu", pad_.size());
+    std::span<const uint8_t> data = buffer.data();
+    if (data.size() >= pad_.size()
+        && std::equal(pad_.begin(), pad_.end(), data.begin())) {
+        buffer.popFront(pad_.size());
+    } else {
+        DBG_PRINT("PaddingModule: padding mismatch!");
+    }
+}
+
+std::unique_ptr<IProtocolStream> PaddingModule::beginProcess() {
+    return std::make_unique<PaddingProcessStream>(pad_);
+}
+
+std::unique_ptr<IProtocolStream> PaddingModule::beginReverse() {
+    return std::make_unique<PaddingReverseStream>(pad_);
+}
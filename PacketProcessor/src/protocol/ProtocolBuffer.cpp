@@ -0,0 +1,72 @@
+#include "protocol/ProtocolBuffer.h"
+#include "common/Debug.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+ProtocolBuffer::ProtocolBuffer(std::span<const uint8_t> data, size_t headroom, size_t tailroom)
+  : storage_(headroom + data.size() + tailroom),
+    offset_(headroom),
+    length_(data.size())
+{
+    if (!data.empty()) {
+        std::memcpy(storage_.data() + offset_, data.data(), data.size());
+    }
+}
+
+ProtocolBuffer::ProtocolBuffer(std::vector<uint8_t>&& data)
+  : storage_(std::move(data)),
+    offset_(0),
+    length_(storage_.size())
+{}
+
+std::span<uint8_t> ProtocolBuffer::pushFront(size_t n) {
+    if (offset_ < n) {
+        grow(n, 0);
+    }
+    offset_ -= n;
+    length_ += n;
+    return {storage_.data() + offset_, n};
+}
+
+std::span<uint8_t> ProtocolBuffer::pushBack(size_t n) {
+    if (tailroom() < n) {
+        grow(0, n);
+    }
+    length_ += n;
+    return {storage_.data() + offset_ + length_ - n, n};
+}
+
+void ProtocolBuffer::popFront(size_t n) {
+    if (n > length_) {
+        throw std::out_of_range("ProtocolBuffer::popFront");
+    }
+    offset_ += n;
+    length_ -= n;
+}
+
+void ProtocolBuffer::popBack(size_t n) {
+    if (n > length_) {
+        throw std::out_of_range("ProtocolBuffer::popBack");
+    }
+    length_ -= n;
+}
+
+std::vector<uint8_t> ProtocolBuffer::release() {
+    if (offset_ > 0 && length_ > 0) {
+        std::memmove(storage_.data(), storage_.data() + offset_, length_);
+    }
+    storage_.resize(length_);
+    offset_ = 0;
+    length_ = 0;
+    return std::move(storage_);
+}
+
+void ProtocolBuffer::grow(size_t headroom, size_t tailroom) {
+    // 모듈이 알린 것보다 많이 붙이는 경우. 결과는 같지만 한 번 더 복사함
+    DBG_PRINT("ProtocolBuffer grow (head+%zu, tail+%zu)", headroom, tailroom);
+    std::vector<uint8_t> grown(storage_.size() + headroom + tailroom);
+    std::copy_n(storage_.data() + offset_, length_, grown.data() + offset_ + headroom);
+    storage_ = std::move(grown);
+    offset_ += headroom;
+}
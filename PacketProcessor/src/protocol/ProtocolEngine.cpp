@@ -1,61 +1,113 @@
-#include "protocol/ProtocolEngine.h"
-
-ProtocolEngine::ProtocolEngine() = default;
-ProtocolEngine::~ProtocolEngine() = default;
-
-std::vector<uint8_t> ProtocolEngine::encrypt(const std::vector<uint8_t>& data) const {
-    std::vector<uint8_t> tmp = data;
-    DBG_PRINT("Encrypt start (%zu bytes)", tmp.size());
-    for (auto& mod : modules_) {
-        tmp = mod->process(tmp);
-        DBG_PRINT(" → after %s: size=%zu",
-                  typeid(*mod).name(), tmp.size());
-    }
-    DBG_PRINT("Encrypt done");
-    return tmp;
-}
-
-std::vector<uint8_t> ProtocolEngine::decrypt(const std::vector<uint8_t>& data) const {
-    std::vector<uint8_t> tmp = data;
-    DBG_PRINT("Decrypt start (%zu bytes)", tmp.size());
-    for (auto it = modules_.rbegin(); it != modules_.rend(); ++it) {
-        tmp = (*it)->reverse(tmp);
-        DBG_PRINT(" ← after %s.reverse: size=%zu",
-                  typeid(**it).name(), tmp.size());
-    }
-    DBG_PRINT("Decrypt done");
-    return tmp;
-}
-
-std::vector<uint8_t> ProtocolEngine::encrypt(std::span<const uint8_t> data) const {
-    std::vector<uint8_t> tmp(data.begin(), data.end());
-    DBG_PRINT("Encrypt (span) start (%zu bytes)", tmp.size());
-
-    for (auto& mod : modules_) {
-        tmp = mod->process(tmp);
-        DBG_PRINT(" → after %s: size=%zu",
-                  typeid(*mod).name(), tmp.size());
-    }
-
-    DBG_PRINT("Encrypt (span) done");
-    return tmp;
-}
-
-std::vector<uint8_t> ProtocolEngine::decrypt(std::span<const uint8_t> data) const {
-    std::vector<uint8_t> tmp(data.begin(), data.end());
-    DBG_PRINT("Decrypt (span) start (%zu bytes)", tmp.size());
-
-    for (auto it = modules_.rbegin(); it != modules_.rend(); ++it) {
-        tmp = (*it)->reverse(tmp);
-        DBG_PRINT(" ← after %s.reverse: size=%zu",
-                  typeid(**it).name(), tmp.size());
-    }
-
-    DBG_PRINT("Decrypt (span) done");
-    return tmp;
-}
-
-void ProtocolEngine::addModule(std::unique_ptr<IProtocolModule> module) {
-    DBG_PRINT("Added module %s", typeid(*module).name());
-    modules_.push_back(std::move(module));
-}
+#include "protocol/ProtocolEngine.h"
+
+ProtocolEngine::ProtocolEngine() = default;
+ProtocolEngine::~ProtocolEngine() = default;
+
+std::vector<uint8_t> ProtocolEngine::encrypt(const std::vector<uint8_t>& data) const {
+    return encrypt(std::span<const uint8_t>(data));
+}
+
+std::vector<uint8_t> ProtocolEngine::decrypt(const std::vector<uint8_t>& data) const {
+    return decrypt(std::span<const uint8_t>(data));
+}
+
+std::vector<uint8_t> ProtocolEngine::encrypt(std::span<const uint8_t> data) const {
+    // 입력 복사는 여기 한 번뿐이고, 모듈들은 앞뒤 여유 안에서 헤더/IV/패딩을 붙임
+    ProtocolBuffer buffer(data, headroom(), tailroom());
+    encryptInPlace(buffer);
+    return buffer.release();
+}
+
+std::vector<uint8_t> ProtocolEngine::decrypt(std::span<const uint8_t> data) const {
+    ProtocolBuffer buffer(data, 0, 0);
+    decryptInPlace(buffer);
+    return buffer.release();
+}
+
+void ProtocolEngine::encryptInPlace(ProtocolBuffer& buffer) const {
+    DBG_PRINT("Encrypt start (%zu bytes)", buffer.size());
+    for (auto& mod : modules_) {
+        mod->processInPlace(buffer);
+        DBG_PRINT(" → after %s: size=%zu",
+                  typeid(*mod).name(), buffer.size());
+    }
+    DBG_PRINT("Encrypt done");
+}
+
+void ProtocolEngine::decryptInPlace(ProtocolBuffer& buffer) const {
+    DBG_PRINT("Decrypt start (%zu bytes)", buffer.size());
+    for (auto it = modules_.rbegin(); it != modules_.rend(); ++it) {
+        (*it)->reverseInPlace(buffer);
+        DBG_PRINT(" ← after %s.reverse: size=%zu",
+                  typeid(**it).name(), buffer.size());
+    }
+    DBG_PRINT("Decrypt done");
+}
+
+size_t ProtocolEngine::headroom() const {
+    size_t total = 0;
+    for (auto& mod : modules_) {
+        total += mod->headroom();
+    }
+    return total;
+}
+
+size_t ProtocolEngine::tailroom() const {
+    size_t total = 0;
+    for (auto& mod : modules_) {
+        total += mod->tailroom();
+    }
+    return total;
+}
+
+ProtocolEngine::Stream ProtocolEngine::beginEncrypt() const {
+    Stream stream;
+    for (auto& mod : modules_) {
+        stream.stages_.push_back(mod->beginProcess());
+    }
+    return stream;
+}
+
+ProtocolEngine::Stream ProtocolEngine::beginDecrypt() const {
+    Stream stream;
+    for (auto it = modules_.rbegin(); it != modules_.rend(); ++it) {
+        stream.stages_.push_back((*it)->beginReverse());
+    }
+    return stream;
+}
+
+void ProtocolEngine::Stream::feed(size_t first, std::span<const uint8_t> data, std::vector<uint8_t>& out) {
+    for (size_t i = first; i < stages_.size(); ++i) {
+        if (i + 1 == stages_.size()) {
+            stages_[i]->update(data, out);
+            return;
+        }
+        std::vector<uint8_t>& next = scratch_[i % 2];
+        next.clear();
+        stages_[i]->update(data, next);
+        data = next;
+    }
+    out.insert(out.end(), data.begin(), data.end());
+}
+
+void ProtocolEngine::Stream::update(std::span<const uint8_t> data, std::vector<uint8_t>& out) {
+    feed(0, data, out);
+}
+
+void ProtocolEngine::Stream::finish(std::vector<uint8_t>& out) {
+    // 앞 단계가 finish에서 내보낸 것(패딩/태그 등)은 뒤 단계에 조각으로 넘긴 뒤 뒤 단계를 끝냄
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        if (i + 1 == stages_.size()) {
+            stages_[i]->finish(out);
+            break;
+        }
+        tail_.clear();
+        stages_[i]->finish(tail_);
+        feed(i + 1, tail_, out);
+    }
+}
+
+void ProtocolEngine::addModule(std::unique_ptr<IProtocolModule> module) {
+    DBG_PRINT("Added module %s", typeid(*module).name());
+    modules_.push_back(std::move(module));
+}
@@ -1,20 +1,55 @@
-#include "protocol/ShiftModule.h"
-#include "common/Debug.h"
-
-std::vector<uint8_t> ShiftModule::process(const std::vector<uint8_t>& in) {
-    DBG_PRINT("ShiftModule::process offset=%d", offset_);
-    std::vector<uint8_t> out = in;
-    for (auto& b : out) {
-        b = static_cast<uint8_t>(b + offset_);
-    }
-    return out;
-}
-
-std::vector<uint8_t> ShiftModule::reverse(const std::vector<uint8_t>& in) {
-    DBG_PRINT("ShiftModule::reverse offset=%d", offset_);
-    std::vector<uint8_t> out = in;
-    for (auto& b : out) {
-        b = static_cast<uint8_t>(b - offset_);
-    }
-    return out;
-}
+#include "protocol/ShiftModule.h"
+#include "common/Debug.h"
+
+static void shift_bytes(std::span<uint8_t> data, int offset) {
+    for (auto& b : data) {
+        b = static_cast<uint8_t>(b + offset);
+    }
+}
+
+namespace {
+// 바이트마다 독립이므로 조각을 받는 대로 옮겨 바꿈
+class ShiftStream : public IProtocolStream {
+public:
+    explicit ShiftStream(int offset) : offset_(offset) {}
+    void update(std::span<const uint8_t> data, std::vector<uint8_t>& out) override {
+        const size_t start = out.size();
+        out.insert(out.end(), data.begin(), data.end());
+        shift_bytes(std::span<uint8_t>(out).subspan(start), offset_);
+    }
+    void finish(std::vector<uint8_t>&) override {}
+
+private:
+    int offset_;
+};
+}
+
+std::vector<uint8_t> ShiftModule::process(const std::vector<uint8_t>& in) {
+    ProtocolBuffer buffer(in, 0, 0);
+    processInPlace(buffer);
+    return buffer.release();
+}
+
+std::vector<uint8_t> ShiftModule::reverse(const std::vector<uint8_t>& in) {
+    ProtocolBuffer buffer(in, 0, 0);
+    reverseInPlace(buffer);
+    return buffer.release();
+}
+
+void ShiftModule::processInPlace(ProtocolBuffer& buffer) {
+    DBG_PRINT("ShiftModule::process offset=%d", offset_);
+    shift_bytes(buffer.data(), offset_);
+}
+
+void ShiftModule::reverseInPlace(ProtocolBuffer& buffer) {
+    DBG_PRINT("ShiftModule::reverse offset=%d", offset_);
+    shift_bytes(buffer.data(), -offset_);
+}
+
+std::unique_ptr<IProtocolStream> ShiftModule::beginProcess() {
+    return std::make_unique<ShiftStream>(offset_);
+}
+
+std::unique_ptr<IProtocolStream> ShiftModule::beginReverse() {
+    return std::make_unique<ShiftStream>(-offset_);
+}
@@ -1,8 +1,17 @@
 #include "encryption/ARIAAlgorithm.h"
+#include "encryption/ARIAReference.h"
+#include "encryption/ARIATable.h"
+#include "encryption/ARIASimd.h"
+#include "common/WorkerPool.h"
 #include <iostream>
 #include <vector>
 #include <cstdint>
 #include <random>
+#include <string>
+#include <utility>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
 
 static std::vector<uint8_t> generate_random_bytes(size_t len) {
     std::vector<uint8_t> v(len);
@@ -13,9 +22,460 @@ static std::vector<uint8_t> generate_random_bytes(size_t len) {
     return v;
 }
 
+static std::vector<uint8_t> from_hex(const char* hex) {
+    std::vector<uint8_t> v;
+    for (; hex[0] && hex[1]; hex += 2) {
+        v.push_back(static_cast<uint8_t>(std::stoi(std::string(hex, 2), nullptr, 16)));
+    }
+    return v;
+}
+
+// RFC 5794 Appendix A 테스트 벡터. 두 코어 모두 암호화/복호화 확인
+static bool run_known_answer_tests() {
+    struct Vector { int key_bits; const char* cipher; };
+    const Vector vectors[] = {
+        {128, "d718fbd6ab644c739da95f3be6451778"},
+        {192, "26449c1805dbe7aa25a468ce263a9e79"},
+        {256, "f92bd7c79fb72e2f2b8f80c1972d24fc"},
+    };
+    const std::vector<uint8_t> key = from_hex("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f");
+    const std::vector<uint8_t> plain = from_hex("00112233445566778899aabbccddeeff");
+
+    bool pass = true;
+    for (const Vector& v : vectors) {
+        const std::vector<uint8_t> expected = from_hex(v.cipher);
+        Byte enc_keys[16 * 17], dec_keys[16 * 17];
+        int rounds = EncKeySetup(key.data(), enc_keys, v.key_bits);
+        DecKeySetup(key.data(), dec_keys, v.key_bits);
+
+        for (auto [name, crypt] : {std::pair{"reference", &Crypt}, std::pair{"table", &CryptTable}}) {
+            std::vector<uint8_t> out(16), back(16);
+            crypt(plain.data(), rounds, enc_keys, out.data());
+            crypt(out.data(), rounds, dec_keys, back.data());
+            std::cout << "[KAT] ARIA-" << v.key_bits << " " << name << "... ";
+            if (out != expected || back != plain) {
+                std::cerr << "FAIL: 테스트 벡터와 다름\n";
+                pass = false;
+            } else {
+                std::cout << "PASS\n";
+            }
+        }
+    }
+    return pass;
+}
+
+// CBC 기지 답: RFC 5794 키/평문을 늘린 4블록을 고정 IV로 처리한 결과 (OpenSSL enc -aria-*-cbc -nopad로 만듦).
+// 코어마다 CbcState 경로(SIMD는 묶음 복호화 포함)로 암호화/복호화 확인
+static bool run_cbc_known_answer_tests() {
+    struct Vector { int key_bits; const char* cipher; };
+    const Vector vectors[] = {
+        {128, "37c7a1f5259e100637798850fdc1fc485cd0c07629122db1e445d68fcdf39959"
+              "621483a6155cfda96129860ddb9aa8b3d482d34e2cdee6e37636fe3c61a6db5b"},
+        {192, "b74acefa7cf905a529a77c435a1b5265890c519076b7cf7e3eb188f1321add80"
+              "6e5cd0e1e924362870d9b932942a46b9f11b7be1d0d81618ed2364f09851a768"},
+        {256, "08186e7986b43c2c7b93c7c95373c4d85bcf46c0c3067f480fef38beab7666d1"
+              "4c0487006501feeed00dbcc00a04ea43bf207a29a9a5fb6474437783431c5053"},
+    };
+    const std::vector<uint8_t> key = from_hex("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f");
+    const std::vector<uint8_t> iv = from_hex("0f0e0d0c0b0a09080706050403020100");
+    const std::vector<uint8_t> plain = from_hex(
+        "00112233445566778899aabbccddeeff0123456789abcdeffedcba9876543210"
+        "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f");
+
+    bool pass = true;
+    for (const Vector& v : vectors) {
+        const std::vector<uint8_t> expected = from_hex(v.cipher);
+        const std::vector<uint8_t> k(key.begin(), key.begin() + v.key_bits / 8);
+        for (auto [name, core] : {std::pair{"reference", ARIAAlgorithm::Core::Reference},
+                                  std::pair{"table", ARIAAlgorithm::Core::Table},
+                                  std::pair{"simd", ARIAAlgorithm::Core::Simd}}) {
+            ARIAAlgorithm aria(k, ARIAAlgorithm::Mode::Cbc, core);
+            std::vector<uint8_t> out = plain;
+            ARIAAlgorithm::CbcState enc = aria.beginEncrypt(std::span<const uint8_t, 16>(iv.data(), 16));
+            ARIAAlgorithm::encryptBlocks(enc, out);
+            std::vector<uint8_t> back = out;
+            ARIAAlgorithm::CbcState dec = aria.beginDecrypt(std::span<const uint8_t, 16>(iv.data(), 16));
+            ARIAAlgorithm::decryptBlocks(dec, back);
+            std::cout << "[KAT] ARIA-" << v.key_bits << "-CBC " << name << "... ";
+            if (out != expected || back != plain) {
+                std::cerr << "FAIL: 테스트 벡터와 다름\n";
+                pass = false;
+            } else {
+                std::cout << "PASS\n";
+            }
+        }
+    }
+    return pass;
+}
+
+// SIMD 백엔드마다 테스트 벡터와, 여러 블록 수(묶음 경계/끝 블록 포함)에서 테이블 코어와 같은 결과인지 확인
+static bool run_simd_backend_tests() {
+    const std::vector<uint8_t> kat_key = from_hex("000102030405060708090a0b0c0d0e0f");
+    const std::vector<uint8_t> kat_plain = from_hex("00112233445566778899aabbccddeeff");
+    const std::vector<uint8_t> kat_cipher = from_hex("d718fbd6ab644c739da95f3be6451778");
+
+    bool pass = true;
+    for (ARIASimdBackend backend : {ARIASimdBackend::Portable, ARIASimdBackend::AesniAvx,
+                                    ARIASimdBackend::GfniAvx2, ARIASimdBackend::GfniAvx512}) {
+        if (!ARIASimdSupported(backend)) {
+            std::cout << "[SIMD] " << ARIASimdBackendName(backend) << " 지원 안 함, 건너뜀\n";
+            continue;
+        }
+        std::cout << "[SIMD] " << ARIASimdBackendName(backend) << "... ";
+        bool ok = true;
+
+        Byte kat_keys[16 * 17];
+        int kat_rounds = EncKeySetup(kat_key.data(), kat_keys, 128);
+        std::vector<uint8_t> kat_out(16);
+        CryptBlocks(backend, kat_plain.data(), kat_out.data(), 1, kat_rounds, kat_keys);
+        ok = ok && kat_out == kat_cipher;
+
+        for (int key_bits : {128, 192, 256}) {
+            const std::vector<uint8_t> key = generate_random_bytes(key_bits / 8);
+            Byte enc_keys[16 * 17], dec_keys[16 * 17];
+            int rounds = EncKeySetup(key.data(), enc_keys, key_bits);
+            DecKeySetup(key.data(), dec_keys, key_bits);
+            for (size_t blocks : {size_t{1}, size_t{15}, size_t{16}, size_t{17}, size_t{63}, size_t{64}, size_t{113}}) {
+                const std::vector<uint8_t> plain = generate_random_bytes(blocks * 16);
+                std::vector<uint8_t> expected(plain.size()), out(plain.size());
+                for (size_t i = 0; i < blocks; ++i) {
+                    CryptTable(plain.data() + 16 * i, rounds, enc_keys, expected.data() + 16 * i);
+                }
+                CryptBlocks(backend, plain.data(), out.data(), blocks, rounds, enc_keys);
+                ok = ok && out == expected;
+                // 제자리 복호화
+                CryptBlocks(backend, out.data(), out.data(), blocks, rounds, dec_keys);
+                ok = ok && out == plain;
+            }
+        }
+        if (ok) {
+            std::cout << "PASS\n";
+        } else {
+            std::cerr << "FAIL: 테이블 코어와 결과가 다름\n";
+            pass = false;
+        }
+    }
+    return pass;
+}
+
+// CTR/GCM: 외부 구현(OpenSSL ARIA-128-GCM)이 만든 메시지 복호화, 코어별 왕복, 변조/잘림 검출
+static bool run_counter_mode_tests() {
+    bool pass = true;
+    auto check = [&pass](bool ok, const char* what) {
+        if (!ok) {
+            std::cerr << "FAIL: " << what << "\n";
+            pass = false;
+        }
+    };
+
+    // nonce || 암호문 || 태그
+    const std::vector<uint8_t> gcm_key = from_hex("000102030405060708090a0b0c0d0e0f");
+    const std::vector<uint8_t> gcm_message = from_hex(
+        "cafebabefacedbaddecaf888"
+        "c2024bf1801a5d1e391986af0747c2ed2f8bd6463c335f2c82611f079ed2e0573626e861e6ceac28"
+        "0c9692c880af76c8b223f6dd9930eb4c");
+    const std::vector<uint8_t> gcm_plain = from_hex(
+        "00112233445566778899aabbccddeeff00112233445566778899aabbccddeeff0011223344556677");
+    std::cout << "[GCM] known message... ";
+    check(ARIAAlgorithm(gcm_key, ARIAAlgorithm::Mode::Gcm).decrypt(gcm_message) == gcm_plain, "GCM known message");
+    std::cout << (pass ? "PASS\n" : "\n");
+
+    for (ARIAAlgorithm::Mode mode : {ARIAAlgorithm::Mode::Ctr, ARIAAlgorithm::Mode::Gcm}) {
+        const char* name = mode == ARIAAlgorithm::Mode::Ctr ? "CTR" : "GCM";
+        std::cout << "[" << name << "] round trips... ";
+        const bool before = pass;
+        const std::vector<uint8_t> key = generate_random_bytes(32);
+        ARIAAlgorithm simd(key, mode);
+        ARIAAlgorithm table(key, mode, ARIAAlgorithm::Core::Table);
+        for (size_t size : {size_t{0}, size_t{1}, size_t{15}, size_t{16}, size_t{17}, size_t{1000}, size_t{4096 * 3 + 7}}) {
+            const std::vector<uint8_t> plain = generate_random_bytes(size);
+            std::vector<uint8_t> cipher = simd.encrypt(plain);
+            check(cipher.size() == ARIAAlgorithm::ciphertextSize(mode, size), "counter mode ciphertext size");
+            check(simd.decrypt(cipher) == plain, "counter mode round trip");
+            check(table.decrypt(cipher) == plain && simd.decrypt(table.encrypt(plain)) == plain, "counter mode core interop");
+
+            if (mode == ARIAAlgorithm::Mode::Gcm) {
+                // nonce, 본문, 태그 어디를 바꾸어도 실패해야 하고, 실패한 평문 자리는 지워짐
+                for (size_t pos : {size_t{0}, ARIAAlgorithm::GCM_NONCE_SIZE + size / 2, cipher.size() - 1}) {
+                    if (size == 0 && pos == ARIAAlgorithm::GCM_NONCE_SIZE) {
+                        continue;
+                    }
+                    std::vector<uint8_t> tampered = cipher;
+                    tampered[pos] ^= 0x01;
+                    check(!simd.decryptInPlace(tampered), "tampered GCM message accepted");
+                }
+                std::vector<uint8_t> truncated(cipher.begin(), cipher.end() - 1);
+                check(!simd.decryptInPlace(truncated), "truncated GCM message accepted");
+            }
+        }
+        if (pass == before) {
+            std::cout << "PASS\n";
+        }
+    }
+
+    // PCLMUL과 테이블 GHASH가 같아야 함
+    const std::vector<uint8_t> h = generate_random_bytes(16);
+    const std::vector<uint8_t> data = generate_random_bytes(1000);
+    GHashKey::Block y_auto{}, y_table{};
+    GHashKey(std::span<const uint8_t, 16>(h.data(), 16)).absorb(y_auto, data);
+    GHashKey(std::span<const uint8_t, 16>(h.data(), 16), false).absorb(y_table, data);
+    check(y_auto == y_table, "GHASH implementations differ");
+    return pass;
+}
+
+// 조각 병렬 CBC 복호화: 직렬 decryptBlocks와 바이트 단위로 같아야 하고, 이어지는 체인도 같아야 함
+static bool run_parallel_cbc_tests() {
+    bool pass = true;
+    auto check = [&pass](bool ok, const char* what, size_t size) {
+        if (!ok) {
+            std::cerr << "FAIL: " << what << " (" << size << " bytes)\n";
+            pass = false;
+        }
+    };
+    std::cout << "[CBC] parallel decrypt... ";
+
+    WorkerPool pool(3);
+    const std::vector<uint8_t> key = generate_random_bytes(32);
+    const std::vector<uint8_t> iv = generate_random_bytes(16);
+    const size_t chunk = ARIAAlgorithm::PARALLEL_CHUNK_SIZE;
+    for (ARIAAlgorithm::Core core : {ARIAAlgorithm::Core::Simd, ARIAAlgorithm::Core::Table}) {
+        ARIAAlgorithm aria(key, ARIAAlgorithm::Mode::Cbc, core);
+        for (size_t size : {chunk - 16, 2 * chunk, 3 * chunk + 4096 + 48}) {
+            const std::vector<uint8_t> cipher = generate_random_bytes(size);
+            std::vector<uint8_t> serial = cipher;
+            std::vector<uint8_t> parallel = cipher;
+            ARIAAlgorithm::CbcState serial_state = aria.beginDecrypt(std::span<const uint8_t, 16>(iv.data(), 16));
+            ARIAAlgorithm::CbcState parallel_state = serial_state;
+            ARIAAlgorithm::decryptBlocks(serial_state, serial);
+            ARIAAlgorithm::decryptBlocksParallel(parallel_state, parallel, pool);
+            check(parallel == serial, "parallel CBC output differs", size);
+            check(parallel_state.chain == serial_state.chain, "parallel CBC chain differs", size);
+        }
+
+        // 공용 풀을 쓰는 decrypt 경로 왕복
+        const std::vector<uint8_t> plain = generate_random_bytes(2 * chunk + 5);
+        check(aria.decrypt(aria.encrypt(plain)) == plain, "parallel CBC round trip", plain.size());
+    }
+
+    // 여러 스레드가 같은 풀에 동시에 작업을 넣어도 모든 번호가 한 번씩 실행되어야 함
+    std::atomic<bool> wrong{false};
+    std::vector<std::thread> callers;
+    for (int t = 0; t < 4; ++t) {
+        callers.emplace_back([&] {
+            for (int round = 0; round < 50; ++round) {
+                std::vector<std::atomic<int>> hits(37);
+                pool.run(hits.size(), [&](size_t i) { hits[i].fetch_add(1); });
+                for (auto& h : hits) {
+                    if (h.load() != 1) {
+                        wrong = true;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& c : callers) {
+        c.join();
+    }
+    check(!wrong, "WorkerPool ran a task zero or multiple times", 0);
+
+    if (pass) {
+        std::cout << "PASS\n";
+    }
+    return pass;
+}
+
+// 스트리밍: 임의로 나눈 조각(0바이트, 1바이트 포함)으로 넣어도 한 번에 처리한 것과 호환되어야 함
+static std::vector<size_t> random_splits(size_t total, std::mt19937& rng) {
+    std::vector<size_t> parts;
+    std::uniform_int_distribution<size_t> dist(0, 70);
+    while (total > 0) {
+        size_t n = std::min(total, (rng() % 8 == 0) ? size_t{5000} : dist(rng));
+        parts.push_back(n);
+        total -= n;
+    }
+    parts.push_back(0);
+    return parts;
+}
+
+template <typename Stream>
+static std::vector<uint8_t> feed_stream(Stream& stream, const std::vector<uint8_t>& data, std::mt19937& rng) {
+    std::vector<uint8_t> out;
+    size_t off = 0;
+    for (size_t n : random_splits(data.size(), rng)) {
+        stream.update(std::span<const uint8_t>(data.data() + off, n), out);
+        off += n;
+    }
+    return out;
+}
+
+static bool run_stream_tests() {
+    bool pass = true;
+    auto check = [&pass](bool ok, const char* what, size_t size) {
+        if (!ok) {
+            std::cerr << "FAIL: " << what << " (" << size << " bytes)\n";
+            pass = false;
+        }
+    };
+    std::cout << "[Stream] begin/update/finish... ";
+
+    std::mt19937 rng(7);
+    const std::vector<uint8_t> key = generate_random_bytes(24);
+    for (ARIAAlgorithm::Mode mode : {ARIAAlgorithm::Mode::Cbc, ARIAAlgorithm::Mode::Ctr, ARIAAlgorithm::Mode::Gcm}) {
+        ARIAAlgorithm aria(key, mode);
+        for (size_t size : {size_t{0}, size_t{1}, size_t{15}, size_t{16}, size_t{33}, size_t{20000}}) {
+            const std::vector<uint8_t> plain = generate_random_bytes(size);
+
+            ARIAAlgorithm::Encryptor enc = aria.beginEncryptStream();
+            std::vector<uint8_t> cipher = feed_stream(enc, plain, rng);
+            enc.finish(cipher);
+            check(cipher.size() == ARIAAlgorithm::ciphertextSize(mode, size), "stream ciphertext size", size);
+            check(aria.decrypt(cipher) == plain, "one-shot cannot decrypt stream output", size);
+
+            const std::vector<uint8_t> one_shot = aria.encrypt(plain);
+            ARIAAlgorithm::Decryptor dec = aria.beginDecryptStream();
+            std::vector<uint8_t> recovered = feed_stream(dec, one_shot, rng);
+            check(dec.finish(recovered) && recovered == plain, "stream cannot decrypt one-shot output", size);
+
+            // 잘린 메시지는 finish에서 실패 (CTR은 길이를 확인할 방법이 없으므로 IV 안에서 끊긴 경우만)
+            std::vector<uint8_t> truncated(one_shot.begin(), one_shot.end() - (mode == ARIAAlgorithm::Mode::Ctr ? size + 1 : 1));
+            ARIAAlgorithm::Decryptor dec_truncated = aria.beginDecryptStream();
+            std::vector<uint8_t> ignored = feed_stream(dec_truncated, truncated, rng);
+            check(!dec_truncated.finish(ignored), "truncated stream accepted", size);
+
+            if (mode == ARIAAlgorithm::Mode::Gcm) {
+                std::vector<uint8_t> tampered = one_shot;
+                tampered[tampered.size() / 2] ^= 0x04;
+                ARIAAlgorithm::Decryptor dec_tampered = aria.beginDecryptStream();
+                ignored = feed_stream(dec_tampered, tampered, rng);
+                check(!dec_tampered.finish(ignored), "tampered GCM stream accepted", size);
+            }
+        }
+    }
+    if (pass) {
+        std::cout << "PASS\n";
+    }
+    return pass;
+}
+
+// 임의 왕복: 모드, 코어, 키 길이, 평문 길이를 시드 고정 난수로 골라 암호화한 코어와 다른 코어로 복호화.
+// 실패하면 시드를 출력하므로 ARIA_TEST_SEED=<시드>로 같은 경우를 다시 돌릴 수 있음
+static bool run_randomized_round_trip_tests() {
+    const char* seed_env = std::getenv("ARIA_TEST_SEED");
+    const uint32_t seed = seed_env ? static_cast<uint32_t>(std::strtoul(seed_env, nullptr, 10)) : std::random_device{}();
+    std::mt19937 rng(seed);
+    std::cout << "[Random] round trips (seed " << seed << ")... ";
+
+    const ARIAAlgorithm::Mode modes[] = {ARIAAlgorithm::Mode::Cbc, ARIAAlgorithm::Mode::Ctr, ARIAAlgorithm::Mode::Gcm};
+    const ARIAAlgorithm::Core cores[] = {ARIAAlgorithm::Core::Reference, ARIAAlgorithm::Core::Table, ARIAAlgorithm::Core::Simd};
+    const size_t key_lens[] = {16, 24, 32};
+    bool pass = true;
+    for (int round = 0; round < 200 && pass; ++round) {
+        const ARIAAlgorithm::Mode mode = modes[rng() % 3];
+        const ARIAAlgorithm::Core enc_core = cores[rng() % 3];
+        const ARIAAlgorithm::Core dec_core = cores[rng() % 3];
+        std::vector<uint8_t> key(key_lens[rng() % 3]);
+        for (auto& b : key) b = static_cast<uint8_t>(rng());
+        // 작은 길이가 많이 나오도록 자릿수부터 고름 (최대 64KiB)
+        const size_t size = rng() % (size_t{1} << (rng() % 17));
+        std::vector<uint8_t> plain(size);
+        for (auto& b : plain) b = static_cast<uint8_t>(rng());
+
+        ARIAAlgorithm enc(key, mode, enc_core);
+        ARIAAlgorithm dec(key, mode, dec_core);
+        const std::vector<uint8_t> cipher = enc.encrypt(plain);
+        if (cipher.size() != ARIAAlgorithm::ciphertextSize(mode, size) || dec.decrypt(cipher) != plain) {
+            std::cerr << "FAIL: round " << round << " (seed " << seed << ", " << size << " bytes)\n";
+            pass = false;
+        }
+    }
+    if (pass) {
+        std::cout << "PASS\n";
+    }
+    return pass;
+}
+
+// OpenSSL provider: 내장 구현과 서로 복호화되어야 하고, 변조/잘림을 같이 거부해야 함
+static bool run_provider_tests() {
+    using Provider = ARIAAlgorithm::Provider;
+    if (!ARIAAlgorithm::providerAvailable(Provider::OpenSsl)) {
+        std::cout << "[Provider] openssl not available, skipped\n";
+        return true;
+    }
+    bool pass = true;
+    auto check = [&pass](bool ok, const char* what, size_t size) {
+        if (!ok) {
+            std::cerr << "FAIL: " << what << " (" << size << " bytes)\n";
+            pass = false;
+        }
+    };
+    std::cout << "[Provider] builtin <-> openssl... ";
+
+    const ARIAAlgorithm::Core core = ARIAAlgorithm::Core::Simd;
+    for (ARIAAlgorithm::Mode mode : {ARIAAlgorithm::Mode::Cbc, ARIAAlgorithm::Mode::Ctr, ARIAAlgorithm::Mode::Gcm}) {
+        for (size_t key_len : {size_t{16}, size_t{24}, size_t{32}}) {
+            const std::vector<uint8_t> key = generate_random_bytes(key_len);
+            ARIAAlgorithm builtin(key, mode, core, Provider::Builtin);
+            ARIAAlgorithm openssl(key, mode, core, Provider::OpenSsl);
+            check(openssl.provider() == Provider::OpenSsl, "provider not selected", key_len);
+            for (size_t size : {size_t{0}, size_t{1}, size_t{15}, size_t{16}, size_t{17}, size_t{1000}, size_t{4096 * 3 + 7}}) {
+                const std::vector<uint8_t> plain = generate_random_bytes(size);
+                const std::vector<uint8_t> cipher = openssl.encrypt(plain);
+                check(cipher.size() == ARIAAlgorithm::ciphertextSize(mode, size), "openssl ciphertext size", size);
+                check(builtin.decrypt(cipher) == plain, "builtin cannot decrypt openssl message", size);
+                check(openssl.decrypt(builtin.encrypt(plain)) == plain, "openssl cannot decrypt builtin message", size);
+
+                if (mode == ARIAAlgorithm::Mode::Gcm) {
+                    std::vector<uint8_t> tampered = cipher;
+                    tampered[tampered.size() - 1] ^= 0x01;
+                    check(!openssl.decryptInPlace(tampered), "tampered GCM message accepted", size);
+                }
+                if (mode != ARIAAlgorithm::Mode::Ctr) {
+                    std::vector<uint8_t> truncated(cipher.begin(), cipher.end() - 1);
+                    check(!openssl.decryptInPlace(truncated), "truncated message accepted", size);
+                }
+            }
+        }
+    }
+
+    // 외부 구현이 만든 GCM 메시지 (run_counter_mode_tests와 같은 벡터)
+    const std::vector<uint8_t> gcm_key = from_hex("000102030405060708090a0b0c0d0e0f");
+    const std::vector<uint8_t> gcm_message = from_hex(
+        "cafebabefacedbaddecaf888"
+        "c2024bf1801a5d1e391986af0747c2ed2f8bd6463c335f2c82611f079ed2e0573626e861e6ceac28"
+        "0c9692c880af76c8b223f6dd9930eb4c");
+    const std::vector<uint8_t> gcm_plain = from_hex(
+        "00112233445566778899aabbccddeeff00112233445566778899aabbccddeeff0011223344556677");
+    check(ARIAAlgorithm(gcm_key, ARIAAlgorithm::Mode::Gcm, core, Provider::OpenSsl).decrypt(gcm_message) == gcm_plain,
+          "GCM known message", gcm_message.size());
+
+    // CTR 카운터는 하위 32비트만 늘어나므로 넘침 직전 IV에서도 두 구현이 같아야 함
+    const std::vector<uint8_t> ctr_key = generate_random_bytes(16);
+    std::vector<uint8_t> near_wrap = generate_random_bytes(ARIAAlgorithm::BLOCK_SIZE + 5 * ARIAAlgorithm::BLOCK_SIZE + 3);
+    std::fill(near_wrap.begin() + 12, near_wrap.begin() + 15, 0xff);
+    near_wrap[15] = 0xfe;
+    std::vector<uint8_t> by_builtin = near_wrap;
+    std::vector<uint8_t> by_openssl = near_wrap;
+    ARIAAlgorithm(ctr_key, ARIAAlgorithm::Mode::Ctr, core, Provider::Builtin).decryptInPlace(by_builtin);
+    ARIAAlgorithm(ctr_key, ARIAAlgorithm::Mode::Ctr, core, Provider::OpenSsl).decryptInPlace(by_openssl);
+    check(by_builtin == by_openssl, "CTR counter wrap differs", near_wrap.size());
+
+    // 기본 provider 전환
+    const Provider saved = ARIAAlgorithm::defaultProvider();
+    ARIAAlgorithm::setDefaultProvider(Provider::OpenSsl);
+    check(ARIAAlgorithm(ctr_key).provider() == Provider::OpenSsl, "default provider not applied", 0);
+    ARIAAlgorithm::setDefaultProvider(saved);
+
+    if (pass) {
+        std::cout << "PASS\n";
+    }
+    return pass;
+}
+
 int main() {
     std::vector<uint8_t> key = generate_random_bytes(16);
     ARIAAlgorithm aria(key);
+    ARIAAlgorithm aria_ref(key, ARIAAlgorithm::Mode::Cbc, ARIAAlgorithm::Core::Reference);
+    ARIAAlgorithm aria_table(key, ARIAAlgorithm::Mode::Cbc, ARIAAlgorithm::Core::Table);
 
     std::vector<std::vector<uint8_t>> test_plaintexts;
     test_plaintexts.push_back({});  
@@ -24,8 +484,17 @@ int main() {
     test_plaintexts.push_back(std::vector<uint8_t>(30, 0x55));
     test_plaintexts.push_back(generate_random_bytes(100));
     test_plaintexts.push_back(generate_random_bytes(1024));
+    // 다중 블록 복호화 묶음(64블록)을 넘는 크기
+    test_plaintexts.push_back(generate_random_bytes(64 * 16 * 3 + 5));
 
-    bool all_pass = true;
+    bool all_pass = run_known_answer_tests();
+    all_pass = run_cbc_known_answer_tests() && all_pass;
+    all_pass = run_simd_backend_tests() && all_pass;
+    all_pass = run_counter_mode_tests() && all_pass;
+    all_pass = run_parallel_cbc_tests() && all_pass;
+    all_pass = run_stream_tests() && all_pass;
+    all_pass = run_randomized_round_trip_tests() && all_pass;
+    all_pass = run_provider_tests() && all_pass;
     for (size_t idx = 0; idx < test_plaintexts.size(); ++idx) {
         const auto& pt = test_plaintexts[idx];
         std::cout << "[Test " << idx << "] Plaintext size = " << pt.size() << " bytes... ";
@@ -36,7 +505,12 @@ int main() {
             continue;
         }
         std::vector<uint8_t> recovered = aria.decrypt(cipher);
-        if (recovered != pt) {
+        // 코어가 달라도 같은 CBC 결과여야 함
+        if (aria_ref.decrypt(cipher) != pt || aria.decrypt(aria_ref.encrypt(pt)) != pt ||
+            aria_table.decrypt(cipher) != pt || aria.decrypt(aria_table.encrypt(pt)) != pt) {
+            std::cerr << "FAIL: 참조 코어와 테이블 코어 결과가 다름\n";
+            all_pass = false;
+        } else if (recovered != pt) {
             std::cerr << "FAIL: 복호화 결과가 원본과 다름\n";
             std::cerr << "  원본 크기=" << pt.size() << ", 복호화 후 크기=" << recovered.size() << "\n";
             all_pass = false;
@@ -0,0 +1,230 @@
+#include "protocol/ProtocolEngine.h"
+#include "protocol/ShiftModule.h"
+#include "protocol/PaddingModule.h"
+#include "protocol/EncryptionModule.h"
+#include "protocol/FusedPipeline.h"
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <stdexcept>
+
+static std::vector<uint8_t> generate_random_bytes(size_t len) {
+    std::vector<uint8_t> v(len);
+    std::random_device rd;
+    for (size_t i = 0; i < len; ++i) {
+        v[i] = static_cast<uint8_t>(rd() & 0xFF);
+    }
+    return v;
+}
+
+// vector API만 구현한 모듈 (기본 제자리 구현 경로 확인용)
+class TrailerModule : public IProtocolModule {
+public:
+    std::vector<uint8_t> process(const std::vector<uint8_t>& data) override {
+        std::vector<uint8_t> out = data;
+        out.push_back(0xEE);
+        return out;
+    }
+    std::vector<uint8_t> reverse(const std::vector<uint8_t>& data) override {
+        return std::vector<uint8_t>(data.begin(), data.end() - (data.empty() ? 0 : 1));
+    }
+};
+
+static ProtocolEngine make_engine(const std::vector<uint8_t>& key, bool with_trailer) {
+    ProtocolEngine engine;
+    engine.addModule(std::make_unique<ShiftModule>(8));
+    engine.addModule(std::make_unique<EncryptionModule>(key));
+    engine.addModule(std::make_unique<PaddingModule>(std::vector<uint8_t>{0,0,0,0}));
+    if (with_trailer) {
+        engine.addModule(std::make_unique<TrailerModule>());
+    }
+    return engine;
+}
+
+// 모듈마다 새 vector를 만들던 이전 방식 그대로 적용
+static std::vector<uint8_t> legacy_encrypt(const std::vector<uint8_t>& key, const std::vector<uint8_t>& data) {
+    ShiftModule shift(8);
+    EncryptionModule encryption(key);
+    PaddingModule padding(std::vector<uint8_t>{0,0,0,0});
+    return padding.process(encryption.process(shift.process(data)));
+}
+
+static std::vector<uint8_t> legacy_decrypt(const std::vector<uint8_t>& key, const std::vector<uint8_t>& data) {
+    ShiftModule shift(8);
+    EncryptionModule encryption(key);
+    PaddingModule padding(std::vector<uint8_t>{0,0,0,0});
+    return shift.reverse(encryption.reverse(padding.reverse(data)));
+}
+
+int main() {
+    std::vector<uint8_t> key = generate_random_bytes(32);
+    ProtocolEngine engine = make_engine(key, false);
+    ProtocolEngine trailer_engine = make_engine(key, true);
+    auto fused = makeFusedPipeline(ShiftStage{8}, AriaCbcStage(key), PaddingStage{{0,0,0,0}});
+    // 암호 단계 뒤의 ChunkStage와 암호 단계가 없는 구간도 확인
+    auto fused_mixed = makeFusedPipeline(ShiftStage{3}, ShiftStage{5}, AriaCbcStage(key), ShiftStage{1}, PaddingStage{{7}});
+    ProtocolEngine mixed_engine;
+    mixed_engine.addModule(std::make_unique<ShiftModule>(3));
+    mixed_engine.addModule(std::make_unique<ShiftModule>(5));
+    mixed_engine.addModule(std::make_unique<EncryptionModule>(key));
+    mixed_engine.addModule(std::make_unique<ShiftModule>(1));
+    mixed_engine.addModule(std::make_unique<PaddingModule>(std::vector<uint8_t>{7}));
+
+    bool all_pass = true;
+    auto check = [&all_pass](bool ok, const char* what, size_t size) {
+        if (!ok) {
+            std::cerr << "FAIL: " << what << " (" << size << " bytes)\n";
+            all_pass = false;
+        }
+    };
+
+    for (size_t size : {size_t{0}, size_t{1}, size_t{15}, size_t{16}, size_t{17}, size_t{1000}, size_t{4096}, size_t{65536 + 3}}) {
+        std::vector<uint8_t> plain = generate_random_bytes(size);
+        std::cout << "[Test] Payload size = " << size << " bytes...\n";
+
+        std::vector<uint8_t> cipher = engine.encrypt(plain);
+        check(cipher.size() == legacy_encrypt(key, plain).size(), "wire size differs from legacy", size);
+        check(engine.decrypt(cipher) == plain, "in-place round trip", size);
+        // IV가 매번 다르므로 바이트 비교 대신 서로의 출력을 복호화하여 호환 확인
+        check(legacy_decrypt(key, cipher) == plain, "legacy cannot decrypt in-place output", size);
+        check(engine.decrypt(legacy_encrypt(key, plain)) == plain, "in-place cannot decrypt legacy output", size);
+
+        // 엔진이 알린 여유 안에서 끝났으면 저장소를 다시 할당하지 않았음
+        ProtocolBuffer buffer(plain, engine.headroom(), engine.tailroom());
+        engine.encryptInPlace(buffer);
+        check(buffer.headroom() == 0, "headroom not consumed exactly", size);
+        engine.decryptInPlace(buffer);
+        check(std::vector<uint8_t>(buffer.data().begin(), buffer.data().end()) == plain, "in-place buffer round trip", size);
+
+        std::vector<uint8_t> trailer_cipher = trailer_engine.encrypt(plain);
+        check(trailer_cipher.size() == cipher.size() + 1 && trailer_cipher.back() == 0xEE, "vector-only module output", size);
+        check(trailer_engine.decrypt(trailer_cipher) == plain, "vector-only module round trip", size);
+
+        std::vector<uint8_t> fused_cipher = fused.encrypt(plain);
+        check(fused_cipher.size() == cipher.size(), "fused wire size differs from engine", size);
+        check(engine.decrypt(fused_cipher) == plain, "engine cannot decrypt fused output", size);
+        check(fused.decrypt(cipher) == plain, "fused cannot decrypt engine output", size);
+        check(mixed_engine.decrypt(fused_mixed.encrypt(plain)) == plain, "engine cannot decrypt mixed fused output", size);
+        check(fused_mixed.decrypt(mixed_engine.encrypt(plain)) == plain, "mixed fused cannot decrypt engine output", size);
+    }
+
+    std::vector<uint8_t> corrupt = engine.encrypt(generate_random_bytes(40));
+    corrupt.pop_back();
+    check(engine.decrypt(corrupt).empty(), "truncated ciphertext must decrypt to empty", corrupt.size());
+    check(fused.decrypt(corrupt).empty(), "fused truncated ciphertext must decrypt to empty", corrupt.size());
+
+    // CTR/GCM 모드 모듈: 엔진 안에서 왕복, 제자리 여유 정확히 사용, GCM은 변조되면 예외
+    for (ARIAAlgorithm::Mode mode : {ARIAAlgorithm::Mode::Ctr, ARIAAlgorithm::Mode::Gcm}) {
+        ProtocolEngine mode_engine;
+        mode_engine.addModule(std::make_unique<ShiftModule>(8));
+        mode_engine.addModule(std::make_unique<EncryptionModule>(key, mode));
+        mode_engine.addModule(std::make_unique<PaddingModule>(std::vector<uint8_t>{0,0,0,0}));
+        for (size_t size : {size_t{0}, size_t{17}, size_t{65536 + 3}}) {
+            std::vector<uint8_t> plain = generate_random_bytes(size);
+            std::vector<uint8_t> cipher = mode_engine.encrypt(plain);
+            check(cipher.size() == 4 + ARIAAlgorithm::ciphertextSize(mode, size), "counter mode wire size", size);
+            check(mode_engine.decrypt(cipher) == plain, "counter mode engine round trip", size);
+
+            ProtocolBuffer buffer(plain, mode_engine.headroom(), mode_engine.tailroom());
+            mode_engine.encryptInPlace(buffer);
+            check(buffer.headroom() == 0 && buffer.tailroom() == 0, "counter mode room not consumed exactly", size);
+
+            if (mode == ARIAAlgorithm::Mode::Gcm) {
+                cipher[cipher.size() / 2] ^= 0x80;
+                bool thrown = false;
+                try {
+                    mode_engine.decrypt(cipher);
+                } catch (const std::runtime_error&) {
+                    thrown = true;
+                }
+                check(thrown, "tampered GCM message must throw", size);
+            }
+        }
+    }
+
+    // 스트리밍: 64KiB 조각으로 나누어 넣어도 한 번에 처리한 것과 호환되고, 조각마다 출력이 조각 크기 정도여야 함
+    for (ARIAAlgorithm::Mode mode : {ARIAAlgorithm::Mode::Cbc, ARIAAlgorithm::Mode::Ctr, ARIAAlgorithm::Mode::Gcm}) {
+        ProtocolEngine stream_engine;
+        stream_engine.addModule(std::make_unique<ShiftModule>(8));
+        stream_engine.addModule(std::make_unique<EncryptionModule>(key, mode));
+        stream_engine.addModule(std::make_unique<PaddingModule>(std::vector<uint8_t>{0,0,0,0}));
+        constexpr size_t CHUNK = 64 * 1024;
+        const std::vector<uint8_t> plain = generate_random_bytes(5 * CHUNK + 123);
+
+        bool bounded = true;
+        auto run_stream = [&](ProtocolEngine::Stream stream, const std::vector<uint8_t>& in) {
+            std::vector<uint8_t> all, out;
+            for (size_t off = 0; off < in.size(); off += CHUNK) {
+                out.clear();
+                stream.update(std::span<const uint8_t>(in).subspan(off, std::min(CHUNK, in.size() - off)), out);
+                bounded = bounded && out.size() <= CHUNK + 64;
+                all.insert(all.end(), out.begin(), out.end());
+            }
+            stream.finish(all);
+            return all;
+        };
+        std::vector<uint8_t> cipher = run_stream(stream_engine.beginEncrypt(), plain);
+        check(stream_engine.decrypt(cipher) == plain, "engine cannot decrypt stream output", plain.size());
+        check(run_stream(stream_engine.beginDecrypt(), stream_engine.encrypt(plain)) == plain, "stream cannot decrypt engine output", plain.size());
+        check(bounded, "stream output not bounded by chunk size", plain.size());
+
+        cipher[cipher.size() / 2] ^= 0x10;
+        bool thrown = false;
+        try {
+            run_stream(stream_engine.beginDecrypt(), cipher);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        check(thrown == (mode == ARIAAlgorithm::Mode::Gcm), "only tampered GCM stream must throw", plain.size());
+    }
+    // 스트리밍을 재정의하지 않은 모듈은 모았다가 처리
+    std::vector<uint8_t> trailer_plain = generate_random_bytes(3000);
+    ProtocolEngine::Stream trailer_stream = trailer_engine.beginEncrypt();
+    std::vector<uint8_t> trailer_out;
+    trailer_stream.update(std::span<const uint8_t>(trailer_plain).first(1000), trailer_out);
+    trailer_stream.update(std::span<const uint8_t>(trailer_plain).subspan(1000), trailer_out);
+    trailer_stream.finish(trailer_out);
+    check(trailer_engine.decrypt(trailer_out) == trailer_plain, "buffered module stream round trip", trailer_plain.size());
+
+    // 키 교체: 파이프라인을 다시 만들지 않고 새 키로 바뀌어야 함
+    std::vector<uint8_t> new_key = generate_random_bytes(32);
+    EncryptionModule rotating(key);
+    std::vector<uint8_t> plain = generate_random_bytes(100);
+    std::vector<uint8_t> old_cipher = rotating.process(plain);
+    rotating.setKey(new_key);
+    check(EncryptionModule(new_key).reverse(rotating.process(plain)) == plain, "rotated module must use new key", plain.size());
+    check(rotating.reverse(old_cipher) != plain, "rotated module must not use old key", plain.size());
+    fused.stage<1>().setKey(new_key);
+    check(make_engine(new_key, false).decrypt(fused.encrypt(plain)) == plain, "rotated fused stage must use new key", plain.size());
+
+    // 처리 중인 스레드와 키 교체가 겹쳐도 각 결과는 두 키 중 하나로 온전히 복호화되어야 함
+    std::atomic<bool> torn{false};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 3; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < 200; ++i) {
+                std::vector<uint8_t> c = rotating.process(plain);
+                if (EncryptionModule(key).reverse(c) != plain && EncryptionModule(new_key).reverse(c) != plain) {
+                    torn = true;
+                }
+            }
+        });
+    }
+    for (int i = 0; i < 200; ++i) {
+        rotating.setKey(i % 2 ? key : new_key);
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    check(!torn, "concurrent key rotation produced undecryptable output", plain.size());
+
+    if (!all_pass) {
+        std::cerr << "ProtocolEngine 테스트 중 실패 케이스 존재\n";
+        return 1;
+    }
+    std::cout << "ProtocolEngine 모든 테스트 통과\n";
+    return 0;
+}